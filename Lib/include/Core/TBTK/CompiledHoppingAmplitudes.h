@@ -0,0 +1,333 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file CompiledHoppingAmplitudes.h
+ *  @brief Flat representation of the @link HoppingAmplitude
+ *  HoppingAmplitudes@endlink in a HoppingAmplitudeSet.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_COMPILED_HOPPING_AMPLITUDES
+#define COM_DAFER45_TBTK_COMPILED_HOPPING_AMPLITUDES
+
+#include "TBTK/HoppingAmplitude.h"
+#include "TBTK/Index.h"
+
+#include <atomic>
+#include <complex>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Flat representation of the @link HoppingAmplitude
+ *  HoppingAmplitudes@endlink in a HoppingAmplitudeSet.
+ *
+ *  The CompiledHoppingAmplitudes stores the HoppingAmplitudes of a
+ *  constructed HoppingAmplitudeSet as three contiguous arrays of to-indices,
+ *  from-indices, and amplitudes, where the indices are basis indices rather
+ *  than physical @link Index Indices@endlink. The entries are sorted by
+ *  to-index (row) and from-index (column), and the entries for a given
+ *  to-index can be located through the row pointers in the same way as for a
+ *  SparseMatrix on the CSR format. Duplicate entries are kept, which means
+ *  that the amplitudes should be added rather than assigned when building a
+ *  matrix.
+ *
+ *  The CompiledHoppingAmplitudes is created by HoppingAmplitudeSet::construct()
+ *  and is obtained through
+ *  HoppingAmplitudeSet::getCompiledHoppingAmplitudes(). Amplitudes that are
+ *  determined by an HoppingAmplitude::AmplitudeCallback are reevaluated
+ *  through HoppingAmplitudeSet::updateCompiledCallbackAmplitudes(), which
+ *  solvers call before they read the amplitudes. The matrix elements that
+ *  are affected by such reevaluations are listed through
+ *  getCallbackDependentElementRanges(), which allows solvers to update only
+ *  these elements between iterations of a self-consistency loop. */
+class CompiledHoppingAmplitudes{
+public:
+	/** Constructs an empty CompiledHoppingAmplitudes. */
+	CompiledHoppingAmplitudes();
+
+	/** Get the basis size.
+	 *
+	 *  @return The number of basis states. */
+	unsigned int getBasisSize() const;
+
+	/** Get the number of HoppingAmplitudes.
+	 *
+	 *  @return The number of HoppingAmplitudes. */
+	unsigned int getNumHoppingAmplitudes() const;
+
+	/** Get the row pointers. The HoppingAmplitudes with to-index n are
+	 *  stored at the positions [rowPointers[n], rowPointers[n+1]).
+	 *
+	 *  @return Pointer to an array with getBasisSize()+1 elements. */
+	const unsigned int* getRowPointers() const;
+
+	/** Get the to-indices.
+	 *
+	 *  @return Pointer to an array with getNumHoppingAmplitudes() basis
+	 *  indices. */
+	const unsigned int* getToIndices() const;
+
+	/** Get the from-indices.
+	 *
+	 *  @return Pointer to an array with getNumHoppingAmplitudes() basis
+	 *  indices. */
+	const unsigned int* getFromIndices() const;
+
+	/** Get the amplitudes.
+	 *
+	 *  @return Pointer to an array with getNumHoppingAmplitudes()
+	 *  amplitudes. */
+	const std::complex<double>* getAmplitudes() const;
+
+	/** Get the number of matrix elements that depend on an
+	 *  HoppingAmplitude::AmplitudeCallback. A matrix element is a pair of
+	 *  to- and from-indices and is callback dependent if at least one of
+	 *  its entries is determined by an AmplitudeCallback.
+	 *
+	 *  @return The number of callback dependent matrix elements. */
+	unsigned int getNumCallbackDependentElements() const;
+
+	/** Get the ranges of entries that make up the callback dependent
+	 *  matrix elements. The entries for the n:th element are stored at
+	 *  the positions [ranges[2*n], ranges[2*n+1]), and the value of the
+	 *  matrix element is the sum of the corresponding amplitudes. The
+	 *  ranges are sorted and do not overlap.
+	 *
+	 *  @return Pointer to an array with
+	 *  2*getNumCallbackDependentElements() positions. */
+	const unsigned int* getCallbackDependentElementRanges() const;
+
+	/** Get the revision. The revision is unique to the content created by
+	 *  the last call to HoppingAmplitudeSet::construct() and is preserved
+	 *  by copies. Solvers that cache matrices built from the
+	 *  CompiledHoppingAmplitudes can compare revisions to detect that the
+	 *  Model has been reconstructed. Reevaluation of callback dependent
+	 *  amplitudes does not change the revision.
+	 *
+	 *  @return The revision. */
+	unsigned long long getRevision() const;
+
+	/** Get size in bytes.
+	 *
+	 *  @return Memory size required to store the
+	 *  CompiledHoppingAmplitudes. */
+	unsigned int getSizeInBytes() const;
+private:
+	/** Information required to reevaluate an amplitude that is determined
+	 *  by an AmplitudeCallback. */
+	class CallbackEntry{
+	public:
+		/** Constructor. */
+		CallbackEntry(
+			unsigned int position,
+			const HoppingAmplitude &hoppingAmplitude
+		);
+
+		/** Position of the amplitude in the amplitude array. */
+		unsigned int position;
+
+		/** The AmplitudeCallback. */
+		const HoppingAmplitude::AmplitudeCallback *callback;
+
+		/** The to-Index. */
+		Index toIndex;
+
+		/** The from-Index. */
+		Index fromIndex;
+	};
+
+	/** Basis size. */
+	unsigned int basisSize;
+
+	/** Row pointers. */
+	std::vector<unsigned int> rowPointers;
+
+	/** To-indices. */
+	std::vector<unsigned int> toIndices;
+
+	/** From-indices. */
+	std::vector<unsigned int> fromIndices;
+
+	/** Amplitudes. */
+	std::vector<std::complex<double>> amplitudes;
+
+	/** Entries that are determined by AmplitudeCallbacks. */
+	std::vector<CallbackEntry> callbackEntries;
+
+	/** Ranges of entries for the callback dependent matrix elements. */
+	std::vector<unsigned int> callbackDependentElementRanges;
+
+	/** Revision. */
+	unsigned long long revision;
+
+	/** Counter used to assign unique revisions. */
+	static std::atomic<unsigned long long> revisionCounter;
+
+	/** Append a HoppingAmplitude. The entries are sorted by construct().
+	 *
+	 *  @param to The basis index for the to-Index.
+	 *  @param from The basis index for the from-Index.
+	 *  @param hoppingAmplitude The HoppingAmplitude. */
+	void add(
+		unsigned int to,
+		unsigned int from,
+		const HoppingAmplitude &hoppingAmplitude
+	);
+
+	/** Sort the entries and setup the row pointers.
+	 *
+	 *  @param basisSize The basis size. */
+	void construct(unsigned int basisSize);
+
+	/** Reevaluate the amplitudes that are determined by
+	 *  AmplitudeCallbacks. */
+	void updateCallbackAmplitudes();
+
+	/** Write the current values of the amplitudes that are determined by
+	 *  AmplitudeCallbacks to an array with getNumHoppingAmplitudes()
+	 *  elements, without modifying the stored amplitudes.
+	 *
+	 *  @param amplitudes The array to write the amplitudes to. */
+	void evaluateCallbackAmplitudes(
+		std::complex<double> *amplitudes
+	) const;
+
+	/** Remove all entries. */
+	void clear();
+
+	/** Check whether two entries belong to the same matrix element.
+	 *
+	 *  @param position0 Position of the first entry.
+	 *  @param position1 Position of the second entry.
+	 *
+	 *  @return True if the entries have the same to- and from-indices. */
+	bool isSameElement(unsigned int position0, unsigned int position1) const;
+
+	friend class HoppingAmplitudeSet;
+};
+
+inline unsigned int CompiledHoppingAmplitudes::getBasisSize() const{
+	return basisSize;
+}
+
+inline unsigned int CompiledHoppingAmplitudes::getNumHoppingAmplitudes(
+) const{
+	return toIndices.size();
+}
+
+inline const unsigned int* CompiledHoppingAmplitudes::getRowPointers() const{
+	return rowPointers.data();
+}
+
+inline const unsigned int* CompiledHoppingAmplitudes::getToIndices() const{
+	return toIndices.data();
+}
+
+inline const unsigned int* CompiledHoppingAmplitudes::getFromIndices() const{
+	return fromIndices.data();
+}
+
+inline const std::complex<double>* CompiledHoppingAmplitudes::getAmplitudes(
+) const{
+	return amplitudes.data();
+}
+
+inline unsigned int CompiledHoppingAmplitudes::getNumCallbackDependentElements(
+) const{
+	return callbackDependentElementRanges.size()/2;
+}
+
+inline const unsigned int*
+CompiledHoppingAmplitudes::getCallbackDependentElementRanges() const{
+	return callbackDependentElementRanges.data();
+}
+
+inline unsigned long long CompiledHoppingAmplitudes::getRevision() const{
+	return revision;
+}
+
+inline unsigned int CompiledHoppingAmplitudes::getSizeInBytes() const{
+	unsigned int size = sizeof(*this);
+	size += rowPointers.capacity()*sizeof(unsigned int);
+	size += toIndices.capacity()*sizeof(unsigned int);
+	size += fromIndices.capacity()*sizeof(unsigned int);
+	size += amplitudes.capacity()*sizeof(std::complex<double>);
+	size += callbackDependentElementRanges.capacity()*sizeof(unsigned int);
+	for(unsigned int n = 0; n < callbackEntries.size(); n++){
+		size += sizeof(CallbackEntry);
+		size += callbackEntries[n].toIndex.getSizeInBytes();
+		size += callbackEntries[n].fromIndex.getSizeInBytes();
+	}
+
+	return size;
+}
+
+inline void CompiledHoppingAmplitudes::add(
+	unsigned int to,
+	unsigned int from,
+	const HoppingAmplitude &hoppingAmplitude
+){
+	if(hoppingAmplitude.getIsCallbackDependent()){
+		callbackEntries.push_back(
+			CallbackEntry(toIndices.size(), hoppingAmplitude)
+		);
+	}
+	toIndices.push_back(to);
+	fromIndices.push_back(from);
+	amplitudes.push_back(hoppingAmplitude.getAmplitude());
+}
+
+inline void CompiledHoppingAmplitudes::updateCallbackAmplitudes(){
+	evaluateCallbackAmplitudes(amplitudes.data());
+}
+
+inline void CompiledHoppingAmplitudes::evaluateCallbackAmplitudes(
+	std::complex<double> *amplitudes
+) const{
+	for(unsigned int n = 0; n < callbackEntries.size(); n++){
+		const CallbackEntry &entry = callbackEntries[n];
+		amplitudes[entry.position]
+			= entry.callback->getHoppingAmplitude(
+				entry.toIndex,
+				entry.fromIndex
+			);
+	}
+}
+
+inline bool CompiledHoppingAmplitudes::isSameElement(
+	unsigned int position0,
+	unsigned int position1
+) const{
+	return toIndices[position0] == toIndices[position1]
+		&& fromIndices[position0] == fromIndices[position1];
+}
+
+inline CompiledHoppingAmplitudes::CallbackEntry::CallbackEntry(
+	unsigned int position,
+	const HoppingAmplitude &hoppingAmplitude
+) :
+	position(position),
+	callback(&hoppingAmplitude.getAmplitudeCallback()),
+	toIndex(hoppingAmplitude.getToIndex()),
+	fromIndex(hoppingAmplitude.getFromIndex())
+{
+}
+
+};	//End of namespace TBTK
+
+#endif
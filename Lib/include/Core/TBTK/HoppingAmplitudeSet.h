@@ -23,6 +23,7 @@
 #ifndef COM_DAFER45_TBTK_HOPPING_AMPLITUDE_SET
 #define COM_DAFER45_TBTK_HOPPING_AMPLITUDE_SET
 
+#include "TBTK/CompiledHoppingAmplitudes.h"
 #include "TBTK/HoppingAmplitude.h"
 #include "TBTK/HoppingAmplitudeTree.h"
 #include "TBTK/IndexTree.h"
@@ -32,8 +33,13 @@
 #include "TBTK/TBTKMacros.h"
 
 #include <complex>
+#include <mutex>
 #include <vector>
 
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
+
 namespace TBTK{
 
 /** @brief HoppingAmplitude container.
@@ -87,6 +93,20 @@ public:
 	/** Destructor. */
 	virtual ~HoppingAmplitudeSet();
 
+	/** Add a HoppingAmplitude from one of several threads. Each thread in
+	 *  an active OpenMP parallel region appends to a staging buffer of its
+	 *  own, which means that no locking is required. Calls from outside
+	 *  such a region, including calls from threads that are not managed
+	 *  by OpenMP, append to a shared buffer under a lock. The staged @link
+	 *  HoppingAmplitude HoppingAmplitudes @endlink are inserted into the
+	 *  HoppingAmplitudeSet in parallel when construct() is called, and
+	 *  are not visible through any other function before that. As for
+	 *  add(), HoppingAmplitudes with the same to- and from-Indices are
+	 *  kept as separate entries, which the solvers sum.
+	 *
+	 *  @param hoppingAmplitude The HoppingAmplitude to add. */
+	void addConcurrently(const HoppingAmplitude &hoppingAmplitude);
+
 	/** Construct Hilbert space. No more @link HoppingAmplitude
 	 *  HoppingAmplitudes @endlink should be added after this call. */
 	void construct();
@@ -137,6 +157,22 @@ public:
 	 */
 	SparseMatrix<std::complex<double>> getSparseMatrix() const;
 
+	/** Get the flat representation of the HoppingAmplitudeSet that is
+	 *  created by construct(). Amplitudes that are determined by an
+	 *  HoppingAmplitude::AmplitudeCallback have the values from the last
+	 *  call to construct() or updateCompiledCallbackAmplitudes().
+	 *
+	 *  @return The CompiledHoppingAmplitudes for the
+	 *  HoppingAmplitudeSet. */
+	const CompiledHoppingAmplitudes& getCompiledHoppingAmplitudes() const;
+
+	/** Reevaluate the amplitudes in the CompiledHoppingAmplitudes that are
+	 *  determined by an HoppingAmplitude::AmplitudeCallback. Should be
+	 *  called before the CompiledHoppingAmplitudes is read whenever the
+	 *  callbacks may return new values. Must not be called concurrently
+	 *  with reads of the CompiledHoppingAmplitudes. */
+	void updateCompiledCallbackAmplitudes();
+
 	class Iterator;
 	class ConstIterator;
 private:
@@ -364,6 +400,30 @@ private:
 	/** Flag indicating whether the HoppingAmplitudeSet have been
 	 *  constructed. */
 	bool isConstructed;
+
+	/** Staging buffers for addConcurrently(), one per thread. The last
+	 *  buffer is shared and used under a lock by threads that do not
+	 *  have a buffer of their own, such as threads in nested parallel
+	 *  regions and threads that are not managed by OpenMP. */
+	std::vector<std::vector<HoppingAmplitude>> stagingBuffers;
+
+	/** Mutex protecting the shared staging buffer. */
+	static std::mutex sharedStagingBufferMutex;
+
+	/** Allocate one staging buffer per thread. */
+	void initStagingBuffers();
+
+	/** Insert the @link HoppingAmplitude HoppingAmplitudes @endlink that
+	 *  have been added through addConcurrently(). */
+	void insertStagedHoppingAmplitudes();
+
+	/** Flat representation of the HoppingAmplitudes using basis indices.
+	 */
+	CompiledHoppingAmplitudes compiledHoppingAmplitudes;
+
+	/** Setup the CompiledHoppingAmplitudes. Called by construct() after
+	 *  the basis indices have been generated. */
+	void compileHoppingAmplitudes();
 };
 
 inline void HoppingAmplitudeSet::construct(){
@@ -374,10 +434,41 @@ inline void HoppingAmplitudeSet::construct(){
 		""
 	);
 
+	insertStagedHoppingAmplitudes();
 	HoppingAmplitudeTree::generateBasisIndices();
+	compileHoppingAmplitudes();
 	isConstructed = true;
 }
 
+inline void HoppingAmplitudeSet::addConcurrently(
+	const HoppingAmplitude &hoppingAmplitude
+){
+	TBTKAssert(
+		!isConstructed,
+		"HoppingAmplitudeSet::addConcurrently()",
+		"Unable to add HoppingAmplitudes to a HoppingAmplitudeSet"
+		<< " that already is constructed.",
+		""
+	);
+
+#ifdef _OPENMP
+	//The thread number only identifies the calling thread inside an
+	//active parallel region. Outside of it, every thread, including
+	//threads that are not managed by OpenMP, is thread zero.
+	unsigned int thread = omp_get_thread_num();
+	if(
+		omp_in_parallel()
+		&& omp_get_level() == 1
+		&& thread + 1 < stagingBuffers.size()
+	){
+		stagingBuffers[thread].push_back(hoppingAmplitude);
+		return;
+	}
+#endif
+	std::lock_guard<std::mutex> lock(sharedStagingBufferMutex);
+	stagingBuffers.back().push_back(hoppingAmplitude);
+}
+
 inline bool HoppingAmplitudeSet::getIsConstructed() const{
 	return isConstructed;
 }
@@ -407,22 +498,57 @@ inline SparseMatrix<std::complex<double>> HoppingAmplitudeSet::getSparseMatrix(
 		SparseMatrix<std::complex<double>>::StorageFormat::CSC
 	);
 
+	//The callback dependent amplitudes are evaluated into a copy to leave
+	//the CompiledHoppingAmplitudes unmodified.
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices
+		= compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	std::vector<std::complex<double>> amplitudes(
+		compiledHoppingAmplitudes.getAmplitudes(),
+		compiledHoppingAmplitudes.getAmplitudes()
+			+ compiledHoppingAmplitudes.getNumHoppingAmplitudes()
+	);
+	compiledHoppingAmplitudes.evaluateCallbackAmplitudes(
+		amplitudes.data()
+	);
 	for(
-		ConstIterator iterator = begin();
-		iterator != end();
-		++iterator
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
 	){
-		sparseMatrix.add(
-			getBasisIndex((*iterator).getToIndex()),
-			getBasisIndex((*iterator).getFromIndex()),
-			(*iterator).getAmplitude()
-		);
+		sparseMatrix.add(toIndices[n], fromIndices[n], amplitudes[n]);
 	}
 	sparseMatrix.construct();
 
 	return sparseMatrix;
 }
 
+inline const CompiledHoppingAmplitudes&
+HoppingAmplitudeSet::getCompiledHoppingAmplitudes() const{
+	TBTKAssert(
+		isConstructed,
+		"HoppingAmplitudeSet::getCompiledHoppingAmplitudes()",
+		"HoppingAmplitudeSet has to be constructed first.",
+		""
+	);
+
+	return compiledHoppingAmplitudes;
+}
+
+inline void HoppingAmplitudeSet::updateCompiledCallbackAmplitudes(){
+	TBTKAssert(
+		isConstructed,
+		"HoppingAmplitudeSet::updateCompiledCallbackAmplitudes()",
+		"HoppingAmplitudeSet has to be constructed first.",
+		""
+	);
+
+	compiledHoppingAmplitudes.updateCallbackAmplitudes();
+}
+
 inline HoppingAmplitudeSet::Iterator HoppingAmplitudeSet::begin(){
 	return Iterator(this);
 }
@@ -500,6 +626,13 @@ inline bool HoppingAmplitudeSet::_Iterator<isConstIterator>::operator!=(
 inline unsigned int HoppingAmplitudeSet::getSizeInBytes() const{
 	unsigned int size = sizeof(*this) - sizeof(HoppingAmplitudeTree);
 	size += HoppingAmplitudeTree::getSizeInBytes();
+	size += compiledHoppingAmplitudes.getSizeInBytes()
+		- sizeof(compiledHoppingAmplitudes);
+	for(unsigned int n = 0; n < stagingBuffers.size(); n++){
+		size += sizeof(std::vector<HoppingAmplitude>);
+		for(unsigned int c = 0; c < stagingBuffers[n].size(); c++)
+			size += stagingBuffers[n][c].getSizeInBytes();
+	}
 
 	return size;
 }
@@ -25,9 +25,11 @@
 #define COM_DAFER45_TBTK_TREE_NODE
 
 #include "TBTK/HoppingAmplitude.h"
+#include "TBTK/IndexLookupTable.h"
 #include "TBTK/IndexTree.h"
 #include "TBTK/Serializable.h"
 
+#include <memory>
 #include <vector>
 
 namespace TBTK{
@@ -71,6 +73,22 @@ public:
 	 *  @param ha HoppingAmplitude to add. */
 	void add(HoppingAmplitude ha);
 
+	/** Add several lists of @link HoppingAmplitude HoppingAmplitudes
+	 *  @endlink. The @link HoppingAmplitude HoppingAmplitudes @endlink
+	 *  are distributed over the subtrees corresponding to the first
+	 *  subindex of their from-Index, after which the subtrees are built
+	 *  in parallel. The result is the same as if the lists were added one
+	 *  after the other using add(HoppingAmplitude).
+	 *
+	 *  @param hoppingAmplitudeLists The lists of @link HoppingAmplitude
+	 *  HoppingAmplitudes @endlink to add. The @link HoppingAmplitude
+	 *  HoppingAmplitudes @endlink are moved into the tree and the lists
+	 *  should be cleared afterwards. */
+	void addInParallel(
+		std::vector<std::vector<HoppingAmplitude>>
+			&hoppingAmplitudeLists
+	);
+
 	/** Get basis size.
 	 *
 	 *  @return The basis size if the basis has been generated using the
@@ -377,6 +395,12 @@ private:
 	/** Basis size of Hamiltonian. */
 	int basisSize;
 
+	/** Lookup table from physical @link Index Indices @endlink to basis
+	 *  indices. Generated by generateBasisIndices() and used by
+	 *  getBasisIndex() to avoid descending the tree. Only used for the
+	 *  root node. */
+	std::shared_ptr<const IndexLookupTable> indexLookupTable;
+
 	/** Flag indicating whether all HoppingAmplitudes passed to this nodes
 	 *  child nodes have the same 'to' and 'from' subindex in the position
 	 *  corresponding this node level. Is set to true when the node is
@@ -470,6 +494,18 @@ private:
 	 *  recursively. */
 	int generateBasisIndices(int i);
 
+	/** Generate the IndexLookupTable from the basis indices. */
+	void generateIndexLookupTable();
+
+	/** Add the basis indices below the current node to the
+	 *  IndexLookupTable. Is called by
+	 *  HoppingAmplitudeTree::generateIndexLookupTable() and is called
+	 *  recursively. */
+	void addToIndexLookupTable(
+		IndexLookupTable &indexLookupTable,
+		Index &index
+	) const;
+
 	/** Generate a list containing the indices in the HoppingAmplitudeTree
 	 *  that satisfies the specified pattern. Is called by
 	 *  HoppingAmplitudeTree::getIndexList. */
@@ -547,6 +583,8 @@ inline HoppingAmplitudeTree::ConstIterator HoppingAmplitudeTree::cend() const{
 
 inline unsigned int HoppingAmplitudeTree::getSizeInBytes() const{
 	unsigned int size = 0;
+	if(indexLookupTable)
+		size += indexLookupTable->getSizeInBytes();
 	for(unsigned int n = 0; n < hoppingAmplitudes.size(); n++)
 		size += hoppingAmplitudes[n].getSizeInBytes();
 	for(unsigned int n = 0; n < children.size(); n++)
@@ -25,6 +25,7 @@
 
 #include "TBTK/Subindex.h"
 #include "TBTK/Serializable.h"
+#include "TBTK/SmallVector.h"
 #include "TBTK/Streams.h"
 
 #include <vector>
@@ -329,14 +330,16 @@ public:
 	 *  @return Memory size required to store the Index. */
 	unsigned int getSizeInBytes() const;
 private:
-	/** Subindex container. */
-	std::vector<Subindex> indices;
+	/** Subindex container. Up to eight Subindices are stored inline, which
+	 *  means that most Indices can be created and copied without any
+	 *  memory allocations. */
+	SmallVector<Subindex, 8> indices;
 };
 
 inline std::string Index::toString() const{
 	std::string str = "{";
 	bool isFirstIndex = true;
-	for(unsigned int n = 0; n < indices.size(); n++){
+	for(unsigned int n = 0; n < indices.getSize(); n++){
 		Subindex subindex = indices.at(n);
 		if(!isFirstIndex && !subindex.isIndexSeparator())
 			str += ", ";
@@ -396,8 +399,8 @@ inline std::ostream& operator<<(std::ostream &stream, const Index &index){
 }
 
 inline bool Index::equals(const Index &index, bool allowWildcard) const{
-	if(indices.size() == index.indices.size()){
-		for(unsigned int n = 0; n < indices.size(); n++){
+	if(indices.getSize() == index.indices.getSize()){
+		for(unsigned int n = 0; n < indices.getSize(); n++){
 			if(indices.at(n) != index.indices.at(n)){
 				if(!allowWildcard)
 					return false;
@@ -413,7 +416,7 @@ inline bool Index::equals(const Index &index, bool allowWildcard) const{
 					){
 						for(
 							unsigned int c = 0;
-							c < indices.size();
+							c < indices.getSize();
 							c++
 						){
 							if(
@@ -431,7 +434,7 @@ inline bool Index::equals(const Index &index, bool allowWildcard) const{
 					){
 						for(
 							unsigned int c = 0;
-							c < indices.size();
+							c < indices.getSize();
 							c++
 						){
 							if(
@@ -467,7 +470,7 @@ inline const Subindex& Index::at(unsigned int n) const{
 }
 
 inline unsigned int Index::getSize() const{
-	return indices.size();
+	return indices.getSize();
 }
 
 inline void Index::reserve(unsigned int size){
@@ -475,30 +478,30 @@ inline void Index::reserve(unsigned int size){
 }
 
 inline void Index::pushBack(Subindex subindex){
-	indices.push_back(subindex);
+	indices.pushBack(subindex);
 }
 
 inline Subindex Index::popFront(){
 	Subindex first = indices.at(0);
-	indices.erase(indices.begin());
+	indices.erase(0);
 
 	return first;
 }
 
 inline Subindex Index::popBack(){
 	Subindex last = indices.back();
-	indices.pop_back();
+	indices.popBack();
 
 	return last;
 }
 
 inline void Index::insert(unsigned int n, Subindex subindex){
-	indices.insert(indices.begin() + n, subindex);
+	indices.insert(n, subindex);
 }
 
 inline Subindex Index::erase(unsigned int n){
 	Subindex subindex = indices[n];
-	indices.erase(indices.begin() + n);
+	indices.erase(n);
 
 	return subindex;
 }
@@ -506,7 +509,7 @@ inline Subindex Index::erase(unsigned int n){
 inline std::vector<Index> Index::split() const{
 	std::vector<Index> components;
 	components.push_back(Index());
-	for(unsigned int n = 0; n < indices.size(); n++){
+	for(unsigned int n = 0; n < indices.getSize(); n++){
 		if(indices[n].isIndexSeparator())
 			components.push_back(Index());
 		else
@@ -517,7 +520,7 @@ inline std::vector<Index> Index::split() const{
 }
 
 inline bool Index::isPatternIndex() const{
-	for(unsigned int n = 0; n < indices.size(); n++)
+	for(unsigned int n = 0; n < indices.getSize(); n++)
 		if(indices.at(n) < 0)
 			return true;
 
@@ -533,7 +536,7 @@ inline const Subindex& Index::operator[](unsigned int subindex) const{
 }
 
 inline unsigned int Index::getSizeInBytes() const{
-	return sizeof(*this) + sizeof(int)*indices.capacity();
+	return sizeof(*this) - sizeof(indices) + indices.getSizeInBytes();
 }
 
 };	//End of namespace TBTK
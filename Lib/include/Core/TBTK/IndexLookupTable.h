@@ -0,0 +1,199 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file IndexLookupTable.h
+ *  @brief Hash table for constant time lookup of values associated with
+ *  @link Index Indices@endlink.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_INDEX_LOOKUP_TABLE
+#define COM_DAFER45_TBTK_INDEX_LOOKUP_TABLE
+
+#include "TBTK/Index.h"
+
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Hash table for constant time lookup of values associated with
+ *  @link Index Indices@endlink.
+ *
+ *  The IndexLookupTable maps @link Index Indices@endlink to non-negative
+ *  integers using open addressing with linear probing. The subindices of
+ *  the added @link Index Indices@endlink are stored contiguously, which
+ *  makes a lookup a hash computation followed by one or a few comparisons
+ *  against contiguous memory, independently of the number of subindices
+ *  and the number of stored @link Index Indices@endlink.
+ *
+ *  The IndexLookupTable is used by the IndexTree and the
+ *  HoppingAmplitudeTree to speed up IndexTree::getLinearIndex() and
+ *  HoppingAmplitudeTree::getBasisIndex(). The @link Index Indices@endlink
+ *  are compared subindex by subindex, which means that a wildcard Index
+ *  only is found when the exact same wildcard Index has been added. */
+class IndexLookupTable{
+public:
+	/** Constructs an empty IndexLookupTable. */
+	IndexLookupTable();
+
+	/** Add an Index. Adding an Index that already has been added
+	 *  replaces the value.
+	 *
+	 *  @param index The Index to add.
+	 *  @param value The value to associate with the Index. Must be
+	 *  non-negative. */
+	void add(const Index &index, int value);
+
+	/** Get the value associated with an Index.
+	 *
+	 *  @param index The Index to get the value for.
+	 *
+	 *  @return The value associated with the Index, or -1 if the Index has
+	 *  not been added. */
+	int get(const Index &index) const;
+
+	/** Get the number of @link Index Indices@endlink in the
+	 *  IndexLookupTable.
+	 *
+	 *  @return The number of @link Index Indices@endlink. */
+	unsigned int getSize() const;
+
+	/** Get size in bytes.
+	 *
+	 *  @return Memory size required to store the IndexLookupTable. */
+	unsigned int getSizeInBytes() const;
+private:
+	/** Hash table slots. Each slot contains the entry number for the
+	 *  stored Index or -1 if the slot is empty. The number of slots is a
+	 *  power of two and kept at least twice as large as the number of
+	 *  entries. */
+	std::vector<int> slots;
+
+	/** Offsets into the subindex array. The subindices for entry n are
+	 *  stored at [offsets[n], offsets[n+1]). */
+	std::vector<unsigned int> offsets;
+
+	/** Subindices for all entries. */
+	std::vector<int> subindices;
+
+	/** Values for all entries. */
+	std::vector<int> values;
+
+	/** Calculate the hash for an Index. */
+	static unsigned long long hash(const Index &index);
+
+	/** Calculate the hash for the subindices stored for an entry. */
+	unsigned long long hash(unsigned int entry) const;
+
+	/** Combine a partial hash with a subindex. */
+	static unsigned long long combine(unsigned long long h, int subindex);
+
+	/** Finalize a hash after all subindices have been combined. */
+	static unsigned long long finalize(unsigned long long h);
+
+	/** Get the slot that contains the given Index, or the empty slot
+	 *  where it should be inserted. */
+	unsigned int findSlot(const Index &index) const;
+
+	/** Check whether a given entry is equal to the given Index. */
+	bool entryEquals(unsigned int entry, const Index &index) const;
+
+	/** Double the number of slots and reinsert the entries. */
+	void grow();
+};
+
+inline int IndexLookupTable::get(const Index &index) const{
+	if(values.size() == 0)
+		return -1;
+
+	int entry = slots[findSlot(index)];
+	if(entry == -1)
+		return -1;
+	else
+		return values[entry];
+}
+
+inline unsigned int IndexLookupTable::getSize() const{
+	return values.size();
+}
+
+inline unsigned int IndexLookupTable::getSizeInBytes() const{
+	return sizeof(*this)
+		+ slots.capacity()*sizeof(int)
+		+ offsets.capacity()*sizeof(unsigned int)
+		+ subindices.capacity()*sizeof(int)
+		+ values.capacity()*sizeof(int);
+}
+
+inline unsigned long long IndexLookupTable::hash(const Index &index){
+	unsigned long long h = 0xcbf29ce484222325ull;
+	for(unsigned int n = 0; n < index.getSize(); n++)
+		h = combine(h, index[n]);
+
+	return finalize(h);
+}
+
+inline unsigned long long IndexLookupTable::hash(unsigned int entry) const{
+	unsigned long long h = 0xcbf29ce484222325ull;
+	for(unsigned int n = offsets[entry]; n < offsets[entry + 1]; n++)
+		h = combine(h, subindices[n]);
+
+	return finalize(h);
+}
+
+inline unsigned long long IndexLookupTable::combine(
+	unsigned long long h,
+	int subindex
+){
+	return (h ^ (unsigned int)subindex)*0x100000001b3ull;
+}
+
+inline unsigned long long IndexLookupTable::finalize(unsigned long long h){
+	h ^= h >> 29;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 32;
+
+	return h;
+}
+
+inline unsigned int IndexLookupTable::findSlot(const Index &index) const{
+	const unsigned int mask = slots.size() - 1;
+	unsigned int slot = hash(index) & mask;
+	while(slots[slot] != -1 && !entryEquals(slots[slot], index))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+inline bool IndexLookupTable::entryEquals(
+	unsigned int entry,
+	const Index &index
+) const{
+	const unsigned int begin = offsets[entry];
+	const unsigned int size = offsets[entry + 1] - begin;
+	if(size != index.getSize())
+		return false;
+	for(unsigned int n = 0; n < size; n++)
+		if(subindices[begin + n] != index[n])
+			return false;
+
+	return true;
+}
+
+};	//End of namespace TBTK
+
+#endif
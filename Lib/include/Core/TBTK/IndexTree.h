@@ -24,9 +24,11 @@
 #define COM_DAFER45_TBTK_INDEX_TREE
 
 #include "TBTK/Index.h"
+#include "TBTK/IndexLookupTable.h"
 #include "TBTK/Serializable.h"
 #include "TBTK/Streamable.h"
 
+#include <memory>
 #include <vector>
 
 namespace TBTK{
@@ -357,6 +359,12 @@ private:
 	/** Size. Only used for top node. */
 	int size;
 
+	/** Lookup table from @link Index Indices @endlink to linear indices.
+	 *  Generated by generateLinearMap() and used by getLinearIndex() to
+	 *  avoid descending the tree for @link Index Indices @endlink that
+	 *  are stored exactly as requested. Only used for top node. */
+	std::shared_ptr<const IndexLookupTable> indexLookupTable;
+
 	/** Add index. Is called by the public function IndexTree:add and is
 	 *  called recursively.*/
 	void add(const Index& index, unsigned int subindex);
@@ -365,6 +373,17 @@ private:
 	 *  called recursively. */
 	int generateLinearMap(int i);
 
+	/** Generate the IndexLookupTable from the linear map. */
+	void generateIndexLookupTable();
+
+	/** Add the @link Index Indices @endlink below the current node to the
+	 *  IndexLookupTable. Is called by
+	 *  IndexTree::generateIndexLookupTable() and is called recursively. */
+	void addToIndexLookupTable(
+		IndexLookupTable &indexLookupTable,
+		Index &index
+	) const;
+
 	/** Get linear index. Is called by the public IndexTree::getLinearIndex
 	 *  and is called recursively. */
 	int getLinearIndex(
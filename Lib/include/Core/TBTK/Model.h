@@ -114,6 +114,30 @@ public:
 	 @param ha HoppingAmplitude to add. */
 	void add(HoppingAmplitude ha);
 
+	/** Add a HoppingAmplitude from one of several threads in an OpenMP
+	 *  parallel region. The HoppingAmplitude is appended to a staging
+	 *  buffer for the calling thread and is inserted into the Model in
+	 *  parallel with the other staged @link HoppingAmplitude
+	 *  HoppingAmplitudes @endlink when construct() is called. Calls from
+	 *  other threads are safe but serialized through a lock. See
+	 *  HoppingAmplitudeSet::addConcurrently(). If a
+	 *  HoppingAmplitudeFilter is set, it must be safe to call from
+	 *  several threads at once.
+	 *
+	 *  @param hoppingAmplitude HoppingAmplitude to add. */
+	void addConcurrently(const HoppingAmplitude &hoppingAmplitude);
+
+	/** Add a HoppingAmplitude and its Hermitian conjugate from one of
+	 *  several threads in an OpenMP parallel region. See
+	 *  addConcurrently(const HoppingAmplitude&).
+	 *
+	 *  @param hoppingAmplitudes The HoppingAmplitude and its Hermitian
+	 *  conjugate, as obtained from HoppingAmplitude + HC. */
+	void addConcurrently(
+		const std::tuple<HoppingAmplitude, HoppingAmplitude>
+			&hoppingAmplitudes
+	);
+
 	/** Add a Model as a subsystem.
 	 *
 	 *  @param model Model to include as subsystem.
@@ -203,6 +227,11 @@ public:
 	 *  @return Reference to the contained HoppingAmplitudeSet. */
 	const HoppingAmplitudeSet& getHoppingAmplitudeSet() const;
 
+	/** Reevaluate the callback dependent amplitudes in the
+	 *  CompiledHoppingAmplitudes of the HoppingAmplitudeSet. See
+	 *  HoppingAmplitudeSet::updateCompiledCallbackAmplitudes(). */
+	void updateCompiledCallbackAmplitudes();
+
 	/** Get SourceAmplitudeSet.
 	 *
 	 *  @return Reference to the contained SourceAmplitudeSet. */
@@ -313,6 +342,24 @@ inline void Model::add(HoppingAmplitude ha){
 	singleParticleContext.getHoppingAmplitudeSet().add(ha);
 }
 
+inline void Model::addConcurrently(const HoppingAmplitude &hoppingAmplitude){
+	if(
+		hoppingAmplitudeFilter == nullptr
+		|| hoppingAmplitudeFilter->isIncluded(hoppingAmplitude)
+	){
+		singleParticleContext.getHoppingAmplitudeSet().addConcurrently(
+			hoppingAmplitude
+		);
+	}
+}
+
+inline void Model::addConcurrently(
+	const std::tuple<HoppingAmplitude, HoppingAmplitude> &hoppingAmplitudes
+){
+	addConcurrently(std::get<0>(hoppingAmplitudes));
+	addConcurrently(std::get<1>(hoppingAmplitudes));
+}
+
 inline int Model::getBasisSize() const{
 	return singleParticleContext.getHoppingAmplitudeSet().getBasisSize();
 }
@@ -373,6 +420,11 @@ inline const HoppingAmplitudeSet& Model::getHoppingAmplitudeSet() const{
 	return singleParticleContext.getHoppingAmplitudeSet();
 }
 
+inline void Model::updateCompiledCallbackAmplitudes(){
+	singleParticleContext.getHoppingAmplitudeSet(
+	).updateCompiledCallbackAmplitudes();
+}
+
 inline const SourceAmplitudeSet& Model::getSourceAmplitudeSet() const{
 	return singleParticleContext.getSourceAmplitudeSet();
 }
@@ -24,5 +24,8 @@
 #define COM_DAFER45_TBTK_MATH_ALL
 
 #include "TBTK/Math/ArrayAlgorithms.h"
+#include "TBTK/Math/BatchedMatrixInverter.h"
+#include "TBTK/Math/Mixer.h"
+#include "TBTK/Math/ParallelSparseMatrix.h"
 
 #endif
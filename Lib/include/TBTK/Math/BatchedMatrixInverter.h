@@ -0,0 +1,378 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file BatchedMatrixInverter.h
+ *  @brief Inverts batches of small dense complex matrices.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_MATH_BATCHED_MATRIX_INVERTER
+#define COM_DAFER45_TBTK_MATH_BATCHED_MATRIX_INVERTER
+
+#include "TBTK/TBTKMacros.h"
+
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace TBTK{
+namespace Math{
+
+/** @brief Inverts batches of small dense complex matrices.
+ *
+ *  Inverting many small matrices one at a time using LAPACK is dominated
+ *  by call overhead and memory allocation. The BatchedMatrixInverter
+ *  instead inverts a whole batch of equally sized matrices using
+ *  Gauss-Jordan elimination with partial pivoting, where the innermost
+ *  loops run over the matrices in the batch. The data is therefore stored
+ *  structure-of-arrays, with the same matrix element for every matrix in
+ *  the batch stored contiguously. That is, element \f$(r, c)\f$ of matrix
+ *  \f$b\f$ is stored at position \f$(r + Nc)B + b\f$, where \f$N\f$ is the
+ *  matrix dimension and \f$B\f$ is the batch size.
+ *
+ *  The batch is processed in chunks of getChunkSize() matrices, which are
+ *  copied to a workspace with the real and imaginary parts stored
+ *  separately to allow the compiler to vectorize the arithmetic. Chunks
+ *  are processed in parallel. Specialized kernels with the matrix
+ *  dimension known at compile time are used for the dimensions 4, 8, 9,
+ *  16, 25, 36, and 50, which covers the matrices of dimension
+ *  \f$N_{orbitals}^2\f$ that appear in the RPA susceptibility for up to
+ *  six orbitals. Other dimensions are handled by a generic kernel.
+ *
+ *  If a matrix is singular, the result for that matrix contains
+ *  non-finite values. Other matrices in the batch are unaffected. */
+class BatchedMatrixInverter{
+public:
+	/** Invert a batch of matrices in place.
+	 *
+	 *  @param data The matrices stored as described in the class
+	 *  description. Is overwritten with the inverses.
+	 *
+	 *  @param dimension The matrix dimension \f$N\f$.
+	 *  @param batchSize The number of matrices \f$B\f$ in the batch. */
+	static void invert(
+		std::complex<double> *data,
+		unsigned int dimension,
+		unsigned int batchSize
+	);
+
+	/** Invert a batch of matrices in place.
+	 *
+	 *  @param data The matrices stored as described in the class
+	 *  description. Is overwritten with the inverses.
+	 *
+	 *  @param dimension The matrix dimension \f$N\f$.
+	 *  @param batchSize The number of matrices \f$B\f$ in the batch. */
+	static void invert(
+		std::vector<std::complex<double>> &data,
+		unsigned int dimension,
+		unsigned int batchSize
+	);
+
+	/** Get the number of matrices that are inverted together.
+	 *
+	 *  @return The chunk size. */
+	static constexpr unsigned int getChunkSize();
+private:
+	/** The number of matrices that are inverted together. */
+	static constexpr unsigned int CHUNK_SIZE = 8;
+
+	/** Invert the matrices in a batch using a kernel with the matrix
+	 *  dimension fixed at compile time.
+	 *
+	 *  @tparam DIMENSION The matrix dimension, or zero if the dimension
+	 *  is only known at runtime.
+	 *
+	 *  @param data The matrices.
+	 *  @param dimension The matrix dimension. Only used if DIMENSION is
+	 *  zero.
+	 *
+	 *  @param batchSize The number of matrices in the batch. */
+	template<unsigned int DIMENSION>
+	static void invertBatch(
+		std::complex<double> *data,
+		unsigned int dimension,
+		unsigned int batchSize
+	);
+
+	/** Invert a chunk of at most CHUNK_SIZE matrices.
+	 *
+	 *  @tparam DIMENSION The matrix dimension, or zero if the dimension
+	 *  is only known at runtime.
+	 *
+	 *  @param real The real part of the matrix elements. Element e of
+	 *  matrix b is stored at e*CHUNK_SIZE + b.
+	 *
+	 *  @param imaginary The imaginary part of the matrix elements.
+	 *  @param pivots Workspace for the pivots with space for
+	 *  dimension*CHUNK_SIZE entries.
+	 *
+	 *  @param dimension The matrix dimension. Only used if DIMENSION is
+	 *  zero. */
+	template<unsigned int DIMENSION>
+	static void invertChunk(
+		double *real,
+		double *imaginary,
+		unsigned int *pivots,
+		unsigned int dimension
+	);
+};
+
+inline void BatchedMatrixInverter::invert(
+	std::complex<double> *data,
+	unsigned int dimension,
+	unsigned int batchSize
+){
+	switch(dimension){
+	case 0:
+		break;
+	case 4:
+		invertBatch<4>(data, dimension, batchSize);
+		break;
+	case 8:
+		invertBatch<8>(data, dimension, batchSize);
+		break;
+	case 9:
+		invertBatch<9>(data, dimension, batchSize);
+		break;
+	case 16:
+		invertBatch<16>(data, dimension, batchSize);
+		break;
+	case 25:
+		invertBatch<25>(data, dimension, batchSize);
+		break;
+	case 36:
+		invertBatch<36>(data, dimension, batchSize);
+		break;
+	case 50:
+		invertBatch<50>(data, dimension, batchSize);
+		break;
+	default:
+		invertBatch<0>(data, dimension, batchSize);
+		break;
+	}
+}
+
+inline void BatchedMatrixInverter::invert(
+	std::vector<std::complex<double>> &data,
+	unsigned int dimension,
+	unsigned int batchSize
+){
+	TBTKAssert(
+		data.size() == (size_t)dimension*dimension*batchSize,
+		"Math::BatchedMatrixInverter::invert()",
+		"Incompatible sizes. The data has size '" << data.size()
+		<< "', but a batch of '" << batchSize << "' matrices with"
+		<< " dimension '" << dimension << "' requires size '"
+		<< (size_t)dimension*dimension*batchSize << "'.",
+		""
+	);
+
+	invert(data.data(), dimension, batchSize);
+}
+
+inline constexpr unsigned int BatchedMatrixInverter::getChunkSize(){
+	return CHUNK_SIZE;
+}
+
+template<unsigned int DIMENSION>
+void BatchedMatrixInverter::invertBatch(
+	std::complex<double> *data,
+	unsigned int dimension,
+	unsigned int batchSize
+){
+	const unsigned int N = (DIMENSION == 0 ? dimension : DIMENSION);
+	const unsigned int NUM_ELEMENTS = N*N;
+	const int NUM_CHUNKS = (batchSize + CHUNK_SIZE - 1)/CHUNK_SIZE;
+
+	#pragma omp parallel
+	{
+		std::vector<double> real(NUM_ELEMENTS*CHUNK_SIZE);
+		std::vector<double> imaginary(NUM_ELEMENTS*CHUNK_SIZE);
+		std::vector<unsigned int> pivots(N*CHUNK_SIZE);
+
+		#pragma omp for
+		for(int chunk = 0; chunk < NUM_CHUNKS; chunk++){
+			const unsigned int FIRST = chunk*CHUNK_SIZE;
+			const unsigned int SIZE
+				= batchSize - FIRST < CHUNK_SIZE
+					? batchSize - FIRST
+					: CHUNK_SIZE;
+
+			//Copy the chunk to the workspace. Unused slots in the
+			//last chunk are filled with unit matrices.
+			for(unsigned int e = 0; e < NUM_ELEMENTS; e++){
+				const std::complex<double> *source
+					= data + (size_t)e*batchSize + FIRST;
+				for(unsigned int b = 0; b < SIZE; b++){
+					real[e*CHUNK_SIZE + b] = source[b].real();
+					imaginary[e*CHUNK_SIZE + b]
+						= source[b].imag();
+				}
+				for(unsigned int b = SIZE; b < CHUNK_SIZE; b++){
+					real[e*CHUNK_SIZE + b]
+						= (e%(N + 1) == 0 ? 1 : 0);
+					imaginary[e*CHUNK_SIZE + b] = 0;
+				}
+			}
+
+			invertChunk<DIMENSION>(
+				real.data(),
+				imaginary.data(),
+				pivots.data(),
+				N
+			);
+
+			//Copy the result back.
+			for(unsigned int e = 0; e < NUM_ELEMENTS; e++){
+				std::complex<double> *destination
+					= data + (size_t)e*batchSize + FIRST;
+				for(unsigned int b = 0; b < SIZE; b++){
+					destination[b] = std::complex<double>(
+						real[e*CHUNK_SIZE + b],
+						imaginary[e*CHUNK_SIZE + b]
+					);
+				}
+			}
+		}
+	}
+}
+
+template<unsigned int DIMENSION>
+void BatchedMatrixInverter::invertChunk(
+	double *real,
+	double *imaginary,
+	unsigned int *pivots,
+	unsigned int dimension
+){
+	const unsigned int N = (DIMENSION == 0 ? dimension : DIMENSION);
+	const unsigned int B = CHUNK_SIZE;
+
+	for(unsigned int k = 0; k < N; k++){
+		//Find the pivot row for every matrix and swap it with row k.
+		//The pivoting differs between the matrices, but only costs
+		//O(N) per matrix and column.
+		for(unsigned int b = 0; b < B; b++){
+			unsigned int pivot = k;
+			double maximum = std::abs(real[(k + N*k)*B + b])
+				+ std::abs(imaginary[(k + N*k)*B + b]);
+			for(unsigned int r = k + 1; r < N; r++){
+				double value = std::abs(real[(r + N*k)*B + b])
+					+ std::abs(imaginary[(r + N*k)*B + b]);
+				if(value > maximum){
+					maximum = value;
+					pivot = r;
+				}
+			}
+			pivots[k*B + b] = pivot;
+			if(pivot != k){
+				for(unsigned int c = 0; c < N; c++){
+					std::swap(
+						real[(k + N*c)*B + b],
+						real[(pivot + N*c)*B + b]
+					);
+					std::swap(
+						imaginary[(k + N*c)*B + b],
+						imaginary[(pivot + N*c)*B + b]
+					);
+				}
+			}
+		}
+
+		//Calculate the inverse of the pivot element.
+		double inverseReal[B];
+		double inverseImaginary[B];
+		for(unsigned int b = 0; b < B; b++){
+			double re = real[(k + N*k)*B + b];
+			double im = imaginary[(k + N*k)*B + b];
+			double normSquared = re*re + im*im;
+			inverseReal[b] = re/normSquared;
+			inverseImaginary[b] = -im/normSquared;
+			real[(k + N*k)*B + b] = 1;
+			imaginary[(k + N*k)*B + b] = 0;
+		}
+
+		//Scale row k.
+		for(unsigned int c = 0; c < N; c++){
+			double *re = &real[(k + N*c)*B];
+			double *im = &imaginary[(k + N*c)*B];
+			#pragma omp simd
+			for(unsigned int b = 0; b < B; b++){
+				double temp = re[b]*inverseReal[b]
+					- im[b]*inverseImaginary[b];
+				im[b] = re[b]*inverseImaginary[b]
+					+ im[b]*inverseReal[b];
+				re[b] = temp;
+			}
+		}
+
+		//Eliminate column k from the other rows.
+		for(unsigned int r = 0; r < N; r++){
+			if(r == k)
+				continue;
+
+			double factorReal[B];
+			double factorImaginary[B];
+			for(unsigned int b = 0; b < B; b++){
+				factorReal[b] = real[(r + N*k)*B + b];
+				factorImaginary[b] = imaginary[(r + N*k)*B + b];
+				real[(r + N*k)*B + b] = 0;
+				imaginary[(r + N*k)*B + b] = 0;
+			}
+			for(unsigned int c = 0; c < N; c++){
+				double *re = &real[(r + N*c)*B];
+				double *im = &imaginary[(r + N*c)*B];
+				const double *pivotRe = &real[(k + N*c)*B];
+				const double *pivotIm = &imaginary[(k + N*c)*B];
+				#pragma omp simd
+				for(unsigned int b = 0; b < B; b++){
+					re[b] -= factorReal[b]*pivotRe[b]
+						- factorImaginary[b]*pivotIm[b];
+					im[b] -= factorReal[b]*pivotIm[b]
+						+ factorImaginary[b]*pivotRe[b];
+				}
+			}
+		}
+	}
+
+	//Undo the row permutations by permuting the columns in reverse
+	//order.
+	for(unsigned int k = N; k-- > 0;){
+		for(unsigned int b = 0; b < B; b++){
+			unsigned int pivot = pivots[k*B + b];
+			if(pivot == k)
+				continue;
+
+			for(unsigned int r = 0; r < N; r++){
+				std::swap(
+					real[(r + N*k)*B + b],
+					real[(r + N*pivot)*B + b]
+				);
+				std::swap(
+					imaginary[(r + N*k)*B + b],
+					imaginary[(r + N*pivot)*B + b]
+				);
+			}
+		}
+	}
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
+
+#endif
@@ -0,0 +1,438 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file Mixer.h
+ *  @brief Mixer for accelerating self-consistent fixed-point iterations.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_MATH_MIXER
+#define COM_DAFER45_TBTK_MATH_MIXER
+
+#include "TBTK/TBTKMacros.h"
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+namespace TBTK{
+namespace Math{
+
+/** @brief Mixer for accelerating self-consistent fixed-point iterations.
+ *
+ *  The Mixer takes the input \f$x_k\f$ and output \f$g(x_k)\f$ of one
+ *  iteration of a fixed-point problem \f$x = g(x)\f$ and generates the input
+ *  \f$x_{k+1}\f$ for the next iteration. The data is treated as a flat
+ *  vector, which means that any quantity that is stored contiguously (such
+ *  as the data of a Property) can be mixed.
+ *
+ *  <b>Linear:</b><br />
+ *  \f$x_{k+1} = x_k + \beta f_k\f$, where \f$f_k = g(x_k) - x_k\f$ is the
+ *  residual and \f$\beta\f$ is the mixing parameter.
+ *
+ *  <b>Anderson:</b><br />
+ *  Anderson mixing, also known as Pulay mixing or DIIS. The differences
+ *  \f$\Delta X\f$ and \f$\Delta F\f$ between consecutive inputs and
+ *  residuals from the last getHistorySize() iterations are stored, and the
+ *  next input is given by
+ *  <br/>
+ *  <center>\f$x_{k+1} = x_k + \beta f_k - (\Delta X + \beta\Delta F)\gamma\f$,
+ *  </center>
+ *  <br/>
+ *  where \f$\gamma\f$ minimizes \f$|f_k - \Delta F\gamma|\f$.
+ *
+ *  <b>Broyden:</b><br />
+ *  Broyden's first method on multisecant form. The update has the same
+ *  form as for Anderson mixing, but \f$\gamma\f$ is instead determined by
+ *  \f$\Delta X^{\dagger}\Delta F\gamma = \Delta X^{\dagger}f_k\f$.
+ *
+ *  If the history becomes linearly dependent, it is cleared and a linear
+ *  step is taken. The memory required by the Anderson and Broyden methods
+ *  is 2*(getHistorySize() + 1) times the size of the mixed data. */
+template<typename DataType>
+class Mixer{
+public:
+	/** Enum class for specifying the mixing method. */
+	enum class Method{Linear, Anderson, Broyden};
+
+	/** Constructor.
+	 *
+	 *  @param method The mixing method.
+	 *  @param mixingParameter The mixing parameter \f$\beta\f$.
+	 *  @param historySize The number of previous iterations that are
+	 *  used by the Anderson and Broyden methods. */
+	Mixer(
+		Method method = Method::Linear,
+		double mixingParameter = 1,
+		unsigned int historySize = 5
+	);
+
+	/** Set the mixing method. Clears the history.
+	 *
+	 *  @param method The mixing method. */
+	void setMethod(Method method);
+
+	/** Get the mixing method.
+	 *
+	 *  @return The mixing method. */
+	Method getMethod() const;
+
+	/** Set the mixing parameter \f$\beta\f$, which is the fraction of the
+	 *  residual that is added to the input in a linear step.
+	 *
+	 *  @param mixingParameter The mixing parameter. */
+	void setMixingParameter(double mixingParameter);
+
+	/** Get the mixing parameter.
+	 *
+	 *  @return The mixing parameter. */
+	double getMixingParameter() const;
+
+	/** Set the number of previous iterations that are used by the
+	 *  Anderson and Broyden methods. Clears the history.
+	 *
+	 *  @param historySize The history size. */
+	void setHistorySize(unsigned int historySize);
+
+	/** Get the number of previous iterations that are used by the
+	 *  Anderson and Broyden methods.
+	 *
+	 *  @return The history size. */
+	unsigned int getHistorySize() const;
+
+	/** Clear the history and the residual norm history. */
+	void reset();
+
+	/** Generate the input for the next iteration.
+	 *
+	 *  @param input The input \f$x_k\f$ to the last iteration. Is
+	 *  overwritten with the input \f$x_{k+1}\f$ for the next iteration.
+	 *
+	 *  @param output The output \f$g(x_k)\f$ of the last iteration. */
+	void mix(std::vector<DataType> &input, const std::vector<DataType> &output);
+
+	/** Get the norm \f$|f_k|\f$ of the residuals for every call to mix()
+	 *  since the last reset.
+	 *
+	 *  @return The residual norms. */
+	const std::vector<double>& getResidualNormHistory() const;
+private:
+	/** The mixing method. */
+	Method method;
+
+	/** The mixing parameter. */
+	double mixingParameter;
+
+	/** The history size. */
+	unsigned int historySize;
+
+	/** Input from the previous call to mix(). */
+	std::vector<DataType> previousInput;
+
+	/** Residual from the previous call to mix(). */
+	std::vector<DataType> previousResidual;
+
+	/** Differences between consecutive inputs. Used as a circular buffer
+	 *  with the oldest entry at position historyStart. */
+	std::vector<std::vector<DataType>> inputDifferences;
+
+	/** Differences between consecutive residuals. */
+	std::vector<std::vector<DataType>> residualDifferences;
+
+	/** Position of the oldest entry in the circular buffers. */
+	unsigned int historyStart;
+
+	/** Residual norms. */
+	std::vector<double> residualNormHistory;
+
+	/** Clear the stored history. */
+	void clearHistory();
+
+	/** Calculate the inner product \f$\langle a|b\rangle\f$.
+	 *
+	 *  @param a The first vector.
+	 *  @param b The second vector.
+	 *
+	 *  @return The inner product. */
+	static DataType dot(
+		const std::vector<DataType> &a,
+		const std::vector<DataType> &b
+	);
+
+	/** Complex conjugate that preserves the type for real numbers. */
+	static double conjugate(double value);
+
+	/** Complex conjugate. */
+	static std::complex<double> conjugate(const std::complex<double> &value);
+
+	/** Solve the linear system Ax = b in place using Gaussian elimination
+	 *  with partial pivoting.
+	 *
+	 *  @param matrix The matrix A stored column by column. Is
+	 *  overwritten.
+	 *
+	 *  @param vector The vector b. Is overwritten with the solution x.
+	 *
+	 *  @return False if the matrix is numerically singular. */
+	static bool solve(
+		std::vector<DataType> &matrix,
+		std::vector<DataType> &vector
+	);
+};
+
+template<typename DataType>
+Mixer<DataType>::Mixer(
+	Method method,
+	double mixingParameter,
+	unsigned int historySize
+){
+	this->method = method;
+	this->mixingParameter = mixingParameter;
+	this->historySize = historySize;
+	historyStart = 0;
+}
+
+template<typename DataType>
+inline void Mixer<DataType>::setMethod(Method method){
+	this->method = method;
+	clearHistory();
+}
+
+template<typename DataType>
+inline typename Mixer<DataType>::Method Mixer<DataType>::getMethod() const{
+	return method;
+}
+
+template<typename DataType>
+inline void Mixer<DataType>::setMixingParameter(double mixingParameter){
+	this->mixingParameter = mixingParameter;
+}
+
+template<typename DataType>
+inline double Mixer<DataType>::getMixingParameter() const{
+	return mixingParameter;
+}
+
+template<typename DataType>
+inline void Mixer<DataType>::setHistorySize(unsigned int historySize){
+	this->historySize = historySize;
+	clearHistory();
+}
+
+template<typename DataType>
+inline unsigned int Mixer<DataType>::getHistorySize() const{
+	return historySize;
+}
+
+template<typename DataType>
+inline void Mixer<DataType>::reset(){
+	clearHistory();
+	previousInput.clear();
+	previousResidual.clear();
+	residualNormHistory.clear();
+}
+
+template<typename DataType>
+void Mixer<DataType>::mix(
+	std::vector<DataType> &input,
+	const std::vector<DataType> &output
+){
+	TBTKAssert(
+		input.size() == output.size(),
+		"Math::Mixer::mix()",
+		"Incompatible sizes. The input has size '" << input.size()
+		<< "' while the output has size '" << output.size() << "'.",
+		""
+	);
+
+	const unsigned int SIZE = input.size();
+	std::vector<DataType> residual(SIZE);
+	for(unsigned int n = 0; n < SIZE; n++)
+		residual[n] = output[n] - input[n];
+	residualNormHistory.push_back(std::sqrt(std::abs(dot(residual, residual))));
+
+	if(method == Method::Linear || historySize == 0){
+		for(unsigned int n = 0; n < SIZE; n++)
+			input[n] += mixingParameter*residual[n];
+
+		return;
+	}
+
+	//Update the history.
+	if(previousInput.size() == SIZE){
+		unsigned int position;
+		if(inputDifferences.size() < historySize){
+			position = inputDifferences.size();
+			inputDifferences.push_back(std::vector<DataType>(SIZE));
+			residualDifferences.push_back(
+				std::vector<DataType>(SIZE)
+			);
+		}
+		else{
+			position = historyStart;
+			historyStart = (historyStart + 1)%historySize;
+		}
+		for(unsigned int n = 0; n < SIZE; n++){
+			inputDifferences[position][n]
+				= input[n] - previousInput[n];
+			residualDifferences[position][n]
+				= residual[n] - previousResidual[n];
+		}
+	}
+	else{
+		clearHistory();
+	}
+	previousInput = input;
+	previousResidual = residual;
+
+	//Solve for the coefficients gamma.
+	const unsigned int NUM_HISTORY = inputDifferences.size();
+	std::vector<DataType> gamma(NUM_HISTORY);
+	if(NUM_HISTORY != 0){
+		const std::vector<std::vector<DataType>> &projectors
+			= method == Method::Anderson
+				? residualDifferences
+				: inputDifferences;
+
+		std::vector<DataType> matrix(NUM_HISTORY*NUM_HISTORY);
+		for(unsigned int row = 0; row < NUM_HISTORY; row++){
+			for(unsigned int col = 0; col < NUM_HISTORY; col++){
+				matrix[row + NUM_HISTORY*col] = dot(
+					projectors[row],
+					residualDifferences[col]
+				);
+			}
+			gamma[row] = dot(projectors[row], residual);
+		}
+
+		if(!solve(matrix, gamma)){
+			clearHistory();
+			gamma.clear();
+		}
+	}
+
+	//Generate the next input.
+	for(unsigned int n = 0; n < SIZE; n++)
+		input[n] += mixingParameter*residual[n];
+	for(unsigned int c = 0; c < gamma.size(); c++){
+		for(unsigned int n = 0; n < SIZE; n++){
+			input[n] -= (
+				inputDifferences[c][n]
+				+ mixingParameter*residualDifferences[c][n]
+			)*gamma[c];
+		}
+	}
+}
+
+template<typename DataType>
+inline const std::vector<double>& Mixer<DataType>::getResidualNormHistory(
+) const{
+	return residualNormHistory;
+}
+
+template<typename DataType>
+inline void Mixer<DataType>::clearHistory(){
+	inputDifferences.clear();
+	residualDifferences.clear();
+	historyStart = 0;
+}
+
+template<typename DataType>
+inline DataType Mixer<DataType>::dot(
+	const std::vector<DataType> &a,
+	const std::vector<DataType> &b
+){
+	DataType result = 0;
+	for(unsigned int n = 0; n < a.size(); n++)
+		result += conjugate(a[n])*b[n];
+
+	return result;
+}
+
+template<typename DataType>
+inline double Mixer<DataType>::conjugate(double value){
+	return value;
+}
+
+template<typename DataType>
+inline std::complex<double> Mixer<DataType>::conjugate(
+	const std::complex<double> &value
+){
+	return std::conj(value);
+}
+
+template<typename DataType>
+bool Mixer<DataType>::solve(
+	std::vector<DataType> &matrix,
+	std::vector<DataType> &vector
+){
+	const unsigned int SIZE = vector.size();
+
+	double scale = 0;
+	for(unsigned int n = 0; n < matrix.size(); n++)
+		if(std::abs(matrix[n]) > scale)
+			scale = std::abs(matrix[n]);
+	const double THRESHOLD
+		= SIZE*std::numeric_limits<double>::epsilon()*scale;
+
+	for(unsigned int col = 0; col < SIZE; col++){
+		unsigned int pivot = col;
+		for(unsigned int row = col + 1; row < SIZE; row++){
+			if(
+				std::abs(matrix[row + SIZE*col])
+				> std::abs(matrix[pivot + SIZE*col])
+			){
+				pivot = row;
+			}
+		}
+		if(std::abs(matrix[pivot + SIZE*col]) <= THRESHOLD)
+			return false;
+
+		if(pivot != col){
+			for(unsigned int c = col; c < SIZE; c++){
+				DataType temp = matrix[col + SIZE*c];
+				matrix[col + SIZE*c] = matrix[pivot + SIZE*c];
+				matrix[pivot + SIZE*c] = temp;
+			}
+			DataType temp = vector[col];
+			vector[col] = vector[pivot];
+			vector[pivot] = temp;
+		}
+
+		for(unsigned int row = col + 1; row < SIZE; row++){
+			DataType factor
+				= matrix[row + SIZE*col]/matrix[col + SIZE*col];
+			for(unsigned int c = col; c < SIZE; c++)
+				matrix[row + SIZE*c] -= factor*matrix[col + SIZE*c];
+			vector[row] -= factor*vector[col];
+		}
+	}
+
+	for(unsigned int row = SIZE; row-- > 0;){
+		for(unsigned int c = row + 1; c < SIZE; c++)
+			vector[row] -= matrix[row + SIZE*c]*vector[c];
+		vector[row] /= matrix[row + SIZE*row];
+	}
+
+	return true;
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
+
+#endif
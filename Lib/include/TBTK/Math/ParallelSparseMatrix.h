@@ -0,0 +1,914 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file ParallelSparseMatrix.h
+ *  @brief Row partitioned sparse matrix for parallel matrix-vector
+ *  multiplication.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_MATH_PARALLEL_SPARSE_MATRIX
+#define COM_DAFER45_TBTK_MATH_PARALLEL_SPARSE_MATRIX
+
+#include "TBTK/SparseMatrix.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <algorithm>
+#include <complex>
+#include <new>
+#include <vector>
+
+#ifdef _OPENMP
+#	include <omp.h>
+#endif
+
+namespace TBTK{
+namespace Math{
+
+/** @brief Row partitioned sparse matrix for parallel matrix-vector
+ *  multiplication.
+ *
+ *  The ParallelSparseMatrix is a copy of a SparseMatrix on the CSR format
+ *  that is optimized for repeated multiplication with vectors. The
+ *  rows are divided into one partition per thread, with approximately the
+ *  same number of matrix elements in each partition, and a given partition
+ *  is always processed by the same thread. The matrix elements, as well as
+ *  any Vector created through createVector(), are first touched by the
+ *  thread that owns the corresponding rows. On NUMA systems this places the
+ *  memory close to the core that later operates on it.
+ *
+ *  Multiplication is performed on the fused form
+ *  <br/>
+ *  <center>\f$y = \alpha Ax + \beta y\f$,</center>
+ *  <br/>
+ *  which for example allows for a Chebyshev iteration
+ *  \f$|j_n\rangle = 2H|j_{n-1}\rangle - |j_{n-2}\rangle\f$ to be performed
+ *  in a single pass over memory.
+ *
+ *  Several vectors can also be multiplied simultaneously using
+ *  multiplyBlock(). The vectors are then stored as a row-major block, with
+ *  the elements of all vectors for a given row stored consecutively. This
+ *  allows each matrix element to be read once for all vectors, which
+ *  improves the arithmetic intensity compared to separate multiplications.
+ *
+ *  The sparsity pattern is fixed at construction, but the values of stored
+ *  matrix elements can be updated in place using
+ *  getMatrixElementPosition() and setMatrixElement(). This allows a matrix
+ *  with only a few parameter dependent matrix elements to be reused across
+ *  iterations of a self-consistency loop.
+ */
+template<typename DataType>
+class ParallelSparseMatrix{
+public:
+	/** @brief Vector that is distributed in memory according to the row
+	 *  partitioning of a ParallelSparseMatrix.
+	 *
+	 *  Vectors are created using ParallelSparseMatrix::createVector(). */
+	class Vector{
+	public:
+		/** Constructs an empty Vector. */
+		Vector();
+
+		/** Copy constructor (deleted). */
+		Vector(const Vector &vector) = delete;
+
+		/** Move constructor.
+		 *
+		 *  @param vector Vector to move. */
+		Vector(Vector &&vector);
+
+		/** Destructor. */
+		~Vector();
+
+		/** Assignment operator (deleted). */
+		Vector& operator=(const Vector &vector) = delete;
+
+		/** Move assignment operator.
+		 *
+		 *  @param rhs Vector to assign to the left hand side.
+		 *
+		 *  @return The left hand side after assignment. */
+		Vector& operator=(Vector &&rhs);
+
+		/** Array subscript operator.
+		 *
+		 *  @param n Element to access.
+		 *
+		 *  @return The nth element. */
+		DataType& operator[](unsigned int n);
+
+		/** Array subscript operator.
+		 *
+		 *  @param n Element to access.
+		 *
+		 *  @return The nth element. */
+		const DataType& operator[](unsigned int n) const;
+
+		/** Get the raw data.
+		 *
+		 *  @return Pointer to the first element. */
+		DataType* getData();
+
+		/** Get the raw data.
+		 *
+		 *  @return Pointer to the first element. */
+		const DataType* getData() const;
+
+		/** Get the number of elements.
+		 *
+		 *  @return The number of elements in the Vector. */
+		unsigned int getSize() const;
+	private:
+		/** Data. */
+		DataType *data;
+
+		/** Number of elements. */
+		unsigned int size;
+
+		/** Constructs a Vector with uninitialized elements.
+		 *
+		 *  @param size The number of elements. */
+		Vector(unsigned int size);
+
+		/** Releases the memory. */
+		void release();
+
+		friend class ParallelSparseMatrix;
+	};
+
+	/** Constructs an empty ParallelSparseMatrix. */
+	ParallelSparseMatrix();
+
+	/** Constructs a ParallelSparseMatrix from a SparseMatrix on the CSR
+	 *  format.
+	 *
+	 *  @param sparseMatrix The SparseMatrix to copy the matrix elements
+	 *  from.
+	 *
+	 *  @param numPartitions The number of row partitions. If zero, the
+	 *  maximum number of OpenMP threads is used. */
+	ParallelSparseMatrix(
+		const SparseMatrix<DataType> &sparseMatrix,
+		unsigned int numPartitions = 0
+	);
+
+	/** Copy constructor (deleted). */
+	ParallelSparseMatrix(
+		const ParallelSparseMatrix &parallelSparseMatrix
+	) = delete;
+
+	/** Move constructor.
+	 *
+	 *  @param parallelSparseMatrix ParallelSparseMatrix to move. */
+	ParallelSparseMatrix(ParallelSparseMatrix &&parallelSparseMatrix);
+
+	/** Destructor. */
+	~ParallelSparseMatrix();
+
+	/** Assignment operator (deleted). */
+	ParallelSparseMatrix& operator=(
+		const ParallelSparseMatrix &rhs
+	) = delete;
+
+	/** Move assignment operator.
+	 *
+	 *  @param rhs ParallelSparseMatrix to assign to the left hand side.
+	 *
+	 *  @return The left hand side after assignment. */
+	ParallelSparseMatrix& operator=(ParallelSparseMatrix &&rhs);
+
+	/** Get the number of rows.
+	 *
+	 *  @return The number of rows. */
+	unsigned int getNumRows() const;
+
+	/** Get the number of columns.
+	 *
+	 *  @return The number of columns. */
+	unsigned int getNumColumns() const;
+
+	/** Get the number of matrix elements.
+	 *
+	 *  @return The number of stored matrix elements. */
+	unsigned int getNumMatrixElements() const;
+
+	/** Get the number of row partitions.
+	 *
+	 *  @return The number of row partitions. */
+	unsigned int getNumPartitions() const;
+
+	/** Get the position of a matrix element in the internal storage.
+	 *
+	 *  @param row The row of the matrix element.
+	 *  @param column The column of the matrix element.
+	 *
+	 *  @return The position of the matrix element, or -1 if the matrix
+	 *  element is not stored. */
+	int getMatrixElementPosition(unsigned int row, unsigned int column) const;
+
+	/** Set the value of a stored matrix element.
+	 *
+	 *  @param position The position of the matrix element as returned by
+	 *  getMatrixElementPosition().
+	 *  @param value The new value. */
+	void setMatrixElement(unsigned int position, const DataType &value);
+
+	/** Create a zero initialized Vector with one element per row and
+	 *  vector. The elements are first touched using the same row
+	 *  partitioning as used during multiplication.
+	 *
+	 *  @param numVectors The number of vectors to store in the block. The
+	 *  element for row r and vector k is stored at r*numVectors + k.
+	 *
+	 *  @return A new Vector. */
+	Vector createVector(unsigned int numVectors = 1) const;
+
+	/** Calculate \f$y = \alpha Ax + \beta y\f$. The input and output
+	 *  vectors are not allowed to overlap. If beta is zero, the original
+	 *  content of y is never read.
+	 *
+	 *  @param x Input vector with getNumColumns() elements.
+	 *  @param y Output vector with getNumRows() elements.
+	 *  @param alpha Factor multiplying the matrix-vector product.
+	 *  @param beta Factor multiplying the original content of y. */
+	void multiply(
+		const DataType *x,
+		DataType *y,
+		const DataType &alpha = 1,
+		const DataType &beta = 0
+	) const;
+
+	/** Calculate \f$y = \alpha Ax + \beta y\f$. The input and output
+	 *  vectors are not allowed to be the same.
+	 *
+	 *  @param x Input vector.
+	 *  @param y Output vector.
+	 *  @param alpha Factor multiplying the matrix-vector product.
+	 *  @param beta Factor multiplying the original content of y. */
+	void multiply(
+		const Vector &x,
+		Vector &y,
+		const DataType &alpha = 1,
+		const DataType &beta = 0
+	) const;
+
+	/** Calculate \f$Y = \alpha AX + \beta Y\f$, where X and Y are blocks
+	 *  of vectors stored on the row-major format described in
+	 *  createVector(). The input and output blocks are not allowed to
+	 *  overlap. If beta is zero, the original content of Y is never read.
+	 *
+	 *  @param x Input block with getNumColumns()*numVectors elements.
+	 *  @param y Output block with getNumRows()*numVectors elements.
+	 *  @param numVectors The number of vectors in the blocks.
+	 *  @param alpha Factor multiplying the matrix-block product.
+	 *  @param beta Factor multiplying the original content of Y. */
+	void multiplyBlock(
+		const DataType *x,
+		DataType *y,
+		unsigned int numVectors,
+		const DataType &alpha = 1,
+		const DataType &beta = 0
+	) const;
+
+	/** Calculate \f$Y = \alpha AX + \beta Y\f$, where X and Y are blocks
+	 *  of vectors created using createVector(). The input and output
+	 *  blocks are not allowed to be the same.
+	 *
+	 *  @param x Input block.
+	 *  @param y Output block.
+	 *  @param numVectors The number of vectors in the blocks.
+	 *  @param alpha Factor multiplying the matrix-block product.
+	 *  @param beta Factor multiplying the original content of Y. */
+	void multiplyBlock(
+		const Vector &x,
+		Vector &y,
+		unsigned int numVectors,
+		const DataType &alpha = 1,
+		const DataType &beta = 0
+	) const;
+private:
+	/** Number of rows. */
+	unsigned int numRows;
+
+	/** Number of columns. */
+	unsigned int numColumns;
+
+	/** Number of matrix elements. */
+	unsigned int numMatrixElements;
+
+	/** First row of each partition, followed by numRows. */
+	std::vector<unsigned int> partitionPointers;
+
+	/** CSR row pointers. */
+	unsigned int *rowPointers;
+
+	/** CSR columns. */
+	unsigned int *columns;
+
+	/** CSR values. */
+	DataType *values;
+
+	/** Calculate the product between a single row and a vector.
+	 *
+	 *  @param columns The columns of the row's matrix elements.
+	 *  @param values The row's matrix elements.
+	 *  @param numElements The number of matrix elements in the row.
+	 *  @param x The vector to multiply by.
+	 *
+	 *  @return The scalar product between the row and the vector. */
+	static DataType multiplyRow(
+		const unsigned int *columns,
+		const DataType *values,
+		unsigned int numElements,
+		const DataType *x
+	);
+
+	/** Calculate the product between a single row and a block of vectors.
+	 *
+	 *  @param columns The columns of the row's matrix elements.
+	 *  @param values The row's matrix elements.
+	 *  @param numElements The number of matrix elements in the row.
+	 *  @param x The block of vectors to multiply by.
+	 *  @param numVectors The number of vectors in the block.
+	 *  @param result Array with numVectors elements that the scalar
+	 *  products are written to. */
+	static void multiplyRowBlock(
+		const unsigned int *columns,
+		const DataType *values,
+		unsigned int numElements,
+		const DataType *x,
+		unsigned int numVectors,
+		DataType *result
+	);
+
+	/** Release all allocated memory. */
+	void release();
+};
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::Vector::Vector(){
+	data = nullptr;
+	size = 0;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::Vector::Vector(unsigned int size){
+	//Allocate without initializing the elements to leave the first touch
+	//to the thread that owns the corresponding rows.
+	data = static_cast<DataType*>(
+		::operator new(sizeof(DataType)*size)
+	);
+	this->size = size;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::Vector::Vector(Vector &&vector){
+	data = vector.data;
+	size = vector.size;
+	vector.data = nullptr;
+	vector.size = 0;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::Vector::~Vector(){
+	release();
+}
+
+template<typename DataType>
+inline typename ParallelSparseMatrix<DataType>::Vector&
+ParallelSparseMatrix<DataType>::Vector::operator=(Vector &&rhs){
+	if(this != &rhs){
+		release();
+		data = rhs.data;
+		size = rhs.size;
+		rhs.data = nullptr;
+		rhs.size = 0;
+	}
+
+	return *this;
+}
+
+template<typename DataType>
+inline DataType& ParallelSparseMatrix<DataType>::Vector::operator[](
+	unsigned int n
+){
+	return data[n];
+}
+
+template<typename DataType>
+inline const DataType& ParallelSparseMatrix<DataType>::Vector::operator[](
+	unsigned int n
+) const{
+	return data[n];
+}
+
+template<typename DataType>
+inline DataType* ParallelSparseMatrix<DataType>::Vector::getData(){
+	return data;
+}
+
+template<typename DataType>
+inline const DataType* ParallelSparseMatrix<DataType>::Vector::getData(
+) const{
+	return data;
+}
+
+template<typename DataType>
+inline unsigned int ParallelSparseMatrix<DataType>::Vector::getSize() const{
+	return size;
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::Vector::release(){
+	if(data != nullptr)
+		::operator delete(data);
+	data = nullptr;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::ParallelSparseMatrix(){
+	numRows = 0;
+	numColumns = 0;
+	numMatrixElements = 0;
+	partitionPointers.push_back(0);
+	rowPointers = nullptr;
+	columns = nullptr;
+	values = nullptr;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::ParallelSparseMatrix(
+	const SparseMatrix<DataType> &sparseMatrix,
+	unsigned int numPartitions
+){
+	numRows = sparseMatrix.getNumRows();
+	numColumns = sparseMatrix.getNumColumns();
+	numMatrixElements = sparseMatrix.getCSRNumMatrixElements();
+	const unsigned int *sourceRowPointers
+		= sparseMatrix.getCSRRowPointers();
+	const unsigned int *sourceColumns = sparseMatrix.getCSRColumns();
+	const DataType *sourceValues = sparseMatrix.getCSRValues();
+
+	if(numPartitions == 0){
+#ifdef _OPENMP
+		numPartitions = omp_get_max_threads();
+#else
+		numPartitions = 1;
+#endif
+	}
+	if(numPartitions > numRows)
+		numPartitions = (numRows == 0 ? 1 : numRows);
+
+	//Balance the partitions with respect to the number of matrix elements
+	//plus the number of rows, where the latter accounts for the constant
+	//overhead of every row.
+	const double totalCost = numMatrixElements + numRows;
+	partitionPointers.push_back(0);
+	unsigned int row = 0;
+	for(unsigned int p = 1; p < numPartitions; p++){
+		const double targetCost = totalCost*p/numPartitions;
+		while(
+			row < numRows
+			&& sourceRowPointers[row] + row < targetCost
+		){
+			row++;
+		}
+		partitionPointers.push_back(row);
+	}
+	partitionPointers.push_back(numRows);
+
+	rowPointers = new unsigned int[numRows + 1];
+	columns = new unsigned int[numMatrixElements];
+	values = static_cast<DataType*>(
+		::operator new(sizeof(DataType)*numMatrixElements)
+	);
+
+	//Copy the matrix elements using the same partitioning as is used
+	//during multiplication to ensure a NUMA friendly first touch.
+	rowPointers[numRows] = sourceRowPointers[numRows];
+	#pragma omp parallel for schedule(static, 1) num_threads(numPartitions)
+	for(unsigned int p = 0; p < numPartitions; p++){
+		for(
+			unsigned int row = partitionPointers[p];
+			row < partitionPointers[p+1];
+			row++
+		){
+			rowPointers[row] = sourceRowPointers[row];
+			for(
+				unsigned int n = sourceRowPointers[row];
+				n < sourceRowPointers[row+1];
+				n++
+			){
+				columns[n] = sourceColumns[n];
+				new (&values[n]) DataType(sourceValues[n]);
+			}
+		}
+	}
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::ParallelSparseMatrix(
+	ParallelSparseMatrix &&parallelSparseMatrix
+){
+	numRows = parallelSparseMatrix.numRows;
+	numColumns = parallelSparseMatrix.numColumns;
+	numMatrixElements = parallelSparseMatrix.numMatrixElements;
+	partitionPointers = std::move(parallelSparseMatrix.partitionPointers);
+	rowPointers = parallelSparseMatrix.rowPointers;
+	columns = parallelSparseMatrix.columns;
+	values = parallelSparseMatrix.values;
+
+	//Leave the source in the same state as a default constructed matrix.
+	parallelSparseMatrix.numRows = 0;
+	parallelSparseMatrix.numColumns = 0;
+	parallelSparseMatrix.numMatrixElements = 0;
+	parallelSparseMatrix.partitionPointers.clear();
+	parallelSparseMatrix.partitionPointers.push_back(0);
+	parallelSparseMatrix.rowPointers = nullptr;
+	parallelSparseMatrix.columns = nullptr;
+	parallelSparseMatrix.values = nullptr;
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>::~ParallelSparseMatrix(){
+	release();
+}
+
+template<typename DataType>
+inline ParallelSparseMatrix<DataType>&
+ParallelSparseMatrix<DataType>::operator=(ParallelSparseMatrix &&rhs){
+	if(this != &rhs){
+		release();
+
+		numRows = rhs.numRows;
+		numColumns = rhs.numColumns;
+		numMatrixElements = rhs.numMatrixElements;
+		partitionPointers = std::move(rhs.partitionPointers);
+		rowPointers = rhs.rowPointers;
+		columns = rhs.columns;
+		values = rhs.values;
+
+		//Leave rhs in the same state as a default constructed matrix.
+		rhs.numRows = 0;
+		rhs.numColumns = 0;
+		rhs.numMatrixElements = 0;
+		rhs.partitionPointers.clear();
+		rhs.partitionPointers.push_back(0);
+		rhs.rowPointers = nullptr;
+		rhs.columns = nullptr;
+		rhs.values = nullptr;
+	}
+
+	return *this;
+}
+
+template<typename DataType>
+inline unsigned int ParallelSparseMatrix<DataType>::getNumRows() const{
+	return numRows;
+}
+
+template<typename DataType>
+inline unsigned int ParallelSparseMatrix<DataType>::getNumColumns() const{
+	return numColumns;
+}
+
+template<typename DataType>
+inline unsigned int ParallelSparseMatrix<DataType>::getNumMatrixElements(
+) const{
+	return numMatrixElements;
+}
+
+template<typename DataType>
+inline unsigned int ParallelSparseMatrix<DataType>::getNumPartitions() const{
+	return partitionPointers.size() - 1;
+}
+
+template<typename DataType>
+inline int ParallelSparseMatrix<DataType>::getMatrixElementPosition(
+	unsigned int row,
+	unsigned int column
+) const{
+	TBTKAssert(
+		row < numRows && column < numColumns,
+		"Math::ParallelSparseMatrix::getMatrixElementPosition()",
+		"Matrix element (" << row << ", " << column << ") out of"
+		<< " bounds for a matrix with dimensions " << numRows << "x"
+		<< numColumns << ".",
+		""
+	);
+
+	for(unsigned int n = rowPointers[row]; n < rowPointers[row+1]; n++)
+		if(columns[n] == column)
+			return n;
+
+	return -1;
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::setMatrixElement(
+	unsigned int position,
+	const DataType &value
+){
+	TBTKAssert(
+		position < numMatrixElements,
+		"Math::ParallelSparseMatrix::setMatrixElement()",
+		"Position '" << position << "' out of bounds. The number of"
+		<< " matrix elements is '" << numMatrixElements << "'.",
+		""
+	);
+
+	values[position] = value;
+}
+
+template<typename DataType>
+inline typename ParallelSparseMatrix<DataType>::Vector
+ParallelSparseMatrix<DataType>::createVector(unsigned int numVectors) const{
+	Vector vector(numRows*numVectors);
+	DataType *data = vector.getData();
+
+	const unsigned int numPartitions = getNumPartitions();
+	#pragma omp parallel for schedule(static, 1) num_threads(numPartitions)
+	for(unsigned int p = 0; p < numPartitions; p++){
+		for(
+			unsigned int row = partitionPointers[p];
+			row < partitionPointers[p+1];
+			row++
+		){
+			for(unsigned int k = 0; k < numVectors; k++)
+				new (&data[row*numVectors + k]) DataType(0);
+		}
+	}
+
+	return vector;
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::multiply(
+	const DataType *x,
+	DataType *y,
+	const DataType &alpha,
+	const DataType &beta
+) const{
+	const unsigned int numPartitions = getNumPartitions();
+	if(beta == DataType(0)){
+		#pragma omp parallel for schedule(static, 1) num_threads(numPartitions)
+		for(unsigned int p = 0; p < numPartitions; p++){
+			for(
+				unsigned int row = partitionPointers[p];
+				row < partitionPointers[p+1];
+				row++
+			){
+				y[row] = alpha*multiplyRow(
+					&columns[rowPointers[row]],
+					&values[rowPointers[row]],
+					rowPointers[row+1] - rowPointers[row],
+					x
+				);
+			}
+		}
+	}
+	else{
+		#pragma omp parallel for schedule(static, 1) num_threads(numPartitions)
+		for(unsigned int p = 0; p < numPartitions; p++){
+			for(
+				unsigned int row = partitionPointers[p];
+				row < partitionPointers[p+1];
+				row++
+			){
+				y[row] = alpha*multiplyRow(
+					&columns[rowPointers[row]],
+					&values[rowPointers[row]],
+					rowPointers[row+1] - rowPointers[row],
+					x
+				) + beta*y[row];
+			}
+		}
+	}
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::multiply(
+	const Vector &x,
+	Vector &y,
+	const DataType &alpha,
+	const DataType &beta
+) const{
+	TBTKAssert(
+		x.getSize() == numColumns && y.getSize() == numRows,
+		"Math::ParallelSparseMatrix::multiply()",
+		"Incompatible dimensions. The matrix has dimensions "
+		<< numRows << "x" << numColumns << ", but the input and output"
+		<< " vectors have " << x.getSize() << " and " << y.getSize()
+		<< " elements, respectively.",
+		""
+	);
+	TBTKAssert(
+		&x != &y,
+		"Math::ParallelSparseMatrix::multiply()",
+		"The input and output vectors cannot be the same.",
+		""
+	);
+
+	multiply(x.getData(), y.getData(), alpha, beta);
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::multiplyBlock(
+	const DataType *x,
+	DataType *y,
+	unsigned int numVectors,
+	const DataType &alpha,
+	const DataType &beta
+) const{
+	if(numVectors == 1){
+		multiply(x, y, alpha, beta);
+		return;
+	}
+
+	//Workspace for the row results, allocated once for all partitions.
+	//The stride is rounded up to a whole number of cache lines to avoid
+	//false sharing between the threads.
+	const unsigned int numPartitions = getNumPartitions();
+	const unsigned int elementsPerCacheLine
+		= std::max(64/(unsigned int)sizeof(DataType), 1u);
+	const unsigned int stride = (
+		(numVectors + elementsPerCacheLine - 1)/elementsPerCacheLine
+	)*elementsPerCacheLine;
+	std::vector<DataType> results(numPartitions*stride);
+	#pragma omp parallel for schedule(static, 1) num_threads(numPartitions)
+	for(unsigned int p = 0; p < numPartitions; p++){
+		DataType *result = &results[p*stride];
+		for(
+			unsigned int row = partitionPointers[p];
+			row < partitionPointers[p+1];
+			row++
+		){
+			multiplyRowBlock(
+				&columns[rowPointers[row]],
+				&values[rowPointers[row]],
+				rowPointers[row+1] - rowPointers[row],
+				x,
+				numVectors,
+				result
+			);
+
+			DataType *yRow = &y[row*numVectors];
+			if(beta == DataType(0)){
+				for(unsigned int k = 0; k < numVectors; k++)
+					yRow[k] = alpha*result[k];
+			}
+			else{
+				for(unsigned int k = 0; k < numVectors; k++)
+					yRow[k] = alpha*result[k] + beta*yRow[k];
+			}
+		}
+	}
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::multiplyBlock(
+	const Vector &x,
+	Vector &y,
+	unsigned int numVectors,
+	const DataType &alpha,
+	const DataType &beta
+) const{
+	TBTKAssert(
+		x.getSize() == numColumns*numVectors
+		&& y.getSize() == numRows*numVectors,
+		"Math::ParallelSparseMatrix::multiplyBlock()",
+		"Incompatible dimensions. The matrix has dimensions "
+		<< numRows << "x" << numColumns << " and 'numVectors="
+		<< numVectors << "', but the input and output blocks have "
+		<< x.getSize() << " and " << y.getSize() << " elements,"
+		<< " respectively.",
+		""
+	);
+	TBTKAssert(
+		&x != &y,
+		"Math::ParallelSparseMatrix::multiplyBlock()",
+		"The input and output blocks cannot be the same.",
+		""
+	);
+
+	multiplyBlock(x.getData(), y.getData(), numVectors, alpha, beta);
+}
+
+template<typename DataType>
+inline DataType ParallelSparseMatrix<DataType>::multiplyRow(
+	const unsigned int *columns,
+	const DataType *values,
+	unsigned int numElements,
+	const DataType *x
+){
+	DataType result = 0;
+	for(unsigned int n = 0; n < numElements; n++)
+		result += values[n]*x[columns[n]];
+
+	return result;
+}
+
+template<>
+inline std::complex<double>
+ParallelSparseMatrix<std::complex<double>>::multiplyRow(
+	const unsigned int *columns,
+	const std::complex<double> *values,
+	unsigned int numElements,
+	const std::complex<double> *x
+){
+	//Operate on the real and imaginary parts separately. This avoids the
+	//checks for infinities and NaNs in the standard complex multiplication
+	//and allows the compiler to vectorize the loop.
+	const double *v = reinterpret_cast<const double*>(values);
+	const double *X = reinterpret_cast<const double*>(x);
+	double real = 0;
+	double imag = 0;
+	#pragma omp simd reduction(+:real, imag)
+	for(unsigned int n = 0; n < numElements; n++){
+		const unsigned int c = 2*columns[n];
+		real += v[2*n]*X[c] - v[2*n+1]*X[c+1];
+		imag += v[2*n]*X[c+1] + v[2*n+1]*X[c];
+	}
+
+	return std::complex<double>(real, imag);
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::multiplyRowBlock(
+	const unsigned int *columns,
+	const DataType *values,
+	unsigned int numElements,
+	const DataType *x,
+	unsigned int numVectors,
+	DataType *result
+){
+	for(unsigned int k = 0; k < numVectors; k++)
+		result[k] = 0;
+	for(unsigned int n = 0; n < numElements; n++){
+		const DataType &value = values[n];
+		const DataType *xRow = &x[columns[n]*numVectors];
+		for(unsigned int k = 0; k < numVectors; k++)
+			result[k] += value*xRow[k];
+	}
+}
+
+template<>
+inline void ParallelSparseMatrix<std::complex<double>>::multiplyRowBlock(
+	const unsigned int *columns,
+	const std::complex<double> *values,
+	unsigned int numElements,
+	const std::complex<double> *x,
+	unsigned int numVectors,
+	std::complex<double> *result
+){
+	//See multiplyRow(). The loop over the vectors in the block is
+	//contiguous in memory and is the one that is vectorized.
+	double *r = reinterpret_cast<double*>(result);
+	for(unsigned int k = 0; k < 2*numVectors; k++)
+		r[k] = 0;
+	for(unsigned int n = 0; n < numElements; n++){
+		const double valueReal = real(values[n]);
+		const double valueImag = imag(values[n]);
+		const double *X = reinterpret_cast<const double*>(
+			&x[columns[n]*numVectors]
+		);
+		#pragma omp simd
+		for(unsigned int k = 0; k < numVectors; k++){
+			r[2*k] += valueReal*X[2*k] - valueImag*X[2*k+1];
+			r[2*k+1] += valueReal*X[2*k+1] + valueImag*X[2*k];
+		}
+	}
+}
+
+template<typename DataType>
+inline void ParallelSparseMatrix<DataType>::release(){
+	if(rowPointers != nullptr)
+		delete [] rowPointers;
+	if(columns != nullptr)
+		delete [] columns;
+	if(values != nullptr)
+		::operator delete(values);
+
+	rowPointers = nullptr;
+	columns = nullptr;
+	values = nullptr;
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
+
+#endif
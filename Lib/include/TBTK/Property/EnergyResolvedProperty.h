@@ -385,6 +385,8 @@ private:
 
 template<typename DataType>
 EnergyResolvedProperty<DataType>::EnergyResolvedProperty(){
+	//Makes default constructed properties copyable.
+	energyType = EnergyType::Real;
 }
 
 template<typename DataType>
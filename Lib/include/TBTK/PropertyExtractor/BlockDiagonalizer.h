@@ -36,6 +36,7 @@
 
 #include <complex>
 //#include <initializer_list>
+#include <memory>
 
 namespace TBTK{
 namespace PropertyExtractor{
@@ -53,6 +54,152 @@ namespace PropertyExtractor{
  *  \image html output/PropertyExtractor/BlockDiagonalizer/figures/PropertyExtractorBlockDiagonalizerDensity.png */
 class BlockDiagonalizer : public PropertyExtractor{
 public:
+	/** @brief Accumulates @link Property::AbstractProperty
+	 *  Properties@endlink while the Solver::BlockDiagonalizer streams the
+	 *  eigenvectors.
+	 *
+	 *  When Solver::BlockDiagonalizer::setStreamEigenVectors() is set to
+	 *  true, the eigenvectors are only available for one block at a time.
+	 *  The Accumulator is added to the solver using
+	 *  Solver::BlockDiagonalizer::addBlockCallback() and calculates the
+	 *  requested @link Property::AbstractProperty Properties@endlink block
+	 *  by block while the solver runs. The energy window and other
+	 *  settings are taken from the PropertyExtractor that the Accumulator
+	 *  is created from. The DOS only depends on the eigenvalues, which are
+	 *  stored for all blocks, and is calculated using calculateDOS() after
+	 *  the solver has been run. */
+	class Accumulator : public Solver::BlockDiagonalizer::BlockCallback{
+	public:
+		/** Constructor.
+		 *
+		 *  @param propertyExtractor The PropertyExtractor to use for
+		 *  the calculations. */
+		Accumulator(BlockDiagonalizer &propertyExtractor);
+
+		/** Accumulate the Density for the given patterns. [See
+		 *  PropertyExtractor for detailed information about the
+		 *  patterns argument.]
+		 *
+		 *  @param patterns The patterns to calculate the Density
+		 *  for. */
+		void addDensity(std::vector<Index> patterns);
+
+		/** Accumulate the LDOS for the given patterns.
+		 *
+		 *  @param patterns The patterns to calculate the LDOS for. */
+		void addLDOS(std::vector<Index> patterns);
+
+		/** Accumulate the SpinPolarizedLDOS for the given patterns.
+		 *
+		 *  @param patterns The patterns to calculate the
+		 *  SpinPolarizedLDOS for. */
+		void addSpinPolarizedLDOS(std::vector<Index> patterns);
+
+		/** Get the accumulated Density.
+		 *
+		 *  @return The Density. */
+		const Property::Density& getDensity() const;
+
+		/** Get the accumulated LDOS.
+		 *
+		 *  @return The LDOS. */
+		const Property::LDOS& getLDOS() const;
+
+		/** Get the accumulated SpinPolarizedLDOS.
+		 *
+		 *  @return The SpinPolarizedLDOS. */
+		const Property::SpinPolarizedLDOS& getSpinPolarizedLDOS() const;
+
+		/** Implements
+		 *  Solver::BlockDiagonalizer::BlockCallback::beginDiagonalization().
+		 *  Resets the accumulated @link Property::AbstractProperty
+		 *  Properties@endlink. */
+		virtual void beginDiagonalization();
+
+		/** Implements
+		 *  Solver::BlockDiagonalizer::BlockCallback::processBlock(). */
+		virtual void processBlock(
+			const Solver::BlockDiagonalizer &blockDiagonalizer,
+			unsigned int firstState,
+			unsigned int lastState
+		);
+	private:
+		/** An Index for which a Property is calculated. */
+		class Entry{
+		public:
+			/** The basis index used to identify the block. */
+			unsigned int basisIndex;
+
+			/** The Index to pass to the callback. */
+			Index index;
+
+			/** The memory offset of the Index in the Property. */
+			int offset;
+
+			/** The spin subindex, or -1 if there is no spin
+			 *  subindex. */
+			int spinIndex;
+		};
+
+		/** The PropertyExtractor. */
+		BlockDiagonalizer &propertyExtractor;
+
+		/** The accumulated Density. */
+		std::shared_ptr<Property::Density> density;
+
+		/** The Entries for the Density. */
+		std::vector<Entry> densityEntries;
+
+		/** The accumulated LDOS. */
+		std::shared_ptr<Property::LDOS> ldos;
+
+		/** The Entries for the LDOS. */
+		std::vector<Entry> ldosEntries;
+
+		/** The accumulated SpinPolarizedLDOS. */
+		std::shared_ptr<Property::SpinPolarizedLDOS> spinPolarizedLDOS;
+
+		/** The Entries for the SpinPolarizedLDOS. */
+		std::vector<Entry> spinPolarizedLDOSEntries;
+
+		/** Create Entries sorted by basis index for all Indices that
+		 *  match the given patterns.
+		 *
+		 *  @param patterns The patterns.
+		 *  @param memoryLayout The memory layout of the Property.
+		 *  @param property The Property.
+		 *
+		 *  @return The Entries. */
+		template<typename DataType>
+		std::vector<Entry> createEntries(
+			const std::vector<Index> &patterns,
+			const IndexTree &memoryLayout,
+			const Property::AbstractProperty<DataType> &property
+		) const;
+
+		/** Call the given callback for all Entries in the given range
+		 *  of states.
+		 *
+		 *  @param callback The callback to use.
+		 *  @param property The Property to calculate.
+		 *  @param entries The Entries for the Property.
+		 *  @param firstState The first state in the block.
+		 *  @param lastState The last state in the block. */
+		void processEntries(
+			void (*callback)(
+				PropertyExtractor *cb_this,
+				Property::Property &property,
+				const Index &index,
+				int offset,
+				Information &information
+			),
+			Property::Property &property,
+			const std::vector<Entry> &entries,
+			unsigned int firstState,
+			unsigned int lastState
+		);
+	};
+
 	/** Constructs a PropertyExtractor::BlockDiagonalizer.
 	 *
 	 *  @param solver The Solver to use. */
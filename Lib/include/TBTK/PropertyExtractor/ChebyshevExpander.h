@@ -24,6 +24,7 @@
 #define COM_DAFER45_TBTK_C_PROPERTY_EXTRACTOR
 
 #include "TBTK/Solver/ChebyshevExpander.h"
+#include "TBTK/Property/DOS.h"
 #include "TBTK/Property/Density.h"
 #include "TBTK/Property/GreensFunction.h"
 #include "TBTK/Property/LDOS.h"
@@ -32,6 +33,7 @@
 #include "TBTK/PropertyExtractor/PropertyExtractor.h"
 
 //#include <initializer_list>
+#include <ctime>
 #include <iostream>
 
 namespace TBTK{
@@ -119,6 +121,41 @@ public:
 		std::vector<Index> patterns
 	);
 
+	/** Set the number of random vectors to use in the stochastic
+	 *  evaluation of the DOS. The default value is 10.
+	 *
+	 *  @param numRandomVectors The number of random vectors. */
+	void setNumRandomVectors(unsigned int numRandomVectors);
+
+	/** Get the number of random vectors to use in the stochastic
+	 *  evaluation of the DOS.
+	 *
+	 *  @return The number of random vectors. */
+	unsigned int getNumRandomVectors() const;
+
+	/** Set the seed used to generate the random vectors in the stochastic
+	 *  evaluation of the DOS. The default value is time(nullptr).
+	 *
+	 *  @param seed The seed. */
+	void setRandomSeed(unsigned int seed);
+
+	/** Overrides PropertyExtractor::calculateDOS(). The DOS is calculated
+	 *  using a stochastic evaluation of the trace of the Green's function
+	 *  over getNumRandomVectors() random-phase vectors. The computational
+	 *  cost is independent of the number of sites that contribute to the
+	 *  DOS. */
+	virtual Property::DOS calculateDOS();
+
+	/** Calculates the DOS in the same way as calculateDOS(), and also
+	 *  returns the statistical error of the estimate.
+	 *
+	 *  @param statisticalError DOS that is overwritten by the standard
+	 *  error of the mean for each energy. Requires at least two random
+	 *  vectors.
+	 *
+	 *  @return The DOS. */
+	Property::DOS calculateDOS(Property::DOS &statisticalError);
+
 	/** Overrides PropertyExtractor::calculateSpinPolarizedLDOS(). */
 	virtual Property::SpinPolarizedLDOS calculateSpinPolarizedLDOS(
 		Index pattern,
@@ -130,9 +167,50 @@ public:
 		std::vector<Index> patterns
 	);
 private:
-	/** !!!Not tested!!! Callback for calculating density.
-	 *  Used by calculateDensity. */
-	static void calculateDensityCallback(
+	/** Number of random vectors used in the stochastic evaluation of the
+	 *  DOS. */
+	unsigned int numRandomVectors;
+
+	/** Seed for the random vectors used in the stochastic evaluation of
+	 *  the DOS. */
+	unsigned int randomSeed;
+
+	/** Information class that collects the Indices and memory offsets
+	 *  that are passed to a callback, to allow the corresponding
+	 *  calculations to be performed in blocks afterwards. */
+	class IndexCollectingInformation : public Information{
+	public:
+		/** Constructs a
+		 *  PropertyExtractor::ChebyshevExpander::IndexCollectingInformation.
+		 */
+		IndexCollectingInformation();
+
+		/** Add an Index and the corresponding memory offset.
+		 *
+		 *  @param index The Index to add.
+		 *  @param offset The memory offset for the Index. */
+		void add(const Index &index, int offset);
+
+		/** Get the collected Indices.
+		 *
+		 *  @return The collected Indices. */
+		const std::vector<Index>& getIndices() const;
+
+		/** Get the collected memory offsets.
+		 *
+		 *  @return The memory offsets for the collected Indices. */
+		const std::vector<int>& getOffsets() const;
+	private:
+		/** Collected Indices. */
+		std::vector<Index> indices;
+
+		/** Memory offsets for the collected Indices. */
+		std::vector<int> offsets;
+	};
+
+	/** Callback that collects the Indices and memory offsets in an
+	 *  IndexCollectingInformation. */
+	static void collectIndicesCallback(
 		PropertyExtractor *cb_this,
 		Property::Property &property,
 		const Index &index,
@@ -140,9 +218,32 @@ private:
 		Information &information
 	);
 
-	/** !!!Not tested!!! Callback for calculating magnetization.
-	 *  Used by calculateMAG. */
-	static void calculateMAGCallback(
+	/** Calculate the LDOS for the given Indices and add the result to the
+	 *  given memory offsets. The Indices are processed in blocks using the
+	 *  block recursion of the Solver::ChebyshevExpander.
+	 *
+	 *  @param indices The Indices to calculate the LDOS for.
+	 *  @param offsets The memory offsets to add the results to.
+	 *  @param ldos The LDOS to add the results to. */
+	void calculateLDOSBlockwise(
+		const std::vector<Index> &indices,
+		const std::vector<int> &offsets,
+		Property::LDOS &ldos
+	);
+
+	/** Convert a Property::GreensFunction::Type to the corresponding
+	 *  Solver::ChebyshevExpander::Type.
+	 *
+	 *  @param type The Property::GreensFunction::Type.
+	 *
+	 *  @return The corresponding Solver::ChebyshevExpander::Type. */
+	static Solver::ChebyshevExpander::Type getSolverType(
+		Property::GreensFunction::Type type
+	);
+
+	/** !!!Not tested!!! Callback for calculating density.
+	 *  Used by calculateDensity. */
+	static void calculateDensityCallback(
 		PropertyExtractor *cb_this,
 		Property::Property &property,
 		const Index &index,
@@ -150,9 +251,9 @@ private:
 		Information &information
 	);
 
-	/** !!!Not tested!!! Callback for calculating local density of states.
-	 *  Used by calculateLDOS. */
-	static void calculateLDOSCallback(
+	/** !!!Not tested!!! Callback for calculating magnetization.
+	 *  Used by calculateMAG. */
+	static void calculateMAGCallback(
 		PropertyExtractor *cb_this,
 		Property::Property &property,
 		const Index &index,
@@ -177,6 +278,45 @@ private:
 	const Solver::ChebyshevExpander& getSolver() const;
 };
 
+inline void ChebyshevExpander::IndexCollectingInformation::add(
+	const Index &index,
+	int offset
+){
+	indices.push_back(index);
+	offsets.push_back(offset);
+}
+
+inline const std::vector<Index>&
+ChebyshevExpander::IndexCollectingInformation::getIndices() const{
+	return indices;
+}
+
+inline const std::vector<int>&
+ChebyshevExpander::IndexCollectingInformation::getOffsets() const{
+	return offsets;
+}
+
+inline void ChebyshevExpander::setNumRandomVectors(
+	unsigned int numRandomVectors
+){
+	TBTKAssert(
+		numRandomVectors > 0,
+		"PropertyExtractor::ChebyshevExpander::setNumRandomVectors()",
+		"'numRandomVectors' must be larger than zero.",
+		""
+	);
+
+	this->numRandomVectors = numRandomVectors;
+}
+
+inline unsigned int ChebyshevExpander::getNumRandomVectors() const{
+	return numRandomVectors;
+}
+
+inline void ChebyshevExpander::setRandomSeed(unsigned int seed){
+	randomSeed = seed;
+}
+
 inline Solver::ChebyshevExpander& ChebyshevExpander::getSolver(){
 	return PropertyExtractor::getSolver<Solver::ChebyshevExpander>();
 }
@@ -27,8 +27,11 @@
 #include "TBTK/Model.h"
 #include "TBTK/Solver/LUSolver.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/TBTKMacros.h"
 
 #include <complex>
+#include <memory>
+#include <vector>
 
 namespace TBTK{
 namespace Solver{
@@ -51,7 +54,23 @@ namespace Solver{
  *
  *  <b>Shift-and-invert mode:</b><br />
  *  In the shift-and-invert mode, the ArnoldiIterator calculates the
- *  eigenvalues and eigenvectors closest to a given "central value".
+ *  eigenvalues and eigenvectors closest to a given "central value". The matrix
+ *  \f$H - \sigma I\f$ is factorized once using SuperLU, and every iteration
+ *  solves directly into the ARPACK workspace using the stored factors.
+ *
+ *  <b>Spectrum slicing:</b><br />
+ *  Interior eigenvalues in a wide energy window can be calculated by passing
+ *  several central values to setCentralValues(). The window is then split
+ *  into slices, one per central value, and the factorizations for the
+ *  different slices are calculated in parallel. For each slice, the
+ *  eigenvalues that are closer to its central value than to any other
+ *  central value are kept, which removes duplicates from overlapping
+ *  slices. The number of eigenvalues calculated per slice should therefore
+ *  be large enough for each slice to reach halfway to its neighbors. If a
+ *  slice does not, eigenvalues in the gap between the slices can be missing.
+ *  This is reported through a warning and getSlicesAreContiguous().
+ *  getNumStates() returns the total number of eigenvalues after the slices
+ *  have been merged.
  *
  *  # Example
  *  \snippet Solver/ArnoldiIterator.cpp ArnoldiIterator
@@ -146,9 +165,44 @@ public:
 	 *  is shifted. */
 	void setCentralValue(double centralValue);
 
+	/** Set multiple central values to use for spectrum slicing in the
+	 *  shift-and-invert mode. The setNumEigenValues() eigenvalues closest
+	 *  to each central value are calculated, after which the results are
+	 *  merged. Only eigenvalues that are closer to the central value of
+	 *  their own slice than to any other central value are kept.
+	 *
+	 *  @param centralValues The central values. */
+	void setCentralValues(const std::vector<double> &centralValues);
+
+	/** Get the central values.
+	 *
+	 *  @return The central values. */
+	const std::vector<double>& getCentralValues() const;
+
 	/** Run the implicitly restarted Arnoldi algorithm. */
 	void run();
 
+	/** Get the number of calculated eigenstates. Equal to the number of
+	 *  eigenvalues unless several central values are used, in which case
+	 *  it is the number of eigenstates that remain after the slices have
+	 *  been merged.
+	 *
+	 *  @return The number of calculated eigenstates. */
+	unsigned int getNumStates() const;
+
+	/** Get whether the slices in the last spectrum slicing run covered
+	 *  the full range between the smallest and largest central value. A
+	 *  slice covers the energies that are closer to its central value
+	 *  than the furthest of its calculated eigenvalues. The slices are
+	 *  contiguous if every slice reaches halfway to its neighboring
+	 *  central values. If not, eigenvalues between the slices may be
+	 *  missing and setNumEigenValues() should be increased. Always true
+	 *  if a single central value is used.
+	 *
+	 *  @return True if no eigenvalues can be missing between the
+	 *  slices. */
+	bool getSlicesAreContiguous() const;
+
 	/** Get eigenValues. */
 	const CArray<std::complex<double>>& getEigenValues() const;
 
@@ -175,9 +229,10 @@ private:
 	 *  space. (Arnoldi variable). */
 	int numLanczosVectors;
 
-	/** Energy around which the eigenvalues and eigenvectors are
-	 *  calculated. (Arnoldi variable). */
-	double shift;
+	/** Energies around which the eigenvalues and eigenvectors are
+	 *  calculated. Only a single value is allowed in the normal mode.
+	 *  (Arnoldi variable). */
+	std::vector<double> shifts;
 
 	/** Accepted tolerance. Machine tolerance is used if tolerance <= 0.
 	 *  (Arnoldi variable). */
@@ -196,41 +251,58 @@ private:
 	/** Eigen vectors. (Arnoldi variable). */
 	CArray<std::complex<double>> eigenVectors;
 
+	/** Number of calculated eigenstates. */
+	unsigned int numStates;
+
+	/** Flag indicating whether the slices in the last spectrum slicing
+	 *  run were contiguous. */
+	bool slicesAreContiguous;
+
 	SparseMatrix<std::complex<double>> matrix;
 
-	/** LUSolver. */
-	LUSolver luSolver;
+	/** LUSolvers containing the factorizations of \f$H - \sigma I\f$, one
+	 *  for each shift. */
+	std::vector<std::unique_ptr<LUSolver>> luSolvers;
 
 	/** Initialize solver for normal mode. Setting up SuperLU. (SuperLU
 	 *  routine). */
 	void initNormal();
 
 	/** Initialize solver for shift and invert mode. Setting up SuperLU.
-	 *  (SuperLU routine). */
+	 *  The factorizations for the different shifts are calculated in
+	 *  parallel. (SuperLU routine). */
 	void initShiftAndInvert();
 
-	/** Run implicitly restarted Arnoldi loop. */
-	void arnoldiLoop();
+	/** Run implicitly restarted Arnoldi loop.
+	 *
+	 *  @param slice The index of the shift to use. */
+	void arnoldiLoop(unsigned int slice);
+
+	/** Run the implicitly restarted Arnoldi loop for each shift and merge
+	 *  the results. */
+	void runSpectrumSlicing();
 
 	/** Check znaupd info for errors. */
 	void checkZnaupdInfo(int info) const;
 
-	/** Execute reverse communication message. */
+	/** Execute reverse communication message. The LUSolver is only used
+	 *  in the shift-and-invert mode. */
 	bool executeReverseCommunicationMessage(
 		int ido,
 		int basisSize,
 		double *workd,
 		int *ipntr,
-		Matrix<double> &b
+		LUSolver *luSolver
 	);
 
-	/** Execute reverse communication message. */
+	/** Execute reverse communication message. The LUSolver is only used
+	 *  in the shift-and-invert mode. */
 	bool executeReverseCommunicationMessage(
 		int ido,
 		int basisSize,
 		std::complex<double> *workd,
 		int *ipntr,
-		Matrix<std::complex<double>> &b
+		LUSolver *luSolver
 	);
 
 	void checkZneupdIerr(int ierr) const;
@@ -302,7 +374,31 @@ inline void ArnoldiIterator::setMaxIterations(int maxIterations){
 }
 
 inline void ArnoldiIterator::setCentralValue(double centralValue){
-	shift = centralValue;
+	shifts.assign(1, centralValue);
+}
+
+inline void ArnoldiIterator::setCentralValues(
+	const std::vector<double> &centralValues
+){
+	TBTKAssert(
+		centralValues.size() > 0,
+		"ArnoldiIterator::setCentralValues()",
+		"At least one central value must be given.",
+		""
+	);
+	shifts = centralValues;
+}
+
+inline const std::vector<double>& ArnoldiIterator::getCentralValues() const{
+	return shifts;
+}
+
+inline unsigned int ArnoldiIterator::getNumStates() const{
+	return numStates;
+}
+
+inline bool ArnoldiIterator::getSlicesAreContiguous() const{
+	return slicesAreContiguous;
 }
 
 inline const CArray<std::complex<double>>& ArnoldiIterator::getEigenValues() const{
@@ -61,6 +61,24 @@ namespace Solver{
  *  behavior instead becomes an upper bound, with \f$h\f$ the maximum block
  *  dimension.
  *
+ *  If every matrix element of the Hamiltonian is real, the blocks are
+ *  diagonalized using the real symmetric LAPACK routine dspev and the
+ *  eigenvectors are stored as real numbers. The amplitudes are still returned
+ *  as complex numbers by getAmplitude(). The real arithmetic can be disabled
+ *  using setUseRealArithmetic().
+ *
+ *  <b>Streaming:</b><br />
+ *  For Models with a large number of blocks, storing all of the eigenvectors
+ *  can require more memory than is available. If setStreamEigenVectors() is
+ *  set to true, the Hamiltonian and eigenvectors are instead stored for one
+ *  block at a time. Each block is set up, diagonalized, and passed to the
+ *  @link BlockCallback BlockCallbacks@endlink added through
+ *  addBlockCallback() before the next block is processed. The peak memory
+ *  is then determined by the largest block rather than by the full Model.
+ *  The eigenvalues are still stored for all blocks. Use
+ *  PropertyExtractor::BlockDiagonalizer::Accumulator to calculate @link
+ *  Property::AbstractProperty Properties@endlink in this mode.
+ *
  *  # Example
  *  \snippet Solver/BlockDiagonalizer.cpp BlockDiagonalizer
  *  ## Output
@@ -80,6 +98,30 @@ public:
 		) = 0;
 	};
 
+	/** Abstract base class for callbacks that process the eigenstates of
+	 *  one block at a time when the eigenvectors are streamed. */
+	class BlockCallback{
+	public:
+		/** Function that is called before the first block is
+		 *  diagonalized. Is called once for every diagonalization of
+		 *  the Hamiltonian and can be overriden to reset the state of
+		 *  the callback. */
+		virtual void beginDiagonalization(){};
+
+		/** Function that is called after a block has been
+		 *  diagonalized. The eigenvectors of the block can be accessed
+		 *  through the BlockDiagonalizer during the call.
+		 *
+		 *  @param blockDiagonalizer The BlockDiagonalizer.
+		 *  @param firstState The first state in the block.
+		 *  @param lastState The last state in the block. */
+		virtual void processBlock(
+			const BlockDiagonalizer &blockDiagonalizer,
+			unsigned int firstState,
+			unsigned int lastState
+		) = 0;
+	};
+
 	/** Constructs a Solver::Diagonalizer. */
 	BlockDiagonalizer();
 
@@ -176,6 +218,80 @@ public:
 	 *
 	 *  @pragma parallelExecution True to enable parallel execution. */
 	void setParallelExecution(bool parallelExecution);
+
+	/** Set the number of states above which a block is considered large.
+	 *  When parallel execution is enabled, the large blocks are
+	 *  diagonalized one at a time outside of the parallel region, which
+	 *  allows a multithreaded LAPACK implementation to use all available
+	 *  threads for them. The remaining blocks are then distributed
+	 *  dynamically over the threads in order of decreasing size. The
+	 *  default value is zero, which means that no block is considered
+	 *  large.
+	 *
+	 *  @param largeBlockThreshold The number of states above which a
+	 *  block is considered large, or zero to disable the special
+	 *  treatment of large blocks. */
+	void setLargeBlockThreshold(unsigned int largeBlockThreshold);
+
+	/** Get the number of states above which a block is considered large.
+	 *
+	 *  @return The number of states above which a block is considered
+	 *  large. */
+	unsigned int getLargeBlockThreshold() const;
+
+	/** Set whether to stream the eigenvectors. If true, the eigenvectors
+	 *  are only stored for one block at a time, and each block is passed
+	 *  to the @link BlockCallback BlockCallbacks@endlink before being
+	 *  discarded. After the solver has been run, only the eigenvectors
+	 *  for the last block are available. The blocks are processed one at
+	 *  a time also when parallel execution is enabled. The setting takes
+	 *  effect the next time run() is called. The default value is false.
+	 *
+	 *  @param streamEigenVectors True to enable streaming. */
+	void setStreamEigenVectors(bool streamEigenVectors);
+
+	/** Get whether the eigenvectors are streamed.
+	 *
+	 *  @return True if the eigenvectors are streamed. */
+	bool getStreamEigenVectors() const;
+
+	/** Add a BlockCallback that is called for every block when the
+	 *  eigenvectors are streamed.
+	 *
+	 *  @param blockCallback The BlockCallback to add. */
+	void addBlockCallback(BlockCallback &blockCallback);
+
+	/** Remove all @link BlockCallback BlockCallbacks@endlink. */
+	void clearBlockCallbacks();
+
+	/** Get the time it took to diagonalize the block corresponding to the
+	 *  given Index during the last diagonalization.
+	 *
+	 *  @param index A physical Index.
+	 *
+	 *  @return The time in seconds spent diagonalizing the block for which
+	 *  the given Index is part of the basis. */
+	double getBlockSolveTime(const Index &index) const;
+
+	/** Set whether to use real arithmetic for Models with a real
+	 *  Hamiltonian. The default value is true.
+	 *
+	 *  @param useRealArithmetic If true, real symmetric LAPACK routines
+	 *  are used when possible. */
+	void setUseRealArithmetic(bool useRealArithmetic);
+
+	/** Get whether to use real arithmetic for Models with a real
+	 *  Hamiltonian.
+	 *
+	 *  @return True if real arithmetic is used when possible. */
+	bool getUseRealArithmetic() const;
+
+	/** Get whether the last diagonalization was performed using real
+	 *  arithmetic.
+	 *
+	 *  @return True if the Hamiltonian was real and real arithmetic was
+	 *  used. */
+	bool getHamiltonianIsReal() const;
 private:
 	/** pointer to array containing Hamiltonian. */
 	CArray<std::complex<double>> hamiltonian;
@@ -186,6 +302,23 @@ private:
 	/** Pointer to array containing eigenvectors. */
 	CArray<std::complex<double>> eigenVectors;
 
+	/** Array containing the Hamiltonian when it is real. */
+	CArray<double> realHamiltonian;
+
+	/** Array containing the eigenvectors when they are real. */
+	CArray<double> realEigenVectors;
+
+	/** Flag indicating whether to use real arithmetic when possible. */
+	bool useRealArithmetic;
+
+	/** Flag indicating whether the current Hamiltonian is stored in
+	 *  realHamiltonian. */
+	bool hamiltonianIsReal;
+
+	/** Flag indicating whether the eigenvectors are stored in
+	 *  realEigenVectors. */
+	bool eigenVectorsAreReal;
+
 	/** BlockStructureDescriptor. */
 	BlockStructureDescriptor blockStructureDescriptor;
 
@@ -207,6 +340,29 @@ private:
 	/** Flag indicating wether to enable parallel execution. */
 	bool parallelExecution;
 
+	/** Number of states above which a block is considered large. */
+	unsigned int largeBlockThreshold;
+
+	/** Time in seconds spent diagonalizing each block. */
+	std::vector<double> blockSolveTimes;
+
+	/** Flag indicating whether to stream the eigenvectors. */
+	bool streamEigenVectors;
+
+	/** Flag indicating whether the Hamiltonian and eigenvectors are
+	 *  stored for one block at a time. Set from streamEigenVectors when
+	 *  the solver is initialized, to keep the storage consistent if the
+	 *  setting is changed after run() has been called. */
+	bool eigenVectorsAreStreamed;
+
+	/** The block that is currently stored when the eigenvectors are
+	 *  streamed. */
+	unsigned int streamedBlock;
+
+	/** Callbacks that are called for each block when the eigenvectors are
+	 *  streamed. */
+	std::vector<BlockCallback*> blockCallbacks;
+
 	/** Callback function to call each time a diagonalization has been
 	 *  completed. */
 	SelfConsistencyCallback *selfConsistencyCallback;
@@ -219,6 +375,59 @@ private:
 
 	/** Diagonalizes the Hamiltonian. */
 	void solve();
+
+	/** Check whether real arithmetic can be used for the given amplitudes.
+	 *  This is the case if real arithmetic is enabled and every amplitude
+	 *  is real.
+	 *
+	 *  @param compiledHoppingAmplitudes The CompiledHoppingAmplitudes to
+	 *  check.
+	 *
+	 *  @return True if the Hamiltonian can be stored as a real matrix. */
+	bool getAmplitudesAreReal(
+		const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+	) const;
+
+	/** Set up the Hamiltonian for a single block.
+	 *
+	 *  @param block The block to set up.
+	 *  @param compiledHoppingAmplitudes The CompiledHoppingAmplitudes to
+	 *  set up the block from. */
+	void setupBlock(
+		unsigned int block,
+		const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+	);
+
+	/** Diagonalize the blocks one at a time and pass them to the @link
+	 *  BlockCallback BlockCallbacks@endlink. */
+	void solveStreamed();
+
+	/** Get the offset of a block in the Hamiltonian storage.
+	 *
+	 *  @param block The block.
+	 *
+	 *  @return The offset of the first element of the block. */
+	unsigned int getHamiltonianOffset(unsigned int block) const;
+
+	/** Get the offset of a block in the eigenvector storage.
+	 *
+	 *  @param block The block.
+	 *
+	 *  @return The offset of the first element of the block. */
+	unsigned int getEigenVectorOffset(unsigned int block) const;
+
+	/** Diagonalize a single block.
+	 *
+	 *  @param block The block to diagonalize.
+	 *  @param eigenValuesOffset Offset for the block's eigenvalues. */
+	void solveBlock(unsigned int block, unsigned int eigenValuesOffset);
+
+	/** Get an element from the eigenvector storage.
+	 *
+	 *  @param n Position in the eigenvector storage.
+	 *
+	 *  @return The element at the given position. */
+	std::complex<double> getEigenVectorElement(unsigned int n) const;
 };
 
 inline void BlockDiagonalizer::setSelfConsistencyCallback(
@@ -237,7 +446,7 @@ inline const std::complex<double> BlockDiagonalizer::getAmplitude(
 ) const{
 	const Model &model = getModel();
 	unsigned int block = blockStructureDescriptor.getBlockIndex(state);
-	unsigned int offset = eigenVectorOffsets.at(block);
+	unsigned int offset = getEigenVectorOffset(block);
 	unsigned int linearIndex = model.getBasisIndex(index);
 	unsigned int firstStateInBlock
 		= blockStructureDescriptor.getFirstStateInBlock(block);
@@ -250,9 +459,9 @@ inline const std::complex<double> BlockDiagonalizer::getAmplitude(
 		linearIndex >= firstStateInBlock
 		&& linearIndex <= lastStateInBlock
 	){
-		return eigenVectors[
+		return getEigenVectorElement(
 			offset + (linearIndex - firstStateInBlock)
-		];
+		);
 	}
 	else{
 		return 0;
@@ -281,13 +490,65 @@ inline const std::complex<double> BlockDiagonalizer::getAmplitude(
 		<< " states, but state " << state << " was requested.",
 		""
 	);
-	unsigned int offset = eigenVectorOffsets.at(block)
+	unsigned int offset = getEigenVectorOffset(block)
 		+ state*blockStructureDescriptor.getNumStatesInBlock(block);
 	unsigned int linearIndex = getModel().getBasisIndex(
 		Index(blockIndex, intraBlockIndex)
 	);
 
-	return eigenVectors[offset + (linearIndex - firstStateInBlock)];
+	return getEigenVectorElement(offset + (linearIndex - firstStateInBlock));
+}
+
+inline void BlockDiagonalizer::setUseRealArithmetic(bool useRealArithmetic){
+	this->useRealArithmetic = useRealArithmetic;
+}
+
+inline bool BlockDiagonalizer::getUseRealArithmetic() const{
+	return useRealArithmetic;
+}
+
+inline bool BlockDiagonalizer::getHamiltonianIsReal() const{
+	return hamiltonianIsReal;
+}
+
+inline std::complex<double> BlockDiagonalizer::getEigenVectorElement(
+	unsigned int n
+) const{
+	if(eigenVectorsAreReal)
+		return realEigenVectors[n];
+	else
+		return eigenVectors[n];
+}
+
+inline unsigned int BlockDiagonalizer::getHamiltonianOffset(
+	unsigned int block
+) const{
+	if(eigenVectorsAreStreamed)
+		return 0;
+	else
+		return blockOffsets.at(block);
+}
+
+inline unsigned int BlockDiagonalizer::getEigenVectorOffset(
+	unsigned int block
+) const{
+	if(eigenVectorsAreStreamed){
+		TBTKAssert(
+			block == streamedBlock,
+			"Solver::BlockDiagonalizer::getAmplitude()",
+			"The eigenvectors for the requested block are not"
+			<< " available.",
+			"The eigenvectors are streamed and are only available"
+			<< " for one block at a time. Use a BlockCallback to"
+			<< " access the eigenvectors while they are being"
+			<< " calculated, or disable streaming using"
+			<< " setStreamEigenVectors(false)."
+		);
+		return 0;
+	}
+	else{
+		return eigenVectorOffsets.at(block);
+	}
 }
 
 inline const double BlockDiagonalizer::getEigenValue(int state) const{
@@ -332,6 +593,47 @@ inline void BlockDiagonalizer::setParallelExecution(
 	this->parallelExecution = parallelExecution;
 }
 
+inline void BlockDiagonalizer::setLargeBlockThreshold(
+	unsigned int largeBlockThreshold
+){
+	this->largeBlockThreshold = largeBlockThreshold;
+}
+
+inline unsigned int BlockDiagonalizer::getLargeBlockThreshold() const{
+	return largeBlockThreshold;
+}
+
+inline void BlockDiagonalizer::setStreamEigenVectors(bool streamEigenVectors){
+	this->streamEigenVectors = streamEigenVectors;
+}
+
+inline bool BlockDiagonalizer::getStreamEigenVectors() const{
+	return streamEigenVectors;
+}
+
+inline void BlockDiagonalizer::addBlockCallback(BlockCallback &blockCallback){
+	blockCallbacks.push_back(&blockCallback);
+}
+
+inline void BlockDiagonalizer::clearBlockCallbacks(){
+	blockCallbacks.clear();
+}
+
+inline double BlockDiagonalizer::getBlockSolveTime(const Index &index) const{
+	TBTKAssert(
+		blockSolveTimes.size() != 0,
+		"Solver::BlockDiagonalizer::getBlockSolveTime()",
+		"No timing information available.",
+		"Make sure to run the solver before requesting the timing"
+		<< " information."
+	);
+	unsigned int linearIndex = getModel().getBasisIndex(index);
+	unsigned int block
+		= blockStructureDescriptor.getBlockIndex(linearIndex);
+
+	return blockSolveTimes[block];
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
 
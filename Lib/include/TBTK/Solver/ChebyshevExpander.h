@@ -28,6 +28,7 @@
 #include "TBTK/CArray.h"
 #include "TBTK/Communicator.h"
 #include "TBTK/Invalidatable.h"
+#include "TBTK/Math/ParallelSparseMatrix.h"
 #include "TBTK/Model.h"
 #include "TBTK/Range.h"
 #include "TBTK/Solver/Solver.h"
@@ -62,6 +63,15 @@ namespace Solver{
  *  the following: Number of coefficients, energy resolution, and the number of
  *  Green's functions.
  *
+ *  The Hamiltonian is constructed the first time coefficients are calculated
+ *  and is reused by later calculations. Only the matrix elements that are
+ *  determined by @link HoppingAmplitude::AmplitudeCallback
+ *  AmplitudeCallbacks@endlink are updated between calculations, which makes
+ *  repeated calculations in a self-consistency loop cheap when only such
+ *  parameters change. Changes to the Model that alter the number of basis
+ *  states or HoppingAmplitudes are detected automatically and lead to a
+ *  reconstruction. For other structural changes, call setModel() again.
+ *
  *  Use the PropertyExtractor::ChebyshevExpander to calculate @link
  *  Property::AbstractProperty Properties@endlink.
  *
@@ -78,6 +88,11 @@ public:
 	/** Destructor. */
 	virtual ~ChebyshevExpander();
 
+	/** Overrides Solver::setModel(). Invalidates the stored Hamiltonian.
+	 *
+	 *  @param model The Model to solve. */
+	virtual void setModel(Model &model);
+
 	/** Sets the scale factor that rescales the Hamiltonian to ensure that
 	 *  the energy spectrum of the Hamiltonian is bounded on the interval
 	 *  (-1, 1).
@@ -164,6 +179,22 @@ public:
 	 *  @return True if a lookup table is used. */
 	bool getUseLookupTable() const ;
 
+	/** Set the maximum number of 'from'-indices for which the Chebyshev
+	 *  recursion is performed simultaneously when coefficients are
+	 *  calculated for multiple 'from'-indices. A larger block size
+	 *  improves the arithmetic intensity of the sparse matrix
+	 *  multiplication, at the cost of blockSize vectors of the size of the
+	 *  Hilbert space in memory. The default value is 16.
+	 *
+	 *  @param blockSize The maximum number of simultaneous recursions. */
+	void setBlockSize(unsigned int blockSize);
+
+	/** Get the maximum number of 'from'-indices for which the Chebyshev
+	 *  recursion is performed simultaneously.
+	 *
+	 *  @return The block size. */
+	unsigned int getBlockSize() const;
+
 	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$, where
 	 *  \f$i = \textrm{to}\f$ is a set of indices and \f$j =
 	 *  \textrm{from}\f$.
@@ -199,6 +230,64 @@ public:
 		Index from
 	);
 
+	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$ for
+	 *  every combination of \f$i\f$ in a set of 'to'-indices and \f$j\f$
+	 *  in a set of 'from'-indices. The recursions for up to getBlockSize()
+	 *  'from'-indices are performed simultaneously, which means that the
+	 *  Hamiltonian is read from memory once per iteration for the whole
+	 *  block rather than once per 'from'-index.
+	 *
+	 *  @param to vector of 'to'-indices, or \f$i\f$'s.
+	 *  @param from vector of 'from'-indices, or \f$j\f$'s.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[fromID][toID][coefficientID]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateCoefficients(
+		std::vector<Index> &to,
+		const std::vector<Index> &from
+	);
+
+	/** Calculates the Chebyshev coefficients for the diagonal elements
+	 *  \f$G_{ii}(E)\f$ for a set of indices \f$i\f$. The recursions are
+	 *  performed blockwise in the same way as for
+	 *  calculateCoefficients(std::vector<Index>&, const std::vector<Index>&),
+	 *  but only the element at the 'from'-index itself is extracted from
+	 *  each vector.
+	 *
+	 *  @param indices The indices \f$i\f$.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[indexID][coefficientID]. */
+	std::vector<std::vector<std::complex<double>>> calculateDiagonalCoefficients(
+		const std::vector<Index> &indices
+	);
+
+	/** Calculates stochastic estimates of the Chebyshev coefficients for
+	 *  the trace \f$\sum_{i}G_{ii}(E)\f$ using the kernel polynomial
+	 *  method. Each estimate is given by \f$\langle r|T_n(H)|r\rangle\f$,
+	 *  where \f$|r\rangle\f$ is a random-phase vector with elements
+	 *  \f$e^{i\phi}\f$ for uniformly distributed \f$\phi\f$. The
+	 *  average over the returned estimates is an unbiased estimate of the
+	 *  trace coefficients, while the spread between them gives the
+	 *  statistical error. The recursions for up to getBlockSize() random
+	 *  vectors are performed simultaneously and the identities
+	 *  \f$T_{2n} = 2T_n^2 - T_0\f$ and \f$T_{2n+1} = 2T_{n+1}T_n -
+	 *  T_1\f$ are used to obtain two coefficients per multiplication with
+	 *  the Hamiltonian. Runs on CPU.
+	 *
+	 *  @param numRandomVectors The number of random vectors to use.
+	 *  @param seed Seed for the random number generator. The result is
+	 *  independent of the block size for a given seed.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[randomVectorID][coefficientID]. */
+	std::vector<std::vector<std::complex<double>>> calculateTraceCoefficients(
+		unsigned int numRandomVectors,
+		unsigned int seed
+	);
+
 	/** Enum class describing the type of Green's function to calculate. */
 	enum class Type{
 		Advanced,
@@ -246,6 +335,10 @@ private:
 	 *  Green's functions. */
 	bool useLookupTable;
 
+	/** Maximum number of 'from'-indices to perform the Chebyshev
+	 *  recursion for simultaneously. */
+	unsigned int blockSize;
+
 	/** Pointer to lookup table used to speed up evaluation of multiple
 	 *  Green's functions. */
 	Invalidatable<
@@ -269,6 +362,29 @@ private:
 	/** Upper bound for energy used for the lookup table. */
 	double lookupTableUpperBound;
 
+	/** Hamiltonian distributed over the available threads. */
+	Math::ParallelSparseMatrix<std::complex<double>> hamiltonian;
+
+	/** Flag indicating whether the Hamiltonian has been constructed. */
+	bool hamiltonianIsConstructed;
+
+	/** Revision of the CompiledHoppingAmplitudes at the time of the
+	 *  construction of the Hamiltonian. Used to detect that the Model has
+	 *  been reconstructed, which requires the Hamiltonian to be
+	 *  reconstructed. */
+	unsigned long long hamiltonianRevision;
+
+	/** Positions in the Hamiltonian of the matrix elements that depend on
+	 *  AmplitudeCallbacks. */
+	std::vector<unsigned int> callbackDependentElementPositions;
+
+	/** Get the Hamiltonian. The Hamiltonian is constructed on the first
+	 *  call, while subsequent calls only update the matrix elements that
+	 *  depend on AmplitudeCallbacks.
+	 *
+	 *  @return The Hamiltonian. */
+	const Math::ParallelSparseMatrix<std::complex<double>>& getHamiltonian();
+
 	/** Ensure that the lookup table is in a ready state. */
 	void ensureLookupTableIsReady();
 
@@ -329,6 +445,57 @@ private:
 		Index from
 	);
 
+	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$, where
+	 *  \f$i = \textrm{to}\f$ is a set of indices and \f$j =
+	 *  \textrm{from}\f$ is a set of indices. Runs on CPU with the
+	 *  recursions for up to blockSize 'from'-indices performed
+	 *  simultaneously.
+	 *
+	 *  @param to vector of 'to'-indices, or \f$i\f$'s.
+	 *  @param from vector of 'from'-indices, or \f$j\f$'s.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[fromID][toID][coefficientID]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateCoefficientsCPU(
+		std::vector<Index> &to,
+		const std::vector<Index> &from
+	);
+
+	/** Calculates the Chebyshev coefficients for the diagonal elements
+	 *  \f$G_{ii}(E)\f$ for a set of indices \f$i\f$. Runs on CPU.
+	 *
+	 *  @param indices The indices \f$i\f$.
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[indexID][coefficientID]. */
+	std::vector<
+		std::vector<std::complex<double>>
+	> calculateDiagonalCoefficientsCPU(
+		const std::vector<Index> &indices
+	);
+
+	/** Performs the blockwise recursions for calculateCoefficientsCPU()
+	 *  and calculateDiagonalCoefficientsCPU().
+	 *
+	 *  @param to vector of 'to'-indices, or \f$i\f$'s. Ignored if
+	 *  diagonal is true.
+	 *
+	 *  @param from vector of 'from'-indices, or \f$j\f$'s.
+	 *  @param diagonal If true, only the coefficients for \f$i = j\f$ are
+	 *  extracted and stored as coefficients[fromID][0][coefficientID].
+	 *
+	 *  @return The coefficients on the format
+	 *  coefficients[fromID][toID][coefficientID]. */
+	std::vector<
+		std::vector<std::vector<std::complex<double>>>
+	> calculateBlockCoefficientsCPU(
+		std::vector<Index> &to,
+		const std::vector<Index> &from,
+		bool diagonal
+	);
+
 	/** Calculates the Chebyshev coefficients for \f$ G_{ij}(E)\f$, where
 	 *  \f$i = \textrm{to}\f$ is a set of indices and \f$j =
 	 *  \textrm{from}\f$. Runs on GPU.
@@ -391,6 +558,11 @@ private:
 	);
 };
 
+inline void ChebyshevExpander::setModel(Model &model){
+	Solver::setModel(model);
+	hamiltonianIsConstructed = false;
+}
+
 inline void ChebyshevExpander::setScaleFactor(double scaleFactor){
 	TBTKAssert(
 		scaleFactor > 0,
@@ -488,6 +660,21 @@ inline bool ChebyshevExpander::getUseLookupTable() const{
 	return useLookupTable;
 }
 
+inline void ChebyshevExpander::setBlockSize(unsigned int blockSize){
+	TBTKAssert(
+		blockSize > 0,
+		"Solver::ChebyshevExpander::setBlockSize()",
+		"The 'blockSize' has to be larger than '0'.",
+		""
+	);
+
+	this->blockSize = blockSize;
+}
+
+inline unsigned int ChebyshevExpander::getBlockSize() const{
+	return blockSize;
+}
+
 inline std::vector<
 		std::vector<std::complex<double>>
 > ChebyshevExpander::calculateCoefficients(
@@ -526,6 +713,52 @@ inline std::vector<std::complex<double>> ChebyshevExpander::calculateCoefficient
 	}
 }
 
+inline std::vector<
+	std::vector<std::vector<std::complex<double>>>
+> ChebyshevExpander::calculateCoefficients(
+	std::vector<Index> &to,
+	const std::vector<Index> &from
+){
+	if(calculateCoefficientsOnGPU){
+		std::vector<
+			std::vector<std::vector<std::complex<double>>>
+		> coefficients;
+		for(unsigned int n = 0; n < from.size(); n++){
+			coefficients.push_back(
+				calculateCoefficientsGPU(to, from[n])
+			);
+		}
+
+		return coefficients;
+	}
+	else{
+		return calculateCoefficientsCPU(
+			to,
+			from
+		);
+	}
+}
+
+inline std::vector<
+	std::vector<std::complex<double>>
+> ChebyshevExpander::calculateDiagonalCoefficients(
+	const std::vector<Index> &indices
+){
+	if(calculateCoefficientsOnGPU){
+		std::vector<std::vector<std::complex<double>>> coefficients;
+		for(unsigned int n = 0; n < indices.size(); n++){
+			coefficients.push_back(
+				calculateCoefficientsGPU(indices[n], indices[n])
+			);
+		}
+
+		return coefficients;
+	}
+	else{
+		return calculateDiagonalCoefficientsCPU(indices);
+	}
+}
+
 inline bool ChebyshevExpander::getLookupTableIsLoadedGPU(){
 	if(generatingFunctionLookupTable_device != NULL)
 		return true;
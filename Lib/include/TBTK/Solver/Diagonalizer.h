@@ -27,8 +27,10 @@
 #include "TBTK/Communicator.h"
 #include "TBTK/Model.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/TBTKMacros.h"
 
 #include <complex>
+#include <mutex>
 
 namespace TBTK{
 namespace Solver{
@@ -45,6 +47,23 @@ namespace Solver{
  *
  *  Here \f$h\f$ is the size of the Hilbert space basis.
  *
+ *  The LAPACK routine used for the diagonalization is selected using
+ *  setAlgorithm(). Algorithm::MRRR can also be used to calculate a subset of
+ *  the eigenstates by calling setStateRange() or setEnergyRange(). The
+ *  calculated eigenstates are then numbered from zero in ascending order
+ *  and getNumStates() returns the number of calculated states. Properties
+ *  extracted from a partial spectrum only include the contribution from
+ *  the calculated states.
+ *
+ *  If every matrix element of the Hamiltonian is real and the basis is
+ *  orthonormal, the Hamiltonian is diagonalized using the corresponding real
+ *  symmetric LAPACK routines (dspev, dsyevd, and dsyevr), and the
+ *  eigenvectors are stored as real numbers. This halves the memory required
+ *  for the eigenvectors and significantly reduces the number of floating
+ *  point operations. The amplitudes are still returned as complex numbers by
+ *  getAmplitude(). The real arithmetic can be disabled using
+ *  setUseRealArithmetic().
+ *
  *  # Example
  *  \snippet Solver/Diagonalizer.cpp Diagonalizer
  *  ## Output
@@ -67,6 +86,22 @@ public:
 		virtual bool selfConsistencyCallback(Diagonalizer &diagonalizer) = 0;
 	};
 
+	/** Enum class for specifying the algorithm used to diagonalize the
+	 *  Hamiltonian. */
+	enum class Algorithm{
+		/** QR iteration on the Hamiltonian stored on packed format
+		 *  (LAPACK zhpev). Requires the least amount of memory. */
+		PackedQR,
+		/** Divide-and-conquer on the Hamiltonian stored on full format
+		 *  (LAPACK zheevd). Usually significantly faster than PackedQR
+		 *  for large bases, but requires additional workspace. */
+		DivideAndConquer,
+		/** Multiple relatively robust representations on the
+		 *  Hamiltonian stored on full format (LAPACK zheevr). Allows
+		 *  for a subset of the eigenstates to be calculated. */
+		MRRR
+	};
+
 	/** Constructs a Solver::Diagonalizer. */
 	Diagonalizer();
 
@@ -93,6 +128,89 @@ public:
 	 *  self-consistent callculation. */
 	void setMaxIterations(int maxIterations);
 
+	/** Set the algorithm to use for the diagonalization. The default
+	 *  algorithm is Algorithm::PackedQR.
+	 *
+	 *  @param algorithm The algorithm to use. */
+	void setAlgorithm(Algorithm algorithm);
+
+	/** Get the algorithm used for the diagonalization.
+	 *
+	 *  @return The algorithm used for the diagonalization. */
+	Algorithm getAlgorithm() const;
+
+	/** Only calculate the eigenstates with state numbers in the range
+	 *  [first, last], where the states are numbered from zero in
+	 *  ascending order of their eigenvalues. Requires Algorithm::MRRR.
+	 *
+	 *  @param first The first state to calculate.
+	 *  @param last The last state to calculate. */
+	void setStateRange(unsigned int first, unsigned int last);
+
+	/** Only calculate the eigenstates with eigenvalues in the interval
+	 *  (lower, upper]. Requires Algorithm::MRRR.
+	 *
+	 *  @param lower The lower bound of the energy interval.
+	 *  @param upper The upper bound of the energy interval. */
+	void setEnergyRange(double lower, double upper);
+
+	/** Calculate all eigenstates. This is the default behavior and
+	 *  removes any restriction set by setStateRange() or
+	 *  setEnergyRange(). */
+	void setCalculateAllStates();
+
+	/** Set whether to use real arithmetic for Models with a real
+	 *  Hamiltonian and an orthonormal basis. The default value is true.
+	 *
+	 *  @param useRealArithmetic If true, real symmetric LAPACK routines
+	 *  are used when possible. */
+	void setUseRealArithmetic(bool useRealArithmetic);
+
+	/** Get whether to use real arithmetic for Models with a real
+	 *  Hamiltonian and an orthonormal basis.
+	 *
+	 *  @return True if real arithmetic is used when possible. */
+	bool getUseRealArithmetic() const;
+
+	/** Set whether to keep the eigenvectors real after a diagonalization
+	 *  that has been performed using real arithmetic. If true, the memory
+	 *  required for the eigenvectors is halved. A complex copy is only
+	 *  created if the eigenvectors are requested through getEigenVectors()
+	 *  or getEigenVectorsRW(). If false, the eigenvectors are converted to
+	 *  complex numbers at the end of the diagonalization. The default
+	 *  value is true.
+	 *
+	 *  @param keepRealEigenVectors If true, real eigenvectors are not
+	 *  converted to complex numbers. */
+	void setKeepRealEigenVectors(bool keepRealEigenVectors);
+
+	/** Get whether the eigenvectors are kept real after a diagonalization
+	 *  that has been performed using real arithmetic.
+	 *
+	 *  @return True if real eigenvectors are not converted to complex
+	 *  numbers. */
+	bool getKeepRealEigenVectors() const;
+
+	/** Get whether the eigenvectors currently are stored as real
+	 *  numbers. If true, they can be accessed without conversion through
+	 *  getRealEigenVectors().
+	 *
+	 *  @return True if the eigenvectors are stored as real numbers. */
+	bool getEigenVectorsAreReal() const;
+
+	/** Get whether the last diagonalization was performed using real
+	 *  arithmetic.
+	 *
+	 *  @return True if the Hamiltonian was real and real arithmetic was
+	 *  used. */
+	bool getHamiltonianIsReal() const;
+
+	/** Get the number of calculated eigenstates. Equal to the basis size
+	 *  unless a state or energy range has been set.
+	 *
+	 *  @return The number of calculated eigenstates. */
+	unsigned int getNumStates() const;
+
 	/** Run calculations. Diagonalizes ones if no self-consistency callback
 	 *  have been set, or otherwise multiple times until self-consistencey
 	 *  or maximum number of iterations has been reached. */
@@ -113,17 +231,32 @@ public:
 	 *  memory, with the eigenvector corresponding to the smallest
 	 *  eigenvalue occupying the 'basisSize' first positions, the second
 	 *  occupying the next 'basisSize' elements, and so forth, where
-	 *  'basisSize' is the basis size of the Model.
+	 *  'basisSize' is the basis size of the Model. Only the getNumStates()
+	 *  calculated eigenvectors are stored. If the eigenvectors are kept
+	 *  real (see setKeepRealEigenVectors()), a complex copy is created on
+	 *  the first call. The real eigenvectors are left untouched, which
+	 *  makes it safe to call this function concurrently with other const
+	 *  member functions. Use getRealEigenVectors() to avoid the copy.
 	 *
 	 *  @return A pointer to the internal storage for the eigenvectors. **/
 	const CArray<std::complex<double>>& getEigenVectors() const;
 
+	/** Get the eigenvectors when they are stored as real numbers. The
+	 *  storage format is the same as for getEigenVectors(). Only
+	 *  available if getEigenVectorsAreReal() is true.
+	 *
+	 *  @return A pointer to the internal storage for the real
+	 *  eigenvectors. **/
+	const CArray<double>& getRealEigenVectors() const;
+
 	/** Get eigenvectors. The eigenvectors are stored successively in
 	 *  memory, with the eigenvector corresponding to the smallest
 	 *  eigenvalue occupying the 'basisSize' first positions, the second
 	 *  occupying the next 'basisSize' elements, and so forth, where
 	 *  'basisSize' is the basis size of the Model. Same as
-	 *  getEigenVectors(), but with write access. Use with caution.
+	 *  getEigenVectors(), but with write access. Use with caution. If the
+	 *  eigenvectors are kept real, they are converted to complex numbers
+	 *  and the real eigenvectors are released.
 	 *
 	 *  @return A pointer to the internal storage for the eigenvectors. **/
 	CArray<std::complex<double>>& getEigenVectorsRW();
@@ -150,11 +283,38 @@ private:
 	/** pointer to array containing Hamiltonian. */
 	CArray<std::complex<double>> hamiltonian;
 
+	/** Array containing the Hamiltonian when it is real. */
+	CArray<double> realHamiltonian;
+
 	/** Pointer to array containing eigenvalues.*/
 	CArray<double> eigenValues;
 
-	/** Pointer to array containing eigenvectors. */
-	CArray<std::complex<double>> eigenVectors;
+	/** Pointer to array containing eigenvectors. When the eigenvectors
+	 *  are real, this is a complex copy that is created on request by
+	 *  getEigenVectors(). */
+	mutable CArray<std::complex<double>> eigenVectors;
+
+	/** Array containing the eigenvectors when they are real. */
+	CArray<double> realEigenVectors;
+
+	/** Flag indicating whether to use real arithmetic when possible. */
+	bool useRealArithmetic;
+
+	/** Flag indicating whether the current Hamiltonian is stored in
+	 *  realHamiltonian. */
+	bool hamiltonianIsReal;
+
+	/** Flag indicating whether the eigenvectors are stored in
+	 *  realEigenVectors. */
+	bool eigenVectorsAreReal;
+
+	/** Flag indicating whether to keep real eigenvectors real after the
+	 *  diagonalization. */
+	bool keepRealEigenVectors;
+
+	/** Mutex protecting the creation of the complex copy of real
+	 *  eigenvectors in getEigenVectors(). */
+	mutable std::mutex eigenVectorsMutex;
 
 	/** Pointer to array containing the basis transformation. Only used for
 	 *  non-orthonormal bases.*/
@@ -167,6 +327,25 @@ private:
 	 *  been completed. */
 	SelfConsistencyCallback *selfConsistencyCallback;
 
+	/** Algorithm used for the diagonalization. */
+	Algorithm algorithm;
+
+	/** Enum class for specifying which eigenstates to calculate. */
+	enum class SpectrumRange{AllStates, StateRange, EnergyRange};
+
+	/** The eigenstates to calculate. */
+	SpectrumRange spectrumRange;
+
+	/** First and last state to calculate when spectrumRange is
+	 *  SpectrumRange::StateRange. */
+	unsigned int firstState;
+	unsigned int lastState;
+
+	/** Energy interval to calculate the eigenstates for when
+	 *  spectrumRange is SpectrumRange::EnergyRange. */
+	double lowerEnergy;
+	double upperEnergy;
+
 	/** Allocates space for Hamiltonian etc. */
 	void init();
 
@@ -176,6 +355,50 @@ private:
 	/** Diagonalizes the Hamiltonian. */
 	void solve();
 
+	/** Diagonalizes the Hamiltonian using zhpev. */
+	void solvePackedQR();
+
+	/** Diagonalizes the Hamiltonian using zheevd. */
+	void solveDivideAndConquer();
+
+	/** Diagonalizes the Hamiltonian using zheevr. */
+	void solveMRRR();
+
+	/** Diagonalizes the real Hamiltonian using dspev. */
+	void solvePackedQRReal();
+
+	/** Diagonalizes the real Hamiltonian using dsyevd. */
+	void solveDivideAndConquerReal();
+
+	/** Diagonalizes the real Hamiltonian using dsyevr. */
+	void solveMRRRReal();
+
+	/** Get the LAPACK range argument corresponding to the spectrum range.
+	 *
+	 *  @return 'A', 'I', or 'V' for all states, a state range, or an
+	 *  energy range, respectively. */
+	char getLapackRange() const;
+
+	/** Copy the upper triangular part of a packed Hamiltonian to a matrix
+	 *  on full column major format.
+	 *
+	 *  @param packedHamiltonian The Hamiltonian on packed format.
+	 *  @param matrix Array with basisSize*basisSize elements to write the
+	 *  Hamiltonian to. The lower triangular part is not written to. */
+	template<typename DataType>
+	void unpackHamiltonian(
+		const CArray<DataType> &packedHamiltonian,
+		DataType *matrix
+	) const;
+
+	/** Fill eigenVectors with a complex copy of the real eigenvectors
+	 *  unless this already has been done. */
+	void copyEigenVectorsToComplex() const;
+
+	/** Convert real eigenvectors to complex eigenvectors and release the
+	 *  real eigenvectors. */
+	void convertEigenVectorsToComplex();
+
 	/** Setup the basis transformation. */
 	void setupBasisTransformation();
 
@@ -196,6 +419,74 @@ inline void Diagonalizer::setMaxIterations(int maxIterations){
 	this->maxIterations = maxIterations;
 }
 
+inline void Diagonalizer::setAlgorithm(Algorithm algorithm){
+	this->algorithm = algorithm;
+}
+
+inline Diagonalizer::Algorithm Diagonalizer::getAlgorithm() const{
+	return algorithm;
+}
+
+inline void Diagonalizer::setStateRange(unsigned int first, unsigned int last){
+	TBTKAssert(
+		first <= last,
+		"Solver::Diagonalizer::setStateRange()",
+		"Invalid state range [" << first << ", " << last << "]. The"
+		<< " first state cannot be larger than the last state.",
+		""
+	);
+
+	spectrumRange = SpectrumRange::StateRange;
+	firstState = first;
+	lastState = last;
+}
+
+inline void Diagonalizer::setEnergyRange(double lower, double upper){
+	TBTKAssert(
+		lower < upper,
+		"Solver::Diagonalizer::setEnergyRange()",
+		"Invalid energy range (" << lower << ", " << upper << "]. The"
+		<< " lower bound must be smaller than the upper bound.",
+		""
+	);
+
+	spectrumRange = SpectrumRange::EnergyRange;
+	lowerEnergy = lower;
+	upperEnergy = upper;
+}
+
+inline void Diagonalizer::setCalculateAllStates(){
+	spectrumRange = SpectrumRange::AllStates;
+}
+
+inline void Diagonalizer::setUseRealArithmetic(bool useRealArithmetic){
+	this->useRealArithmetic = useRealArithmetic;
+}
+
+inline bool Diagonalizer::getUseRealArithmetic() const{
+	return useRealArithmetic;
+}
+
+inline void Diagonalizer::setKeepRealEigenVectors(bool keepRealEigenVectors){
+	this->keepRealEigenVectors = keepRealEigenVectors;
+}
+
+inline bool Diagonalizer::getKeepRealEigenVectors() const{
+	return keepRealEigenVectors;
+}
+
+inline bool Diagonalizer::getEigenVectorsAreReal() const{
+	return eigenVectorsAreReal;
+}
+
+inline bool Diagonalizer::getHamiltonianIsReal() const{
+	return hamiltonianIsReal;
+}
+
+inline unsigned int Diagonalizer::getNumStates() const{
+	return eigenValues.getSize();
+}
+
 inline const CArray<double>& Diagonalizer::getEigenValues() const{
 	return eigenValues;
 }
@@ -205,10 +496,27 @@ inline CArray<double>& Diagonalizer::getEigenValuesRW(){
 }
 
 inline const CArray<std::complex<double>>& Diagonalizer::getEigenVectors() const{
+	if(eigenVectorsAreReal)
+		copyEigenVectorsToComplex();
+
 	return eigenVectors;
 }
 
+inline const CArray<double>& Diagonalizer::getRealEigenVectors() const{
+	TBTKAssert(
+		eigenVectorsAreReal,
+		"Solver::Diagonalizer::getRealEigenVectors()",
+		"The eigenvectors are not stored as real numbers.",
+		"Use Diagonalizer::getEigenVectors() instead."
+	);
+
+	return realEigenVectors;
+}
+
 inline CArray<std::complex<double>>& Diagonalizer::getEigenVectorsRW(){
+	if(eigenVectorsAreReal)
+		convertEigenVectorsToComplex();
+
 	return eigenVectors;
 }
 
@@ -217,13 +525,34 @@ inline const std::complex<double> Diagonalizer::getAmplitude(
 	const Index &index
 ) const{
 	const Model &model = getModel();
-	return eigenVectors[model.getBasisSize()*state + model.getBasisIndex(index)];
+	if(eigenVectorsAreReal){
+		return realEigenVectors[
+			model.getBasisSize()*state + model.getBasisIndex(index)
+		];
+	}
+	else{
+		return eigenVectors[
+			model.getBasisSize()*state + model.getBasisIndex(index)
+		];
+	}
 }
 
 inline const double Diagonalizer::getEigenValue(int state) const{
 	return eigenValues[state];
 }
 
+template<typename DataType>
+inline void Diagonalizer::unpackHamiltonian(
+	const CArray<DataType> &packedHamiltonian,
+	DataType *matrix
+) const{
+	int basisSize = getModel().getBasisSize();
+	for(int col = 0; col < basisSize; col++)
+		for(int row = 0; row <= col; row++)
+			matrix[row + basisSize*col]
+				= packedHamiltonian[row + (col*(col+1))/2];
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
 
@@ -24,6 +24,7 @@
 #ifndef COM_DAFER45_TBTK_SOLVER_FLEX
 #define COM_DAFER45_TBTK_SOLVER_FLEX
 
+#include "TBTK/Math/Mixer.h"
 #include "TBTK/MomentumSpaceContext.h"
 #include "TBTK/Property/GreensFunction.h"
 #include "TBTK/Property/Susceptibility.h"
@@ -31,6 +32,8 @@
 #include "TBTK/Property/SelfEnergy.h"
 #include "TBTK/Solver/Solver.h"
 
+#include <chrono>
+
 namespace TBTK{
 namespace Solver{
 
@@ -51,6 +54,17 @@ public:
 	 *  convergence parameter. */
 	enum class Norm{Max, L2};
 
+	/** Enum class for specifying a stage of the calculation. Used to
+	 *  query the time spent in the different stages. */
+	enum class Stage {
+		BareGreensFunction,
+		BareSusceptibility,
+		RPASusceptibilities,
+		InteractionVertex,
+		SelfEnergy,
+		GreensFunction
+	};
+
 	/** Constructor. */
 	FLEX(const MomentumSpaceContext &momentumSpaceContext);
 
@@ -99,6 +113,34 @@ public:
 	 *  SelfEnergy. */
 	void setSelfEnergyMixingParameter(double selfEnergyMixingParameter);
 
+	/** Set the method used to mix the new SelfEnergy with the SelfEnergy
+	 *  from previous iterations. The default method is
+	 *  Math::Mixer::Method::Linear. For the Anderson and Broyden methods,
+	 *  one minus the SelfEnergy mixing parameter is used as the fraction
+	 *  of the residual that is added in a linear step, and
+	 *  setMixingHistorySize() determines the number of previous
+	 *  iterations that are used.
+	 *
+	 *  @param mixingMethod The mixing method. */
+	void setMixingMethod(
+		Math::Mixer<std::complex<double>>::Method mixingMethod
+	);
+
+	/** Set the number of previous iterations that are used by the
+	 *  Anderson and Broyden mixing methods. The default value is five.
+	 *
+	 *  @param mixingHistorySize The number of previous iterations to
+	 *  use. */
+	void setMixingHistorySize(unsigned int mixingHistorySize);
+
+	/** Get the norm of the difference between the newly calculated
+	 *  SelfEnergy and the SelfEnergy that was used as input, for each
+	 *  iteration of the current call to run(). Can be used in the
+	 *  callback to monitor the convergence.
+	 *
+	 *  @return The residual norms. */
+	const std::vector<double>& getResidualNormHistory() const;
+
 	/** Set the energy window used for the calculation.
 	 *
 	 *  @param lowerFermionicMatsubaraEnergyIndex The lower Fermionic
@@ -212,6 +254,30 @@ public:
 	 *  @param numSlices The number of slices to use. */
 	void setNumSlices(unsigned int numSlices);
 
+	/** Set whether the slices should be pipelined. If enabled, the bare
+	 *  susceptibility for the next slice is calculated in a separate
+	 *  thread while the RPA susceptibilities, interaction vertex, and
+	 *  self-energy are calculated for the current slice. This requires
+	 *  memory for one additional bare susceptibility slice. The
+	 *  callback is still called from the calling thread, in the same
+	 *  order as without pipelining. Since the callback is allowed to
+	 *  modify the solver, the calculation for the next slice is completed
+	 *  before the callback is called, which means that the overlap is
+	 *  limited to the RPA susceptibilities when a callback is set.
+	 *  Disabled by default.
+	 *
+	 *  @param slicePipelining True to enable pipelining. */
+	void setSlicePipelining(bool slicePipelining);
+
+	/** Get the wall-clock time spent in a given stage during the last
+	 *  call to run(). When the slices are pipelined, the time spent on
+	 *  the bare susceptibility overlaps with the other stages.
+	 *
+	 *  @param stage The stage.
+	 *
+	 *  @return The time in seconds. */
+	double getStageTime(Stage stage) const;
+
 	/** Execute the FLEX loop. */
 	void run();
 private:
@@ -249,6 +315,9 @@ private:
 	 *  should be mixed into the new SelfEnergy.*/
 	double selfEnergyMixingParameter;
 
+	/** Mixer used to generate the SelfEnergy for the next iteration. */
+	Math::Mixer<std::complex<double>> selfEnergyMixer;
+
 	/** Density. */
 	double density;
 
@@ -312,11 +381,35 @@ private:
 	/** Callback that is called after each step in the loop. */
 	void (*callback)(FLEX &solver);
 
+	/** Flag indicating whether the slices are pipelined. */
+	bool slicePipelining;
+
+	/** Time spent in each stage during the last run, indexed by Stage. */
+	std::vector<double> stageTimes;
+
+	/** Add the time elapsed since a given start time to the time spent
+	 *  in a given stage.
+	 *
+	 *  @param stage The stage.
+	 *  @param start The start time. */
+	void addStageTime(
+		Stage stage,
+		const std::chrono::steady_clock::time_point &start
+	);
+
 	/** Calculate the bare Green's function. */
 	void calculateBareGreensFunction();
 
-	/** Calculate the bare susceptibility. */
-	void calculateBareSusceptibility(unsigned int slice);
+	/** Calculate the bare susceptibility. Only reads the Green's
+	 *  function and parameters, which allows it to be executed
+	 *  concurrently with the later stages for the previous slice.
+	 *
+	 *  @param slice The slice to calculate the bare susceptibility for.
+	 *
+	 *  @return The bare susceptibility for the given slice. */
+	Property::Susceptibility calculateBareSusceptibility(
+		unsigned int slice
+	);
 
 	/** Calculate the bare susceptibility. */
 	void calculateRPASusceptibilities();
@@ -415,6 +508,20 @@ inline void FLEX::setSelfEnergyMixingParameter(
 	this->selfEnergyMixingParameter = selfEnergyMixingParameter;
 }
 
+inline void FLEX::setMixingMethod(
+	Math::Mixer<std::complex<double>>::Method mixingMethod
+){
+	selfEnergyMixer.setMethod(mixingMethod);
+}
+
+inline void FLEX::setMixingHistorySize(unsigned int mixingHistorySize){
+	selfEnergyMixer.setHistorySize(mixingHistorySize);
+}
+
+inline const std::vector<double>& FLEX::getResidualNormHistory() const{
+	return selfEnergyMixer.getResidualNormHistory();
+}
+
 inline double FLEX::getDensity() const{
 	TBTKAssert(
 		targetDensity >= 0,
@@ -538,6 +645,14 @@ inline void FLEX::setNumSlices(unsigned int numSlices){
 	this->numSlices = numSlices;
 }
 
+inline void FLEX::setSlicePipelining(bool slicePipelining){
+	this->slicePipelining = slicePipelining;
+}
+
+inline double FLEX::getStageTime(Stage stage) const{
+	return stageTimes[static_cast<unsigned int>(stage)];
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
 
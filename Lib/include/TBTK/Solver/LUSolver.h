@@ -28,6 +28,7 @@
 #include "TBTK/SparseMatrix.h"
 
 #include <complex>
+#include <vector>
 
 #include "slu_zdefs.h"
 
@@ -78,6 +79,26 @@ public:
 	 *  @param b The vector \f$b\f$. Contains the answer \f$x\f$ when
 	 *  finished. */
 	void solve(Matrix<std::complex<double>> &b);
+
+	/** Solve for \f$x\f$ in the equation \f$Mx = b\f$ in place. Unlike
+	 *  solve(Matrix<double>&), the right hand side is passed to SuperLU
+	 *  without being copied, which makes this version suitable for
+	 *  iterative solvers that repeatedly solve against the same
+	 *  factorization.
+	 *
+	 *  @param b Pointer to an array with as many elements as the matrix
+	 *  has rows. Contains the answer \f$x\f$ when finished. */
+	void solve(double *b);
+
+	/** Solve for \f$x\f$ in the equation \f$Mx = b\f$ in place. Unlike
+	 *  solve(Matrix<std::complex<double>>&), the right hand side is passed
+	 *  to SuperLU without being copied if the matrix is complex. If the
+	 *  matrix is real, the real and imaginary parts are solved for
+	 *  simultaneously using an internal workspace.
+	 *
+	 *  @param b Pointer to an array with as many elements as the matrix
+	 *  has rows. Contains the answer \f$x\f$ when finished. */
+	void solve(std::complex<double> *b);
 private:
 	/** Pointer to lower triangular matrix. */
 	SuperMatrix *L;
@@ -97,6 +118,10 @@ private:
 	/** Get matrix data type. */
 	DataType matrixDataType;
 
+	/** Workspace used to solve for complex right hand sides when the
+	 *  matrix is real. */
+	std::vector<double> realWorkspace;
+
 	/** Allocate permutation matrices. */
 	void allocatePermutationMatrices(
 		unsigned int numRows,
@@ -0,0 +1,488 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file Lanczos.h
+ *  @brief Solves a Hermitian Model using thick-restart Lanczos iteration.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_SOLVER_LANCZOS
+#define COM_DAFER45_TBTK_SOLVER_LANCZOS
+
+#include "TBTK/CArray.h"
+#include "TBTK/Communicator.h"
+#include "TBTK/Math/ParallelSparseMatrix.h"
+#include "TBTK/Model.h"
+#include "TBTK/Solver/Solver.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace TBTK{
+namespace Solver{
+
+/** @brief Solves a Hermitian Model using thick-restart Lanczos iteration.
+ *
+ *  The Lanczos solver calculates a selected number of extremal eigenvalues
+ *  and eigenvectors of a Model. It is an alternative to the
+ *  Solver::ArnoldiIterator in the normal mode that exploits the fact that
+ *  the Hamiltonian is Hermitian and that does not depend on ARPACK. The
+ *  matrix-vector multiplications are performed directly on the
+ *  CompiledHoppingAmplitudes of the Model. Use the
+ *  PropertyExtractor::Lanczos to extract @link Property::AbstractProperty
+ *  Properties@endlink.
+ *
+ *  <b>Thick restart:</b><br />
+ *  A Krylov space with getNumLanczosVectors() vectors is built, after which
+ *  the Ritz pairs of the projected Hamiltonian are calculated. If the wanted
+ *  Ritz pairs have not converged, the Ritz vectors closest to the target are
+ *  kept together with the last Lanczos vector and the iteration continues
+ *  from there.
+ *
+ *  <b>Reorthogonalization:</b><br />
+ *  In the Full mode, every new Lanczos vector is orthogonalized against the
+ *  full basis using two passes of classical Gram-Schmidt. In the Selective
+ *  mode, new Lanczos vectors are only orthogonalized against the kept Ritz
+ *  vectors and the two most recent Lanczos vectors. The loss of
+ *  orthogonality against the rest of the basis is estimated using the
+ *  \f$\omega\f$-recurrence of Simon, and a full reorthogonalization is
+ *  performed for two consecutive steps whenever the estimate exceeds
+ *  \f$\sqrt{\epsilon}\f$. The Selective mode requires the block size to be
+ *  one.
+ *
+ *  <b>Block Lanczos:</b><br />
+ *  If the block size is larger than one, the Krylov space is expanded with
+ *  several vectors at the time. This allows for degenerate eigenvalues to
+ *  be resolved more reliably and lets the Hamiltonian be applied to all
+ *  vectors in the block in a single pass over memory. */
+class Lanczos : public Solver, public Communicator{
+	TBTK_DYNAMIC_TYPE_INFORMATION(Lanczos)
+public:
+	/** Constructs a Solver::Lanczos. */
+	Lanczos();
+
+	/** Enum class describing which part of the spectrum to calculate.
+	 *
+	 *  Lowest:
+	 *      Calculate the lowest eigenvalues.
+	 *
+	 *  Highest:
+	 *      Calculate the highest eigenvalues. */
+	enum class Target {Lowest, Highest};
+
+	/** Enum class describing the reorthogonalization strategy.
+	 *
+	 *  Full:
+	 *      Orthogonalize every new Lanczos vector against the full
+	 *      basis.
+	 *
+	 *  Selective:
+	 *      Orthogonalize against the kept Ritz vectors and the two most
+	 *      recent Lanczos vectors, and against the full basis only when
+	 *      the estimated loss of orthogonality becomes too large. */
+	enum class Reorthogonalization {Full, Selective};
+
+	/** Set the part of the spectrum to calculate.
+	 *
+	 *  @param target The part of the spectrum to calculate. */
+	void setTarget(Target target);
+
+	/** Get the part of the spectrum that is calculated.
+	 *
+	 *  @return The part of the spectrum that is calculated. */
+	Target getTarget() const;
+
+	/** Set the reorthogonalization strategy.
+	 *
+	 *  @param reorthogonalization The reorthogonalization strategy. */
+	void setReorthogonalization(Reorthogonalization reorthogonalization);
+
+	/** Get the reorthogonalization strategy.
+	 *
+	 *  @return The reorthogonalization strategy. */
+	Reorthogonalization getReorthogonalization() const;
+
+	/** Set the number of eigenvalues to calculate.
+	 *
+	 *  @param numEigenValues The number of eigenvalues to calculate. */
+	void setNumEigenValues(int numEigenValues);
+
+	/** Get number of eigenvalues.
+	 *
+	 *  @return The number of eigenvalues that are calculated. */
+	int getNumEigenValues() const;
+
+	/** Set whether eigen vectors should be calculated.
+	 *
+	 *  @param calculateEigenVectors True to enable the calculation of
+	 *  eigenvectors. */
+	void setCalculateEigenVectors(bool calculateEigenVectors);
+
+	/** Get wether eigen vectors are calculated or not.
+	 *
+	 *  @return True if eigenvectors are set to be calculated. */
+	bool getCalculateEigenVectors() const;
+
+	/** Set the number of Lanczos vectors to use. (Dimension of the Krylov
+	 *  space). If zero, the number of Lanczos vectors is chosen
+	 *  automatically based on the number of eigenvalues and the block
+	 *  size. The number is rounded down to a multiple of the block size.
+	 *
+	 *  @param numLanczosVectors The dimension of the Krylov space used. */
+	void setNumLanczosVectors(int numLanczosVectors);
+
+	/** Get the number of Lanczos vectors to use. (Dimension of the Krylov
+	 *  space).
+	 *
+	 *  @return The dimension of the Krylov space used. */
+	int getNumLanczosVectors() const;
+
+	/** Set the block size.
+	 *
+	 *  @param blockSize The number of vectors that the Krylov space is
+	 *  expanded with in each step. */
+	void setBlockSize(int blockSize);
+
+	/** Get the block size.
+	 *
+	 *  @return The number of vectors that the Krylov space is expanded
+	 *  with in each step. */
+	int getBlockSize() const;
+
+	/** Set the accepted tolerance. A Ritz pair is considered converged
+	 *  when the norm of its residual is smaller than the tolerance times
+	 *  the largest Ritz value in magnitude. The default value is 1e-10,
+	 *  and machine precision is used if tolerance <= 0.
+	 *
+	 *  @param tolerance The tolerance. */
+	void setTolerance(double tolerance);
+
+	/** Get the accepted tolerance.
+	 *
+	 *  @return The tolerance. */
+	double getTolerance() const;
+
+	/** Set the maximum number of restarts.
+	 *
+	 *  @param maxIterations The maximum number of restarts. */
+	void setMaxIterations(int maxIterations);
+
+	/** Get the maximum number of restarts.
+	 *
+	 *  @return The maximum number of restarts. */
+	int getMaxIterations() const;
+
+	/** Run the thick-restart Lanczos algorithm. */
+	void run();
+
+	/** Get the number of restarts that were needed in the last call to
+	 *  run().
+	 *
+	 *  @return The number of restarts. */
+	unsigned int getNumRestarts() const;
+
+	/** Get the number of calculated eigenstates.
+	 *
+	 *  @return The number of calculated eigenstates. */
+	unsigned int getNumStates() const;
+
+	/** Get the eigenvalues in accending order.
+	 *
+	 *  @return The eigenvalues. */
+	const CArray<double>& getEigenValues() const;
+
+	/** Get eigenvalue.
+	 *
+	 *  @param state The state number.
+	 *
+	 *  @return The eigenvalue for the given state. */
+	double getEigenValue(int state) const;
+
+	/** Get amplitude for given eigen vector \f$n\f$ and physical index
+	 *  \f$x\f$: \f$\Psi_{n}(x)\f$.
+	 *
+	 *  @param state Eigen state number \f$n\f$.
+	 *  @param index Physical index \f$x\f$.
+	 *
+	 *  @return The amplitude \f$\Psi_{n}(x)\f$. */
+	const std::complex<double> getAmplitude(
+		int state,
+		const Index &index
+	) const;
+private:
+	/** Part of the spectrum to calculate. */
+	Target target;
+
+	/** Reorthogonalization strategy. */
+	Reorthogonalization reorthogonalization;
+
+	/** Number of eigenvalues to calculate. */
+	int numEigenValues;
+
+	/** Flag indicating whether eigenvectors should be calculated. */
+	bool calculateEigenVectors;
+
+	/** Number of Lanczos vectors to use, i.e. the dimension of the Krylov
+	 *  space. */
+	int numLanczosVectors;
+
+	/** Block size. */
+	int blockSize;
+
+	/** Accepted tolerance. Machine tolerance is used if tolerance <= 0. */
+	double tolerance;
+
+	/** Maximum number of restarts. */
+	int maxIterations;
+
+	/** Number of restarts needed in the last run. */
+	unsigned int numRestarts;
+
+	/** Number of calculated eigenstates. */
+	unsigned int numStates;
+
+	/** Eigen values. */
+	CArray<double> eigenValues;
+
+	/** Eigen vectors. */
+	CArray<std::complex<double>> eigenVectors;
+
+	/** Hamiltonian. */
+	Math::ParallelSparseMatrix<std::complex<double>> hamiltonian;
+
+	/** Upper bound for the norm of the Hamiltonian, used as reference
+	 *  scale when detecting linearly dependent Lanczos vectors. */
+	double hamiltonianNorm;
+
+	/** Basis size. */
+	unsigned int basisSize;
+
+	/** Dimension of the Krylov space used in the current run. */
+	unsigned int krylovSize;
+
+	/** Lanczos vectors stored column by column. Contains krylovSize +
+	 *  blockSize vectors, where the last block holds the residual block
+	 *  that continues the iteration after a restart. */
+	std::vector<std::complex<double>> lanczosVectors;
+
+	/** Projected Hamiltonian stored column by column. Only the upper
+	 *  triangle is used. */
+	std::vector<std::complex<double>> projectedHamiltonian;
+
+	/** Coupling between the last block of Lanczos vectors and the
+	 *  residual block, stored column by column. */
+	std::vector<std::complex<double>> residualCoupling;
+
+	/** Random number generator used for starting vectors. */
+	std::mt19937_64 randomEngine;
+
+	/** Build the Hamiltonian from the CompiledHoppingAmplitudes. */
+	void setupHamiltonian();
+
+	/** Expand the Krylov space from numKeptVectors vectors to krylovSize
+	 *  vectors.
+	 *
+	 *  @param numKeptVectors The number of Ritz vectors kept at the last
+	 *  restart. */
+	void expand(unsigned int numKeptVectors);
+
+	/** Project the vectors in a block onto a set of Lanczos vectors and
+	 *  subtract the projections.
+	 *
+	 *  @param block Pointer to the first vector in the block.
+	 *  @param numVectors The number of vectors in the block.
+	 *  @param rows The Lanczos vectors to project onto.
+	 *  @param coefficients Output for the projection coefficients. The
+	 *  coefficient for the nth row and the cth vector is stored at
+	 *  n + rows.size()*c. */
+	void project(
+		std::complex<double> *block,
+		unsigned int numVectors,
+		const std::vector<unsigned int> &rows,
+		std::complex<double> *coefficients
+	) const;
+
+	/** Project the vectors in a block onto a set of Lanczos vectors twice
+	 *  and add the coefficients to the projected Hamiltonian.
+	 *
+	 *  @param block Pointer to the first vector in the block.
+	 *  @param rows The Lanczos vectors to project onto.
+	 *  @param column The column in the projected Hamiltonian that
+	 *  corresponds to the first vector in the block. */
+	void reorthogonalize(
+		std::complex<double> *block,
+		const std::vector<unsigned int> &rows,
+		unsigned int column
+	);
+
+	/** Orthonormalize a block of vectors against itself and store the
+	 *  result as the Lanczos vectors starting at the given position.
+	 *  Vectors that are linearly dependent are replaced by random
+	 *  vectors that are orthogonal to all Lanczos vectors before the
+	 *  given position.
+	 *
+	 *  @param block The block to orthonormalize.
+	 *  @param position The position of the first Lanczos vector to
+	 *  store.
+	 *  @param coupling Output for the upper triangular matrix that
+	 *  expresses the input block in terms of the new Lanczos vectors,
+	 *  stored column by column. */
+	void orthonormalize(
+		std::complex<double> *block,
+		unsigned int position,
+		std::complex<double> *coupling
+	);
+
+	/** Replace a vector by a normalized random vector that is orthogonal
+	 *  to the given number of Lanczos vectors.
+	 *
+	 *  @param vector The vector to replace.
+	 *  @param numVectors The number of Lanczos vectors to orthogonalize
+	 *  against. */
+	void randomize(std::complex<double> *vector, unsigned int numVectors);
+
+	/** Calculate the norm of a vector.
+	 *
+	 *  @param vector The vector.
+	 *
+	 *  @return The norm of the vector. */
+	double norm(const std::complex<double> *vector) const;
+
+	/** Diagonalize the projected Hamiltonian.
+	 *
+	 *  @param ritzValues Output for the Ritz values in accending order.
+	 *  @param ritzVectors Output for the eigenvectors of the projected
+	 *  Hamiltonian, stored column by column. */
+	void diagonalizeProjectedHamiltonian(
+		std::vector<double> &ritzValues,
+		std::vector<std::complex<double>> &ritzVectors
+	) const;
+
+	/** Calculate the Ritz vectors for the given Ritz states.
+	 *
+	 *  @param ritzVectors The eigenvectors of the projected Hamiltonian.
+	 *  @param states The Ritz states.
+	 *  @param result Output for the Ritz vectors, stored column by
+	 *  column. Is allowed to point to the Lanczos vectors. */
+	void calculateRitzVectors(
+		const std::vector<std::complex<double>> &ritzVectors,
+		const std::vector<unsigned int> &states,
+		std::complex<double> *result
+	) const;
+};
+
+inline void Lanczos::setTarget(Target target){
+	this->target = target;
+}
+
+inline Lanczos::Target Lanczos::getTarget() const{
+	return target;
+}
+
+inline void Lanczos::setReorthogonalization(
+	Reorthogonalization reorthogonalization
+){
+	this->reorthogonalization = reorthogonalization;
+}
+
+inline Lanczos::Reorthogonalization Lanczos::getReorthogonalization() const{
+	return reorthogonalization;
+}
+
+inline void Lanczos::setNumEigenValues(int numEigenValues){
+	this->numEigenValues = numEigenValues;
+}
+
+inline int Lanczos::getNumEigenValues() const{
+	return numEigenValues;
+}
+
+inline void Lanczos::setCalculateEigenVectors(bool calculateEigenVectors){
+	this->calculateEigenVectors = calculateEigenVectors;
+}
+
+inline bool Lanczos::getCalculateEigenVectors() const{
+	return calculateEigenVectors;
+}
+
+inline void Lanczos::setNumLanczosVectors(int numLanczosVectors){
+	this->numLanczosVectors = numLanczosVectors;
+}
+
+inline int Lanczos::getNumLanczosVectors() const{
+	return numLanczosVectors;
+}
+
+inline void Lanczos::setBlockSize(int blockSize){
+	TBTKAssert(
+		blockSize > 0,
+		"Solver::Lanczos::setBlockSize()",
+		"The block size must be positive.",
+		""
+	);
+	this->blockSize = blockSize;
+}
+
+inline int Lanczos::getBlockSize() const{
+	return blockSize;
+}
+
+inline void Lanczos::setTolerance(double tolerance){
+	this->tolerance = tolerance;
+}
+
+inline double Lanczos::getTolerance() const{
+	return tolerance;
+}
+
+inline void Lanczos::setMaxIterations(int maxIterations){
+	this->maxIterations = maxIterations;
+}
+
+inline int Lanczos::getMaxIterations() const{
+	return maxIterations;
+}
+
+inline unsigned int Lanczos::getNumRestarts() const{
+	return numRestarts;
+}
+
+inline unsigned int Lanczos::getNumStates() const{
+	return numStates;
+}
+
+inline const CArray<double>& Lanczos::getEigenValues() const{
+	return eigenValues;
+}
+
+inline double Lanczos::getEigenValue(int state) const{
+	return eigenValues[state];
+}
+
+inline const std::complex<double> Lanczos::getAmplitude(
+	int state,
+	const Index &index
+) const{
+	return eigenVectors[basisSize*state + getModel().getBasisIndex(index)];
+}
+
+};	//End of namespace Solver
+};	//End of namesapce TBTK
+
+#endif
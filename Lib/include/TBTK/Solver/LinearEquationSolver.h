@@ -24,9 +24,12 @@
 #define COM_DAFER45_TBTK_SOLVER_LINEAR_EQUATION_SOLVER
 
 #include "TBTK/Communicator.h"
+#include "TBTK/Math/ParallelSparseMatrix.h"
 #include "TBTK/Matrix.h"
 #include "TBTK/Model.h"
+#include "TBTK/Range.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/SparseMatrix.h"
 
 #include <complex>
 #include <vector>
@@ -34,6 +37,44 @@
 namespace TBTK{
 namespace Solver{
 
+/** @brief Solves Hx = y for x, where H is given by the Model.
+ *
+ *  The LinearEquationSolver solves the linear equation \f$Hx = y\f$, where
+ *  \f$H\f$ is given by the @link HoppingAmplitude HoppingAmplitudes@endlink
+ *  and \f$y\f$ by the @link SourceAmplitude SourceAmplitudes@endlink of the
+ *  Model.
+ *
+ *  <b>Direct solution:</b><br />
+ *  In the LU mode, the matrix is factorized using the LUSolver. This is
+ *  robust, but the fill-in of the factors makes it infeasible for large
+ *  three-dimensional Models. The LU mode is only available if TBTK has been
+ *  built with SuperLU, while the remaining modes are always available.
+ *
+ *  <b>Iterative solution:</b><br />
+ *  In the COCG, GMRES, and BiCGStab modes, the equation is instead solved
+ *  using a Krylov subspace method that only requires matrix-vector
+ *  multiplications with the sparse matrix. The iteration stops when the
+ *  norm of the residual is smaller than the tolerance times the norm of
+ *  \f$y\f$. The COCG method is the conjugate gradient method for complex
+ *  symmetric matrices (\f$H^T = H\f$), which for a Hermitian Hamiltonian
+ *  means that it has to be real. GMRES and BiCGStab work for general
+ *  matrices. The convergence can be accelerated by a Jacobi or ILU(0)
+ *  preconditioner.
+ *
+ *  <b>Multi-shift solution:</b><br />
+ *  In the MultiShift mode, the equations
+ *  <br/>
+ *  <center>\f$(E_n + i\delta - H)x_n = y\f$</center>
+ *  <br/>
+ *  are solved simultaneously for all energies \f$E_n\f$ in the energy
+ *  window, where \f$\delta\f$ is the energy infinitesimal. The Krylov
+ *  space is shift invariant, which means that a single Lanczos sweep is
+ *  shared by all energies, while the solutions are updated through short
+ *  recurrences. The cost is therefore approximately that of a single
+ *  solve, plus two vectors per energy. For a source on a single site, the
+ *  solution \f$x_n\f$ is a column of the retarded Green's function at
+ *  energy \f$E_n\f$. The MultiShift mode requires a Hermitian Hamiltonian
+ *  and does not use preconditioning. */
 class LinearEquationSolver : public Solver, public Communicator{
 	TBTK_DYNAMIC_TYPE_INFORMATION(LinearEquationSolver)
 public:
@@ -43,25 +84,344 @@ public:
 	/** Destructor. */
 	virtual ~LinearEquationSolver();
 
+	/** Enum class describing the different modes of operation.
+	 *
+	 *  LU:
+	 *      Factorize the matrix using the LUSolver. Requires SuperLU.
+	 *
+	 *  COCG:
+	 *      Conjugate orthogonal conjugate gradient method for complex
+	 *      symmetric matrices.
+	 *
+	 *  GMRES:
+	 *      Restarted generalized minimal residual method.
+	 *
+	 *  BiCGStab:
+	 *      Stabilized biconjugate gradient method.
+	 *
+	 *  MultiShift:
+	 *      Solve \f$(E_n + i\delta - H)x_n = y\f$ for all energies in
+	 *      the energy window using a single Krylov sweep. */
+	enum class Mode{LU, COCG, GMRES, BiCGStab, MultiShift};
+
+	/** Enum class describing the preconditioners for the iterative
+	 *  modes.
+	 *
+	 *  None:
+	 *      No preconditioning.
+	 *
+	 *  Jacobi:
+	 *      Divide by the diagonal of the matrix.
+	 *
+	 *  ILU:
+	 *      Incomplete LU factorization with the same sparsity pattern
+	 *      as the matrix (ILU(0)). */
+	enum class Preconditioner{None, Jacobi, ILU};
+
+	/** Set mode of operation.
+	 *
+	 *  @param mode The mode of operation to use. */
+	void setMode(Mode mode);
+
+	/** Get mode of operation.
+	 *
+	 *  @return The mode of operation. */
+	Mode getMode() const;
+
+	/** Set the preconditioner to use in the COCG, GMRES, and BiCGStab
+	 *  modes.
+	 *
+	 *  @param preconditioner The preconditioner. */
+	void setPreconditioner(Preconditioner preconditioner);
+
+	/** Get the preconditioner.
+	 *
+	 *  @return The preconditioner. */
+	Preconditioner getPreconditioner() const;
+
+	/** Set the tolerance for the iterative modes. The iteration stops when
+	 *  the norm of the residual is smaller than the tolerance times the
+	 *  norm of the right hand side. The default value is 1e-10.
+	 *
+	 *  @param tolerance The relative tolerance. */
+	void setTolerance(double tolerance);
+
+	/** Get the tolerance for the iterative modes.
+	 *
+	 *  @return The relative tolerance. */
+	double getTolerance() const;
+
+	/** Set the maximum number of iterations for the iterative modes. The
+	 *  default value is 1000.
+	 *
+	 *  @param maxIterations The maximum number of iterations. */
+	void setMaxIterations(unsigned int maxIterations);
+
+	/** Get the maximum number of iterations for the iterative modes.
+	 *
+	 *  @return The maximum number of iterations. */
+	unsigned int getMaxIterations() const;
+
+	/** Set the number of iterations after which GMRES is restarted. The
+	 *  default value is 30.
+	 *
+	 *  @param restartLength The dimension of the Krylov space that is
+	 *  built before GMRES is restarted. */
+	void setRestartLength(unsigned int restartLength);
+
+	/** Get the number of iterations after which GMRES is restarted.
+	 *
+	 *  @return The dimension of the Krylov space that is built before
+	 *  GMRES is restarted. */
+	unsigned int getRestartLength() const;
+
+	/** Set the energy window for the MultiShift mode.
+	 *
+	 *  @param energyWindow The energies \f$E_n\f$. */
+	void setEnergyWindow(const Range &energyWindow);
+
+	/** Get the energy window for the MultiShift mode.
+	 *
+	 *  @return The energies \f$E_n\f$. */
+	const Range& getEnergyWindow() const;
+
+	/** Set the energy infinitesimal \f$\delta\f$ for the MultiShift
+	 *  mode. Must be positive.
+	 *
+	 *  @param energyInfinitesimal The energy infinitesimal. */
+	void setEnergyInfinitesimal(double energyInfinitesimal);
+
+	/** Get the energy infinitesimal \f$\delta\f$ for the MultiShift
+	 *  mode.
+	 *
+	 *  @return The energy infinitesimal. */
+	double getEnergyInfinitesimal() const;
+
 	/** Run calculation. */
 	void run();
 
+	/** Get the number of iterations performed in the last call to run().
+	 *  Zero in the LU mode.
+	 *
+	 *  @return The number of iterations. */
+	unsigned int getNumIterations() const;
+
 	/** Get amplitude for given Index. */
 	const std::complex<double> getAmplitude(const Index &index) const;
 
-	/** Get result. */
+	/** Get amplitude for given Index and energy in the MultiShift mode.
+	 *
+	 *  @param index The Index.
+	 *  @param energy The energy index \f$n\f$ in the energy window.
+	 *
+	 *  @return The amplitude of \f$x_n\f$ for the given Index. */
+	const std::complex<double> getAmplitude(
+		const Index &index,
+		unsigned int energy
+	) const;
+
+	/** Get result. In the MultiShift mode, the nth column is the solution
+	 *  for the nth energy. */
 	const Matrix<std::complex<double>>& getResult() const;
 private:
-	/** The right hand side of the equation. */
+	/** The right hand side of the equation. Overwritten by the
+	 *  result. */
 	Matrix<std::complex<double>> source;
+
+	/** Mode of operation. */
+	Mode mode;
+
+	/** Preconditioner. */
+	Preconditioner preconditioner;
+
+	/** Relative tolerance for the iterative modes. */
+	double tolerance;
+
+	/** Maximum number of iterations for the iterative modes. */
+	unsigned int maxIterations;
+
+	/** Restart length for GMRES. */
+	unsigned int restartLength;
+
+	/** Energy window for the MultiShift mode. */
+	Range energyWindow;
+
+	/** Flag indicating whether the energy window has been set. */
+	bool energyWindowIsSet;
+
+	/** Energy infinitesimal for the MultiShift mode. */
+	double energyInfinitesimal;
+
+	/** Number of iterations performed in the last run. */
+	unsigned int numIterations;
+
+	/** The matrix on the CSR format. Used to setup the
+	 *  preconditioners. */
+	SparseMatrix<std::complex<double>> matrix;
+
+	/** The matrix used for matrix-vector multiplication. */
+	Math::ParallelSparseMatrix<std::complex<double>> parallelMatrix;
+
+	/** Inverse of the diagonal for the Jacobi preconditioner. */
+	std::vector<std::complex<double>> inverseDiagonal;
+
+	/** Values of the ILU(0) factors, stored with the same sparsity
+	 *  pattern as the matrix. The unit diagonal of L is implicit. */
+	std::vector<std::complex<double>> iluValues;
+
+	/** Position of the diagonal element for every row of the ILU(0)
+	 *  factors. */
+	std::vector<unsigned int> iluDiagonalPositions;
+
+	/** Solve using the LUSolver. */
+	void solveLU();
+
+	/** Setup the sparse matrix and the preconditioner for the iterative
+	 *  modes. */
+	void setupIterativeSolver();
+
+	/** Setup the ILU(0) preconditioner. */
+	void setupILU();
+
+	/** Apply the preconditioner.
+	 *
+	 *  @param in The vector to apply the preconditioner to.
+	 *  @param out Output vector. */
+	void applyPreconditioner(
+		const std::complex<double> *in,
+		std::complex<double> *out
+	) const;
+
+	/** Check whether the matrix is complex symmetric.
+	 *
+	 *  @return True if the matrix is equal to its transpose. */
+	bool isComplexSymmetric() const;
+
+	/** Solve using the COCG method.
+	 *
+	 *  @param b The right hand side.
+	 *  @param x Output for the solution. */
+	void solveCOCG(
+		const std::vector<std::complex<double>> &b,
+		std::vector<std::complex<double>> &x
+	);
+
+	/** Solve using the restarted GMRES method.
+	 *
+	 *  @param b The right hand side.
+	 *  @param x Output for the solution. */
+	void solveGMRES(
+		const std::vector<std::complex<double>> &b,
+		std::vector<std::complex<double>> &x
+	);
+
+	/** Solve using the BiCGStab method.
+	 *
+	 *  @param b The right hand side.
+	 *  @param x Output for the solution. */
+	void solveBiCGStab(
+		const std::vector<std::complex<double>> &b,
+		std::vector<std::complex<double>> &x
+	);
+
+	/** Solve for all energies in the energy window using a shifted
+	 *  Lanczos iteration.
+	 *
+	 *  @param b The right hand side. */
+	void solveMultiShift(const std::vector<std::complex<double>> &b);
+
+	/** Check that the maximum number of iterations has not been
+	 *  exceeded.
+	 *
+	 *  @param functionName The name of the calling function. */
+	void checkNumIterations(const std::string &functionName) const;
 };
 
+inline void LinearEquationSolver::setMode(Mode mode){
+	this->mode = mode;
+}
+
+inline LinearEquationSolver::Mode LinearEquationSolver::getMode() const{
+	return mode;
+}
+
+inline void LinearEquationSolver::setPreconditioner(
+	Preconditioner preconditioner
+){
+	this->preconditioner = preconditioner;
+}
+
+inline LinearEquationSolver::Preconditioner
+LinearEquationSolver::getPreconditioner() const{
+	return preconditioner;
+}
+
+inline void LinearEquationSolver::setTolerance(double tolerance){
+	this->tolerance = tolerance;
+}
+
+inline double LinearEquationSolver::getTolerance() const{
+	return tolerance;
+}
+
+inline void LinearEquationSolver::setMaxIterations(unsigned int maxIterations){
+	this->maxIterations = maxIterations;
+}
+
+inline unsigned int LinearEquationSolver::getMaxIterations() const{
+	return maxIterations;
+}
+
+inline void LinearEquationSolver::setRestartLength(unsigned int restartLength){
+	TBTKAssert(
+		restartLength > 0,
+		"Solver::LinearEquationSolver::setRestartLength()",
+		"The restart length must be positive.",
+		""
+	);
+	this->restartLength = restartLength;
+}
+
+inline unsigned int LinearEquationSolver::getRestartLength() const{
+	return restartLength;
+}
+
+inline void LinearEquationSolver::setEnergyWindow(const Range &energyWindow){
+	this->energyWindow = energyWindow;
+	energyWindowIsSet = true;
+}
+
+inline const Range& LinearEquationSolver::getEnergyWindow() const{
+	return energyWindow;
+}
+
+inline void LinearEquationSolver::setEnergyInfinitesimal(
+	double energyInfinitesimal
+){
+	this->energyInfinitesimal = energyInfinitesimal;
+}
+
+inline double LinearEquationSolver::getEnergyInfinitesimal() const{
+	return energyInfinitesimal;
+}
+
+inline unsigned int LinearEquationSolver::getNumIterations() const{
+	return numIterations;
+}
+
 inline const std::complex<double> LinearEquationSolver::getAmplitude(
 	const Index &index
 ) const{
 	return source.at(getModel().getBasisIndex(index), 0);
 }
 
+inline const std::complex<double> LinearEquationSolver::getAmplitude(
+	const Index &index,
+	unsigned int energy
+) const{
+	return source.at(getModel().getBasisIndex(index), energy);
+}
+
 inline const Matrix<std::complex<double>>& LinearEquationSolver::getResult() const{
 	return source;
 }
@@ -80,12 +80,6 @@ private:
 	/** MomentumSpaceContext. */
 	const MomentumSpaceContext &momentumSpaceContext;
 
-	/** Invert matix. */
-	void invertMatrix(
-		std::complex<double> *matrix,
-		unsigned int dimensions
-	);
-
 	/** RPA-susceptibility main algorithm. */
 	std::vector<std::vector<std::vector<
 		std::vector<std::vector<std::complex<double>>>
@@ -24,6 +24,7 @@
 #ifndef COM_DAFER45_TBTK_TIME_EVOLVER
 #define COM_DAFER45_TBTK_TIME_EVOLVER
 
+#include "TBTK/Math/ParallelSparseMatrix.h"
 #include "TBTK/Solver/Diagonalizer.h"
 #include "TBTK/Model.h"
 #include "TBTK/UnitHandler.h"
@@ -62,6 +63,83 @@ public:
 	/** Set length of time step used for time evolution. */
 	void setTimeStep(double dt);
 
+	/** Propagators:
+	 *	Euler - First order explicit Euler step
+	 *		\f$\Psi(t+dt) = (1 - iHdt/\hbar)\Psi(t)\f$ followed by
+	 *		renormalization of the states. Requires a small time
+	 *		step to remain accurate.
+	 *	Chebyshev - Expands the propagator \f$e^{-iHdt/\hbar}\f$ in
+	 *		Chebyshev polynomials of the sparse Hamiltonian and
+	 *		applies it to all states simultaneously. The expansion
+	 *		is truncated once the expansion coefficients fall below
+	 *		the propagator tolerance, which allows for time steps
+	 *		that are much larger than for the Euler propagator. The
+	 *		number of terms grows linearly with the time step and
+	 *		the bandwidth of the Hamiltonian.
+	 */
+	enum class Propagator{Euler, Chebyshev};
+
+	/** Set the propagator used for the time stepping. The default value
+	 *  is Propagator::Chebyshev. */
+	void setPropagator(Propagator propagator);
+
+	/** Get the propagator used for the time stepping. */
+	Propagator getPropagator() const;
+
+	/** Set the tolerance for the Chebyshev propagator. The Chebyshev
+	 *  expansion is truncated when the expansion coefficients become
+	 *  smaller than the tolerance. The default value is 1e-12. */
+	void setPropagatorTolerance(double propagatorTolerance);
+
+	/** Get the tolerance for the Chebyshev propagator. */
+	double getPropagatorTolerance() const;
+
+	/** Get the number of Chebyshev polynomials used in the last time
+	 *  step. Zero if the Euler propagator is used. */
+	unsigned int getNumChebyshevTerms() const;
+
+	/** Time dependence \f$f(t)\f$ of a driving term \f$f(t)V\f$. */
+	class DrivingFunction{
+	public:
+		/** Get the value of the driving function.
+		 *
+		 *  @param time The time in natural units.
+		 *
+		 *  @return The value of \f$f(t)\f$. */
+		virtual std::complex<double> getValue(double time) const = 0;
+	};
+
+	/** Add a driving term \f$f(t)V\f$ to the Hamiltonian, such that the
+	 *  Hamiltonian becomes \f$H(t) = H_0 + \sum_k f_k(t)V_k\f$, where
+	 *  \f$H_0\f$ is the Hamiltonian of the Model. The driving terms are
+	 *  compiled once when the time evolution starts, after which each
+	 *  time step only requires the driving functions to be evaluated and
+	 *  the affected matrix elements to be updated. This is more efficient
+	 *  than letting HoppingAmplitude::AmplitudeCallbacks in the Model
+	 *  provide the time dependence. The Chebyshev propagator evaluates the
+	 *  driving functions at the middle of each time step, while the Euler
+	 *  propagator evaluates them at the beginning of each time step. The
+	 *  driving terms do not affect the initial state, which is determined
+	 *  by \f$H_0\f$ alone.
+	 *
+	 *  @param hoppingAmplitudes The HoppingAmplitudes that make up
+	 *  \f$V\f$. The Indices must be part of the Model's basis, and
+	 *  Hermitian conjugates are not added automatically. A
+	 *  HoppingAmplitude and its Hermitian conjugate can therefore be given
+	 *  complex conjugated driving functions, which for example allows for
+	 *  a time dependent Peierls phase.
+	 *
+	 *  @param drivingFunction The DrivingFunction \f$f(t)\f$. The
+	 *  TimeEvolver stores a reference to the DrivingFunction, which
+	 *  therefore has to remain alive during the time evolution. */
+	void addDrivingTerm(
+		const std::vector<HoppingAmplitude> &hoppingAmplitudes,
+		const DrivingFunction &drivingFunction
+	);
+
+	/** Remove all driving terms. */
+	void clearDrivingTerms();
+
 	/** Set number of particles.
 	 *
 	 *  @param Number of occupied particles. If set to a negative number,
@@ -78,6 +156,52 @@ public:
 	 *  the same throughout the calculation. */
 	void fixParticleNumber(bool particleNumberIsFixed);
 
+	/** Set whether to only evolve the occupied subspace. When the number
+	 *  of particles is fixed, only the states below the Fermi level
+	 *  contribute to the observables, and the remaining states can be
+	 *  left out of the time evolution. If set to true, only the
+	 *  numberOfParticles + occupiedSubspaceMargin lowest eigenstates are
+	 *  calculated by the Diagonalizer (using
+	 *  Diagonalizer::Algorithm::MRRR) and evolved in time. The
+	 *  Diagonalizer's previous algorithm and full spectrum are restored
+	 *  the next time run() is called with this option disabled. This reduces
+	 *  the memory required for the eigenvectors and the cost of each time
+	 *  step by a factor numberOfParticles/basisSize. The state numbers
+	 *  passed to getOccupancy(), getEigenValue(), and getAmplitude() then
+	 *  run over the evolved states only. Requires the number of particles
+	 *  to be set using setNumberOfParticles() and to be fixed. The default
+	 *  value is false.
+	 *
+	 *  @param evolveOccupiedSubspace Whether to only evolve the occupied
+	 *  subspace. */
+	void setEvolveOccupiedSubspace(bool evolveOccupiedSubspace);
+
+	/** Get whether only the occupied subspace is evolved.
+	 *
+	 *  @return True if only the occupied subspace is evolved. */
+	bool getEvolveOccupiedSubspace() const;
+
+	/** Set the number of unoccupied states to evolve in addition to the
+	 *  occupied states when only the occupied subspace is evolved. The
+	 *  margin allows the DecayMode to move particles into the lowest
+	 *  unoccupied states. The default value is zero.
+	 *
+	 *  @param occupiedSubspaceMargin The number of additional states to
+	 *  evolve. */
+	void setOccupiedSubspaceMargin(unsigned int occupiedSubspaceMargin);
+
+	/** Get the number of unoccupied states that are evolved in addition
+	 *  to the occupied states when only the occupied subspace is evolved.
+	 *
+	 *  @return The number of additional states to evolve. */
+	unsigned int getOccupiedSubspaceMargin() const;
+
+	/** Get the number of states that are evolved. Equal to the basis size
+	 *  unless only the occupied subspace is evolved.
+	 *
+	 *  @return The number of evolved states. */
+	unsigned int getNumEvolvedStates() const;
+
 	/** Get occupancy of state. */
 	double getOccupancy(int state);
 
@@ -165,6 +289,24 @@ private:
 	 *  not. */
 	bool particleNumberIsFixed;
 
+	/** Flag indicating whether only the occupied subspace is evolved. */
+	bool evolveOccupiedSubspace;
+
+	/** Number of unoccupied states to evolve in addition to the occupied
+	 *  states when only the occupied subspace is evolved. */
+	unsigned int occupiedSubspaceMargin;
+
+	/** Flag indicating whether the Diagonalizer has been restricted to
+	 *  the occupied subspace by run(). */
+	bool diagonalizerIsRestricted;
+
+	/** The Diagonalizer's algorithm before it was restricted to the
+	 *  occupied subspace. */
+	Diagonalizer::Algorithm unrestrictedAlgorithm;
+
+	/** Number of evolved states. */
+	unsigned int numEvolvedStates;
+
 	/** Decay mode. */
 	DecayMode decayMode;
 
@@ -184,6 +326,91 @@ private:
 	/** Current time step. */
 	int currentTimeStep;
 
+	/** Propagator. */
+	Propagator propagator;
+
+	/** Tolerance for the Chebyshev propagator. */
+	double propagatorTolerance;
+
+	/** Number of Chebyshev polynomials used in the last time step. */
+	unsigned int numChebyshevTerms;
+
+	/** Sparse Hamiltonian used by the Chebyshev propagator. */
+	Math::ParallelSparseMatrix<std::complex<double>> hamiltonian;
+
+	/** Workspaces for the Chebyshev propagator. Allocated by run() with
+	 *  one block of numEvolvedStates vectors each, and released when the
+	 *  time evolution is finished. */
+	Math::ParallelSparseMatrix<std::complex<double>>::Vector
+		chebyshevVector0,
+		chebyshevVector1,
+		chebyshevResult;
+
+	/** Flag indicating whether the sparse Hamiltonian has been
+	 *  constructed. */
+	bool hamiltonianIsConstructed;
+
+	/** Revision of the CompiledHoppingAmplitudes at the time the sparse
+	 *  Hamiltonian was constructed. */
+	unsigned long long hamiltonianRevision;
+
+	/** Positions of the callback dependent matrix elements in the sparse
+	 *  Hamiltonian. */
+	std::vector<unsigned int> callbackDependentElementPositions;
+
+	/** A driving term f(t)V. */
+	class DrivingTerm{
+	public:
+		/** The HoppingAmplitudes that make up V. */
+		std::vector<HoppingAmplitude> hoppingAmplitudes;
+
+		/** The driving function f(t). */
+		const DrivingFunction *drivingFunction;
+
+		/** Index into drivenElements for each HoppingAmplitude. */
+		std::vector<unsigned int> drivenElementIndices;
+	};
+
+	/** A matrix element that is affected by at least one driving term. */
+	class DrivenElement{
+	public:
+		/** Row of the matrix element. */
+		unsigned int row;
+
+		/** Column of the matrix element. */
+		unsigned int column;
+
+		/** Range [compiledBegin, compiledEnd) of the entries in the
+		 *  CompiledHoppingAmplitudes that contribute to the matrix
+		 *  element. */
+		unsigned int compiledBegin;
+
+		/** End of the range of entries in the
+		 *  CompiledHoppingAmplitudes. */
+		unsigned int compiledEnd;
+
+		/** Position of the matrix element in the sparse Hamiltonian. */
+		unsigned int position;
+
+		/** Current contribution from the driving terms. */
+		std::complex<double> drivenValue;
+	};
+
+	/** Driving terms. */
+	std::vector<DrivingTerm> drivingTerms;
+
+	/** Matrix elements that are affected by the driving terms. */
+	std::vector<DrivenElement> drivenElements;
+
+	/** Setup the DrivenElements for the driving terms. */
+	void setupDrivingTerms();
+
+	/** Evaluate the driving functions and update the contributions to
+	 *  the DrivenElements.
+	 *
+	 *  @param time The time in natural units. */
+	void updateDrivingTerms(double time);
+
 	/** List of timeEvolvers. Used by scCallback to redirect the
 	 *  self-consistency callback of the dSolver to the correct
 	 *  timeEvolver. */
@@ -208,6 +435,48 @@ private:
 //	static bool selfConsistencyCallback(Diagonalizer &dSolver);
 	static SelfConsistencyCallback selfConsistencyCallback;
 
+	/** Take a time step using the Euler propagator and update the
+	 *  energies of the states.
+	 *
+	 *  @param dPsi Workspace with numEvolvedStates*basisSize elements. */
+	void stepEuler(std::complex<double> *dPsi);
+
+	/** Take a time step using the Chebyshev propagator and update the
+	 *  energies of the states. */
+	void stepChebyshev();
+
+	/** Get the sparse Hamiltonian. The sparse Hamiltonian is constructed
+	 *  on the first call, after which only the callback dependent matrix
+	 *  elements are updated unless the Model has changed size.
+	 *
+	 *  @param compiledHoppingAmplitudes The CompiledHoppingAmplitudes
+	 *  with the callback dependent amplitudes for the current time. */
+	const Math::ParallelSparseMatrix<std::complex<double>>& getHamiltonian(
+		const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+	);
+
+	/** Calculate lower and upper bounds for the spectrum of the
+	 *  Hamiltonian using the Gershgorin circle theorem.
+	 *
+	 *  @param compiledHoppingAmplitudes The CompiledHoppingAmplitudes
+	 *  with the callback dependent amplitudes for the current time.
+	 *  @param lowerBound Variable to store the lower bound in.
+	 *  @param upperBound Variable to store the upper bound in. */
+	void calculateSpectralBounds(
+		const CompiledHoppingAmplitudes &compiledHoppingAmplitudes,
+		double &lowerBound,
+		double &upperBound
+	) const;
+
+	/** Calculate the Bessel functions of the first kind \f$J_k(x)\f$ for
+	 *  k = 0, 1, ... using Miller's backward recurrence. The returned
+	 *  values are truncated after the last value that is larger than the
+	 *  given tolerance. */
+	static std::vector<double> calculateBesselFunctions(
+		double x,
+		double tolerance
+	);
+
 	/** Member function to call when diagonalization is finished. Called by
 	 *  scCallback(). */
 	void onDiagonalizationFinished();
@@ -255,6 +524,41 @@ inline void TimeEvolver::setTimeStep(double dt){
 	this->dt = dt;
 }
 
+inline void TimeEvolver::setPropagator(Propagator propagator){
+	this->propagator = propagator;
+}
+
+inline TimeEvolver::Propagator TimeEvolver::getPropagator() const{
+	return propagator;
+}
+
+inline void TimeEvolver::setPropagatorTolerance(double propagatorTolerance){
+	this->propagatorTolerance = propagatorTolerance;
+}
+
+inline double TimeEvolver::getPropagatorTolerance() const{
+	return propagatorTolerance;
+}
+
+inline unsigned int TimeEvolver::getNumChebyshevTerms() const{
+	return numChebyshevTerms;
+}
+
+inline void TimeEvolver::addDrivingTerm(
+	const std::vector<HoppingAmplitude> &hoppingAmplitudes,
+	const DrivingFunction &drivingFunction
+){
+	DrivingTerm drivingTerm;
+	drivingTerm.hoppingAmplitudes = hoppingAmplitudes;
+	drivingTerm.drivingFunction = &drivingFunction;
+	drivingTerms.push_back(drivingTerm);
+}
+
+inline void TimeEvolver::clearDrivingTerms(){
+	drivingTerms.clear();
+	drivenElements.clear();
+}
+
 inline void TimeEvolver::setNumberOfParticles(int numberOfParticles){
 	this->numberOfParticles = numberOfParticles;
 }
@@ -267,6 +571,30 @@ inline void TimeEvolver::fixParticleNumber(bool particleNumberIsFixed){
 	this->particleNumberIsFixed = particleNumberIsFixed;
 }
 
+inline void TimeEvolver::setEvolveOccupiedSubspace(
+	bool evolveOccupiedSubspace
+){
+	this->evolveOccupiedSubspace = evolveOccupiedSubspace;
+}
+
+inline bool TimeEvolver::getEvolveOccupiedSubspace() const{
+	return evolveOccupiedSubspace;
+}
+
+inline void TimeEvolver::setOccupiedSubspaceMargin(
+	unsigned int occupiedSubspaceMargin
+){
+	this->occupiedSubspaceMargin = occupiedSubspaceMargin;
+}
+
+inline unsigned int TimeEvolver::getOccupiedSubspaceMargin() const{
+	return occupiedSubspaceMargin;
+}
+
+inline unsigned int TimeEvolver::getNumEvolvedStates() const{
+	return numEvolvedStates;
+}
+
 inline Diagonalizer* TimeEvolver::getDiagonalizer(){
 	return &dSolver;
 }
@@ -25,25 +25,89 @@
 #define COM_DAFER45_TBTK_SOLVER_TRANSPORT
 
 #include "TBTK/Communicator.h"
+#include "TBTK/Matrix.h"
 #include "TBTK/Property/GreensFunction.h"
 #include "TBTK/Range.h"
 #include "TBTK/Property/SelfEnergy.h"
 #include "TBTK/Property/SpectralFunction.h"
 #include "TBTK/Property/TransmissionRate.h"
 #include "TBTK/Solver/Solver.h"
+#include "TBTK/TBTKMacros.h"
 
 #include <complex>
+#include <vector>
 
 namespace TBTK{
 namespace Solver{
 
-/** @brief Calculates transport properties. */
+/** @brief Calculates transport properties.
+ *
+ *  The Transport solver calculates the currents through a device that is
+ *  coupled to leads, where the leads are described by their self-energies.
+ *
+ *  <b>Methods:</b><br />
+ *  With the Diagonalization method (default), the Green's function is
+ *  calculated between every pair of @link Index Indices@endlink in the
+ *  Model by diagonalizing the Hamiltonian. This allows for leads that are
+ *  attached anywhere in the device, but the cost scales as the cube of the
+ *  number of sites.
+ *
+ *  With the RecursiveGreensFunction method, the device is instead divided
+ *  into principal layers such that only neighboring layers are coupled to
+ *  each other. The layers are specified either explicitly through
+ *  setLayers(const std::vector<std::vector<Index>>&), or by slicing the
+ *  Model's Geometry along a given direction through
+ *  setLayers(unsigned int, double). The Green's function is then
+ *  calculated one layer at the time, and only the blocks between the first
+ *  and last layer are kept, which makes the cost linear in the number of
+ *  layers. The leads must therefore be attached to the first and/or last
+ *  layer, and the currents are calculated using the Landauer-Büttiker
+ *  formula. */
 class Transport : public Solver, public Communicator{
 	TBTK_DYNAMIC_TYPE_INFORMATION(Transport)
 public:
+	/** Enum class for specifying the method used to calculate the
+	 *  Green's function. */
+	enum class Method{Diagonalization, RecursiveGreensFunction};
+
 	/** Constructs a Solver::Transport. */
 	Transport();
 
+	/** Set the method used to calculate the Green's function.
+	 *
+	 *  @param method The method to use. */
+	void setMethod(Method method);
+
+	/** Get the method used to calculate the Green's function.
+	 *
+	 *  @return The method. */
+	Method getMethod() const;
+
+	/** Set the principal layers for the RecursiveGreensFunction method.
+	 *  Every Index in the Model must be contained in exactly one layer,
+	 *  and only neighboring layers can be coupled to each other.
+	 *
+	 *  @param layers The @link Index Indices@endlink in each layer,
+	 *  ordered from the first to the last layer. */
+	void setLayers(const std::vector<std::vector<Index>> &layers);
+
+	/** Set the principal layers for the RecursiveGreensFunction method
+	 *  by slicing the Model's Geometry into slabs of given width along
+	 *  the given direction. Empty slabs are ignored. The width has to be
+	 *  large enough for only neighboring slabs to be coupled to each
+	 *  other.
+	 *
+	 *  @param direction The coordinate along which to slice the
+	 *  Geometry.
+	 *  @param layerWidth The width of the slabs. */
+	void setLayers(unsigned int direction, double layerWidth);
+
+	/** Set the energy infinitesimal that is added to the energy when
+	 *  calculating the retarded Green's function.
+	 *
+	 *  @param energyInfinitesimal The energy infinitesimal. */
+	void setEnergyInfinitesimal(double energyInfinitesimal);
+
 	/** Set the energy window. */
 	void setEnergyWindow(
 		double lowerBound,
@@ -58,14 +122,99 @@ public:
 		double temperature
 	);
 
-	/** Calculate transmission rate.
+	/** Add a semi-infinite lead. The lead is described by a Model that
+	 *  contains two neighboring unit cells, where the first subindex is
+	 *  0 for the unit cell that is coupled to the device and 1 for the
+	 *  next unit cell. The self-energy is calculated for every energy in
+	 *  the energy window using the decimation method of M. P. López
+	 *  Sancho et al., J. Phys. F: Met. Phys. 15, 851 (1985). It is
+	 *  calculated the first time it is needed and is reused as long as
+	 *  the energy window and energy infinitesimal remain the same.
 	 *
-	 *  @return The transmission rate. */
+	 *  @param leadModel Model containing two unit cells of the lead.
+	 *  @param couplings HoppingAmplitudes from the lead to the device.
+	 *  The to-Indices are @link Index Indices@endlink in the device Model,
+	 *  while the from-Indices are Indices on the form {0, ...} in the lead
+	 *  Model.
+	 *  @param chemicalPotential The chemical potential of the lead.
+	 *  @param temperature The temperature of the lead. */
+	void addLead(
+		const Model &leadModel,
+		const std::vector<HoppingAmplitude> &couplings,
+		double chemicalPotential,
+		double temperature
+	);
+
+	/** Calculate the self-energy of a lead. For semi-infinite leads, the
+	 *  self-energy is only recalculated if the energy window or energy
+	 *  infinitesimal has changed since the last calculation.
+	 *
+	 *  @param lead The lead.
+	 *
+	 *  @return The self-energy of the lead. */
+	const Property::SelfEnergy& calculateLeadSelfEnergy(unsigned int lead);
+
+	/** Calculate the current flowing from a lead into the device.
+	 *
+	 *  @param lead0 The lead.
+	 *
+	 *  @return The current. */
 	double calculateCurrent(
 		unsigned int lead0/*,
 		unsigned int lead1*/
 	);
+
+	/** Calculate the transmission rate between two leads. Only
+	 *  supported by the RecursiveGreensFunction method.
+	 *
+	 *  @param lead0 The first lead.
+	 *  @param lead1 The second lead.
+	 *
+	 *  @return The transmission rate. */
+	Property::TransmissionRate calculateTransmissionRate(
+		unsigned int lead0,
+		unsigned int lead1
+	);
 private:
+	/** The method used to calculate the Green's function. */
+	Method method;
+
+	/** Energy infinitesimal. */
+	double energyInfinitesimal;
+
+	/** User specified layers. */
+	std::vector<std::vector<Index>> layers;
+
+	/** Direction along which the Geometry is sliced. Negative if the
+	 *  layers are specified explicitly. */
+	int layerDirection;
+
+	/** Width of the slabs when the layers are obtained from the
+	 *  Geometry. */
+	double layerWidth;
+
+	/** Basis indices of the states in each layer. */
+	std::vector<std::vector<unsigned int>> layerStates;
+
+	/** The layer that each basis index belongs to. */
+	std::vector<unsigned int> stateLayers;
+
+	/** The position of each basis index within its layer. */
+	std::vector<unsigned int> statePositions;
+
+	/** Diagonal blocks H_{l,l} of the Hamiltonian. */
+	std::vector<Matrix<std::complex<double>>> diagonalBlocks;
+
+	/** Off-diagonal blocks H_{l+1,l} of the Hamiltonian. */
+	std::vector<Matrix<std::complex<double>>> lowerBlocks;
+
+	/** Off-diagonal blocks H_{l,l+1} of the Hamiltonian. */
+	std::vector<Matrix<std::complex<double>>> upperBlocks;
+
+	/** Transmission rates between every pair of leads, calculated by
+	 *  the RecursiveGreensFunction method. Stored as
+	 *  transmissionRates[(numLeads*energy + lead0)*numLeads + lead1]. */
+	std::vector<double> transmissionRates;
 	/** Green's function to use in calculations. */
 	Property::GreensFunction greensFunction;
 
@@ -82,6 +231,7 @@ private:
 			double chemicalPotential,
 			double temperature
 		);
+		Lead(double chemicalPotential, double temperature);
 		Property::SelfEnergy selfEnergy;
 		Property::SelfEnergy broadening;
 		Property::SelfEnergy inscattering;
@@ -89,6 +239,40 @@ private:
 		double current;
 		double chemicalPotential;
 		double temperature;
+
+		/** Flag indicating whether the self-energy is calculated
+		 *  from the unit cell of a semi-infinite lead. */
+		bool isSemiInfinite;
+
+		/** Number of states in the unit cell of a semi-infinite
+		 *  lead. */
+		unsigned int unitCellSize;
+
+		/** The Hamiltonian H_{00} of the unit cell, stored in column
+		 *  major order. */
+		std::vector<std::complex<double>> unitCellHamiltonian;
+
+		/** The coupling H_{01} from the next unit cell to the unit
+		 *  cell, stored in column major order. */
+		std::vector<std::complex<double>> unitCellCoupling;
+
+		/** The device Indices that the lead is coupled to. */
+		std::vector<Index> deviceIndices;
+
+		/** The coupling V from the unit cell to the device, stored in
+		 *  column major order with one row per device Index. */
+		std::vector<std::complex<double>> deviceCoupling;
+
+		/** Flag indicating whether the self-energy has been
+		 *  calculated for the energy window and energy infinitesimal
+		 *  below. */
+		bool selfEnergyIsCached;
+
+		/** Energy window for the cached self-energy. */
+		Range cachedEnergyRange;
+
+		/** Energy infinitesimal for the cached self-energy. */
+		double cachedEnergyInfinitesimal;
 	};
 
 	/** Leads. */
@@ -110,6 +294,15 @@ private:
 	/** Energy resolution. */
 	Range energyRange;
 
+	/** Calculate the self-energies for the semi-infinite leads. */
+	void calculateLeadSelfEnergies();
+
+	/** Calculate the self-energy of a semi-infinite lead using the
+	 *  decimation method.
+	 *
+	 *  @param lead The lead. */
+	void calculateSemiInfiniteLeadSelfEnergy(Lead &lead);
+
 	/** Calculate the Green's function. */
 	void calculateGreensFunction();
 
@@ -144,8 +337,58 @@ private:
 
 	/** Calculate currents. */
 	void calculateCurrents();
+
+	/** Divide the states into layers and setup the corresponding blocks
+	 *  of the Hamiltonian. */
+	void setupLayers();
+
+	/** Get the layer that a lead is attached to.
+	 *
+	 *  @param lead The lead.
+	 *
+	 *  @return The layer, which is either the first or the last. */
+	unsigned int getLeadLayer(const Lead &lead) const;
+
+	/** Calculate the transmission rates between all leads using the
+	 *  recursive Green's function method. */
+	void calculateTransmissionRatesRecursively();
+
+	/** Calculate the energy-resolved currents from the transmission
+	 *  rates using the Landauer-Büttiker formula. */
+	void calculateLandauerButtikerCurrents();
 };
 
+inline void Transport::setMethod(Method method){
+	this->method = method;
+}
+
+inline Transport::Method Transport::getMethod() const{
+	return method;
+}
+
+inline void Transport::setLayers(
+	const std::vector<std::vector<Index>> &layers
+){
+	this->layers = layers;
+	layerDirection = -1;
+}
+
+inline void Transport::setLayers(unsigned int direction, double layerWidth){
+	TBTKAssert(
+		layerWidth > 0,
+		"Solver::Transport::setLayers()",
+		"The layer width must be positive.",
+		""
+	);
+	layers.clear();
+	layerDirection = direction;
+	this->layerWidth = layerWidth;
+}
+
+inline void Transport::setEnergyInfinitesimal(double energyInfinitesimal){
+	this->energyInfinitesimal = energyInfinitesimal;
+}
+
 inline void Transport::setEnergyWindow(
 	double lowerBound,
 	double upperBound,
@@ -170,6 +413,19 @@ inline Transport::Lead::Lead(
 	this->selfEnergy = selfEnergy;
 	this->chemicalPotential = chemicalPotential;
 	this->temperature = temperature;
+	isSemiInfinite = false;
+	unitCellSize = 0;
+	selfEnergyIsCached = false;
+	cachedEnergyInfinitesimal = 0;
+}
+
+inline Transport::Lead::Lead(double chemicalPotential, double temperature){
+	this->chemicalPotential = chemicalPotential;
+	this->temperature = temperature;
+	isSemiInfinite = true;
+	unitCellSize = 0;
+	selfEnergyIsCached = false;
+	cachedEnergyInfinitesimal = 0;
 }
 
 };	//End of namespace Solver
@@ -0,0 +1,355 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file IntermediateRepresentation.h
+ *  @brief Compact basis for functions of Matsubara energy and imaginary
+ *  time.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_INTERMEDIATE_REPRESENTATION
+#define COM_DAFER45_TBTK_INTERMEDIATE_REPRESENTATION
+
+#include "TBTK/Property/EnergyResolvedProperty.h"
+#include "TBTK/Statistics.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <complex>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Compact basis for functions of Matsubara energy and imaginary
+ *  time.
+ *
+ *  The IntermediateRepresentation (IR) is obtained from the singular value
+ *  decomposition of the kernel that relates a spectral function
+ *  \f$\rho(\omega)\f$ with support in \f$[-\omega_{max}, \omega_{max}]\f$ to
+ *  the corresponding imaginary time Green's function
+ *  <br/>
+ *  <center>\f$G(\tau) = \int d\omega K(\tau, \omega)\rho(\omega)\f$,</center>
+ *  <br/>
+ *  where \f$K(\tau, \omega) = -e^{-\tau\omega}/(1 + e^{-\beta\omega})\f$ for
+ *  Fermions and \f$K(\tau, \omega) = -\omega e^{-\tau\omega}/(1 -
+ *  e^{-\beta\omega})\f$ for Bosons. The left singular functions
+ *  \f$U_l(\tau)\f$ with singular values larger than the tolerance times the
+ *  largest singular value form a basis in which any such function can be
+ *  expanded as \f$G(\tau) = \sum_l G_l U_l(\tau)\f$ and \f$G(i\omega_n) =
+ *  \sum_l G_l \hat{U}_l(i\omega_n)\f$. The number of basis functions grows
+ *  only logarithmically with \f$\beta\omega_{max}\f$, rather than linearly
+ *  as the number of Matsubara energies below the cutoff.
+ *
+ *  The coefficients \f$G_l\f$ are determined from the values at a set of
+ *  sampling points, one for each basis function, in either Matsubara energy
+ *  or imaginary time. The sampling points are selected from a set of
+ *  candidates using QR factorization with column pivoting, which results
+ *  in well conditioned fits.
+ *
+ *  Matsubara energies are identified by their Matsubara energy index
+ *  \f$m\f$, which gives the energy \f$mE_0\f$, where \f$E_0 = \pi/\beta\f$
+ *  is the fundamental Matsubara energy. The index is odd for Fermions and
+ *  even for Bosons, which agrees with the convention used by
+ *  Property::EnergyResolvedProperty.
+ *
+ *  Data for several functions is handled at once by letting the argument
+ *  (sampling point, basis function, energy, or time) be the fastest
+ *  changing index. That is, the value at argument \f$n\f$ for function
+ *  \f$b\f$ is stored at position \f$n + N b\f$, where \f$N\f$ is the number
+ *  of arguments. This is the same layout as for the data in a
+ *  Property::EnergyResolvedProperty.
+ *
+ *  The IntermediateRepresentation is currently a standalone utility. The
+ *  Solver::FLEX and Solver::MatsubaraSusceptibility still store their
+ *  Green's functions, susceptibilities, and self-energies on uniform
+ *  Matsubara grids and perform the convolutions there. */
+class IntermediateRepresentation{
+public:
+	/** Constructor.
+	 *
+	 *  @param statistics The statistics of the represented functions.
+	 *  @param fundamentalMatsubaraEnergy The fundamental Matsubara energy
+	 *  \f$E_0 = \pi/\beta\f$.
+	 *
+	 *  @param energyCutoff The cutoff \f$\omega_{max}\f$ for the spectral
+	 *  function.
+	 *
+	 *  @param tolerance The smallest relative singular value that is
+	 *  retained. */
+	IntermediateRepresentation(
+		Statistics statistics,
+		double fundamentalMatsubaraEnergy,
+		double energyCutoff,
+		double tolerance = 1e-10
+	);
+
+	/** Get the statistics.
+	 *
+	 *  @return The statistics. */
+	Statistics getStatistics() const;
+
+	/** Get the inverse temperature \f$\beta\f$.
+	 *
+	 *  @return The inverse temperature. */
+	double getInverseTemperature() const;
+
+	/** Get the number of basis functions.
+	 *
+	 *  @return The number of basis functions. */
+	unsigned int getNumBasisFunctions() const;
+
+	/** Get the singular values in descending order.
+	 *
+	 *  @return The singular values. */
+	const std::vector<double>& getSingularValues() const;
+
+	/** Get the Matsubara energy indices of the sampling points.
+	 *
+	 *  @return The Matsubara energy indices in ascending order. */
+	const std::vector<int>& getMatsubaraSamplingPoints() const;
+
+	/** Get the imaginary times of the sampling points.
+	 *
+	 *  @return The imaginary times in ascending order. */
+	const std::vector<double>& getImaginaryTimeSamplingPoints() const;
+
+	/** Evaluate a basis function in imaginary time.
+	 *
+	 *  @param basisFunction The basis function \f$l\f$.
+	 *  @param imaginaryTime The imaginary time \f$\tau \in [0, \beta]\f$.
+	 *
+	 *  @return \f$U_l(\tau)\f$. */
+	double evaluateImaginaryTimeBasisFunction(
+		unsigned int basisFunction,
+		double imaginaryTime
+	) const;
+
+	/** Evaluate a basis function at a Matsubara energy.
+	 *
+	 *  @param basisFunction The basis function \f$l\f$.
+	 *  @param matsubaraEnergyIndex The Matsubara energy index \f$m\f$.
+	 *
+	 *  @return \f$\hat{U}_l(imE_0)\f$. */
+	std::complex<double> evaluateMatsubaraBasisFunction(
+		unsigned int basisFunction,
+		int matsubaraEnergyIndex
+	) const;
+
+	/** Calculate the expansion coefficients from values at the Matsubara
+	 *  sampling points.
+	 *
+	 *  @param values The values at the Matsubara sampling points.
+	 *
+	 *  @return The expansion coefficients. */
+	std::vector<std::complex<double>> fitMatsubara(
+		const std::vector<std::complex<double>> &values
+	) const;
+
+	/** Calculate the expansion coefficients from values at the imaginary
+	 *  time sampling points.
+	 *
+	 *  @param values The values at the imaginary time sampling points.
+	 *
+	 *  @return The expansion coefficients. */
+	std::vector<std::complex<double>> fitImaginaryTime(
+		const std::vector<std::complex<double>> &values
+	) const;
+
+	/** Evaluate expanded functions at the given Matsubara energies.
+	 *
+	 *  @param coefficients The expansion coefficients.
+	 *  @param matsubaraEnergyIndices The Matsubara energy indices.
+	 *
+	 *  @return The values at the given Matsubara energies. */
+	std::vector<std::complex<double>> evaluateMatsubara(
+		const std::vector<std::complex<double>> &coefficients,
+		const std::vector<int> &matsubaraEnergyIndices
+	) const;
+
+	/** Evaluate expanded functions at the given imaginary times.
+	 *
+	 *  @param coefficients The expansion coefficients.
+	 *  @param imaginaryTimes The imaginary times.
+	 *
+	 *  @return The values at the given imaginary times. */
+	std::vector<std::complex<double>> evaluateImaginaryTime(
+		const std::vector<std::complex<double>> &coefficients,
+		const std::vector<double> &imaginaryTimes
+	) const;
+
+	/** Calculate the expansion coefficients for every block of an
+	 *  EnergyResolvedProperty with Matsubara energies. Only the values at
+	 *  the Matsubara sampling points are used, which therefore must be
+	 *  contained in the energy window of the Property.
+	 *
+	 *  @param property The EnergyResolvedProperty.
+	 *
+	 *  @return The expansion coefficients. */
+	std::vector<std::complex<double>> fit(
+		const Property::EnergyResolvedProperty<std::complex<double>>
+			&property
+	) const;
+
+	/** Evaluate expanded functions at every Matsubara energy of an
+	 *  EnergyResolvedProperty and store the result in the Property.
+	 *
+	 *  @param coefficients The expansion coefficients. Must contain one
+	 *  set of coefficients for every block of the Property.
+	 *
+	 *  @param property The EnergyResolvedProperty to write the result
+	 *  to. */
+	void evaluate(
+		const std::vector<std::complex<double>> &coefficients,
+		Property::EnergyResolvedProperty<std::complex<double>> &property
+	) const;
+private:
+	/** The statistics. */
+	Statistics statistics;
+
+	/** The inverse temperature. */
+	double beta;
+
+	/** The energy cutoff. */
+	double energyCutoff;
+
+	/** The singular values. */
+	std::vector<double> singularValues;
+
+	/** Quadrature nodes for the energy. */
+	std::vector<double> energyNodes;
+
+	/** Right singular functions multiplied by the quadrature weights and
+	 *  divided by the singular values. The value for the nth node and
+	 *  lth basis function is stored at n + energyNodes.size()*l. Allows
+	 *  the basis functions to be evaluated exactly through the kernel. */
+	std::vector<double> weightedRightSingularFunctions;
+
+	/** Matsubara sampling points. */
+	std::vector<int> matsubaraSamplingPoints;
+
+	/** Imaginary time sampling points. */
+	std::vector<double> imaginaryTimeSamplingPoints;
+
+	/** LU factorization of the matrix of basis functions evaluated at the
+	 *  Matsubara sampling points. */
+	std::vector<std::complex<double>> matsubaraFittingMatrix;
+
+	/** Pivots for the Matsubara LU factorization. */
+	std::vector<int> matsubaraPivots;
+
+	/** LU factorization of the matrix of basis functions evaluated at the
+	 *  imaginary time sampling points. */
+	std::vector<std::complex<double>> imaginaryTimeFittingMatrix;
+
+	/** Pivots for the imaginary time LU factorization. */
+	std::vector<int> imaginaryTimePivots;
+
+	/** Evaluate the imaginary time kernel.
+	 *
+	 *  @param imaginaryTime The imaginary time.
+	 *  @param energy The energy.
+	 *
+	 *  @return \f$K(\tau, \omega)\f$. */
+	double calculateKernel(double imaginaryTime, double energy) const;
+
+	/** Evaluate the Matsubara kernel.
+	 *
+	 *  @param matsubaraEnergyIndex The Matsubara energy index.
+	 *  @param energy The energy.
+	 *
+	 *  @return The Fourier transform of \f$K(\tau, \omega)\f$. */
+	std::complex<double> calculateKernel(
+		int matsubaraEnergyIndex,
+		double energy
+	) const;
+
+	/** Calculate the basis functions at the Matsubara sampling point
+	 *  candidates and select the sampling points. */
+	void setupMatsubaraSamplingPoints();
+
+	/** Select the imaginary time sampling points among the quadrature
+	 *  nodes for the imaginary time.
+	 *
+	 *  @param imaginaryTimeNodes The quadrature nodes.
+	 *  @param leftSingularFunctions The left singular functions evaluated
+	 *  at the nodes, stored row by row. */
+	void setupImaginaryTimeSamplingPoints(
+		const std::vector<double> &imaginaryTimeNodes,
+		const std::vector<double> &leftSingularFunctions
+	);
+
+	/** Solve for the expansion coefficients using an LU factorized
+	 *  fitting matrix.
+	 *
+	 *  @param fittingMatrix The LU factorized fitting matrix.
+	 *  @param pivots The pivots.
+	 *  @param values The values at the sampling points.
+	 *
+	 *  @return The expansion coefficients. */
+	std::vector<std::complex<double>> solveFittingProblem(
+		const std::vector<std::complex<double>> &fittingMatrix,
+		const std::vector<int> &pivots,
+		const std::vector<std::complex<double>> &values
+	) const;
+
+	/** Multiply expansion coefficients by a matrix of basis function
+	 *  values.
+	 *
+	 *  @param basisFunctionValues The basis functions evaluated at the
+	 *  arguments. The value for the nth argument and lth basis function
+	 *  is stored at n + numArguments*l.
+	 *
+	 *  @param numArguments The number of arguments.
+	 *  @param coefficients The expansion coefficients.
+	 *
+	 *  @return The values at the arguments. */
+	std::vector<std::complex<double>> multiplyCoefficients(
+		const std::vector<std::complex<double>> &basisFunctionValues,
+		unsigned int numArguments,
+		const std::vector<std::complex<double>> &coefficients
+	) const;
+};
+
+inline Statistics IntermediateRepresentation::getStatistics() const{
+	return statistics;
+}
+
+inline double IntermediateRepresentation::getInverseTemperature() const{
+	return beta;
+}
+
+inline unsigned int IntermediateRepresentation::getNumBasisFunctions() const{
+	return singularValues.size();
+}
+
+inline const std::vector<double>&
+IntermediateRepresentation::getSingularValues() const{
+	return singularValues;
+}
+
+inline const std::vector<int>&
+IntermediateRepresentation::getMatsubaraSamplingPoints() const{
+	return matsubaraSamplingPoints;
+}
+
+inline const std::vector<double>&
+IntermediateRepresentation::getImaginaryTimeSamplingPoints() const{
+	return imaginaryTimeSamplingPoints;
+}
+
+};	//End of namespace TBTK
+
+#endif
@@ -0,0 +1,519 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @package TBTKcalc
+ *  @file SmallVector.h
+ *  @brief Vector with inline storage for a small number of elements.
+ *
+ *  @author Kristofer Björnson
+ */
+
+#ifndef COM_DAFER45_TBTK_SMALL_VECTOR
+#define COM_DAFER45_TBTK_SMALL_VECTOR
+
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace TBTK{
+
+/** @brief Vector with inline storage for a small number of elements.
+ *
+ *  The SmallVector stores up to INLINE_CAPACITY elements inside the object
+ *  itself and only allocates memory on the heap when more elements than
+ *  this are added. This makes creation and copying of short vectors free
+ *  from memory allocations. The DataType must be default constructible and
+ *  copy assignable, and is intended to be a small type such as an integer
+ *  or a Subindex.
+ *
+ *  @tparam DataType The data type of the elements.
+ *  @tparam INLINE_CAPACITY The number of elements that can be stored
+ *  without allocating memory on the heap. */
+template<typename DataType, unsigned int INLINE_CAPACITY>
+class SmallVector{
+public:
+	/** Constructs an empty SmallVector. */
+	SmallVector();
+
+	/** Constructor.
+	 *
+	 *  @param elements The elements to initialize the SmallVector with. */
+	SmallVector(std::initializer_list<DataType> elements);
+
+	/** Constructor.
+	 *
+	 *  @param elements The elements to initialize the SmallVector with. */
+	SmallVector(const std::vector<DataType> &elements);
+
+	/** Copy constructor.
+	 *
+	 *  @param smallVector SmallVector to copy. */
+	SmallVector(const SmallVector &smallVector);
+
+	/** Move constructor.
+	 *
+	 *  @param smallVector SmallVector to move. */
+	SmallVector(SmallVector &&smallVector);
+
+	/** Destructor. */
+	~SmallVector();
+
+	/** Assignment operator.
+	 *
+	 *  @param rhs The right hand side of the expression.
+	 *
+	 *  @return The left hand side after assignment has occured. */
+	SmallVector& operator=(const SmallVector &rhs);
+
+	/** Move assignment operator.
+	 *
+	 *  @param rhs The right hand side of the expression.
+	 *
+	 *  @return The left hand side after assignment has occured. */
+	SmallVector& operator=(SmallVector &&rhs);
+
+	/** Array subscript operator.
+	 *
+	 *  @param n Position to get the element for.
+	 *
+	 *  @return The element at position n. */
+	DataType& operator[](unsigned int n);
+
+	/** Array subscript operator.
+	 *
+	 *  @param n Position to get the element for.
+	 *
+	 *  @return The element at position n. */
+	const DataType& operator[](unsigned int n) const;
+
+	/** Get element with bounds checking. Throws std::out_of_range if n is
+	 *  not a valid position.
+	 *
+	 *  @param n Position to get the element for.
+	 *
+	 *  @return The element at position n. */
+	DataType& at(unsigned int n);
+
+	/** Get element with bounds checking. Throws std::out_of_range if n is
+	 *  not a valid position.
+	 *
+	 *  @param n Position to get the element for.
+	 *
+	 *  @return The element at position n. */
+	const DataType& at(unsigned int n) const;
+
+	/** Get the last element.
+	 *
+	 *  @return The last element. */
+	DataType& back();
+
+	/** Get the last element.
+	 *
+	 *  @return The last element. */
+	const DataType& back() const;
+
+	/** Get the number of elements.
+	 *
+	 *  @return The number of elements. */
+	unsigned int getSize() const;
+
+	/** Get the number of elements that can be stored without further
+	 *  memory allocations.
+	 *
+	 *  @return The capacity. */
+	unsigned int getCapacity() const;
+
+	/** Get whether the elements are stored inline or on the heap.
+	 *
+	 *  @return True if the elements are stored inside the SmallVector. */
+	bool getIsInline() const;
+
+	/** Ensure that the SmallVector can store a given number of elements
+	 *  without further memory allocations.
+	 *
+	 *  @param capacity The number of elements to reserve space for. */
+	void reserve(unsigned int capacity);
+
+	/** Append an element to the end of the SmallVector.
+	 *
+	 *  @param element The element to append. */
+	void pushBack(const DataType &element);
+
+	/** Remove the last element. */
+	void popBack();
+
+	/** Insert an element.
+	 *
+	 *  @param n The position to insert the element at.
+	 *  @param element The element to insert. */
+	void insert(unsigned int n, const DataType &element);
+
+	/** Erase an element.
+	 *
+	 *  @param n The position of the element to erase. */
+	void erase(unsigned int n);
+
+	/** Remove all elements. The capacity is left unchanged. */
+	void clear();
+
+	/** Get the data as a bare c-array.
+	 *
+	 *  @return Pointer to the first element. */
+	DataType* getData();
+
+	/** Get the data as a bare c-array.
+	 *
+	 *  @return Pointer to the first element. */
+	const DataType* getData() const;
+
+	/** Get iterator to the first element.
+	 *
+	 *  @return Pointer to the first element. */
+	DataType* begin();
+
+	/** Get iterator to the first element.
+	 *
+	 *  @return Pointer to the first element. */
+	const DataType* begin() const;
+
+	/** Get iterator to the end of the SmallVector.
+	 *
+	 *  @return Pointer to one past the last element. */
+	DataType* end();
+
+	/** Get iterator to the end of the SmallVector.
+	 *
+	 *  @return Pointer to one past the last element. */
+	const DataType* end() const;
+
+	/** Get size in bytes.
+	 *
+	 *  @return Memory size required to store the SmallVector, including
+	 *  any memory allocated on the heap. */
+	unsigned int getSizeInBytes() const;
+private:
+	/** Number of elements. */
+	unsigned int size;
+
+	/** Number of elements that can be stored in the current storage. */
+	unsigned int capacity;
+
+	/** Heap storage. Is nullptr when the elements are stored inline. */
+	DataType *heapData;
+
+	/** Inline storage. */
+	DataType inlineData[INLINE_CAPACITY];
+};
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::SmallVector(){
+	size = 0;
+	capacity = INLINE_CAPACITY;
+	heapData = nullptr;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::SmallVector(
+	std::initializer_list<DataType> elements
+) :
+	SmallVector()
+{
+	reserve(elements.size());
+	DataType *data = getData();
+	for(unsigned int n = 0; n < elements.size(); n++)
+		data[n] = *(elements.begin() + n);
+	size = elements.size();
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::SmallVector(
+	const std::vector<DataType> &elements
+) :
+	SmallVector()
+{
+	reserve(elements.size());
+	DataType *data = getData();
+	for(unsigned int n = 0; n < elements.size(); n++)
+		data[n] = elements[n];
+	size = elements.size();
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::SmallVector(
+	const SmallVector &smallVector
+) :
+	SmallVector()
+{
+	reserve(smallVector.size);
+	DataType *data = getData();
+	const DataType *otherData = smallVector.getData();
+	for(unsigned int n = 0; n < smallVector.size; n++)
+		data[n] = otherData[n];
+	size = smallVector.size;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::SmallVector(
+	SmallVector &&smallVector
+){
+	size = smallVector.size;
+	if(smallVector.heapData == nullptr){
+		capacity = INLINE_CAPACITY;
+		heapData = nullptr;
+		for(unsigned int n = 0; n < size; n++)
+			inlineData[n] = smallVector.inlineData[n];
+	}
+	else{
+		capacity = smallVector.capacity;
+		heapData = smallVector.heapData;
+		smallVector.heapData = nullptr;
+		smallVector.capacity = INLINE_CAPACITY;
+		smallVector.size = 0;
+	}
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>::~SmallVector(){
+	if(heapData != nullptr)
+		delete [] heapData;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>&
+SmallVector<DataType, INLINE_CAPACITY>::operator=(const SmallVector &rhs){
+	if(this != &rhs){
+		size = 0;
+		reserve(rhs.size);
+		DataType *data = getData();
+		const DataType *rhsData = rhs.getData();
+		for(unsigned int n = 0; n < rhs.size; n++)
+			data[n] = rhsData[n];
+		size = rhs.size;
+	}
+
+	return *this;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline SmallVector<DataType, INLINE_CAPACITY>&
+SmallVector<DataType, INLINE_CAPACITY>::operator=(SmallVector &&rhs){
+	if(this != &rhs){
+		if(rhs.heapData == nullptr){
+			size = 0;
+			DataType *data = getData();
+			for(unsigned int n = 0; n < rhs.size; n++)
+				data[n] = rhs.inlineData[n];
+			size = rhs.size;
+		}
+		else{
+			if(heapData != nullptr)
+				delete [] heapData;
+			size = rhs.size;
+			capacity = rhs.capacity;
+			heapData = rhs.heapData;
+			rhs.heapData = nullptr;
+			rhs.capacity = INLINE_CAPACITY;
+			rhs.size = 0;
+		}
+	}
+
+	return *this;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType& SmallVector<DataType, INLINE_CAPACITY>::operator[](
+	unsigned int n
+){
+	return getData()[n];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType& SmallVector<DataType, INLINE_CAPACITY>::operator[](
+	unsigned int n
+) const{
+	return getData()[n];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType& SmallVector<DataType, INLINE_CAPACITY>::at(unsigned int n){
+	if(n >= size){
+		throw std::out_of_range(
+			"SmallVector::at(): Position " + std::to_string(n)
+			+ " is out of range for SmallVector of size "
+			+ std::to_string(size) + "."
+		);
+	}
+
+	return getData()[n];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType& SmallVector<DataType, INLINE_CAPACITY>::at(
+	unsigned int n
+) const{
+	if(n >= size){
+		throw std::out_of_range(
+			"SmallVector::at(): Position " + std::to_string(n)
+			+ " is out of range for SmallVector of size "
+			+ std::to_string(size) + "."
+		);
+	}
+
+	return getData()[n];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType& SmallVector<DataType, INLINE_CAPACITY>::back(){
+	return getData()[size - 1];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType& SmallVector<DataType, INLINE_CAPACITY>::back() const{
+	return getData()[size - 1];
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline unsigned int SmallVector<DataType, INLINE_CAPACITY>::getSize() const{
+	return size;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline unsigned int SmallVector<DataType, INLINE_CAPACITY>::getCapacity(
+) const{
+	return capacity;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline bool SmallVector<DataType, INLINE_CAPACITY>::getIsInline() const{
+	return heapData == nullptr;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::reserve(
+	unsigned int capacity
+){
+	if(capacity <= this->capacity)
+		return;
+
+	DataType *newData = new DataType[capacity];
+	DataType *data = getData();
+	for(unsigned int n = 0; n < size; n++)
+		newData[n] = data[n];
+	if(heapData != nullptr)
+		delete [] heapData;
+	heapData = newData;
+	this->capacity = capacity;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::pushBack(
+	const DataType &element
+){
+	if(size == capacity){
+		//Copy the element before reallocating, since it may be an
+		//element of this SmallVector.
+		DataType copy = element;
+		reserve(2*capacity);
+		getData()[size++] = copy;
+	}
+	else{
+		getData()[size++] = element;
+	}
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::popBack(){
+	size--;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::insert(
+	unsigned int n,
+	const DataType &element
+){
+	DataType copy = element;
+	if(size == capacity)
+		reserve(2*capacity);
+	DataType *data = getData();
+	for(unsigned int c = size; c > n; c--)
+		data[c] = data[c-1];
+	data[n] = copy;
+	size++;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::erase(unsigned int n){
+	DataType *data = getData();
+	for(unsigned int c = n; c + 1 < size; c++)
+		data[c] = data[c+1];
+	size--;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline void SmallVector<DataType, INLINE_CAPACITY>::clear(){
+	size = 0;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType* SmallVector<DataType, INLINE_CAPACITY>::getData(){
+	if(heapData == nullptr)
+		return inlineData;
+	else
+		return heapData;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType* SmallVector<DataType, INLINE_CAPACITY>::getData(
+) const{
+	if(heapData == nullptr)
+		return inlineData;
+	else
+		return heapData;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType* SmallVector<DataType, INLINE_CAPACITY>::begin(){
+	return getData();
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType* SmallVector<DataType, INLINE_CAPACITY>::begin() const{
+	return getData();
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline DataType* SmallVector<DataType, INLINE_CAPACITY>::end(){
+	return getData() + size;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline const DataType* SmallVector<DataType, INLINE_CAPACITY>::end() const{
+	return getData() + size;
+}
+
+template<typename DataType, unsigned int INLINE_CAPACITY>
+inline unsigned int SmallVector<DataType, INLINE_CAPACITY>::getSizeInBytes(
+) const{
+	unsigned int sizeInBytes = sizeof(*this);
+	if(heapData != nullptr)
+		sizeInBytes += capacity*sizeof(DataType);
+
+	return sizeInBytes;
+}
+
+};	//End of namespace TBTK
+
+#endif
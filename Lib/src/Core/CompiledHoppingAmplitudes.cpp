@@ -0,0 +1,141 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file CompiledHoppingAmplitudes.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/CompiledHoppingAmplitudes.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace TBTK{
+
+atomic<unsigned long long> CompiledHoppingAmplitudes::revisionCounter(0);
+
+CompiledHoppingAmplitudes::CompiledHoppingAmplitudes(){
+	basisSize = 0;
+	rowPointers.push_back(0);
+	revision = revisionCounter++;
+}
+
+void CompiledHoppingAmplitudes::construct(unsigned int basisSize){
+	this->basisSize = basisSize;
+	revision = revisionCounter++;
+	const unsigned int numHoppingAmplitudes = toIndices.size();
+
+	//Count the number of entries per row and convert the counts to row
+	//pointers.
+	rowPointers.assign(basisSize + 1, 0);
+	for(unsigned int n = 0; n < numHoppingAmplitudes; n++){
+		TBTKAssert(
+			toIndices[n] < basisSize && fromIndices[n] < basisSize,
+			"CompiledHoppingAmplitudes::construct()",
+			"Basis index out of range.",
+			"This should never happen, contact the developer."
+		);
+		rowPointers[toIndices[n] + 1]++;
+	}
+	for(unsigned int n = 0; n < basisSize; n++)
+		rowPointers[n + 1] += rowPointers[n];
+
+	//Bucket the entries by row. The bucketing is stable, which together
+	//with the sort by column below makes the order independent of the
+	//order in which the entries were added.
+	vector<unsigned int> permutation(numHoppingAmplitudes);
+	vector<unsigned int> rowCounters(
+		rowPointers.begin(),
+		rowPointers.end() - 1
+	);
+	for(unsigned int n = 0; n < numHoppingAmplitudes; n++)
+		permutation[rowCounters[toIndices[n]]++] = n;
+	for(unsigned int row = 0; row < basisSize; row++){
+		stable_sort(
+			permutation.begin() + rowPointers[row],
+			permutation.begin() + rowPointers[row + 1],
+			[this](unsigned int lhs, unsigned int rhs){
+				return fromIndices[lhs] < fromIndices[rhs];
+			}
+		);
+	}
+
+	//Apply the permutation.
+	vector<unsigned int> sortedToIndices(numHoppingAmplitudes);
+	vector<unsigned int> sortedFromIndices(numHoppingAmplitudes);
+	vector<complex<double>> sortedAmplitudes(numHoppingAmplitudes);
+	vector<unsigned int> inversePermutation(numHoppingAmplitudes);
+	for(unsigned int n = 0; n < numHoppingAmplitudes; n++){
+		sortedToIndices[n] = toIndices[permutation[n]];
+		sortedFromIndices[n] = fromIndices[permutation[n]];
+		sortedAmplitudes[n] = amplitudes[permutation[n]];
+		inversePermutation[permutation[n]] = n;
+	}
+	toIndices = std::move(sortedToIndices);
+	fromIndices = std::move(sortedFromIndices);
+	amplitudes = std::move(sortedAmplitudes);
+	for(unsigned int n = 0; n < callbackEntries.size(); n++){
+		callbackEntries[n].position
+			= inversePermutation[callbackEntries[n].position];
+	}
+
+	//Collect the ranges of entries that make up the callback dependent
+	//matrix elements. Entries with the same to- and from-indices are
+	//adjacent after the sort, and each range is extended to cover all of
+	//them.
+	vector<unsigned int> callbackPositions;
+	for(unsigned int n = 0; n < callbackEntries.size(); n++)
+		callbackPositions.push_back(callbackEntries[n].position);
+	sort(callbackPositions.begin(), callbackPositions.end());
+	callbackDependentElementRanges.clear();
+	for(unsigned int n = 0; n < callbackPositions.size(); n++){
+		const unsigned int position = callbackPositions[n];
+		if(
+			callbackDependentElementRanges.size() != 0
+			&& position < callbackDependentElementRanges.back()
+		){
+			continue;
+		}
+
+		unsigned int begin = position;
+		while(begin > 0 && isSameElement(begin - 1, position))
+			begin--;
+		unsigned int end = position + 1;
+		while(
+			end < numHoppingAmplitudes
+			&& isSameElement(end, position)
+		){
+			end++;
+		}
+		callbackDependentElementRanges.push_back(begin);
+		callbackDependentElementRanges.push_back(end);
+	}
+}
+
+void CompiledHoppingAmplitudes::clear(){
+	basisSize = 0;
+	rowPointers.assign(1, 0);
+	toIndices.clear();
+	fromIndices.clear();
+	amplitudes.clear();
+	callbackEntries.clear();
+	callbackDependentElementRanges.clear();
+	revision = revisionCounter++;
+}
+
+};	//End of namespace TBTK
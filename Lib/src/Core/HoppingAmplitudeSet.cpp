@@ -28,8 +28,11 @@ using namespace std;
 
 namespace TBTK{
 
+mutex HoppingAmplitudeSet::sharedStagingBufferMutex;
+
 HoppingAmplitudeSet::HoppingAmplitudeSet(){
 	isConstructed = false;
+	initStagingBuffers();
 }
 
 HoppingAmplitudeSet::HoppingAmplitudeSet(
@@ -38,6 +41,7 @@ HoppingAmplitudeSet::HoppingAmplitudeSet(
 	HoppingAmplitudeTree(capacity)
 {
 	isConstructed = false;
+	initStagingBuffers();
 }
 
 HoppingAmplitudeSet::HoppingAmplitudeSet(
@@ -100,6 +104,10 @@ HoppingAmplitudeSet::HoppingAmplitudeSet(
 			""
 		);
 	}
+
+	initStagingBuffers();
+	if(isConstructed)
+		compileHoppingAmplitudes();
 }
 
 HoppingAmplitudeSet::~HoppingAmplitudeSet(){
@@ -165,6 +173,45 @@ string HoppingAmplitudeSet::serialize(Mode mode) const{
 	}
 }
 
+void HoppingAmplitudeSet::initStagingBuffers(){
+#ifdef _OPENMP
+	stagingBuffers.resize(omp_get_max_threads() + 1);
+#else
+	stagingBuffers.resize(1);
+#endif
+}
+
+void HoppingAmplitudeSet::insertStagedHoppingAmplitudes(){
+	bool isEmpty = true;
+	for(unsigned int n = 0; n < stagingBuffers.size(); n++)
+		if(stagingBuffers[n].size() != 0)
+			isEmpty = false;
+	if(isEmpty)
+		return;
+
+	HoppingAmplitudeTree::addInParallel(stagingBuffers);
+	unsigned int numStagingBuffers = stagingBuffers.size();
+	stagingBuffers.clear();
+	stagingBuffers.resize(numStagingBuffers);
+}
+
+void HoppingAmplitudeSet::compileHoppingAmplitudes(){
+	compiledHoppingAmplitudes.clear();
+	for(
+		HoppingAmplitudeTree::ConstIterator iterator
+			= HoppingAmplitudeTree::cbegin();
+		iterator != HoppingAmplitudeTree::cend();
+		++iterator
+	){
+		compiledHoppingAmplitudes.add(
+			getBasisIndex((*iterator).getToIndex()),
+			getBasisIndex((*iterator).getFromIndex()),
+			*iterator
+		);
+	}
+	compiledHoppingAmplitudes.construct(getBasisSize());
+}
+
 void HoppingAmplitudeSet::tabulate(
 	complex<double> **amplitudes,
 	int **table,
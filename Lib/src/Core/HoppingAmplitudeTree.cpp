@@ -120,6 +120,8 @@ HoppingAmplitudeTree::HoppingAmplitudeTree(
 			)
 			children.push_back(HoppingAmplitudeTree(elements.at(n), mode));
 		}
+		if(basisSize != -1)
+			generateIndexLookupTable();
 
 		break;
 	}
@@ -155,6 +157,8 @@ HoppingAmplitudeTree::HoppingAmplitudeTree(
 			catch(nlohmann::json::exception &e){
 				//It is valid to not have children.
 			}
+			if(basisSize != -1)
+				generateIndexLookupTable();
 		}
 		catch(nlohmann::json::exception &e){
 			TBTKExit(
@@ -238,9 +242,106 @@ void HoppingAmplitudeTree::print(unsigned int subindex){
 }
 
 void HoppingAmplitudeTree::add(HoppingAmplitude ha){
+	indexLookupTable.reset();
 	_add(ha, 0);
 }
 
+void HoppingAmplitudeTree::addInParallel(
+	vector<vector<HoppingAmplitude>> &hoppingAmplitudeLists
+){
+	indexLookupTable.reset();
+
+	//Perform the root level part of _add() serially and count the number
+	//of HoppingAmplitudes that go into each child node.
+	vector<unsigned int> childSizes(children.size(), 0);
+	for(unsigned int n = 0; n < hoppingAmplitudeLists.size(); n++){
+		for(
+			unsigned int c = 0;
+			c < hoppingAmplitudeLists[n].size();
+			c++
+		){
+			HoppingAmplitude &ha = hoppingAmplitudeLists[n][c];
+			const Index &fromIndex = ha.getFromIndex();
+			if(fromIndex.getSize() == 0){
+				_add(ha, 0);
+				continue;
+			}
+
+			int currentIndex = fromIndex[0];
+			TBTKAssert(
+				currentIndex >= 0,
+				"HoppingAmplitudeTree::addInParallel()",
+				"Invalid Index. Only indices with non-negative"
+				<< " subindices can be added. But the"
+				<< " from-Index " << fromIndex.toString()
+				<< " has a negative subindex in position"
+				<< " '0'.",
+				""
+			);
+			if(currentIndex >= (int)children.size()){
+				children.resize(currentIndex + 1);
+				childSizes.resize(currentIndex + 1, 0);
+			}
+			TBTKAssert(
+				hoppingAmplitudes.size() == 0,
+				"HoppingAmplitudeTree::addInParallel()",
+				"Incompatible HoppingAmplitudes. Tried to add"
+				<< " a HoppingAmplitude with from-Index "
+				<< fromIndex.toString() << ", but"
+				<< " HoppingAmplitude with from-Index "
+				<< hoppingAmplitudes[0].getFromIndex(
+				).toString() << " has already been added.",
+				""
+			);
+			const Index &toIndex = ha.getToIndex();
+			if(
+				toIndex.getSize() == 0
+				|| currentIndex != toIndex[0]
+			){
+				isPotentialBlockSeparator = false;
+			}
+			childSizes[currentIndex]++;
+		}
+	}
+
+	//Bucket the HoppingAmplitudes by child node, preserving the order in
+	//which they appear in the lists.
+	vector<unsigned int> childOffsets(children.size() + 1, 0);
+	for(unsigned int n = 0; n < children.size(); n++)
+		childOffsets[n + 1] = childOffsets[n] + childSizes[n];
+	vector<HoppingAmplitude*> buckets(childOffsets.back());
+	vector<unsigned int> counters(
+		childOffsets.begin(),
+		childOffsets.end() - 1
+	);
+	for(unsigned int n = 0; n < hoppingAmplitudeLists.size(); n++){
+		for(
+			unsigned int c = 0;
+			c < hoppingAmplitudeLists[n].size();
+			c++
+		){
+			HoppingAmplitude &ha = hoppingAmplitudeLists[n][c];
+			if(ha.getFromIndex().getSize() == 0)
+				continue;
+
+			buckets[counters[ha.getFromIndex()[0]]++] = &ha;
+		}
+	}
+
+	//The subtrees are independent and can therefore be built in
+	//parallel.
+	#pragma omp parallel for schedule(dynamic)
+	for(unsigned int n = 0; n < children.size(); n++){
+		for(
+			unsigned int c = childOffsets[n];
+			c < childOffsets[n+1];
+			c++
+		){
+			children[n]._add(*buckets[c], 1);
+		}
+	}
+}
+
 void HoppingAmplitudeTree::_add(HoppingAmplitude &ha, unsigned int subindex){
 	if(subindex < ha.getFromIndex().getSize()){
 		//If the current subindex is not the last, the HoppingAmplitude
@@ -314,7 +415,7 @@ void HoppingAmplitudeTree::_add(HoppingAmplitude &ha, unsigned int subindex){
 			""
 		);
 		//Add HoppingAmplitude to node.
-		hoppingAmplitudes.push_back(ha);
+		hoppingAmplitudes.push_back(std::move(ha));
 	}
 }
 
@@ -499,6 +600,12 @@ const std::vector<
 }
 
 int HoppingAmplitudeTree::getBasisIndex(const Index &index) const{
+	if(indexLookupTable){
+		int basisIndex = indexLookupTable->get(index);
+		if(basisIndex != -1)
+			return basisIndex;
+	}
+
 	return _getBasisIndex(index, 0);
 }
 
@@ -595,6 +702,7 @@ int HoppingAmplitudeTree::getMaxIndex() const{
 
 void HoppingAmplitudeTree::generateBasisIndices(){
 	basisSize = generateBasisIndices(0);
+	generateIndexLookupTable();
 }
 
 int HoppingAmplitudeTree::generateBasisIndices(int i){
@@ -615,6 +723,29 @@ int HoppingAmplitudeTree::generateBasisIndices(int i){
 	return i;
 }
 
+void HoppingAmplitudeTree::generateIndexLookupTable(){
+	IndexLookupTable *indexLookupTable = new IndexLookupTable();
+	Index index;
+	addToIndexLookupTable(*indexLookupTable, index);
+	this->indexLookupTable.reset(indexLookupTable);
+}
+
+void HoppingAmplitudeTree::addToIndexLookupTable(
+	IndexLookupTable &indexLookupTable,
+	Index &index
+) const{
+	if(basisIndex != -1){
+		indexLookupTable.add(index, basisIndex);
+		return;
+	}
+
+	for(unsigned int n = 0; n < children.size(); n++){
+		index.pushBack(n);
+		children[n].addToIndexLookupTable(indexLookupTable, index);
+		index.popBack();
+	}
+}
+
 class SortHelperClass{
 public:
 	static HoppingAmplitudeTree *rootNode;
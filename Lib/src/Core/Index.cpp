@@ -33,46 +33,40 @@ namespace TBTK{
 
 Index::Index(const Index &head, const Index &tail){
 	indices.reserve(head.getSize() + tail.getSize());
-	indices.insert(
-		indices.end(),
-		head.indices.begin(),
-		head.indices.end()
-	);
-	indices.insert(
-		indices.end(),
-		tail.indices.begin(),
-		tail.indices.end()
-	);
+	for(unsigned int n = 0; n < head.getSize(); n++)
+		indices.pushBack(head.indices[n]);
+	for(unsigned int n = 0; n < tail.getSize(); n++)
+		indices.pushBack(tail.indices[n]);
 }
 
 /*Index::Index(initializer_list<initializer_list<Subindex>> indexList){
 	for(unsigned int n = 0; n < indexList.size(); n++){
 		if(n > 0)
-			indices.push_back(IDX_SEPARATOR);
+			indices.pushBack(IDX_SEPARATOR);
 		for(unsigned int c = 0; c < (indexList.begin()+n)->size(); c++)
-			indices.push_back(*((indexList.begin() + n)->begin() + c));
+			indices.pushBack(*((indexList.begin() + n)->begin() + c));
 	}
 }*/
 
 Index::Index(const vector<vector<Subindex>> &indexList){
 	for(unsigned int n = 0; n < indexList.size(); n++){
 		if(n > 0)
-			indices.push_back(IDX_SEPARATOR);
+			indices.pushBack(IDX_SEPARATOR);
 		for(unsigned int c = 0; c < indexList.at(n).size(); c++)
-			indices.push_back(indexList.at(n).at(c));
+			indices.pushBack(indexList.at(n).at(c));
 	}
 }
 
 Index::Index(initializer_list<Index> indexList){
 	for(unsigned int n = 0; n < indexList.size(); n++){
 		if(n > 0)
-			indices.push_back(IDX_SEPARATOR);
+			indices.pushBack(IDX_SEPARATOR);
 		for(
 			unsigned int c = 0;
 			c < (indexList.begin() + n)->getSize();
 			c++
 		){
-			indices.push_back((indexList.begin() + n)->at(c));
+			indices.pushBack((indexList.begin() + n)->at(c));
 		}
 	}
 }
@@ -80,13 +74,13 @@ Index::Index(initializer_list<Index> indexList){
 Index::Index(vector<Index> indexList){
 	for(unsigned int n = 0; n < indexList.size(); n++){
 		if(n > 0)
-			indices.push_back(IDX_SEPARATOR);
+			indices.pushBack(IDX_SEPARATOR);
 		for(
 			unsigned int c = 0;
 			c < (indexList.begin() + n)->getSize();
 			c++
 		){
-			indices.push_back((indexList.begin() + n)->at(c));
+			indices.pushBack((indexList.begin() + n)->at(c));
 		}
 	}
 }
@@ -258,7 +252,7 @@ Index::Index(const string &indexString){
 	);
 
 	for(unsigned int n = 0; n < indexVector.size(); n++)
-		indices.push_back(indexVector.at(n));
+		indices.pushBack(indexVector.at(n));
 }
 
 Index::Index(const string &serialization, Serializable::Mode mode){
@@ -281,7 +275,7 @@ Index::Index(const string &serialization, Serializable::Mode mode){
 		ss.str(content);
 		Subindex subindex;
 		while((ss >> subindex)){
-			indices.push_back(subindex);
+			indices.pushBack(subindex);
 			char c;
 			TBTKAssert(
 				!(ss >> c) || c == ',',
@@ -305,7 +299,9 @@ Index::Index(const string &serialization, Serializable::Mode mode){
 
 		try{
 			nlohmann::json j = nlohmann::json::parse(serialization);
-			indices = j.at("indices").get<vector<Subindex>>();
+			indices = SmallVector<Subindex, 8>(
+				j.at("indices").get<vector<Subindex>>()
+			);
 		}
 		catch(nlohmann::json::exception &e){
 			TBTKExit(
@@ -391,11 +387,11 @@ Index Index::getUnitRange(){
 }
 
 Index Index::getSubIndex(int first, int last) const{
-	vector<Subindex> newSubindices;
+	Index subIndex;
 	for(int n = first; n <= last; n++)
-		newSubindices.push_back(indices.at(n));
+		subIndex.pushBack(indices.at(n));
 
-	return Index(newSubindices);
+	return subIndex;
 }
 
 string Index::serialize(Serializable::Mode mode) const{
@@ -404,7 +400,7 @@ string Index::serialize(Serializable::Mode mode) const{
 	{
 		stringstream ss;
 		ss << "Index(";
-		for(unsigned int n = 0; n < indices.size(); n++){
+		for(unsigned int n = 0; n < indices.getSize(); n++){
 			if(n != 0)
 				ss << ",";
 			ss << Serializable::serialize(indices.at(n), mode);
@@ -417,7 +413,9 @@ string Index::serialize(Serializable::Mode mode) const{
 	{
 		nlohmann::json j;
 		j["id"] = "Index";
-		j["indices"] = nlohmann::json(indices);
+		j["indices"] = nlohmann::json(
+			vector<Subindex>(indices.begin(), indices.end())
+		);
 
 		return j.dump();
 	}
@@ -0,0 +1,69 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file IndexLookupTable.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/IndexLookupTable.h"
+#include "TBTK/TBTKMacros.h"
+
+using namespace std;
+
+namespace TBTK{
+
+IndexLookupTable::IndexLookupTable(){
+	offsets.push_back(0);
+}
+
+void IndexLookupTable::add(const Index &index, int value){
+	TBTKAssert(
+		value >= 0,
+		"IndexLookupTable::add()",
+		"Invalid value '" << value << "'. The value must be"
+		<< " non-negative.",
+		""
+	);
+
+	if(2*(values.size() + 1) > slots.size())
+		grow();
+
+	unsigned int slot = findSlot(index);
+	if(slots[slot] != -1){
+		values[slots[slot]] = value;
+		return;
+	}
+
+	slots[slot] = values.size();
+	for(unsigned int n = 0; n < index.getSize(); n++)
+		subindices.push_back(index[n]);
+	offsets.push_back(subindices.size());
+	values.push_back(value);
+}
+
+void IndexLookupTable::grow(){
+	unsigned int numSlots = (slots.size() == 0 ? 16 : 2*slots.size());
+	slots.assign(numSlots, -1);
+	const unsigned int mask = numSlots - 1;
+	for(unsigned int entry = 0; entry < values.size(); entry++){
+		unsigned int slot = hash(entry) & mask;
+		while(slots[slot] != -1)
+			slot = (slot + 1) & mask;
+		slots[slot] = entry;
+	}
+}
+
+};	//End of namespace TBTK
@@ -86,6 +86,9 @@ IndexTree::IndexTree(const string &serialization, Mode mode){
 		ss.str(elements.at(counter++));
 		ss >> size;
 
+		if(size != -1)
+			generateIndexLookupTable();
+
 		break;
 	}
 	case Mode::JSON:
@@ -109,6 +112,8 @@ IndexTree::IndexTree(const string &serialization, Mode mode){
 			indexSeparator = j.at("indexSeparator").get<bool>();
 			linearIndex = j.at("linearIndex").get<int>();
 			size = j.at("size").get<int>();
+			if(size != -1)
+				generateIndexLookupTable();
 		}
 		catch(nlohmann::json::exception &e){
 			TBTKExit(
@@ -164,6 +169,7 @@ bool operator==(const IndexTree &lhs, const IndexTree &rhs){
 }
 
 void IndexTree::add(const Index &index){
+	indexLookupTable.reset();
 	add(index, 0);
 }
 
@@ -293,6 +299,7 @@ void IndexTree::add(const Index &index, unsigned int subindex){
 
 void IndexTree::generateLinearMap(){
 	size = generateLinearMap(0);
+	generateIndexLookupTable();
 }
 
 int IndexTree::generateLinearMap(int i){
@@ -312,11 +319,50 @@ int IndexTree::generateLinearMap(int i){
 	return i;
 }
 
+void IndexTree::generateIndexLookupTable(){
+	IndexLookupTable *indexLookupTable = new IndexLookupTable();
+	Index index;
+	addToIndexLookupTable(*indexLookupTable, index);
+	this->indexLookupTable.reset(indexLookupTable);
+}
+
+void IndexTree::addToIndexLookupTable(
+	IndexLookupTable &indexLookupTable,
+	Index &index
+) const{
+	if(linearIndex != -1){
+		indexLookupTable.add(index, linearIndex);
+		return;
+	}
+
+	if(indexSeparator)
+		index.pushBack(IDX_SEPARATOR);
+
+	for(unsigned int n = 0; n < children.size(); n++){
+		if(wildcardIndex)
+			index.pushBack(wildcardType);
+		else
+			index.pushBack(n);
+
+		children[n].addToIndexLookupTable(indexLookupTable, index);
+		index.popBack();
+	}
+
+	if(indexSeparator)
+		index.popBack();
+}
+
 int IndexTree::getLinearIndex(
 	const Index &index,
 	SearchMode searchMode,
 	bool returnNegativeForMissingIndex
 ) const{
+	if(indexLookupTable){
+		int linearIndex = indexLookupTable->get(index);
+		if(linearIndex != -1)
+			return linearIndex;
+	}
+
 	return getLinearIndex(
 		index,
 		0,
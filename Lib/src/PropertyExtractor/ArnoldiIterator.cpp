@@ -36,7 +36,7 @@ ArnoldiIterator::ArnoldiIterator(){
 
 Property::EigenValues ArnoldiIterator::getEigenValues(){
 	const Solver::ArnoldiIterator &solver = getSolver();
-	int size = solver.getNumEigenValues();
+	int size = solver.getNumStates();
 	const CArray<complex<double>> &ev = solver.getEigenValues();
 
 	Property::EigenValues eigenValues(size);
@@ -149,7 +149,7 @@ Property::DOS ArnoldiIterator::calculateDOS(){
 	Property::DOS dos(energyWindow);
 	std::vector<double> &data = dos.getDataRW();
 	double dE = dos.getDeltaE();
-	for(int n = 0; n < solver.getNumEigenValues(); n++){
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
 		int e = (int)(
 			(
 				(
@@ -367,7 +367,7 @@ void ArnoldiIterator::calculateLDOSCallback(
 
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	double dE = ldos.getDeltaE();
-	for(int n = 0; n < solver.getNumEigenValues(); n++){
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
 		if(
 			real(eigenValues[n]) > energyWindow[0]
 			&& real(eigenValues[n]) < energyWindow.getLast()
@@ -405,7 +405,7 @@ void ArnoldiIterator::calculateSpinPolarizedLDOSCallback(
 	index_d.at(spinIndex) = 1;
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	double dE = spinPolarizedLDOS.getDeltaE();
-	for(int n = 0; n < solver.getNumEigenValues(); n++){
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
 		if(
 			real(eigenValues[n]) > energyWindow[0]
 			&& real(eigenValues[n]) < energyWindow.getLast()
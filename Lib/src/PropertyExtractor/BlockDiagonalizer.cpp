@@ -24,6 +24,7 @@
 #include "TBTK/Functions.h"
 #include "TBTK/Streams.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
@@ -537,8 +538,8 @@ void BlockDiagonalizer::calculateMagnetizationCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	int firstStateInBlock = solver.getFirstStateInBlock(index);
-	int lastStateInBlock = solver.getLastStateInBlock(index);
+	int firstStateInBlock = solver.getFirstStateInBlock(index_u);
+	int lastStateInBlock = solver.getLastStateInBlock(index_u);
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			solver.getEigenValue(n),
@@ -606,8 +607,8 @@ void BlockDiagonalizer::calculateSP_LDOSCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	int firstStateInBlock = solver.getFirstStateInBlock(index);
-	int lastStateInBlock = solver.getLastStateInBlock(index);
+	int firstStateInBlock = solver.getFirstStateInBlock(index_u);
+	int lastStateInBlock = solver.getLastStateInBlock(index_u);
 	double dE = spinPolarizedLDOS.getDeltaE();
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	for(int n = firstStateInBlock; n <= lastStateInBlock; n++){
@@ -630,5 +631,251 @@ void BlockDiagonalizer::calculateSP_LDOSCallback(
 	}
 }
 
+BlockDiagonalizer::Accumulator::Accumulator(
+	BlockDiagonalizer &propertyExtractor
+) :
+	propertyExtractor(propertyExtractor)
+{
+}
+
+void BlockDiagonalizer::Accumulator::addDensity(vector<Index> patterns){
+	PatternValidator::validateDensityPatterns(patterns);
+	IndexTree memoryLayout
+		= propertyExtractor.generateMemoryLayout(patterns);
+
+	density = make_shared<Property::Density>(memoryLayout);
+	densityEntries = createEntries(patterns, memoryLayout, *density);
+}
+
+void BlockDiagonalizer::Accumulator::addLDOS(vector<Index> patterns){
+	PatternValidator::validateLDOSPatterns(patterns);
+	TBTKAssert(
+		propertyExtractor.getEnergyType() == EnergyType::Real,
+		"PropertyExtractor::BlockDiagonalizer::Accumulator::addLDOS()",
+		"Only real energies supported for the LDOS.",
+		"Use PropertyExtractor::BlockDiagonalizer::setEnergyWindow()"
+		<< " to set a real energy window."
+	);
+	IndexTree memoryLayout
+		= propertyExtractor.generateMemoryLayout(patterns);
+
+	ldos = make_shared<Property::LDOS>(
+		memoryLayout,
+		propertyExtractor.getEnergyWindow()
+	);
+	ldosEntries = createEntries(patterns, memoryLayout, *ldos);
+}
+
+void BlockDiagonalizer::Accumulator::addSpinPolarizedLDOS(
+	vector<Index> patterns
+){
+	PatternValidator::validateSpinPolarizedLDOSPatterns(patterns);
+	TBTKAssert(
+		propertyExtractor.getEnergyType() == EnergyType::Real,
+		"PropertyExtractor::BlockDiagonalizer::Accumulator::"
+		"addSpinPolarizedLDOS()",
+		"Only real energies supported for the SpinPolarizedLDOS.",
+		"Use PropertyExtractor::BlockDiagonalizer::setEnergyWindow()"
+		<< " to set a real energy window."
+	);
+	IndexTree memoryLayout
+		= propertyExtractor.generateMemoryLayout(patterns);
+
+	spinPolarizedLDOS = make_shared<Property::SpinPolarizedLDOS>(
+		memoryLayout,
+		propertyExtractor.getEnergyWindow()
+	);
+	spinPolarizedLDOSEntries = createEntries(
+		patterns,
+		memoryLayout,
+		*spinPolarizedLDOS
+	);
+}
+
+const Property::Density& BlockDiagonalizer::Accumulator::getDensity() const{
+	TBTKAssert(
+		density != nullptr,
+		"PropertyExtractor::BlockDiagonalizer::Accumulator::getDensity()",
+		"The Density is not accumulated.",
+		"Use addDensity() to accumulate the Density."
+	);
+
+	return *density;
+}
+
+const Property::LDOS& BlockDiagonalizer::Accumulator::getLDOS() const{
+	TBTKAssert(
+		ldos != nullptr,
+		"PropertyExtractor::BlockDiagonalizer::Accumulator::getLDOS()",
+		"The LDOS is not accumulated.",
+		"Use addLDOS() to accumulate the LDOS."
+	);
+
+	return *ldos;
+}
+
+const Property::SpinPolarizedLDOS&
+BlockDiagonalizer::Accumulator::getSpinPolarizedLDOS() const{
+	TBTKAssert(
+		spinPolarizedLDOS != nullptr,
+		"PropertyExtractor::BlockDiagonalizer::Accumulator::"
+		"getSpinPolarizedLDOS()",
+		"The SpinPolarizedLDOS is not accumulated.",
+		"Use addSpinPolarizedLDOS() to accumulate the"
+		<< " SpinPolarizedLDOS."
+	);
+
+	return *spinPolarizedLDOS;
+}
+
+void BlockDiagonalizer::Accumulator::beginDiagonalization(){
+	if(density != nullptr){
+		vector<double> &data = density->getDataRW();
+		for(unsigned int n = 0; n < data.size(); n++)
+			data[n] = 0;
+	}
+	if(ldos != nullptr){
+		vector<double> &data = ldos->getDataRW();
+		for(unsigned int n = 0; n < data.size(); n++)
+			data[n] = 0;
+	}
+	if(spinPolarizedLDOS != nullptr){
+		vector<SpinMatrix> &data = spinPolarizedLDOS->getDataRW();
+		for(unsigned int n = 0; n < data.size(); n++)
+			data[n] = SpinMatrix(0);
+	}
+}
+
+void BlockDiagonalizer::Accumulator::processBlock(
+	const Solver::BlockDiagonalizer &blockDiagonalizer,
+	unsigned int firstState,
+	unsigned int lastState
+){
+	if(density != nullptr){
+		processEntries(
+			calculateDensityCallback,
+			*density,
+			densityEntries,
+			firstState,
+			lastState
+		);
+	}
+	if(ldos != nullptr){
+		processEntries(
+			calculateLDOSCallback,
+			*ldos,
+			ldosEntries,
+			firstState,
+			lastState
+		);
+	}
+	if(spinPolarizedLDOS != nullptr){
+		processEntries(
+			calculateSP_LDOSCallback,
+			*spinPolarizedLDOS,
+			spinPolarizedLDOSEntries,
+			firstState,
+			lastState
+		);
+	}
+}
+
+template<typename DataType>
+vector<BlockDiagonalizer::Accumulator::Entry>
+BlockDiagonalizer::Accumulator::createEntries(
+	const vector<Index> &patterns,
+	const IndexTree &memoryLayout,
+	const Property::AbstractProperty<DataType> &property
+) const{
+	const Model &model = propertyExtractor.getSolver().getModel();
+	IndexTree allIndices = propertyExtractor.generateAllIndices(patterns);
+
+	vector<Entry> entries;
+	for(
+		IndexTree::ConstIterator iterator = allIndices.cbegin();
+		iterator != allIndices.end();
+		++iterator
+	){
+		Entry entry;
+		entry.index = *iterator;
+		entry.offset = property.getOffset(entry.index);
+		entry.spinIndex = -1;
+		vector<unsigned int> spinIndices
+			= memoryLayout.getSubindicesMatching(
+				IDX_SPIN,
+				entry.index,
+				IndexTree::SearchMode::MatchWildcards
+			);
+		if(spinIndices.size() != 0){
+			TBTKAssert(
+				spinIndices.size() == 1,
+				"PropertyExtractor::BlockDiagonalizer::"
+				"Accumulator::createEntries()",
+				"Several spin indeces found.",
+				"Use IDX_SPIN at most once per pattern to"
+				<< " indicate spin index."
+			);
+			entry.spinIndex = spinIndices[0];
+		}
+
+		//The spin subindex is a wildcard in the Index that is passed
+		//to the callback. Replace it by zero to identify the block.
+		Index basisIndex = entry.index;
+		if(entry.spinIndex != -1)
+			basisIndex.at(entry.spinIndex) = 0;
+		entry.basisIndex = model.getBasisIndex(basisIndex);
+
+		entries.push_back(entry);
+	}
+	stable_sort(
+		entries.begin(),
+		entries.end(),
+		[](const Entry &lhs, const Entry &rhs){
+			return lhs.basisIndex < rhs.basisIndex;
+		}
+	);
+
+	return entries;
+}
+
+void BlockDiagonalizer::Accumulator::processEntries(
+	void (*callback)(
+		PropertyExtractor *cb_this,
+		Property::Property &property,
+		const Index &index,
+		int offset,
+		Information &information
+	),
+	Property::Property &property,
+	const vector<Entry> &entries,
+	unsigned int firstState,
+	unsigned int lastState
+){
+	vector<Entry>::const_iterator iterator = lower_bound(
+		entries.begin(),
+		entries.end(),
+		firstState,
+		[](const Entry &entry, unsigned int state){
+			return entry.basisIndex < state;
+		}
+	);
+	Information information;
+	for(
+		;
+		iterator != entries.end() && iterator->basisIndex <= lastState;
+		++iterator
+	){
+		if(iterator->spinIndex != -1)
+			information.setSpinIndex(iterator->spinIndex);
+		callback(
+			&propertyExtractor,
+			property,
+			iterator->index,
+			iterator->offset,
+			information
+		);
+	}
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -23,6 +23,8 @@
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <cmath>
+#include <map>
 #include <set>
 
 using namespace std;
@@ -65,6 +67,9 @@ ChebyshevExpander::ChebyshevExpander(Solver::ChebyshevExpander &solver){
 
 	setSolver(solver);
 
+	numRandomVectors = 10;
+	randomSeed = time(nullptr);
+
 	setEnergyWindow(
 		energyWindow[0],
 		energyWindow.getLast(),
@@ -111,7 +116,7 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 	IndexTree memoryLayout;
 	IndexTree fromIndices;
 	set<unsigned int> toIndexSizes;
-	const Solver::ChebyshevExpander &solver = getSolver();
+	Solver::ChebyshevExpander &solver = getSolver();
 	for(unsigned int n = 0; n < patterns.size(); n++){
 		const vector<Index>& pattern = *(patterns.begin() + n);
 
@@ -169,6 +174,9 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 		getEnergyWindow()
 	);
 
+	//Collect the 'to'-indices for each 'from'-index.
+	vector<Index> fromIndexList;
+	vector<vector<Index>> toIndexLists;
 	for(
 		IndexTree::ConstIterator iterator = fromIndices.cbegin();
 		iterator != fromIndices.cend();
@@ -197,34 +205,87 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunction(
 			}
 		}
 
-		Property::GreensFunction gf = calculateGreensFunctions(
-			toIndices,
-			fromIndex,
-			type
+		fromIndexList.push_back(fromIndex);
+		toIndexLists.push_back(toIndices);
+	}
+
+	//Calculate the Green's function for blocks of 'from'-indices, using
+	//the union of the blocks 'to'-indices as 'to'-indices.
+	Solver::ChebyshevExpander::Type chebyshevType = getSolverType(type);
+	std::vector<complex<double>> &data = greensFunction.getDataRW();
+	const unsigned int blockSize = solver.getBlockSize();
+	for(
+		unsigned int blockStart = 0;
+		blockStart < fromIndexList.size();
+		blockStart += blockSize
+	){
+		const unsigned int blockEnd = min(
+			blockStart + blockSize,
+			(unsigned int)fromIndexList.size()
+		);
+		vector<Index> fromBlock(
+			fromIndexList.begin() + blockStart,
+			fromIndexList.begin() + blockEnd
 		);
 
-		for(unsigned int n = 0; n < toIndices.size(); n++){
-			std::vector<complex<double>> &data
-				= greensFunction.getDataRW();
-			const std::vector<complex<double>> &dataGF
-				= gf.getData();
+		vector<Index> toBlock;
+		map<Index, unsigned int> toBlockIDs;
+		vector<unsigned int> fromIDs;
+		vector<unsigned int> toIDs;
+		vector<unsigned int> offsets;
+		for(unsigned int f = 0; f < fromBlock.size(); f++){
+			const vector<Index> &toIndices
+				= toIndexLists[blockStart + f];
+			for(unsigned int n = 0; n < toIndices.size(); n++){
+				map<Index, unsigned int>::iterator iterator
+					= toBlockIDs.find(toIndices[n]);
+				if(iterator == toBlockIDs.end()){
+					iterator = toBlockIDs.insert(
+						make_pair(
+							toIndices[n],
+							toBlock.size()
+						)
+					).first;
+					toBlock.push_back(toIndices[n]);
+				}
+
+				fromIDs.push_back(f);
+				toIDs.push_back(iterator->second);
+				offsets.push_back(
+					greensFunction.getOffset(
+						{toIndices[n], fromBlock[f]}
+					)
+				);
+			}
+		}
 
-			Index compoundIndex = Index({toIndices[n], fromIndex});
+		vector<
+			vector<vector<complex<double>>>
+		> coefficients = solver.calculateCoefficients(
+			toBlock,
+			fromBlock
+		);
 
-			unsigned int offset = greensFunction.getOffset(
-				compoundIndex
-			);
-			unsigned int offsetGF = gf.getOffset(
-				compoundIndex
+		//The first Green's function is generated serially to ensure
+		//that any lookup table is set up before the parallel section.
+		const unsigned int energyResolution
+			= getEnergyWindow().getResolution();
+		vector<complex<double>> firstGreensFunctionData
+			= solver.generateGreensFunction(
+				coefficients[fromIDs[0]][toIDs[0]],
+				chebyshevType
 			);
-
-			for(
-				unsigned int c = 0;
-				c < getEnergyWindow().getResolution();
-				c++
-			){
-				data[offset + c] = dataGF[offsetGF + c];
-			}
+		for(unsigned int c = 0; c < energyResolution; c++)
+			data[offsets[0] + c] = firstGreensFunctionData[c];
+		#pragma omp parallel for
+		for(unsigned int n = 1; n < offsets.size(); n++){
+			vector<complex<double>> greensFunctionData
+				= solver.generateGreensFunction(
+					coefficients[fromIDs[n]][toIDs[n]],
+					chebyshevType
+				);
+			for(unsigned int c = 0; c < energyResolution; c++)
+				data[offsets[n] + c] = greensFunctionData[c];
 		}
 	}
 
@@ -242,27 +303,7 @@ Property::GreensFunction ChebyshevExpander::calculateGreensFunctions(
 		from
 	);
 
-	Solver::ChebyshevExpander::Type chebyshevType;
-	switch(type){
-	case Property::GreensFunction::Type::Advanced:
-		chebyshevType = Solver::ChebyshevExpander::Type::Advanced;
-		break;
-	case Property::GreensFunction::Type::Retarded:
-		chebyshevType = Solver::ChebyshevExpander::Type::Retarded;
-		break;
-	case Property::GreensFunction::Type::Principal:
-		chebyshevType = Solver::ChebyshevExpander::Type::Principal;
-		break;
-	case Property::GreensFunction::Type::NonPrincipal:
-		chebyshevType = Solver::ChebyshevExpander::Type::NonPrincipal;
-		break;
-	default:
-		TBTKExit(
-			"PropertyExtractor::ChebyshevExpander::calculateGreensFunctions()",
-			"Unknown GreensFunction type.",
-			"This should never happen, contact the developer."
-		);
-	}
+	Solver::ChebyshevExpander::Type chebyshevType = getSolverType(type);
 
 	IndexTree memoryLayout;
 	for(unsigned int n = 0; n < to.size(); n++)
@@ -458,9 +499,9 @@ Property::LDOS ChebyshevExpander::calculateLDOS(Index pattern, Index ranges){
 	vector<int> loopRanges = getLoopRanges(pattern, ranges);
 	Property::LDOS ldos(loopRanges, getEnergyWindow());
 
-	Information information;
+	IndexCollectingInformation information;
 	calculate(
-		calculateLDOSCallback,
+		collectIndicesCallback,
 		ldos,
 		pattern,
 		ranges,
@@ -468,6 +509,11 @@ Property::LDOS ChebyshevExpander::calculateLDOS(Index pattern, Index ranges){
 		getEnergyWindow().getResolution(),
 		information
 	);
+	calculateLDOSBlockwise(
+		information.getIndices(),
+		information.getOffsets(),
+		ldos
+	);
 
 	return ldos;
 }
@@ -492,18 +538,111 @@ Property::LDOS ChebyshevExpander::calculateLDOS(
 
 	Property::LDOS ldos(memoryLayout, getEnergyWindow());
 
-	Information information;
+	IndexCollectingInformation information;
 	calculate(
-		calculateLDOSCallback,
+		collectIndicesCallback,
 		allIndices,
 		memoryLayout,
 		ldos,
 		information
 	);
+	calculateLDOSBlockwise(
+		information.getIndices(),
+		information.getOffsets(),
+		ldos
+	);
 
 	return ldos;
 }
 
+Property::DOS ChebyshevExpander::calculateDOS(){
+	Solver::ChebyshevExpander &solver = getSolver();
+	vector<vector<complex<double>>> coefficients
+		= solver.calculateTraceCoefficients(
+			numRandomVectors,
+			randomSeed
+		);
+
+	//The DOS is linear in the coefficients, which means that the average
+	//can be taken before the DOS is generated.
+	for(unsigned int r = 1; r < coefficients.size(); r++)
+		for(unsigned int n = 0; n < coefficients[r].size(); n++)
+			coefficients[0][n] += coefficients[r][n];
+	for(unsigned int n = 0; n < coefficients[0].size(); n++)
+		coefficients[0][n] /= (double)numRandomVectors;
+
+	vector<complex<double>> greensFunction
+		= solver.generateGreensFunction(
+			coefficients[0],
+			Solver::ChebyshevExpander::Type::NonPrincipal
+		);
+
+	const Range &energyWindow = getEnergyWindow();
+	Property::DOS dos(energyWindow);
+	for(unsigned int e = 0; e < energyWindow.getResolution(); e++)
+		dos(e) = imag(greensFunction[e])/M_PI;
+
+	return dos;
+}
+
+Property::DOS ChebyshevExpander::calculateDOS(
+	Property::DOS &statisticalError
+){
+	TBTKAssert(
+		numRandomVectors > 1,
+		"PropertyExtractor::ChebyshevExpander::calculateDOS()",
+		"At least two random vectors are required to estimate the"
+		<< " statistical error.",
+		"Use PropertyExtractor::ChebyshevExpander::setNumRandomVectors()"
+		<< " to set the number of random vectors."
+	);
+
+	Solver::ChebyshevExpander &solver = getSolver();
+	vector<vector<complex<double>>> coefficients
+		= solver.calculateTraceCoefficients(
+			numRandomVectors,
+			randomSeed
+		);
+
+	const Range &energyWindow = getEnergyWindow();
+	Property::DOS dos(energyWindow);
+	Property::DOS dosSquared(energyWindow);
+	//The first Green's function is generated serially to ensure that any
+	//lookup table is set up before the parallel section.
+	vector<vector<complex<double>>> greensFunctions(numRandomVectors);
+	greensFunctions[0] = solver.generateGreensFunction(
+		coefficients[0],
+		Solver::ChebyshevExpander::Type::NonPrincipal
+	);
+	#pragma omp parallel for
+	for(unsigned int r = 1; r < numRandomVectors; r++){
+		greensFunctions[r] = solver.generateGreensFunction(
+			coefficients[r],
+			Solver::ChebyshevExpander::Type::NonPrincipal
+		);
+	}
+	for(unsigned int r = 0; r < numRandomVectors; r++){
+		for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
+			double sample = imag(greensFunctions[r][e])/M_PI;
+			dos(e) += sample;
+			dosSquared(e) += sample*sample;
+		}
+	}
+
+	statisticalError = Property::DOS(energyWindow);
+	for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
+		dos(e) /= numRandomVectors;
+		double variance = (
+			dosSquared(e)/numRandomVectors - dos(e)*dos(e)
+		)*numRandomVectors/(numRandomVectors - 1.);
+		statisticalError(e) = sqrt(
+			max(variance, 0.)/numRandomVectors
+		);
+	}
+
+	return dos;
+}
+
 Property::SpinPolarizedLDOS ChebyshevExpander::calculateSpinPolarizedLDOS(
 	Index pattern,
 	Index ranges
@@ -658,31 +797,6 @@ void ChebyshevExpander::calculateMAGCallback(
 	}
 }
 
-void ChebyshevExpander::calculateLDOSCallback(
-	PropertyExtractor *cb_this,
-	Property::Property &property,
-	const Index &index,
-	int offset,
-	Information &information
-){
-	ChebyshevExpander *propertyExtractor = (ChebyshevExpander*)cb_this;
-	Property::LDOS &ldos = (Property::LDOS&)property;
-	vector<double> &data = ldos.getDataRW();
-
-	Property::GreensFunction greensFunction
-		= propertyExtractor->calculateGreensFunction(
-			index,
-			index,
-			Property::GreensFunction::Type::NonPrincipal
-		);
-	const std::vector<complex<double>> &greensFunctionData
-		= greensFunction.getData();
-
-	const Range &energyWindow = propertyExtractor->getEnergyWindow();
-	for(unsigned int n = 0; n < energyWindow.getResolution(); n++)
-		data[offset + n] += imag(greensFunctionData[n])/M_PI;
-}
-
 void ChebyshevExpander::calculateSP_LDOSCallback(
 	PropertyExtractor *cb_this,
 	Property::Property &property,
@@ -719,5 +833,96 @@ void ChebyshevExpander::calculateSP_LDOSCallback(
 	}
 }
 
+void ChebyshevExpander::collectIndicesCallback(
+	PropertyExtractor *cb_this,
+	Property::Property &property,
+	const Index &index,
+	int offset,
+	Information &information
+){
+	((IndexCollectingInformation&)information).add(index, offset);
+}
+
+void ChebyshevExpander::calculateLDOSBlockwise(
+	const vector<Index> &indices,
+	const vector<int> &offsets,
+	Property::LDOS &ldos
+){
+	Solver::ChebyshevExpander &solver = getSolver();
+	vector<double> &data = ldos.getDataRW();
+	const Range &energyWindow = getEnergyWindow();
+	const unsigned int blockSize = solver.getBlockSize();
+	for(
+		unsigned int blockStart = 0;
+		blockStart < indices.size();
+		blockStart += blockSize
+	){
+		const unsigned int blockEnd = min(
+			blockStart + blockSize,
+			(unsigned int)indices.size()
+		);
+		vector<Index> block(
+			indices.begin() + blockStart,
+			indices.begin() + blockEnd
+		);
+
+		vector<vector<complex<double>>> coefficients
+			= solver.calculateDiagonalCoefficients(block);
+
+		//The first Green's function is generated serially to ensure
+		//that any lookup table is set up before the parallel section.
+		vector<vector<complex<double>>> greensFunctions(block.size());
+		greensFunctions[0] = solver.generateGreensFunction(
+			coefficients[0],
+			Solver::ChebyshevExpander::Type::NonPrincipal
+		);
+		#pragma omp parallel for
+		for(unsigned int n = 1; n < block.size(); n++){
+			greensFunctions[n] = solver.generateGreensFunction(
+				coefficients[n],
+				Solver::ChebyshevExpander::Type::NonPrincipal
+			);
+		}
+
+		//Accumulated serially since several Indices can share the
+		//same offset when summation indices are present.
+		for(unsigned int n = 0; n < block.size(); n++){
+			const int offset = offsets[blockStart + n];
+			for(
+				unsigned int e = 0;
+				e < energyWindow.getResolution();
+				e++
+			){
+				data[offset + e]
+					+= imag(greensFunctions[n][e])/M_PI;
+			}
+		}
+	}
+}
+
+Solver::ChebyshevExpander::Type ChebyshevExpander::getSolverType(
+	Property::GreensFunction::Type type
+){
+	switch(type){
+	case Property::GreensFunction::Type::Advanced:
+		return Solver::ChebyshevExpander::Type::Advanced;
+	case Property::GreensFunction::Type::Retarded:
+		return Solver::ChebyshevExpander::Type::Retarded;
+	case Property::GreensFunction::Type::Principal:
+		return Solver::ChebyshevExpander::Type::Principal;
+	case Property::GreensFunction::Type::NonPrincipal:
+		return Solver::ChebyshevExpander::Type::NonPrincipal;
+	default:
+		TBTKExit(
+			"PropertyExtractor::ChebyshevExpander::getSolverType()",
+			"Unknown GreensFunction type.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+ChebyshevExpander::IndexCollectingInformation::IndexCollectingInformation(){
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
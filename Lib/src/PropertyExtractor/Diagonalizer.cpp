@@ -48,11 +48,10 @@ Property::WaveFunctions Diagonalizer::calculateWaveFunctions(
 	PatternValidator::validateWaveFunctionPatterns(patterns);
 	IndexTree allIndices = generateAllIndices(patterns);
 	IndexTree memoryLayout = generateMemoryLayout(patterns);
-	const Model &model = getSolver().getModel();
 
 	vector<unsigned int> statesVector;
 	if(states.size() == 1 && (*states.begin()).isWildcard()){
-		for(int n = 0; n < model.getBasisSize(); n++)
+		for(unsigned int n = 0; n < getSolver().getNumStates(); n++)
 			statesVector.push_back(n);
 	}
 	else{
@@ -184,7 +183,7 @@ Property::DOS Diagonalizer::calculateDOS(){
 complex<double> Diagonalizer::calculateExpectationValue(Index to, Index from){
 	complex<double> expectationValue = 0.;
 	const Model &model = getSolver().getModel();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(unsigned int n = 0; n < getSolver().getNumStates(); n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
@@ -406,7 +405,7 @@ Property::SpinPolarizedLDOS Diagonalizer::calculateSpinPolarizedLDOS(
 double Diagonalizer::calculateEntropy(){
 	double entropy = 0.;
 	const Model &model = getSolver().getModel();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(unsigned int n = 0; n < getSolver().getNumStates(); n++){
 		double p = getThermodynamicEquilibriumOccupation(
 			getEigenValue(n),
 			model
@@ -445,6 +444,8 @@ void Diagonalizer::calculateGreensFunctionCallback(
 ){
 	Diagonalizer *propertyExtractor = (Diagonalizer*)cb_this;
 	const Model &model = propertyExtractor->getSolver().getModel();
+	const unsigned int numStates
+		= propertyExtractor->getSolver().getNumStates();
 
 	vector<Index> components = index.split();
 
@@ -477,7 +478,7 @@ void Diagonalizer::calculateGreensFunctionCallback(
 		for(unsigned int e = 0; e < energyWindow.getResolution(); e++){
 			double E = energyWindow[e];;
 
-			for(int n = 0; n < model.getBasisSize(); n++){
+			for(unsigned int n = 0; n < numStates; n++){
 				double E_n = propertyExtractor->getEigenValue(n);
 				complex<double> amplitude0
 					= propertyExtractor->getAmplitude(n, components[0]);
@@ -502,7 +503,7 @@ void Diagonalizer::calculateGreensFunctionCallback(
 			complex<double> E = greensFunction.getMatsubaraEnergy(e)
 				+ chemicalPotential;
 
-			for(int n = 0; n < model.getBasisSize(); n++){
+			for(unsigned int n = 0; n < numStates; n++){
 				double E_n = propertyExtractor->getEigenValue(n);
 				complex<double> amplitude0
 					= propertyExtractor->getAmplitude(n, components[0]);
@@ -543,7 +544,7 @@ void Diagonalizer::calculateDensityCallback(
 	const Model &model = solver.getModel();
 
 	const CArray<double> &eigenValues = solver.getEigenValues();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(unsigned int n = 0; n < solver.getNumStates(); n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			eigenValues[n],
 			model
@@ -575,7 +576,7 @@ void Diagonalizer::calculateMAGCallback(
 	Index index_d(index);
 	index_u.at(spinIndex) = 0;
 	index_d.at(spinIndex) = 1;
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(unsigned int n = 0; n < solver.getNumStates(); n++){
 		double weight = getThermodynamicEquilibriumOccupation(
 			eigenValues[n],
 			model
@@ -630,7 +631,6 @@ void Diagonalizer::calculateSP_LDOSCallback(
 		= (Property::SpinPolarizedLDOS&)property;
 	vector<SpinMatrix> &data = spinPolarizedLDOS.getDataRW();
 	const Solver::Diagonalizer &solver = propertyExtractor->getSolver();
-	const Model &model = solver.getModel();
 
 	const CArray<double> &eigenValues = solver.getEigenValues();
 
@@ -642,7 +642,7 @@ void Diagonalizer::calculateSP_LDOSCallback(
 	index_d.at(spinIndex) = 1;
 	const Range &energyWindow = propertyExtractor->getEnergyWindow();
 	double dE = spinPolarizedLDOS.getDeltaE();
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(unsigned int n = 0; n < solver.getNumStates(); n++){
 		if(
 			eigenValues[n] > energyWindow[0]
 			&& eigenValues[n] < energyWindow.getLast()
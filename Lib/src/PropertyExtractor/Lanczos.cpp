@@ -0,0 +1,392 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file Lanczos.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/PropertyExtractor/Lanczos.h"
+#include "TBTK/Functions.h"
+#include "TBTK/Streams.h"
+
+using namespace std;
+
+namespace TBTK{
+namespace PropertyExtractor{
+
+Lanczos::Lanczos(){
+}
+
+Property::EigenValues Lanczos::getEigenValues(){
+	const Solver::Lanczos &solver = getSolver();
+	int size = solver.getNumStates();
+	const CArray<double> &ev = solver.getEigenValues();
+
+	Property::EigenValues eigenValues(size);
+	std::vector<double> &data = eigenValues.getDataRW();
+	for(int n = 0; n < size; n++)
+		data[n] = ev[n];
+
+	return eigenValues;
+}
+
+Property::WaveFunctions Lanczos::calculateWaveFunctions(
+	vector<Index> patterns,
+	vector<Subindex> states
+){
+	const Solver::Lanczos &solver = getSolver();
+
+	IndexTree allIndices = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		false,
+		false
+	);
+
+	IndexTree memoryLayout = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		true,
+		true
+	);
+
+	vector<unsigned int> statesVector;
+	if(states.size() == 1){
+		if((*states.begin()).isWildcard()){
+			for(unsigned int n = 0; n < solver.getNumStates(); n++)
+				statesVector.push_back(n);
+		}
+		else{
+			TBTKAssert(
+				*states.begin() >= 0,
+				"PropertyExtractor::Lanczos::calculateWaveFunctions()",
+				"Found unexpected index symbol.",
+				"Use only positive numbers or '{IDX_ALL}'"
+			);
+			statesVector.push_back(*states.begin());
+		}
+	}
+	else{
+		for(unsigned int n = 0; n < states.size(); n++){
+			TBTKAssert(
+				*(states.begin() + n) >= 0,
+				"PropertyExtractor::Lanczos::calculateWaveFunctions()",
+				"Found unexpected index symbol.",
+				"Use only positive numbers or '{IDX_ALL}'"
+			);
+			statesVector.push_back(*(states.begin() + n));
+		}
+	}
+
+	Property::WaveFunctions waveFunctions(memoryLayout, statesVector);
+
+	Information information;
+	calculate(
+		calculateWaveFunctionsCallback,
+		allIndices,
+		memoryLayout,
+		waveFunctions,
+		information
+	);
+
+	return waveFunctions;
+}
+
+Property::DOS Lanczos::calculateDOS(){
+	const Solver::Lanczos &solver = getSolver();
+	const CArray<double> &eigenValues = solver.getEigenValues();
+
+	const Range &energyWindow = getEnergyWindow();
+	Property::DOS dos(energyWindow);
+	std::vector<double> &data = dos.getDataRW();
+	double dE = dos.getDeltaE();
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
+		int e = (int)(
+			(
+				(
+					eigenValues[n] - energyWindow[0]
+				)/(energyWindow.getLast() - energyWindow[0])
+			)*energyWindow.getResolution()
+		);
+		if(e >= 0 && e < (int)energyWindow.getResolution()){
+			data[e] += 1./dE;
+		}
+	}
+
+	return dos;
+}
+
+Property::LDOS Lanczos::calculateLDOS(
+	Index pattern,
+	Index ranges
+){
+	const Solver::Lanczos &solver = getSolver();
+	TBTKAssert(
+		solver.getCalculateEigenVectors(),
+		"PropertyExtractor::Lanczos::calculateLDOS()",
+		"Eigen vectors not calculated.",
+		"Use Solver::Lanczos::setCalculateEigenVectors() to"
+		<< " ensure eigen vectors are calculated."
+	);
+
+	ensureCompliantRanges(pattern, ranges);
+
+	vector<int> loopRanges = getLoopRanges(pattern, ranges);
+	Property::LDOS ldos(loopRanges, getEnergyWindow());
+
+	Information information;
+	calculate(
+		calculateLDOSCallback,
+		ldos,
+		pattern,
+		ranges,
+		0,
+		getEnergyWindow().getResolution(),
+		information
+	);
+
+	return ldos;
+}
+
+Property::LDOS Lanczos::calculateLDOS(
+	vector<Index> patterns
+){
+	const Solver::Lanczos &solver = getSolver();
+	TBTKAssert(
+		solver.getCalculateEigenVectors(),
+		"PropertyExtractor::Lanczos::calculateLDOS()",
+		"Eigen vectors not calculated.",
+		"Use Solver::Lanczos::setCalculateEigenVectors() to ensure eigen vectors are calculated."
+	);
+
+	IndexTree allIndices = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		false,
+		true
+	);
+
+	IndexTree memoryLayout = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		true,
+		true
+	);
+
+	Property::LDOS ldos(memoryLayout, getEnergyWindow());
+
+	Information information;
+	calculate(
+		calculateLDOSCallback,
+		allIndices,
+		memoryLayout,
+		ldos,
+		information
+	);
+
+	return ldos;
+}
+
+Property::SpinPolarizedLDOS Lanczos::calculateSpinPolarizedLDOS(
+	Index pattern,
+	Index ranges
+){
+	const Solver::Lanczos &solver = getSolver();
+	TBTKAssert(
+		solver.getCalculateEigenVectors(),
+		"Lanczos::calculateSpinPolarizedLDOS()",
+		"Eigen vectors not calculated.",
+		"Use Solver::Lanczos::setCalculateEigenVectors() to"
+		<< " ensure eigen vectors are calculated."
+	);
+
+	Information information;
+	for(unsigned int n = 0; n < pattern.getSize(); n++){
+		if(pattern.at(n).isSpinIndex()){
+			information.setSpinIndex(n);
+			pattern.at(n) = 0;
+			ranges.at(n) = 1;
+			break;
+		}
+	}
+	if(information.getSpinIndex() == -1){
+		TBTKExit(
+			"PropertyExtractor::Lanczos::calculateSpinPolarizedLDOS()",
+			"No spin index indicated.",
+			"Use IDX_SPIN to indicate the position of the spin index."
+		);
+	}
+
+	ensureCompliantRanges(pattern, ranges);
+
+	vector<int> loopRanges = getLoopRanges(pattern, ranges);
+	Property::SpinPolarizedLDOS spinPolarizedLDOS(
+		loopRanges,
+		getEnergyWindow()
+	);
+
+	calculate(
+		calculateSpinPolarizedLDOSCallback,
+		spinPolarizedLDOS,
+		pattern,
+		ranges,
+		0,
+		getEnergyWindow().getResolution(),
+		information
+	);
+
+	return spinPolarizedLDOS;
+}
+
+Property::SpinPolarizedLDOS Lanczos::calculateSpinPolarizedLDOS(
+	vector<Index> patterns
+){
+	const Solver::Lanczos &solver = getSolver();
+	TBTKAssert(
+		solver.getCalculateEigenVectors(),
+		"PropertyExtractor::Lanczos::calculateSpinPolarizedLDOS()",
+		"Eigen vectors not calculated.",
+		"Use Solver::Lanczos::setCalculateEigenVectors() to"
+		<< " ensure eigen vectors are calculated."
+	);
+
+	IndexTree allIndices = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		false,
+		true
+	);
+
+	IndexTree memoryLayout = generateIndexTree(
+		patterns,
+		solver.getModel().getHoppingAmplitudeSet(),
+		true,
+		true
+	);
+
+	Property::SpinPolarizedLDOS spinPolarizedLDOS(
+		memoryLayout,
+		getEnergyWindow()
+	);
+
+	Information information;
+	calculate(
+		calculateSpinPolarizedLDOSCallback,
+		allIndices,
+		memoryLayout,
+		spinPolarizedLDOS,
+		information
+	);
+
+	return spinPolarizedLDOS;
+}
+
+void Lanczos::calculateWaveFunctionsCallback(
+	PropertyExtractor *cb_this,
+	Property::Property &property,
+	const Index &index,
+	int offset,
+	Information &information
+){
+	Lanczos *propertyExtractor = (Lanczos*)cb_this;
+	Property::WaveFunctions &waveFunctions
+		= (Property::WaveFunctions&)property;
+	vector<complex<double>> &data = waveFunctions.getDataRW();
+
+	const vector<unsigned int> states = waveFunctions.getStates();
+	for(unsigned int n = 0; n < states.size(); n++){
+		data[offset + n] += propertyExtractor->getAmplitude(
+			states.at(n),
+			index
+		);
+	}
+}
+
+void Lanczos::calculateLDOSCallback(
+	PropertyExtractor *cb_this,
+	Property::Property &property,
+	const Index &index,
+	int offset,
+	Information &information
+){
+	Lanczos *propertyExtractor = (Lanczos*)cb_this;
+	Property::LDOS &ldos = (Property::LDOS&)property;
+	vector<double> &data = ldos.getDataRW();
+	const Solver::Lanczos &solver = propertyExtractor->getSolver();
+
+	const CArray<double> &eigenValues = solver.getEigenValues();
+
+	const Range &energyWindow = propertyExtractor->getEnergyWindow();
+	double dE = ldos.getDeltaE();
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
+		if(
+			eigenValues[n] > energyWindow[0]
+			&& eigenValues[n] < energyWindow.getLast()
+		){
+			complex<double> u = solver.getAmplitude(n, index);
+
+			int e = (int)((eigenValues[n] - energyWindow[0])/dE);
+			if(e >= (int)energyWindow.getResolution())
+				e = energyWindow.getResolution() - 1;
+			data[offset + e] += real(conj(u)*u)/dE;
+		}
+	}
+}
+
+void Lanczos::calculateSpinPolarizedLDOSCallback(
+	PropertyExtractor *cb_this,
+	Property::Property &property,
+	const Index &index,
+	int offset,
+	Information &information
+){
+	Lanczos *propertyExtractor = (Lanczos*)cb_this;
+	Property::SpinPolarizedLDOS &spinPolarizedLDOS
+		= (Property::SpinPolarizedLDOS&)property;
+	vector<SpinMatrix> &data = spinPolarizedLDOS.getDataRW();
+	const Solver::Lanczos &solver = propertyExtractor->getSolver();
+
+	const CArray<double> &eigenValues = solver.getEigenValues();
+
+	int spinIndex = information.getSpinIndex();
+
+	Index index_u(index);
+	Index index_d(index);
+	index_u.at(spinIndex) = 0;
+	index_d.at(spinIndex) = 1;
+	const Range &energyWindow = propertyExtractor->getEnergyWindow();
+	double dE = spinPolarizedLDOS.getDeltaE();
+	for(int n = 0; n < (int)solver.getNumStates(); n++){
+		if(
+			eigenValues[n] > energyWindow[0]
+			&& eigenValues[n] < energyWindow.getLast()
+		){
+			complex<double> u_u = solver.getAmplitude(n, index_u);
+			complex<double> u_d = solver.getAmplitude(n, index_d);
+
+			int e = (int)((eigenValues[n] - energyWindow[0])/dE);
+			if(e >= (int)energyWindow.getResolution())
+				e = energyWindow.getResolution() - 1;
+			data[offset + e].at(0, 0) += conj(u_u)*u_u/dE;
+			data[offset + e].at(0, 1) += conj(u_u)*u_d/dE;
+			data[offset + e].at(1, 0) += conj(u_d)*u_u/dE;
+			data[offset + e].at(1, 1) += conj(u_d)*u_d/dE;
+		}
+	}
+}
+
+};	//End of namespace PropertyExtractor
+};	//End of namespace TBTK
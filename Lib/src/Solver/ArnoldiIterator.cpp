@@ -29,6 +29,7 @@
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -52,9 +53,11 @@ ArnoldiIterator::ArnoldiIterator(
 	calculateEigenVectors = false;
 	numEigenValues = 0;
 	numLanczosVectors = 0;
-	shift = 0.;
+	shifts.push_back(0.);
 	tolerance = 0.;
 	maxIterations = 20;
+	numStates = 0;
+	slicesAreContiguous = true;
 }
 
 //ARPACK function for performing single Arnoldi iteration step (double)
@@ -163,12 +166,28 @@ void ArnoldiIterator::run(){
 
 	switch(mode){
 	case Mode::Normal:
+		TBTKAssert(
+			shifts.size() == 1,
+			"ArnoldiIterator::run()",
+			"Multiple central values are only supported in the"
+			<< " shift-and-invert mode.",
+			"Use ArnoldiIterator::setCentralValue() to set a single"
+			<< " central value."
+		);
 		initNormal();
-		arnoldiLoop();
+		arnoldiLoop(0);
+		numStates = numEigenValues;
 		break;
 	case Mode::ShiftAndInvert:
 		initShiftAndInvert();
-		arnoldiLoop();
+		slicesAreContiguous = true;
+		if(shifts.size() == 1){
+			arnoldiLoop(0);
+			numStates = numEigenValues;
+		}
+		else{
+			runSpectrumSlicing();
+		}
 		break;
 	default:
 		TBTKExit(
@@ -180,7 +199,7 @@ void ArnoldiIterator::run(){
 	sort();
 }
 
-void ArnoldiIterator::arnoldiLoop(){
+void ArnoldiIterator::arnoldiLoop(unsigned int slice){
 	TBTKAssert(
 		numEigenValues > 0,
 		"ArnoldiIterator::arnoldiLoop()",
@@ -213,7 +232,7 @@ void ArnoldiIterator::arnoldiLoop(){
 	//numEigenValues largest (in magnitude) eigenvalues.
 	char which[2] = {'L', 'M'};
 
-	complex<double> sigma = shift;
+	complex<double> sigma = shifts[slice];
 
 	//Reverse communication variable.
 	int ido = 0;
@@ -250,7 +269,8 @@ void ArnoldiIterator::arnoldiLoop(){
 	if(
 		false	//Se comment below
 		&& mode == Mode::ShiftAndInvert
-		&& luSolver.getMatrixDataType() == LUSolver::DataType::Double
+		&& luSolvers[slice]->getMatrixDataType()
+			== LUSolver::DataType::Double
 	){
 		//This never happens!
 		//
@@ -272,9 +292,6 @@ void ArnoldiIterator::arnoldiLoop(){
 			eigenVectors = CArray<complex<double>>(numEigenValues*model.getBasisSize());
 		CArray<double> workev(3*numLanczosVectors);
 
-		//Only used in Mode::ShiftAndInvert.
-		Matrix<double> b(basisSize, 1);
-
 		//Main loop ()
 		int counter = 0;
 		while(true){
@@ -320,7 +337,7 @@ void ArnoldiIterator::arnoldiLoop(){
 					basisSize,
 					workd.getData(),
 					ipntr,
-					b
+					luSolvers[slice].get()
 				)
 			){
 				break;
@@ -425,7 +442,11 @@ void ArnoldiIterator::arnoldiLoop(){
 		CArray<complex<double>> workev(2*numLanczosVectors);
 
 		//Only used in Mode::ShiftAndInvert.
-		Matrix<complex<double>> b(basisSize, 1);
+		LUSolver *luSolver = (
+			mode == Mode::ShiftAndInvert
+				? luSolvers[slice].get()
+				: nullptr
+		);
 
 		//Main loop ()
 		int counter = 0;
@@ -473,7 +494,7 @@ void ArnoldiIterator::arnoldiLoop(){
 					basisSize,
 					workd.getData(),
 					ipntr,
-					b
+					luSolver
 				)
 			){
 				break;
@@ -589,7 +610,7 @@ bool ArnoldiIterator::executeReverseCommunicationMessage(
 	int basisSize,
 	double *workd,
 	int *ipntr,
-	Matrix<double> &b
+	LUSolver *luSolver
 ){
 	if(ido == -1 || ido == 1){
 		switch(mode){
@@ -605,14 +626,14 @@ bool ArnoldiIterator::executeReverseCommunicationMessage(
 			//Solve x = (A - sigma*I)^{-1}b, where b =
 			//workd[ipntr[0]] and x = workd[ipntr[1]]. "-1"
 			//is for conversion between Fortran one based
-			//indices and c++ zero based indices.
-			for(int n = 0; n < basisSize; n++)
-				b.at(n, 0) = workd[(ipntr[0] - 1) + n];
-
-			luSolver.solve(b);
+			//indices and c++ zero based indices. The
+			//solution is calculated in place in workd.
+			for(int n = 0; n < basisSize; n++){
+				workd[(ipntr[1] - 1) + n]
+					= workd[(ipntr[0] - 1) + n];
+			}
 
-			for(int n = 0; n < basisSize; n++)
-				workd[(ipntr[1] - 1) + n] = b.at(n, 0);
+			luSolver->solve(&workd[ipntr[1] - 1]);
 
 			break;
 		default:
@@ -645,7 +666,7 @@ bool ArnoldiIterator::executeReverseCommunicationMessage(
 	int basisSize,
 	complex<double> *workd,
 	int *ipntr,
-	Matrix<complex<double>> &b
+	LUSolver *luSolver
 ){
 	if(ido == -1 || ido == 1){
 		switch(mode){
@@ -699,14 +720,14 @@ bool ArnoldiIterator::executeReverseCommunicationMessage(
 			//Solve x = (A - sigma*I)^{-1}b, where b =
 			//workd[ipntr[0]] and x = workd[ipntr[1]]. "-1"
 			//is for conversion between Fortran one based
-			//indices and c++ zero based indices.
-			for(int n = 0; n < basisSize; n++)
-				b.at(n, 0) = workd[(ipntr[0] - 1) + n];
+			//indices and c++ zero based indices. The
+			//solution is calculated in place in workd.
+			for(int n = 0; n < basisSize; n++){
+				workd[(ipntr[1] - 1) + n]
+					= workd[(ipntr[0] - 1) + n];
+			}
 
-			luSolver.solve(b);
-
-			for(int n = 0; n < basisSize; n++)
-				workd[(ipntr[1] - 1) + n] = b.at(n, 0);
+			luSolver->solve(&workd[ipntr[1] - 1]);
 
 			break;
 		default:
@@ -775,67 +796,187 @@ void ArnoldiIterator::initNormal(){
 		"Use Model::constructCOO() to construct COO format."
 	);*/
 
-	const Model &model = getModel();
+	Model &model = getModel();
 
 	matrix = SparseMatrix<complex<double>>(
 		SparseMatrix<complex<double>>::StorageFormat::CSC
 	);
 
+	model.updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
 	for(
-		HoppingAmplitudeSet::ConstIterator iterator
-			= getModel().getHoppingAmplitudeSet().cbegin();
-		iterator != getModel().getHoppingAmplitudeSet().cend();
-		++iterator
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
 	){
-		int from = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getFromIndex()
-		);
-		int to = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getToIndex()
-		);
-		matrix.add(to, from, (*iterator).getAmplitude());
+		matrix.add(toIndices[n], fromIndices[n], amplitudes[n]);
 	}
 	for(int n = 0; n < model.getBasisSize(); n++)
-		matrix.add(n, n, -shift);
+		matrix.add(n, n, -shifts[0]);
 	matrix.constructCSX();
 }
 
 void ArnoldiIterator::initShiftAndInvert(){
-	const Model &model = getModel();
+	Model &model = getModel();
 
-	SparseMatrix<complex<double>> matrix(
-		SparseMatrix<complex<double>>::StorageFormat::CSC
-	);
+	luSolvers.clear();
+	for(unsigned int n = 0; n < shifts.size(); n++){
+		luSolvers.push_back(unique_ptr<LUSolver>(new LUSolver()));
+		luSolvers.back()->setVerbose(getVerbose());
+	}
 
-	for(
-		HoppingAmplitudeSet::ConstIterator iterator
-			= getModel().getHoppingAmplitudeSet().cbegin();
-		iterator != getModel().getHoppingAmplitudeSet().cend();
-		++iterator
-	){
-		int from = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getFromIndex()
+	//The callback dependent amplitudes are reevaluated before the
+	//parallel region.
+	model.updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	const unsigned int numHoppingAmplitudes
+		= compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+	const int basisSize = model.getBasisSize();
+
+	//The factorizations are independent of each other and are
+	//calculated in parallel.
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(unsigned int slice = 0; slice < shifts.size(); slice++){
+		SparseMatrix<complex<double>> matrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSC
+		);
+		for(unsigned int n = 0; n < numHoppingAmplitudes; n++){
+			matrix.add(
+				toIndices[n],
+				fromIndices[n],
+				amplitudes[n]
+			);
+		}
+		for(int n = 0; n < basisSize; n++)
+			matrix.add(n, n, -shifts[slice]);
+		matrix.constructCSX();
+
+		luSolvers[slice]->setMatrix(matrix);
+	}
+}
+
+void ArnoldiIterator::runSpectrumSlicing(){
+	const int basisSize = getModel().getBasisSize();
+
+	//ARPACK keeps its state between reverse communication calls in
+	//static variables, which means that the Arnoldi loops for the
+	//different slices have to be run one at a time.
+	vector<complex<double>> slicedEigenValues;
+	vector<complex<double>> slicedEigenVectors;
+	vector<double> sliceRadii(shifts.size(), 0);
+	for(unsigned int slice = 0; slice < shifts.size(); slice++){
+		arnoldiLoop(slice);
+
+		//All eigenvalues that are closer to the shift than the
+		//furthest calculated eigenvalue have been found.
+		for(int n = 0; n < numEigenValues; n++){
+			sliceRadii[slice] = max(
+				sliceRadii[slice],
+				abs(real(eigenValues[n]) - shifts[slice])
+			);
+		}
+
+		//Only keep the eigenvalues that are closer to the current
+		//shift than to any other shift. This removes the duplicates
+		//that are found by overlapping slices.
+		for(int n = 0; n < numEigenValues; n++){
+			double energy = real(eigenValues[n]);
+			unsigned int closestSlice = 0;
+			for(unsigned int c = 1; c < shifts.size(); c++){
+				if(
+					abs(energy - shifts[c])
+					< abs(energy - shifts[closestSlice])
+				){
+					closestSlice = c;
+				}
+			}
+			if(closestSlice != slice)
+				continue;
+
+			slicedEigenValues.push_back(eigenValues[n]);
+			if(calculateEigenVectors){
+				for(int c = 0; c < basisSize; c++){
+					slicedEigenVectors.push_back(
+						eigenVectors[basisSize*n + c]
+					);
+				}
+			}
+		}
+	}
+
+	//Eigenvalues between two neighboring shifts are only kept by the
+	//slice of the closest shift. Unless both slices reach the midpoint,
+	//eigenvalues in the gap between the covered ranges can therefore be
+	//missing.
+	vector<unsigned int> order(shifts.size());
+	for(unsigned int n = 0; n < order.size(); n++)
+		order[n] = n;
+	std::sort(
+		order.begin(),
+		order.end(),
+		[this](unsigned int lhs, unsigned int rhs){
+			return shifts[lhs] < shifts[rhs];
+		}
+	);
+	for(unsigned int n = 0; n + 1 < order.size(); n++){
+		const unsigned int lower = order[n];
+		const unsigned int upper = order[n + 1];
+		const double midpoint = (shifts[lower] + shifts[upper])/2.;
+		const double lowerEnd = min(
+			shifts[lower] + sliceRadii[lower],
+			midpoint
 		);
-		int to = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getToIndex()
+		const double upperStart = max(
+			shifts[upper] - sliceRadii[upper],
+			midpoint
 		);
-		matrix.add(to, from, (*iterator).getAmplitude());
+		if(lowerEnd < upperStart){
+			slicesAreContiguous = false;
+			Streams::out << "Warning in"
+				<< " ArnoldiIterator::runSpectrumSlicing(): The"
+				<< " slices around the central values "
+				<< shifts[lower] << " and " << shifts[upper]
+				<< " do not overlap. Eigenvalues between "
+				<< lowerEnd << " and " << upperStart
+				<< " may be missing. Increase the number of"
+				<< " eigenvalues per slice or add central"
+				<< " values.\n";
+		}
 	}
-	for(int n = 0; n < model.getBasisSize(); n++)
-		matrix.add(n, n, -shift);
-	matrix.constructCSX();
 
-	luSolver.setMatrix(matrix);
+	numStates = slicedEigenValues.size();
+	eigenValues = CArray<complex<double>>(numStates);
+	for(unsigned int n = 0; n < numStates; n++)
+		eigenValues[n] = slicedEigenValues[n];
+	if(calculateEigenVectors){
+		eigenVectors = CArray<complex<double>>(numStates*basisSize);
+		for(unsigned int n = 0; n < numStates*basisSize; n++)
+			eigenVectors[n] = slicedEigenVectors[n];
+	}
 }
 
 void ArnoldiIterator::sort(){
-	CArray<complex<double>> workspace(numEigenValues);
-	for(int n = 0; n < numEigenValues; n++)
+	const int numSortedStates = numStates;
+
+	CArray<complex<double>> workspace(numSortedStates);
+	for(int n = 0; n < numSortedStates; n++)
 		workspace[n] = eigenValues[n];
 
-	CArray<int> order(numEigenValues);
-	CArray<int> orderWorkspace(numEigenValues);
-	for(int n = 0; n < numEigenValues; n++){
+	CArray<int> order(numSortedStates);
+	CArray<int> orderWorkspace(numSortedStates);
+	for(int n = 0; n < numSortedStates; n++){
 		order[n] = n;
 		orderWorkspace[n] = n;
 	}
@@ -846,16 +987,16 @@ void ArnoldiIterator::sort(){
 		orderWorkspace.getData(),
 		order.getData(),
 		0,
-		numEigenValues
+		numSortedStates
 	);
 
 	const Model &model = getModel();
 	if(calculateEigenVectors){
-		CArray<complex<double>> eigenVectorsWorkspace(numEigenValues*model.getBasisSize());
-		for(int n = 0; n < numEigenValues*model.getBasisSize(); n++)
+		CArray<complex<double>> eigenVectorsWorkspace(numSortedStates*model.getBasisSize());
+		for(int n = 0; n < numSortedStates*model.getBasisSize(); n++)
 			eigenVectorsWorkspace[n] = eigenVectors[n];
 
-		for(int n = 0; n < numEigenValues; n++)
+		for(int n = 0; n < numSortedStates; n++)
 			for(int c = 0; c < model.getBasisSize(); c++)
 				eigenVectors[n*model.getBasisSize() + c] = eigenVectorsWorkspace[order[n]*model.getBasisSize() + c];
 	}
@@ -22,6 +22,8 @@
 #include "TBTK/Streams.h"
 #include "TBTK/TBTKMacros.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 
 using namespace std;
@@ -39,6 +41,13 @@ BlockDiagonalizer::BlockDiagonalizer() : Communicator(false){
 	selfConsistencyCallback = nullptr;
 
 	parallelExecution = false;
+	largeBlockThreshold = 0;
+	streamEigenVectors = false;
+	eigenVectorsAreStreamed = false;
+	streamedBlock = 0;
+	useRealArithmetic = true;
+	hamiltonianIsReal = false;
+	eigenVectorsAreReal = false;
 }
 
 void BlockDiagonalizer::run(){
@@ -77,6 +86,8 @@ void BlockDiagonalizer::init(){
 	if(getGlobalVerbose() && getVerbose())
 		Streams::out << "Initializing BlockDiagonalizer\n";
 
+	eigenVectorsAreStreamed = streamEigenVectors;
+
 	//Setup the BlockStructureDescriptor.
 	blockStructureDescriptor = BlockStructureDescriptor(
 		getModel().getHoppingAmplitudeSet()
@@ -122,8 +133,21 @@ void BlockDiagonalizer::init(){
 	){
 		unsigned int numStatesInBlock
 			= blockStructureDescriptor.getNumStatesInBlock(n);
-		hamiltonianSize += (numStatesInBlock*(numStatesInBlock + 1))/2;
-		eigenVectorsSize += numStatesInBlock*numStatesInBlock;
+		if(eigenVectorsAreStreamed){
+			hamiltonianSize = max(
+				hamiltonianSize,
+				(size_t)(numStatesInBlock*(numStatesInBlock + 1)/2)
+			);
+			eigenVectorsSize = max(
+				eigenVectorsSize,
+				(size_t)numStatesInBlock*numStatesInBlock
+			);
+		}
+		else{
+			hamiltonianSize
+				+= (numStatesInBlock*(numStatesInBlock + 1))/2;
+			eigenVectorsSize += numStatesInBlock*numStatesInBlock;
+		}
 	}
 
 	if(getGlobalVerbose() && getVerbose()){
@@ -175,15 +199,25 @@ void BlockDiagonalizer::init(){
 			<< blockStructureDescriptor.getNumBlocks() << "\n";
 	}
 
-	hamiltonian = CArray<complex<double>>(hamiltonianSize);
 	eigenValues = CArray<double>(getModel().getBasisSize());
-	eigenVectors = CArray<complex<double>>(eigenVectorsSize);
 
 	update();
 }
 
 void BlockDiagonalizer::update(){
-	const Model &model = getModel();
+	Model &model = getModel();
+
+	//When the eigenvectors are streamed, the blocks are set up one at a
+	//time by solveStreamed().
+	if(eigenVectorsAreStreamed)
+		return;
+
+	//The amplitudes are checked every update since callback dependent
+	//amplitudes can become complex between iterations.
+	model.updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	hamiltonianIsReal = getAmplitudesAreReal(compiledHoppingAmplitudes);
 
 	unsigned int hamiltonianSize = 0;
 	for(
@@ -195,97 +229,98 @@ void BlockDiagonalizer::update(){
 			= blockStructureDescriptor.getNumStatesInBlock(n);
 		hamiltonianSize += (numStatesInBlock*(numStatesInBlock + 1))/2;
 	}
-	for(unsigned int n = 0; n < hamiltonianSize; n++)
-		hamiltonian[n] = 0.;
-
-	IndexTree blockIndices
-		= getModel().getHoppingAmplitudeSet().getSubspaceIndices();
-	IndexTree::ConstIterator blockIterator = blockIndices.cbegin();
-	if(parallelExecution){
-		vector<HoppingAmplitudeSet::ConstIterator> iterators;
-		vector<HoppingAmplitudeSet::ConstIterator> endIterators;
-
-		while(blockIterator != blockIndices.cend()){
-			Index blockIndex = *blockIterator;
 
-			iterators.push_back(
-				getModel().getHoppingAmplitudeSet().cbegin(
-					blockIndex
-				)
-			);
-			endIterators.push_back(
-				getModel().getHoppingAmplitudeSet().cend(
-					blockIndex
-				)
-			);
-
-			++blockIterator;
-		}
+	if(hamiltonianIsReal){
+		hamiltonian = CArray<complex<double>>();
+		if(realHamiltonian.getSize() != hamiltonianSize)
+			realHamiltonian = CArray<double>(hamiltonianSize);
+		for(unsigned int n = 0; n < hamiltonianSize; n++)
+			realHamiltonian[n] = 0.;
+	}
+	else{
+		realHamiltonian = CArray<double>();
+		if(hamiltonian.getSize() != hamiltonianSize)
+			hamiltonian = CArray<complex<double>>(hamiltonianSize);
+		for(unsigned int n = 0; n < hamiltonianSize; n++)
+			hamiltonian[n] = 0.;
+	}
 
+	if(parallelExecution){
 		#pragma omp parallel for
-		for(unsigned int block = 0; block < iterators.size(); block++){
-			HoppingAmplitudeSet::ConstIterator &iterator
-				= iterators[block];
-			HoppingAmplitudeSet::ConstIterator &endIterator
-				= endIterators[block];
-
-			int minBasisIndex = iterator.getMinBasisIndex();
-			while(iterator != endIterator){
-				int from = model.getHoppingAmplitudeSet(
-				).getBasisIndex(
-					(*iterator).getFromIndex()
-				) - minBasisIndex;
-				int to = model.getHoppingAmplitudeSet(
-				).getBasisIndex(
-					(*iterator).getToIndex()
-				) - minBasisIndex;
-				if(from >= to){
-					hamiltonian[
-						blockOffsets.at(block)
-						+ to
-						+ (from*(from+1))/2
-					] += (*iterator).getAmplitude();
-				}
-
-				++iterator;
-			}
+		for(
+			unsigned int block = 0;
+			block < blockStructureDescriptor.getNumBlocks();
+			block++
+		){
+			setupBlock(block, compiledHoppingAmplitudes);
 		}
 	}
 	else{
-		unsigned int blockCounter = 0;
-		while(blockIterator != blockIndices.cend()){
-			Index blockIndex = *blockIterator;
-
-			HoppingAmplitudeSet::ConstIterator iterator
-				= getModel().getHoppingAmplitudeSet().cbegin(
-					blockIndex
-				);
-			int minBasisIndex = iterator.getMinBasisIndex();
-			while(
-				iterator != getModel().getHoppingAmplitudeSet(
-				).cend(blockIndex)
-			){
-				int from = model.getHoppingAmplitudeSet(
-				).getBasisIndex(
-					(*iterator).getFromIndex()
-				) - minBasisIndex;
-				int to = model.getHoppingAmplitudeSet(
-				).getBasisIndex(
-					(*iterator).getToIndex()
-				) - minBasisIndex;
-				if(from >= to){
-					hamiltonian[
-						blockOffsets.at(blockCounter)
-						+ to
-						+ (from*(from+1))/2
-					] += (*iterator).getAmplitude();
-				}
+		for(
+			unsigned int block = 0;
+			block < blockStructureDescriptor.getNumBlocks();
+			block++
+		){
+			setupBlock(block, compiledHoppingAmplitudes);
+		}
+	}
+}
 
-				++iterator;
-			}
+bool BlockDiagonalizer::getAmplitudesAreReal(
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+) const{
+	if(!useRealArithmetic)
+		return false;
+
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	for(
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
+	){
+		if(imag(amplitudes[n]) != 0)
+			return false;
+	}
 
-			blockCounter++;
-			++blockIterator;
+	return true;
+}
+
+void BlockDiagonalizer::setupBlock(
+	unsigned int block,
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+){
+	//The rows of a block are consecutive in the CompiledHoppingAmplitudes,
+	//which means that the HoppingAmplitudes of a block are stored in a
+	//single contiguous range.
+	const unsigned int *rowPointers
+		= compiledHoppingAmplitudes.getRowPointers();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+
+	unsigned int firstState
+		= blockStructureDescriptor.getFirstStateInBlock(block);
+	unsigned int numStates
+		= blockStructureDescriptor.getNumStatesInBlock(block);
+	unsigned int hamiltonianOffset = getHamiltonianOffset(block);
+	for(
+		unsigned int n = rowPointers[firstState];
+		n < rowPointers[firstState + numStates];
+		n++
+	){
+		unsigned int from = fromIndices[n] - firstState;
+		unsigned int to = toIndices[n] - firstState;
+		if(from >= to){
+			unsigned int position = hamiltonianOffset
+				+ to
+				+ (from*(from+1))/2;
+			if(hamiltonianIsReal)
+				realHamiltonian[position] += real(amplitudes[n]);
+			else
+				hamiltonian[position] += amplitudes[n];
 		}
 	}
 }
@@ -302,6 +337,19 @@ extern "C" void zhpev_(char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues
 			double *rwork,		//Workspace, dimension = max(1, 3*N-2)
 			int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
+//Lapack function for matrix diagonalization of real symmetric triangular
+//matrix.
+extern "C" void dspev_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	double *ap,		//Input matrix
+	double *w,		//Eigenvalues, is in accending order if info = 0
+	double *z,		//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	double *work,		//Workspace, dimension = 3*N
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
+
 //Lapack function for matrix diagonalization of banded triangular matrix
 extern "C" void zhbeb_(
 	char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
@@ -318,100 +366,103 @@ extern "C" void zhbeb_(
 	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
 void BlockDiagonalizer::solve(){
+	if(eigenVectorsAreStreamed){
+		solveStreamed();
+		return;
+	}
+
+	//Allocate storage for the eigenvectors on the format determined by
+	//the Hamiltonian.
+	unsigned int eigenVectorsSize = 0;
+	for(unsigned int n = 0; n < eigenVectorSizes.size(); n++)
+		eigenVectorsSize += eigenVectorSizes[n];
+	if(hamiltonianIsReal){
+		eigenVectors = CArray<complex<double>>();
+		if(realEigenVectors.getSize() != eigenVectorsSize)
+			realEigenVectors = CArray<double>(eigenVectorsSize);
+	}
+	else{
+		realEigenVectors = CArray<double>();
+		if(eigenVectors.getSize() != eigenVectorsSize)
+			eigenVectors = CArray<complex<double>>(eigenVectorsSize);
+	}
+	eigenVectorsAreReal = hamiltonianIsReal;
+
 	if(true){//Currently no support for banded matrices.
+		vector<unsigned int> eigenValuesOffsets;
+		eigenValuesOffsets.push_back(0);
+		for(
+			unsigned int b = 1;
+			b < blockStructureDescriptor.getNumBlocks();
+			b++
+		){
+			eigenValuesOffsets.push_back(
+				eigenValuesOffsets[b-1]
+				+ blockStructureDescriptor.getNumStatesInBlock(b-1)
+			);
+		}
+
+		blockSolveTimes.assign(
+			blockStructureDescriptor.getNumBlocks(),
+			0
+		);
 		if(parallelExecution){
-			vector<unsigned int> eigenValuesOffsets;
-			eigenValuesOffsets.push_back(0);
+			//Order the blocks by decreasing size. Large blocks are
+			//solved one at a time to allow LAPACK to use multiple
+			//threads, while the remaining blocks are handed out to
+			//the threads one by one as they become idle. Starting
+			//with the most expensive blocks avoids having a single
+			//thread finish a large block long after the others.
+			vector<unsigned int> blockOrder;
 			for(
-				unsigned int b = 1;
+				unsigned int b = 0;
 				b < blockStructureDescriptor.getNumBlocks();
 				b++
 			){
-				eigenValuesOffsets.push_back(
-					eigenValuesOffsets[b-1]
-					+ blockStructureDescriptor.getNumStatesInBlock(b-1)
-				);
+				blockOrder.push_back(b);
+			}
+			stable_sort(
+				blockOrder.begin(),
+				blockOrder.end(),
+				[this](unsigned int lhs, unsigned int rhs){
+					return blockStructureDescriptor.getNumStatesInBlock(
+						lhs
+					) > blockStructureDescriptor.getNumStatesInBlock(
+						rhs
+					);
+				}
+			);
+
+			unsigned int numLargeBlocks = 0;
+			while(
+				largeBlockThreshold != 0
+				&& numLargeBlocks < blockOrder.size()
+				&& blockStructureDescriptor.getNumStatesInBlock(
+					blockOrder[numLargeBlocks]
+				) > largeBlockThreshold
+			){
+				unsigned int b = blockOrder[numLargeBlocks];
+				solveBlock(b, eigenValuesOffsets[b]);
+				numLargeBlocks++;
 			}
 
-			#pragma omp parallel for
+			#pragma omp parallel for schedule(dynamic, 1)
 			for(
-				unsigned int b = 0;
-				b < blockStructureDescriptor.getNumBlocks();
-				b++
+				unsigned int n = numLargeBlocks;
+				n < blockOrder.size();
+				n++
 			){
-				//Setup zhpev to calculate...
-				char jobz = 'V';						//...eigenvalues and eigenvectors...
-				char uplo = 'U';						//...for an upper triangular...
-				int n = blockStructureDescriptor.getNumStatesInBlock(b);	//...nxn-matrix.
-				//Initialize workspaces
-				CArray<complex<double>> work(2*n-1);
-				CArray<double> rwork(3*n-2);
-				int info;
-				//Solve brop
-				zhpev_(
-					&jobz,
-					&uplo,
-					&n,
-					hamiltonian.getData()
-						+ blockOffsets.at(b),
-					eigenValues.getData()
-						+ eigenValuesOffsets[b],
-					eigenVectors.getData()
-						+ eigenVectorOffsets.at(b),
-					&n,
-					work.getData(),
-					rwork.getData(),
-					&info
-				);
-
-				TBTKAssert(
-					info == 0,
-					"Diagonalizer:solve()",
-					"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
-					"See LAPACK documentation for zhpev for further information."
-				);
+				unsigned int b = blockOrder[n];
+				solveBlock(b, eigenValuesOffsets[b]);
 			}
 		}
 		else{
-			unsigned int eigenValuesOffset = 0;
 			for(
 				unsigned int b = 0;
 				b < blockStructureDescriptor.getNumBlocks();
 				b++
 			){
-				//Setup zhpev to calculate...
-				char jobz = 'V';						//...eigenvalues and eigenvectors...
-				char uplo = 'U';						//...for an upper triangular...
-				int n = blockStructureDescriptor.getNumStatesInBlock(b);	//...nxn-matrix.
-				//Initialize workspaces
-				CArray<complex<double>> work(2*n-1);
-				CArray<double> rwork(3*n-2);
-				int info;
-				//Solve brop
-				zhpev_(
-					&jobz,
-					&uplo,
-					&n,
-					hamiltonian.getData()
-						+ blockOffsets.at(b),
-					eigenValues.getData()
-						+ eigenValuesOffset,
-					eigenVectors.getData()
-						+ eigenVectorOffsets.at(b),
-					&n,
-					work.getData(),
-					rwork.getData(),
-					&info
-				);
-
-				TBTKAssert(
-					info == 0,
-					"Diagonalizer:solve()",
-					"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
-					"See LAPACK documentation for zhpev for further information."
-				);
-
-				eigenValuesOffset += blockStructureDescriptor.getNumStatesInBlock(b);
+				solveBlock(b, eigenValuesOffsets[b]);
 			}
 		}
 	}
@@ -441,5 +492,140 @@ void BlockDiagonalizer::solve(){
 	}*/
 }
 
+void BlockDiagonalizer::solveStreamed(){
+	//The blocks are set up from the amplitudes requested here, which
+	//therefore are the ones that determine whether real arithmetic can be
+	//used.
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel().getHoppingAmplitudeSet(
+		).getCompiledHoppingAmplitudes();
+	hamiltonianIsReal = getAmplitudesAreReal(compiledHoppingAmplitudes);
+
+	//Allocate storage for the largest block.
+	unsigned int hamiltonianSize = 0;
+	unsigned int eigenVectorsSize = 0;
+	for(unsigned int n = 0; n < blockSizes.size(); n++){
+		hamiltonianSize = max(hamiltonianSize, blockSizes[n]);
+		eigenVectorsSize = max(eigenVectorsSize, eigenVectorSizes[n]);
+	}
+	if(hamiltonianIsReal){
+		hamiltonian = CArray<complex<double>>();
+		eigenVectors = CArray<complex<double>>();
+		if(realHamiltonian.getSize() != hamiltonianSize)
+			realHamiltonian = CArray<double>(hamiltonianSize);
+		if(realEigenVectors.getSize() != eigenVectorsSize)
+			realEigenVectors = CArray<double>(eigenVectorsSize);
+	}
+	else{
+		realHamiltonian = CArray<double>();
+		realEigenVectors = CArray<double>();
+		if(hamiltonian.getSize() != hamiltonianSize)
+			hamiltonian = CArray<complex<double>>(hamiltonianSize);
+		if(eigenVectors.getSize() != eigenVectorsSize)
+			eigenVectors = CArray<complex<double>>(eigenVectorsSize);
+	}
+	eigenVectorsAreReal = hamiltonianIsReal;
+
+	for(unsigned int n = 0; n < blockCallbacks.size(); n++)
+		blockCallbacks[n]->beginDiagonalization();
+
+	blockSolveTimes.assign(blockStructureDescriptor.getNumBlocks(), 0);
+	for(
+		unsigned int b = 0;
+		b < blockStructureDescriptor.getNumBlocks();
+		b++
+	){
+		for(unsigned int n = 0; n < blockSizes[b]; n++){
+			if(hamiltonianIsReal)
+				realHamiltonian[n] = 0.;
+			else
+				hamiltonian[n] = 0.;
+		}
+		setupBlock(b, compiledHoppingAmplitudes);
+
+		unsigned int firstState
+			= blockStructureDescriptor.getFirstStateInBlock(b);
+		streamedBlock = b;
+		solveBlock(b, firstState);
+
+		unsigned int lastState = firstState
+			+ blockStructureDescriptor.getNumStatesInBlock(b) - 1;
+		for(unsigned int n = 0; n < blockCallbacks.size(); n++){
+			blockCallbacks[n]->processBlock(
+				*this,
+				firstState,
+				lastState
+			);
+		}
+	}
+}
+
+void BlockDiagonalizer::solveBlock(
+	unsigned int block,
+	unsigned int eigenValuesOffset
+){
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	//Setup zhpev or dspev to calculate...
+	char jobz = 'V';						//...eigenvalues and eigenvectors...
+	char uplo = 'U';						//...for an upper triangular...
+	int n = blockStructureDescriptor.getNumStatesInBlock(block);	//...nxn-matrix.
+	int info;
+	if(hamiltonianIsReal){
+		//Initialize workspace
+		CArray<double> work(3*n);
+		//Solve brop
+		dspev_(
+			&jobz,
+			&uplo,
+			&n,
+			realHamiltonian.getData() + getHamiltonianOffset(block),
+			eigenValues.getData() + eigenValuesOffset,
+			realEigenVectors.getData()
+				+ getEigenVectorOffset(block),
+			&n,
+			work.getData(),
+			&info
+		);
+
+		TBTKAssert(
+			info == 0,
+			"BlockDiagonalizer:solveBlock()",
+			"Diagonalization routine dspev exited with INFO=" + to_string(info) + ".",
+			"See LAPACK documentation for dspev for further information."
+		);
+	}
+	else{
+		//Initialize workspaces
+		CArray<complex<double>> work(2*n-1);
+		CArray<double> rwork(3*n-2);
+		//Solve brop
+		zhpev_(
+			&jobz,
+			&uplo,
+			&n,
+			hamiltonian.getData() + getHamiltonianOffset(block),
+			eigenValues.getData() + eigenValuesOffset,
+			eigenVectors.getData() + getEigenVectorOffset(block),
+			&n,
+			work.getData(),
+			rwork.getData(),
+			&info
+		);
+
+		TBTKAssert(
+			info == 0,
+			"BlockDiagonalizer:solveBlock()",
+			"Diagonalization routine zhpev exited with INFO=" + to_string(info) + ".",
+			"See LAPACK documentation for zhpev for further information."
+		);
+	}
+
+	blockSolveTimes[block] = chrono::duration<double>(
+		chrono::steady_clock::now() - start
+	).count();
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
@@ -26,6 +26,8 @@
 
 #include <iostream>
 #include <cmath>
+#include <random>
+#include <utility>
 
 using namespace std;
 
@@ -39,6 +41,38 @@ DynamicTypeInformation ChebyshevExpander::dynamicTypeInformation(
 
 namespace{
 	const complex<double> i(0, 1);
+
+	//Calculates <bra_k|ket_k> for each of the numVectors vectors in a
+	//block stored with the elements for a given basis index stored
+	//consecutively.
+	void calculateBlockInnerProducts(
+		const Math::ParallelSparseMatrix<complex<double>>::Vector &bra,
+		const Math::ParallelSparseMatrix<complex<double>>::Vector &ket,
+		unsigned int numVectors,
+		vector<complex<double>> &innerProducts
+	){
+		const complex<double> *braData = bra.getData();
+		const complex<double> *ketData = ket.getData();
+		const int basisSize = bra.getSize()/numVectors;
+		for(unsigned int k = 0; k < numVectors; k++)
+			innerProducts[k] = 0;
+
+		#pragma omp parallel
+		{
+			vector<complex<double>> partialSums(numVectors, 0);
+			#pragma omp for schedule(static)
+			for(int n = 0; n < basisSize; n++){
+				for(unsigned int k = 0; k < numVectors; k++){
+					partialSums[k] += conj(
+						braData[n*numVectors + k]
+					)*ketData[n*numVectors + k];
+				}
+			}
+			#pragma omp critical
+			for(unsigned int k = 0; k < numVectors; k++)
+				innerProducts[k] += partialSums[k];
+		}
+	}
 }
 
 ChebyshevExpander::ChebyshevExpander() : Communicator(false){
@@ -49,12 +83,15 @@ ChebyshevExpander::ChebyshevExpander() : Communicator(false){
 	calculateCoefficientsOnGPU = false;
 	generateGreensFunctionsOnGPU = false;
 	useLookupTable = false;
+	blockSize = 16;
 	generatingFunctionLookupTable.setIsValid(false);
 	generatingFunctionLookupTable_device = NULL;
 	lookupTableNumCoefficients = 0;
 	lookupTableResolution = 0;
 	lookupTableLowerBound = 0.;
 	lookupTableUpperBound = 0.;
+	hamiltonianIsConstructed = false;
+	hamiltonianRevision = 0;
 }
 
 ChebyshevExpander::~ChebyshevExpander(){
@@ -62,36 +99,6 @@ ChebyshevExpander::~ChebyshevExpander(){
 		destroyLookupTableGPU();
 }
 
-void addHamiltonianProduct(
-	const SparseMatrix<complex<double>> &sparseMatrix,
-	const CArray<complex<double>> &vector,
-	CArray<complex<double>> &result
-){
-	const unsigned int *csrRowPointers = sparseMatrix.getCSRRowPointers();
-	const unsigned int *csrColumns = sparseMatrix.getCSRColumns();
-	const complex<double> *values = sparseMatrix.getCSRValues();
-	for(unsigned int row = 0; row < sparseMatrix.getNumRows(); row++){
-		for(
-			unsigned int n = csrRowPointers[row];
-			n < csrRowPointers[row+1];
-			n++
-		){
-			result[row] += values[n]*vector[csrColumns[n]];
-		}
-	}
-}
-
-void cyclicSwap(
-	CArray<complex<double>> &jIn1,
-	CArray<complex<double>> &jIn2,
-	CArray<complex<double>> &jResult
-){
-	CArray<complex<double>> temp = std::move(jIn2);
-	jIn2 = std::move(jIn1);
-	jIn1 = std::move(jResult);
-	jResult = std::move(temp);
-}
-
 vector<complex<double>> ChebyshevExpander::calculateCoefficientsCPU(
 	Index to,
 	Index from
@@ -103,6 +110,40 @@ vector<complex<double>> ChebyshevExpander::calculateCoefficientsCPU(
 vector<vector<complex<double>>> ChebyshevExpander::calculateCoefficientsCPU(
 	vector<Index> &to,
 	Index from
+){
+	return std::move(calculateCoefficientsCPU(to, vector<Index>({from}))[0]);
+}
+
+vector<
+	vector<vector<complex<double>>>
+> ChebyshevExpander::calculateCoefficientsCPU(
+	vector<Index> &to,
+	const vector<Index> &from
+){
+	return calculateBlockCoefficientsCPU(to, from, false);
+}
+
+vector<vector<complex<double>>> ChebyshevExpander::calculateDiagonalCoefficientsCPU(
+	const vector<Index> &indices
+){
+	vector<Index> to;
+	vector<vector<vector<complex<double>>>> blockCoefficients
+		= calculateBlockCoefficientsCPU(to, indices, true);
+
+	vector<vector<complex<double>>> coefficients;
+	coefficients.reserve(indices.size());
+	for(unsigned int n = 0; n < indices.size(); n++)
+		coefficients.push_back(std::move(blockCoefficients[n][0]));
+
+	return coefficients;
+}
+
+vector<
+	vector<vector<complex<double>>>
+> ChebyshevExpander::calculateBlockCoefficientsCPU(
+	vector<Index> &to,
+	const vector<Index> &from,
+	bool diagonal
 ){
 	TBTKAssert(
 		numCoefficients > 0,
@@ -111,77 +152,272 @@ vector<vector<complex<double>>> ChebyshevExpander::calculateCoefficientsCPU(
 		""
 	);
 
-	vector<vector<complex<double>>> coefficients;
-	for(unsigned int n = 0; n < to.size(); n++){
-		coefficients.push_back(vector<complex<double>>());
-		coefficients[n].reserve(numCoefficients);
-		for(int c = 0; c < numCoefficients; c++)
-			coefficients[n].push_back(0);
-	}
+	const unsigned int numToIndices = diagonal ? 1 : to.size();
+	vector<vector<vector<complex<double>>>> coefficients(
+		from.size(),
+		vector<vector<complex<double>>>(
+			numToIndices,
+			vector<complex<double>>(numCoefficients, 0)
+		)
+	);
 
 	const HoppingAmplitudeSet &hoppingAmplitudeSet
 		= getModel().getHoppingAmplitudeSet();
 	unsigned int basisSize = hoppingAmplitudeSet.getBasisSize();
 
-	int fromBasisIndex = hoppingAmplitudeSet.getBasisIndex(from);
-	CArray<int> coefficientMap(basisSize);
-	for(unsigned int n = 0; n < basisSize; n++)
-		coefficientMap[n] = -1;
-	for(unsigned int n = 0; n < to.size(); n++)
-		coefficientMap[hoppingAmplitudeSet.getBasisIndex(to.at(n))] = n;
+	vector<unsigned int> fromBasisIndices;
+	fromBasisIndices.reserve(from.size());
+	for(unsigned int n = 0; n < from.size(); n++){
+		fromBasisIndices.push_back(
+			hoppingAmplitudeSet.getBasisIndex(from[n])
+		);
+	}
+	vector<unsigned int> toBasisIndices;
+	toBasisIndices.reserve(to.size());
+	for(unsigned int n = 0; n < to.size(); n++){
+		toBasisIndices.push_back(
+			hoppingAmplitudeSet.getBasisIndex(to[n])
+		);
+	}
 
 	if(getGlobalVerbose() && getVerbose()){
 		Streams::out << "ChebyshevExpander::calculateCoefficients\n";
-		Streams::out << "\tFrom Index: " << fromBasisIndex << "\n";
+		if(from.size() == 1){
+			Streams::out << "\tFrom Index: " << fromBasisIndices[0]
+				<< "\n";
+		}
+		else{
+			Streams::out << "\tNumber of from Indices: "
+				<< from.size() << "\n";
+			Streams::out << "\tBlock size: " << blockSize << "\n";
+		}
 		Streams::out << "\tBasis size: " << basisSize << "\n";
 		Streams::out << "\tProgress (100 coefficients per dot): ";
 	}
 
-	//Get the Hamiltonian on SparseMatrix format and scale it by the scale
-	//factor.
-	SparseMatrix<complex<double>> sparseMatrix
-		= hoppingAmplitudeSet.getSparseMatrix();
-	sparseMatrix.setStorageFormat(
-		SparseMatrix<complex<double>>::StorageFormat::CSR
+	//Get the Hamiltonian distributed over the available threads. The scale
+	//factor is applied during the multiplications.
+	const Math::ParallelSparseMatrix<complex<double>> &hamiltonian
+		= getHamiltonian();
+
+	//Extracts the nth coefficient from the current block. Only the element
+	//at the 'from'-index itself is extracted for diagonal coefficients.
+	auto extractCoefficients = [&](
+		const Math::ParallelSparseMatrix<complex<double>>::Vector &jIn,
+		unsigned int blockStart,
+		unsigned int numVectors,
+		int n
+	){
+		for(unsigned int k = 0; k < numVectors; k++){
+			if(diagonal){
+				coefficients[blockStart + k][0][n] = jIn[
+					fromBasisIndices[blockStart + k]
+					*numVectors + k
+				];
+				continue;
+			}
+			for(unsigned int c = 0; c < to.size(); c++){
+				coefficients[blockStart + k][c][n]
+					= jIn[toBasisIndices[c]*numVectors + k];
+			}
+		}
+	};
+
+	//Perform the recursion for blocks of up to blockSize from-indices at
+	//the time. The vectors in a block are stored with the elements for a
+	//given basis index stored consecutively, which allows the Hamiltonian
+	//to be read once per iteration for the whole block.
+	for(
+		unsigned int blockStart = 0;
+		blockStart < from.size();
+		blockStart += blockSize
+	){
+		const unsigned int numVectors = min(
+			blockSize,
+			(unsigned int)from.size() - blockStart
+		);
+
+		//Initialize workspace and set the initial states (|j0>).
+		Math::ParallelSparseMatrix<complex<double>>::Vector jIn1
+			= hamiltonian.createVector(numVectors);
+		Math::ParallelSparseMatrix<complex<double>>::Vector jIn2
+			= hamiltonian.createVector(numVectors);
+		for(unsigned int k = 0; k < numVectors; k++)
+			jIn1[fromBasisIndices[blockStart + k]*numVectors + k] = 1.;
+
+		extractCoefficients(jIn1, blockStart, numVectors, 0);
+
+		//Calculate |j1>
+		hamiltonian.multiplyBlock(jIn1, jIn2, numVectors, 1/scaleFactor);
+		swap(jIn1, jIn2);
+		extractCoefficients(jIn1, blockStart, numVectors, 1);
+
+		//Iteratively calculate |jn> = 2H|j(n-1)> - |j(n-2)> and
+		//corresponding Chebyshev coefficients. The result overwrites
+		//|j(n-2)> in place, which requires a single pass over memory
+		//per iteration.
+		for(int n = 2; n < numCoefficients; n++){
+			hamiltonian.multiplyBlock(
+				jIn1,
+				jIn2,
+				numVectors,
+				2/scaleFactor,
+				-1
+			);
+			swap(jIn1, jIn2);
+			extractCoefficients(jIn1, blockStart, numVectors, n);
+
+			if(getGlobalVerbose() && getVerbose()){
+				if(n%100 == 0)
+					Streams::out << "." << flush;
+				if(n%1000 == 0)
+					Streams::out << " " << flush;
+			}
+		}
+	}
+	if(getGlobalVerbose() && getVerbose())
+		Streams::out << "\n";
+
+	//Lorentzian convolution
+	if(broadening != 0){
+		double lambda = broadening*numCoefficients;
+		for(int n = 0; n < numCoefficients; n++){
+			const double factor
+				= sinh(lambda*(1 - n/(double)numCoefficients))
+				/sinh(lambda);
+			for(unsigned int f = 0; f < from.size(); f++)
+				for(unsigned int c = 0; c < numToIndices; c++)
+					coefficients[f][c][n] *= factor;
+		}
+	}
+
+	return coefficients;
+}
+
+vector<vector<complex<double>>> ChebyshevExpander::calculateTraceCoefficients(
+	unsigned int numRandomVectors,
+	unsigned int seed
+){
+	TBTKAssert(
+		numCoefficients > 0,
+		"ChebyshevExpander::calculateTraceCoefficients()",
+		"numCoefficients has to be larger than 0.",
+		""
+	);
+	TBTKAssert(
+		numRandomVectors > 0,
+		"ChebyshevExpander::calculateTraceCoefficients()",
+		"numRandomVectors has to be larger than 0.",
+		""
+	);
+
+	vector<vector<complex<double>>> coefficients(
+		numRandomVectors,
+		vector<complex<double>>(numCoefficients, 0)
 	);
-	sparseMatrix *= 1/scaleFactor;
-
-	//Initialize workspace and set the initial state (|j0>).
-	CArray<complex<double>> jIn1(basisSize, 0);
-	CArray<complex<double>> jIn2(basisSize, 0);
-	CArray<complex<double>> jResult(basisSize, 0);
-	jIn1[fromBasisIndex] = 1.;
-
-	for(unsigned int n = 0; n < basisSize; n++)
-		if(coefficientMap[n] != -1)
-			coefficients[coefficientMap[n]][0] = jIn1[n];
-
-	//Calculate |j1>
-	addHamiltonianProduct(sparseMatrix, jIn1, jResult);
-	cyclicSwap(jIn1, jIn2, jResult);
-	for(unsigned int n = 0; n < basisSize; n++)
-		if(coefficientMap[n] != -1)
-			coefficients[coefficientMap[n]][1] = jIn1[n];
-
-	//Multiply hopping amplitudes by factor two, to speed up calculation of
-	//the first term in 2H|j(n-1)> - |j(n-2)>.
-	sparseMatrix *= 2;
-
-	//Iteratively calculate |jn> and corresponding Chebyshev coefficients.
-	for(int n = 2; n < numCoefficients; n++){
-		for(unsigned int c = 0; c < basisSize; c++)
-			jResult[c] = -jIn2[c];
-		addHamiltonianProduct(sparseMatrix, jIn1, jResult);
-		cyclicSwap(jIn1, jIn2, jResult);
-		for(unsigned int c = 0; c < basisSize; c++)
-			if(coefficientMap[c] != -1)
-				coefficients[coefficientMap[c]][n] = jIn1[c];
-
-		if(getGlobalVerbose() && getVerbose()){
-			if(n%100 == 0)
-				Streams::out << "." << flush;
-			if(n%1000 == 0)
-				Streams::out << " " << flush;
+
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+	unsigned int basisSize = hoppingAmplitudeSet.getBasisSize();
+
+	if(getGlobalVerbose() && getVerbose()){
+		Streams::out << "ChebyshevExpander::calculateTraceCoefficients\n";
+		Streams::out << "\tNumber of random vectors: "
+			<< numRandomVectors << "\n";
+		Streams::out << "\tBlock size: " << blockSize << "\n";
+		Streams::out << "\tBasis size: " << basisSize << "\n";
+		Streams::out << "\tProgress (100 coefficients per dot): ";
+	}
+
+	const Math::ParallelSparseMatrix<complex<double>> &hamiltonian
+		= getHamiltonian();
+
+	mt19937_64 randomNumberGenerator(seed);
+	uniform_real_distribution<double> phaseDistribution(0, 2*M_PI);
+	vector<complex<double>> innerProducts(min(blockSize, numRandomVectors));
+	for(
+		unsigned int blockStart = 0;
+		blockStart < numRandomVectors;
+		blockStart += blockSize
+	){
+		const unsigned int numVectors = min(
+			blockSize,
+			numRandomVectors - blockStart
+		);
+
+		//Initialize the random-phase vectors |r> = |v0>. The vectors
+		//are generated one at the time to make the result independent
+		//of the block size.
+		Math::ParallelSparseMatrix<complex<double>>::Vector jIn1
+			= hamiltonian.createVector(numVectors);
+		Math::ParallelSparseMatrix<complex<double>>::Vector jIn2
+			= hamiltonian.createVector(numVectors);
+		for(unsigned int k = 0; k < numVectors; k++){
+			for(unsigned int n = 0; n < basisSize; n++){
+				jIn1[n*numVectors + k] = exp(
+					i*phaseDistribution(randomNumberGenerator)
+				);
+			}
+		}
+
+		//mu_0 = <v0|v0>
+		calculateBlockInnerProducts(jIn1, jIn1, numVectors, innerProducts);
+		for(unsigned int k = 0; k < numVectors; k++)
+			coefficients[blockStart + k][0] = innerProducts[k];
+		if(numCoefficients == 1)
+			continue;
+
+		//|v1> = H|v0> and mu_1 = <v1|v0>.
+		hamiltonian.multiplyBlock(jIn1, jIn2, numVectors, 1/scaleFactor);
+		swap(jIn1, jIn2);
+		calculateBlockInnerProducts(jIn1, jIn2, numVectors, innerProducts);
+		for(unsigned int k = 0; k < numVectors; k++)
+			coefficients[blockStart + k][1] = innerProducts[k];
+
+		//With |vn> in jIn1 and |v(n-1)> in jIn2, calculate
+		//mu_(2n) = 2<vn|vn> - mu_0, |v(n+1)> = 2H|vn> - |v(n-1)>, and
+		//mu_(2n+1) = 2<v(n+1)|vn> - mu_1.
+		for(int n = 1; 2*n < numCoefficients; n++){
+			calculateBlockInnerProducts(
+				jIn1,
+				jIn1,
+				numVectors,
+				innerProducts
+			);
+			for(unsigned int k = 0; k < numVectors; k++){
+				coefficients[blockStart + k][2*n]
+					= 2.*innerProducts[k]
+					- coefficients[blockStart + k][0];
+			}
+			if(2*n + 1 == numCoefficients)
+				break;
+
+			hamiltonian.multiplyBlock(
+				jIn1,
+				jIn2,
+				numVectors,
+				2/scaleFactor,
+				-1
+			);
+			swap(jIn1, jIn2);
+			calculateBlockInnerProducts(
+				jIn1,
+				jIn2,
+				numVectors,
+				innerProducts
+			);
+			for(unsigned int k = 0; k < numVectors; k++){
+				coefficients[blockStart + k][2*n + 1]
+					= 2.*innerProducts[k]
+					- coefficients[blockStart + k][1];
+			}
+
+			if(getGlobalVerbose() && getVerbose()){
+				if(n%50 == 0)
+					Streams::out << "." << flush;
+				if(n%500 == 0)
+					Streams::out << " " << flush;
+			}
 		}
 	}
 	if(getGlobalVerbose() && getVerbose())
@@ -190,14 +426,87 @@ vector<vector<complex<double>>> ChebyshevExpander::calculateCoefficientsCPU(
 	//Lorentzian convolution
 	if(broadening != 0){
 		double lambda = broadening*numCoefficients;
-		for(int n = 0; n < numCoefficients; n++)
-			for(unsigned int c = 0; c < to.size(); c++)
-				coefficients[c][n] = coefficients[c][n]*sinh(lambda*(1 - n/(double)numCoefficients))/sinh(lambda);
+		for(int n = 0; n < numCoefficients; n++){
+			const double factor
+				= sinh(lambda*(1 - n/(double)numCoefficients))
+				/sinh(lambda);
+			for(unsigned int r = 0; r < numRandomVectors; r++)
+				coefficients[r][n] *= factor;
+		}
 	}
 
 	return coefficients;
 }
 
+const Math::ParallelSparseMatrix<complex<double>>&
+ChebyshevExpander::getHamiltonian(){
+	getModel().updateCompiledCallbackAmplitudes();
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= getModel().getHoppingAmplitudeSet();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	const unsigned int *ranges
+		= compiledHoppingAmplitudes.getCallbackDependentElementRanges();
+	const unsigned int numCallbackDependentElements
+		= compiledHoppingAmplitudes.getNumCallbackDependentElements();
+
+	if(
+		!hamiltonianIsConstructed
+		|| hamiltonianRevision
+			!= compiledHoppingAmplitudes.getRevision()
+	){
+		SparseMatrix<complex<double>> sparseMatrix
+			= hoppingAmplitudeSet.getSparseMatrix();
+		sparseMatrix.setStorageFormat(
+			SparseMatrix<complex<double>>::StorageFormat::CSR
+		);
+		hamiltonian = Math::ParallelSparseMatrix<complex<double>>(
+			sparseMatrix
+		);
+
+		const unsigned int *toIndices
+			= compiledHoppingAmplitudes.getToIndices();
+		const unsigned int *fromIndices
+			= compiledHoppingAmplitudes.getFromIndices();
+		callbackDependentElementPositions.clear();
+		for(unsigned int n = 0; n < numCallbackDependentElements; n++){
+			int position = hamiltonian.getMatrixElementPosition(
+				toIndices[ranges[2*n]],
+				fromIndices[ranges[2*n]]
+			);
+			TBTKAssert(
+				position != -1,
+				"Solver::ChebyshevExpander::getHamiltonian()",
+				"Unable to find callback dependent matrix"
+				<< " element.",
+				"This should never happen, contact the"
+				<< " developer."
+			);
+			callbackDependentElementPositions.push_back(position);
+		}
+
+		hamiltonianRevision = compiledHoppingAmplitudes.getRevision();
+		hamiltonianIsConstructed = true;
+	}
+	else{
+		//Only the callback dependent matrix elements can have changed
+		//since the construction.
+		const complex<double> *amplitudes
+			= compiledHoppingAmplitudes.getAmplitudes();
+		for(unsigned int n = 0; n < numCallbackDependentElements; n++){
+			complex<double> value = 0;
+			for(unsigned int c = ranges[2*n]; c < ranges[2*n+1]; c++)
+				value += amplitudes[c];
+			hamiltonian.setMatrixElement(
+				callbackDependentElementPositions[n],
+				value
+			);
+		}
+	}
+
+	return hamiltonian;
+}
+
 void ChebyshevExpander::generateLookupTable(){
 	TBTKAssert(
 		numCoefficients > 0,
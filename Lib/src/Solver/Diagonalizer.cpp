@@ -35,6 +35,16 @@ DynamicTypeInformation Diagonalizer::dynamicTypeInformation(
 Diagonalizer::Diagonalizer() : Communicator(false){
 	maxIterations = 50;
 	selfConsistencyCallback = nullptr;
+	algorithm = Algorithm::PackedQR;
+	spectrumRange = SpectrumRange::AllStates;
+	firstState = 0;
+	lastState = 0;
+	lowerEnergy = 0;
+	upperEnergy = 0;
+	useRealArithmetic = true;
+	hamiltonianIsReal = false;
+	eigenVectorsAreReal = false;
+	keepRealEigenVectors = true;
 }
 
 void Diagonalizer::run(){
@@ -76,34 +86,81 @@ void Diagonalizer::init(){
 	if(getGlobalVerbose() && getVerbose())
 		Streams::out << "\tBasis size: " << basisSize << "\n";
 
-	hamiltonian = CArray<complex<double>>((basisSize*(basisSize+1))/2);
-	eigenValues = CArray<double>(basisSize);
-	eigenVectors = CArray<complex<double>>(basisSize*basisSize);
+	TBTKAssert(
+		spectrumRange == SpectrumRange::AllStates
+		|| algorithm == Algorithm::MRRR,
+		"Solver::Diagonalizer::init()",
+		"Partial spectra are only supported by Algorithm::MRRR.",
+		"Use Diagonalizer::setAlgorithm() to select"
+		<< " Diagonalizer::Algorithm::MRRR."
+	);
+	TBTKAssert(
+		spectrumRange != SpectrumRange::StateRange
+		|| lastState < (unsigned int)basisSize,
+		"Solver::Diagonalizer::init()",
+		"The last state '" << lastState << "' in the state range is"
+		<< " out of bounds for a Model with basis size '" << basisSize
+		<< "'.",
+		""
+	);
 
 	update();
 }
 
 void Diagonalizer::update(){
-	const Model &model = getModel();
+	Model &model = getModel();
+	model.updateCompiledCallbackAmplitudes();
 	int basisSize = model.getBasisSize();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	const unsigned int numHoppingAmplitudes
+		= compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+
+	//Real arithmetic is used if every amplitude is real and the basis is
+	//orthonormal.
+	hamiltonianIsReal = useRealArithmetic
+		&& model.getOverlapAmplitudeSet().getAssumeOrthonormalBasis();
+	for(unsigned int n = 0; n < numHoppingAmplitudes; n++){
+		if(!hamiltonianIsReal)
+			break;
+		if(imag(amplitudes[n]) != 0)
+			hamiltonianIsReal = false;
+	}
 
-	for(int n = 0; n < (basisSize*(basisSize+1))/2; n++)
-		hamiltonian[n] = 0.;
+	const unsigned int hamiltonianSize = (basisSize*(basisSize+1))/2;
+	if(hamiltonianIsReal){
+		hamiltonian = CArray<complex<double>>();
+		if(realHamiltonian.getSize() != hamiltonianSize)
+			realHamiltonian = CArray<double>(hamiltonianSize);
+		for(unsigned int n = 0; n < hamiltonianSize; n++)
+			realHamiltonian[n] = 0.;
+	}
+	else{
+		realHamiltonian = CArray<double>();
+		if(hamiltonian.getSize() != hamiltonianSize)
+			hamiltonian = CArray<complex<double>>(hamiltonianSize);
+		for(unsigned int n = 0; n < hamiltonianSize; n++)
+			hamiltonian[n] = 0.;
+	}
 
-	for(
-		HoppingAmplitudeSet::ConstIterator iterator
-			= model.getHoppingAmplitudeSet().cbegin();
-		iterator != model.getHoppingAmplitudeSet().cend();
-		++iterator
-	){
-		int from = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getFromIndex()
-		);
-		int to = model.getHoppingAmplitudeSet().getBasisIndex(
-			(*iterator).getToIndex()
-		);
-		if(from >= to)
-			hamiltonian[to + (from*(from+1))/2] += (*iterator).getAmplitude();
+	for(unsigned int n = 0; n < numHoppingAmplitudes; n++){
+		unsigned int from = fromIndices[n];
+		unsigned int to = toIndices[n];
+		if(from >= to){
+			if(hamiltonianIsReal){
+				realHamiltonian[to + (from*(from+1))/2]
+					+= real(amplitudes[n]);
+			}
+			else{
+				hamiltonian[to + (from*(from+1))/2]
+					+= amplitudes[n];
+			}
+		}
 	}
 
 	setupBasisTransformation();
@@ -122,6 +179,103 @@ extern "C" void zhpev_(char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues
 			double *rwork,		//Workspace, dimension = max(1, 3*N-2)
 			int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
 
+//Lapack function for divide-and-conquer diagonalization of a Hermitian
+//matrix.
+extern "C" void zheevd_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, overwritten by the eigenvectors
+	int *lda,		//Leading dimension of a
+	double *w,		//Eigenvalues, in accending order if info = 0
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = the algorithm failed to converge.
+
+//Lapack function for diagonalization of a Hermitian matrix using multiple
+//relatively robust representations.
+extern "C" void zheevr_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *range,		//'A' = All, 'V' = Eigenvalues in (vl, vu], 'I' = Eigenvalues il through iu.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, destroyed on exit
+	int *lda,		//Leading dimension of a
+	double *vl,		//Lower bound of the interval if range = 'V'
+	double *vu,		//Upper bound of the interval if range = 'V'
+	int *il,		//Index (starting from 1) of the first eigenvalue if range = 'I'
+	int *iu,		//Index (starting from 1) of the last eigenvalue if range = 'I'
+	double *abstol,		//Absolute error tolerance, <= 0 for default
+	int *m,			//Number of eigenvalues found
+	double *w,		//Eigenvalues, in accending order if info = 0
+	complex<double> *z,	//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	int *isuppz,		//Support of the eigenvectors, dimension = 2*max(1, m)
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = internal error.
+
+//Lapack function for matrix diagonalization of real symmetric triangular
+//matrix.
+extern "C" void dspev_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	double *ap,		//Input matrix
+	double *w,		//Eigenvalues, is in accending order if info = 0
+	double *z,		//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	double *work,		//Workspace, dimension = 3*N
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = info number of off-diagonal elements failed to converge.
+
+//Lapack function for divide-and-conquer diagonalization of a real symmetric
+//matrix.
+extern "C" void dsyevd_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	double *a,		//Input matrix, overwritten by the eigenvectors
+	int *lda,		//Leading dimension of a
+	double *w,		//Eigenvalues, in accending order if info = 0
+	double *work,		//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = the algorithm failed to converge.
+
+//Lapack function for diagonalization of a real symmetric matrix using
+//multiple relatively robust representations.
+extern "C" void dsyevr_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *range,		//'A' = All, 'V' = Eigenvalues in (vl, vu], 'I' = Eigenvalues il through iu.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	double *a,		//Input matrix, destroyed on exit
+	int *lda,		//Leading dimension of a
+	double *vl,		//Lower bound of the interval if range = 'V'
+	double *vu,		//Upper bound of the interval if range = 'V'
+	int *il,		//Index (starting from 1) of the first eigenvalue if range = 'I'
+	int *iu,		//Index (starting from 1) of the last eigenvalue if range = 'I'
+	double *abstol,		//Absolute error tolerance, <= 0 for default
+	int *m,			//Number of eigenvalues found
+	double *w,		//Eigenvalues, in accending order if info = 0
+	double *z,		//Eigenvectors
+	int *ldz,		//Leading dimension of z
+	int *isuppz,		//Support of the eigenvectors, dimension = 2*max(1, m)
+	double *work,		//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = internal error.
+
 //Lapack function for matrix diagonalization of banded triangular matrix
 extern "C" void zhbeb_(
 	char *jobz,		//'E' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
@@ -266,25 +420,26 @@ void Diagonalizer::transformToOriginalBasis(){
 		return;
 
 	int basisSize = getModel().getBasisSize();
+	int numStates = getNumStates();
 
 	//Perform the transformation v = Uv', where U is the transformation to
 	//the orthonormal basis and v and v' are the eigenvectors in the
 	//original and orthonormal basis, respectively.
 	Matrix<complex<double>> U(basisSize, basisSize);
-	Matrix<complex<double>> Vp(basisSize, basisSize);
+	Matrix<complex<double>> Vp(basisSize, numStates);
 	for(int row = 0; row < basisSize; row++){
 		for(int col = 0; col < basisSize; col++){
 			U.at(row, col)
 				= basisTransformation[row + basisSize*col];
-
-			Vp.at(row, col) = eigenVectors[row + basisSize*col];
 		}
+		for(int col = 0; col < numStates; col++)
+			Vp.at(row, col) = eigenVectors[row + basisSize*col];
 	}
 
 	Matrix<complex<double>> V = U*Vp;
 
 	for(int row = 0; row < basisSize; row++){
-		for(int col = 0; col < basisSize; col++){
+		for(int col = 0; col < numStates; col++){
 			eigenVectors[row + basisSize*col]
 				= V.at(row, col);
 		}
@@ -292,6 +447,69 @@ void Diagonalizer::transformToOriginalBasis(){
 }
 
 void Diagonalizer::solve(){
+	//Allocate storage for the eigenstates on the format determined by the
+	//Hamiltonian. The MRRR algorithm allocates the storage itself once
+	//the number of eigenstates is known.
+	int basisSize = getModel().getBasisSize();
+	if(algorithm == Algorithm::MRRR){
+		eigenVectors = CArray<complex<double>>();
+		realEigenVectors = CArray<double>();
+	}
+	else if(hamiltonianIsReal){
+		if(eigenValues.getSize() != (unsigned int)basisSize)
+			eigenValues = CArray<double>(basisSize);
+		eigenVectors = CArray<complex<double>>();
+		if(realEigenVectors.getSize() != (unsigned int)basisSize*basisSize)
+			realEigenVectors = CArray<double>(basisSize*basisSize);
+	}
+	else{
+		if(eigenValues.getSize() != (unsigned int)basisSize)
+			eigenValues = CArray<double>(basisSize);
+		realEigenVectors = CArray<double>();
+		if(eigenVectors.getSize() != (unsigned int)basisSize*basisSize){
+			eigenVectors = CArray<complex<double>>(
+				basisSize*basisSize
+			);
+		}
+	}
+	eigenVectorsAreReal = hamiltonianIsReal;
+
+	switch(algorithm){
+	case Algorithm::PackedQR:
+		if(hamiltonianIsReal)
+			solvePackedQRReal();
+		else
+			solvePackedQR();
+		break;
+	case Algorithm::DivideAndConquer:
+		if(hamiltonianIsReal)
+			solveDivideAndConquerReal();
+		else
+			solveDivideAndConquer();
+		break;
+	case Algorithm::MRRR:
+		if(hamiltonianIsReal)
+			solveMRRRReal();
+		else
+			solveMRRR();
+		break;
+	default:
+		TBTKExit(
+			"Solver::Diagonalizer::solve()",
+			"Unknown algorithm.",
+			"This should never happen, contact the developer."
+		);
+	}
+
+	transformToOriginalBasis();
+
+	//Convert the eigenvectors here rather than on access if they are not
+	//to be kept real.
+	if(eigenVectorsAreReal && !keepRealEigenVectors)
+		convertEigenVectorsToComplex();
+}
+
+void Diagonalizer::solvePackedQR(){
 	if(true){//Currently no support for banded matrices.
 		//Setup zhpev to calculate...
 		char jobz = 'V';		//...eigenvalues and eigenvectors...
@@ -346,8 +564,416 @@ void Diagonalizer::solve(){
 		delete [] work;
 		delete [] rwork;
 	}*/
+}
 
-	transformToOriginalBasis();
+void Diagonalizer::solveDivideAndConquer(){
+	//Setup zheevd to calculate eigenvalues and eigenvectors for an upper
+	//triangular nxn-matrix. The eigenvectors overwrite the matrix, which
+	//therefore is stored directly in the eigenvector storage.
+	char jobz = 'V';
+	char uplo = 'U';
+	int n = getModel().getBasisSize();
+	unpackHamiltonian(hamiltonian, eigenVectors.getData());
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	int info;
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		eigenVectors.getData(),
+		&n,
+		eigenValues.getData(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		eigenVectors.getData(),
+		&n,
+		eigenValues.getData(),
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solveDivideAndConquer()",
+		"Diagonalization routine zheevd exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zheevd for further information."
+	);
+}
+
+void Diagonalizer::solveMRRR(){
+	//Setup zheevr to calculate eigenvalues and eigenvectors for an upper
+	//triangular nxn-matrix. Which eigenstates to calculate is determined
+	//by the spectrum range.
+	char jobz = 'V';
+	char range = getLapackRange();
+	char uplo = 'U';
+	int n = getModel().getBasisSize();
+	double vl = lowerEnergy;
+	double vu = upperEnergy;
+	int il = firstState + 1;
+	int iu = lastState + 1;
+	double abstol = 0;
+
+	CArray<complex<double>> matrix(n*n);
+	unpackHamiltonian(hamiltonian, matrix.getData());
+
+	//The number of eigenstates in an energy range is not known in
+	//advance, in which case storage for n eigenstates is used.
+	int maxNumStates = n;
+	if(spectrumRange == SpectrumRange::StateRange)
+		maxNumStates = iu - il + 1;
+	CArray<double> w(n);
+	CArray<complex<double>> z(n*maxNumStates);
+	CArray<int> isuppz(2*max(1, maxNumStates));
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	int m;
+	int info;
+	zheevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		matrix.getData(),
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w.getData(),
+		z.getData(),
+		&n,
+		isuppz.getData(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		matrix.getData(),
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w.getData(),
+		z.getData(),
+		&n,
+		isuppz.getData(),
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solveMRRR()",
+		"Diagonalization routine zheevr exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for zheevr for further information."
+	);
+
+	//Store the m calculated eigenstates. The Hamiltonian is released
+	//first, and z is used as storage directly when it has the right size.
+	matrix = CArray<complex<double>>();
+	if(eigenValues.getSize() != (unsigned int)m)
+		eigenValues = CArray<double>(m);
+	for(int state = 0; state < m; state++)
+		eigenValues[state] = w[state];
+	if(m == maxNumStates){
+		eigenVectors = std::move(z);
+	}
+	else{
+		eigenVectors = CArray<complex<double>>(n*m);
+		for(int c = 0; c < n*m; c++)
+			eigenVectors[c] = z[c];
+	}
+}
+
+void Diagonalizer::solvePackedQRReal(){
+	//Setup dspev to calculate eigenvalues and eigenvectors for an upper
+	//triangular nxn-matrix.
+	char jobz = 'V';
+	char uplo = 'U';
+	int n = getModel().getBasisSize();
+	CArray<double> work(3*n);
+	int info;
+	dspev_(
+		&jobz,
+		&uplo,
+		&n,
+		realHamiltonian.getData(),
+		eigenValues.getData(),
+		realEigenVectors.getData(),
+		&n,
+		work.getData(),
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solvePackedQRReal()",
+		"Diagonalization routine dspev exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for dspev for further information."
+	);
+}
+
+void Diagonalizer::solveDivideAndConquerReal(){
+	//Setup dsyevd to calculate eigenvalues and eigenvectors for an upper
+	//triangular nxn-matrix. The eigenvectors overwrite the matrix, which
+	//therefore is stored directly in the eigenvector storage.
+	char jobz = 'V';
+	char uplo = 'U';
+	int n = getModel().getBasisSize();
+	unpackHamiltonian(realHamiltonian, realEigenVectors.getData());
+
+	//Workspace query.
+	int lwork = -1;
+	int liwork = -1;
+	double workSize;
+	int iworkSize;
+	int info;
+	dsyevd_(
+		&jobz,
+		&uplo,
+		&n,
+		realEigenVectors.getData(),
+		&n,
+		eigenValues.getData(),
+		&workSize,
+		&lwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)workSize;
+	liwork = iworkSize;
+	CArray<double> work(lwork);
+	CArray<int> iwork(liwork);
+	dsyevd_(
+		&jobz,
+		&uplo,
+		&n,
+		realEigenVectors.getData(),
+		&n,
+		eigenValues.getData(),
+		work.getData(),
+		&lwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solveDivideAndConquerReal()",
+		"Diagonalization routine dsyevd exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for dsyevd for further information."
+	);
+}
+
+void Diagonalizer::solveMRRRReal(){
+	//Setup dsyevr to calculate eigenvalues and eigenvectors for an upper
+	//triangular nxn-matrix. Which eigenstates to calculate is determined
+	//by the spectrum range.
+	char jobz = 'V';
+	char range = getLapackRange();
+	char uplo = 'U';
+	int n = getModel().getBasisSize();
+	double vl = lowerEnergy;
+	double vu = upperEnergy;
+	int il = firstState + 1;
+	int iu = lastState + 1;
+	double abstol = 0;
+
+	CArray<double> matrix(n*n);
+	unpackHamiltonian(realHamiltonian, matrix.getData());
+
+	//The number of eigenstates in an energy range is not known in
+	//advance, in which case storage for n eigenstates is used.
+	int maxNumStates = n;
+	if(spectrumRange == SpectrumRange::StateRange)
+		maxNumStates = iu - il + 1;
+	CArray<double> w(n);
+	CArray<double> z(n*maxNumStates);
+	CArray<int> isuppz(2*max(1, maxNumStates));
+
+	//Workspace query.
+	int lwork = -1;
+	int liwork = -1;
+	double workSize;
+	int iworkSize;
+	int m;
+	int info;
+	dsyevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		matrix.getData(),
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w.getData(),
+		z.getData(),
+		&n,
+		isuppz.getData(),
+		&workSize,
+		&lwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)workSize;
+	liwork = iworkSize;
+	CArray<double> work(lwork);
+	CArray<int> iwork(liwork);
+	dsyevr_(
+		&jobz,
+		&range,
+		&uplo,
+		&n,
+		matrix.getData(),
+		&n,
+		&vl,
+		&vu,
+		&il,
+		&iu,
+		&abstol,
+		&m,
+		w.getData(),
+		z.getData(),
+		&n,
+		isuppz.getData(),
+		work.getData(),
+		&lwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Diagonalizer:solveMRRRReal()",
+		"Diagonalization routine dsyevr exited with INFO=" + to_string(info) + ".",
+		"See LAPACK documentation for dsyevr for further information."
+	);
+
+	//Store the m calculated eigenstates. The Hamiltonian is released
+	//first, and z is used as storage directly when it has the right size.
+	matrix = CArray<double>();
+	if(eigenValues.getSize() != (unsigned int)m)
+		eigenValues = CArray<double>(m);
+	for(int state = 0; state < m; state++)
+		eigenValues[state] = w[state];
+	if(m == maxNumStates){
+		realEigenVectors = std::move(z);
+	}
+	else{
+		realEigenVectors = CArray<double>(n*m);
+		for(int c = 0; c < n*m; c++)
+			realEigenVectors[c] = z[c];
+	}
+}
+
+char Diagonalizer::getLapackRange() const{
+	switch(spectrumRange){
+	case SpectrumRange::AllStates:
+		return 'A';
+	case SpectrumRange::StateRange:
+		return 'I';
+	case SpectrumRange::EnergyRange:
+		return 'V';
+	default:
+		TBTKExit(
+			"Solver::Diagonalizer::getLapackRange()",
+			"Unknown spectrum range.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+void Diagonalizer::copyEigenVectorsToComplex() const{
+	lock_guard<mutex> lock(eigenVectorsMutex);
+	if(eigenVectors.getSize() == realEigenVectors.getSize())
+		return;
+
+	CArray<complex<double>> complexEigenVectors(realEigenVectors.getSize());
+	for(unsigned int n = 0; n < realEigenVectors.getSize(); n++)
+		complexEigenVectors[n] = realEigenVectors[n];
+	eigenVectors = std::move(complexEigenVectors);
+}
+
+void Diagonalizer::convertEigenVectorsToComplex(){
+	copyEigenVectorsToComplex();
+	realEigenVectors = CArray<double>();
+	eigenVectorsAreReal = false;
 }
 
 };	//End of namespace Solver
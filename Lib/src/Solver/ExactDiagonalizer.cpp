@@ -71,29 +71,35 @@ void ExactDiagonalizer::setupManyParticleModel<BitRegister>(unsigned int subspac
 		subspaceContext.fockStateRuleSet
 	);
 
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel().getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices = compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes = compiledHoppingAmplitudes.getAmplitudes();
+
 	subspaceContext.manyParticleModel.reset(new Model());
 	for(unsigned int n = 0; n < fockStateMap->getBasisSize(); n++){
 		for(
-			HoppingAmplitudeSet::ConstIterator iterator
-				= getModel().getHoppingAmplitudeSet().cbegin();
-			iterator != getModel().getHoppingAmplitudeSet().cend();
-			++iterator
+			unsigned int c = 0;
+			c < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+			c++
 		){
 			FockState<BitRegister> fockState = fockStateMap->getFockState(n);
 
 			int from = fockStateMap->getBasisIndex(fockState);
 
-			operators[getModel().getBasisIndex((*iterator).getFromIndex())][1]*fockState;
+			operators[fromIndices[c]][1]*fockState;
 			if(fockState.isNull())
 				continue;
-			operators[getModel().getBasisIndex((*iterator).getToIndex())][0]*fockState;
+			operators[toIndices[c]][0]*fockState;
 			if(fockState.isNull())
 				continue;
 
 			int to = fockStateMap->getBasisIndex(fockState);
 
 			*subspaceContext.manyParticleModel << HoppingAmplitude(
-				(*iterator).getAmplitude()*(double)fockState.getPrefactor(),
+				amplitudes[c]*(double)fockState.getPrefactor(),
 				{to},
 				{from}
 			);
@@ -144,29 +150,35 @@ void ExactDiagonalizer::setupManyParticleModel<ExtensiveBitRegister>(unsigned in
 		subspaceContext.fockStateRuleSet
 	);
 
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel().getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices = compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices = compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes = compiledHoppingAmplitudes.getAmplitudes();
+
 	subspaceContext.manyParticleModel.reset(new Model());
 	for(unsigned int n = 0; n < fockStateMap->getBasisSize(); n++){
 		for(
-			HoppingAmplitudeSet::ConstIterator iterator
-				= getModel().getHoppingAmplitudeSet().cbegin();
-			iterator != getModel().getHoppingAmplitudeSet().cend();
-			++iterator
+			unsigned int c = 0;
+			c < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+			c++
 		){
 			FockState<ExtensiveBitRegister> fockState = fockStateMap->getFockState(n);
 
 			int from = fockStateMap->getBasisIndex(fockState);
 
-			operators[getModel().getBasisIndex((*iterator).getFromIndex())][1]*fockState;
+			operators[fromIndices[c]][1]*fockState;
 			if(fockState.isNull())
 				continue;
-			operators[getModel().getBasisIndex((*iterator).getToIndex())][0]*fockState;
+			operators[toIndices[c]][0]*fockState;
 			if(fockState.isNull())
 				continue;
 
 			int to = fockStateMap->getBasisIndex(fockState);
 
 			*subspaceContext.manyParticleModel << HoppingAmplitude(
-				(*iterator).getAmplitude()*(double)fockState.getPrefactor(),
+				amplitudes[c]*(double)fockState.getPrefactor(),
 				{to},
 				{from}
 			);
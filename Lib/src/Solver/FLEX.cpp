@@ -32,7 +32,9 @@
 #include "TBTK/Solver/SelfEnergy2.h"
 #include "TBTK/Solver/FLEX.h"
 
+#include <chrono>
 #include <complex>
+#include <thread>
 
 using namespace std;
 
@@ -75,16 +77,25 @@ FLEX::FLEX(
 	tolerance = 0;
 	convergenceParameter = 0;
 	numSlices = 1;
+	slicePipelining = false;
+	stageTimes.assign(static_cast<unsigned int>(Stage::GreensFunction) + 1, 0);
 }
 
 void FLEX::run(){
+	selfEnergyMixer.reset();
+	for(unsigned int n = 0; n < stageTimes.size(); n++)
+		stageTimes[n] = 0;
+
 	//Calculate the non-interacting Green's function.
-	Timer::tick("Green's function 0");
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
 	calculateBareGreensFunction();
+	addStageTime(Stage::BareGreensFunction, start);
 	greensFunction = greensFunction0;
-	if(selfEnergy.getData().size() != 0)
+	if(selfEnergy.getData().size() != 0){
+		start = chrono::steady_clock::now();
 		calculateGreensFunction();
-	Timer::tock();
+		addStageTime(Stage::GreensFunction, start);
+	}
 
 	state = State::GreensFunctionCalculated;
 	if(callback != nullptr)
@@ -93,47 +104,101 @@ void FLEX::run(){
 	//The main loop.
 	unsigned int iteration = 0;
 	while(iteration++ < maxIterations){
-		for(unsigned int n = 0; n < numSlices; n++){
-			Timer::tick("One slice");
+		//The bare susceptibility for the next slice and the time it
+		//took to calculate it. Only used if the slices are pipelined.
+		Property::Susceptibility nextBareSusceptibility;
+		double nextBareSusceptibilityTime = 0;
+		thread bareSusceptibilityThread;
 
-			Timer::tick("Bare susceptibility");
-			//Calculate the bare susceptibility.
-			calculateBareSusceptibility(n);
+		for(unsigned int n = 0; n < numSlices; n++){
+			//Calculate the bare susceptibility, or wait for it to
+			//be calculated if the slices are pipelined.
+			if(n == 0 || !slicePipelining){
+				start = chrono::steady_clock::now();
+				bareSusceptibility = calculateBareSusceptibility(n);
+				addStageTime(Stage::BareSusceptibility, start);
+			}
+			else{
+				if(bareSusceptibilityThread.joinable())
+					bareSusceptibilityThread.join();
+				bareSusceptibility = nextBareSusceptibility;
+				stageTimes[
+					static_cast<unsigned int>(
+						Stage::BareSusceptibility
+					)
+				] += nextBareSusceptibilityTime;
+			}
 			state = State::BareSusceptibilityCalculated;
 			if(callback != nullptr)
 				callback(*this);
-			Timer::tock();
 
-			Timer::tick("RPA susceptibility");
+			//Start the calculation of the bare susceptibility for
+			//the next slice. The Green's function is not modified
+			//until all slices have been processed. The thread reads
+			//the solver, so it is joined before the callback is
+			//called to allow the callback to modify the solver.
+			if(slicePipelining && n + 1 < numSlices){
+				bareSusceptibilityThread = thread(
+					[
+						this,
+						n,
+						&nextBareSusceptibility,
+						&nextBareSusceptibilityTime
+					](){
+						chrono::steady_clock::time_point threadStart
+							= chrono::steady_clock::now();
+						nextBareSusceptibility
+							= calculateBareSusceptibility(
+								n + 1
+							);
+						nextBareSusceptibilityTime
+							= chrono::duration<double>(
+								chrono::steady_clock::now()
+								- threadStart
+							).count();
+					}
+				);
+			}
+
 			//Calculate the RPA charge and spin susceptibilities.
+			start = chrono::steady_clock::now();
 			calculateRPASusceptibilities();
+			addStageTime(Stage::RPASusceptibilities, start);
 			state = State::RPASusceptibilitiesCalculated;
-			if(callback != nullptr)
+			if(callback != nullptr){
+				if(bareSusceptibilityThread.joinable())
+					bareSusceptibilityThread.join();
 				callback(*this);
-			Timer::tock();
+			}
 
-			Timer::tick("Interaction vertex");
 			//Calculate the interaction vertex.
+			start = chrono::steady_clock::now();
 			calculateInteractionVertex();
+			addStageTime(Stage::InteractionVertex, start);
 			state = State::InteractionVertexCalculated;
-			if(callback != nullptr)
+			if(callback != nullptr){
+				if(bareSusceptibilityThread.joinable())
+					bareSusceptibilityThread.join();
 				callback(*this);
-			Timer::tock();
+			}
 
-			Timer::tick("Self energy");
 			//Calculate the self-energy.
+			start = chrono::steady_clock::now();
 			calculateSelfEnergy(n);
+			addStageTime(Stage::SelfEnergy, start);
 			state = State::SelfEnergyCalculated;
-			if(callback != nullptr)
+			if(callback != nullptr){
+				if(bareSusceptibilityThread.joinable())
+					bareSusceptibilityThread.join();
 				callback(*this);
-			Timer::tock();
-
-			Timer::tock();
+			}
 		}
 
 		//Calculate the Green's function.
 		oldGreensFunction = greensFunction;
+		start = chrono::steady_clock::now();
 		calculateGreensFunction();
+		addStageTime(Stage::GreensFunction, start);
 		state = State::GreensFunctionCalculated;
 		if(callback != nullptr)
 			callback(*this);
@@ -144,6 +209,16 @@ void FLEX::run(){
 	}
 }
 
+void FLEX::addStageTime(
+	Stage stage,
+	const chrono::steady_clock::time_point &start
+){
+	stageTimes[static_cast<unsigned int>(stage)]
+		+= chrono::duration<double>(
+			chrono::steady_clock::now() - start
+		).count();
+}
+
 void FLEX::calculateBareGreensFunction(){
 	const vector<unsigned int> &numMeshPoints
 		= momentumSpaceContext.getNumMeshPoints();
@@ -186,7 +261,9 @@ void FLEX::calculateBareGreensFunction(){
 		);
 }
 
-void FLEX::calculateBareSusceptibility(unsigned int slice){
+Property::Susceptibility FLEX::calculateBareSusceptibility(
+	unsigned int slice
+){
 	MatsubaraSusceptibility matsubaraSusceptibilitySolver(
 		momentumSpaceContext,
 		greensFunction
@@ -205,8 +282,7 @@ void FLEX::calculateBareSusceptibility(unsigned int slice){
 		getLowerBosonicMatsubaraEnergyIndex(slice),
 		getUpperBosonicMatsubaraEnergyIndex(slice)
 	);
-	bareSusceptibility
-		= matsubaraSusceptibilityPropertyExtractor.calculateSusceptibility({
+	return matsubaraSusceptibilityPropertyExtractor.calculateSusceptibility({
 			{
 				{IDX_ALL, IDX_ALL},
 				{IDX_ALL},
@@ -451,6 +527,11 @@ void FLEX::calculateInteractionVertex(){
 }
 
 void FLEX::calculateSelfEnergy(unsigned int slice){
+	//TODO
+	//The Green's function, susceptibilities, and self-energy are stored on
+	//uniform Matsubara grids. Storing them at the sampling points of an
+	//IntermediateRepresentation would allow for lower temperatures at the
+	//same memory and time cost.
 	SelfEnergy2 selfEnergySolver(
 		momentumSpaceContext,
 		interactionVertex,
@@ -482,12 +563,19 @@ void FLEX::calculateSelfEnergy(unsigned int slice){
 	if(slice == numSlices - 1){
 		convertSelfEnergyIndexStructure();
 
-		if(
-			previousSelfEnergy.getData().size() != 0
-			&& selfEnergyMixingParameter != 0
-		){
-			selfEnergy = (1 - selfEnergyMixingParameter)*selfEnergy
-				+ selfEnergyMixingParameter*previousSelfEnergy;
+		if(previousSelfEnergy.getData().size() != 0){
+			//Mix the flattened data. The previous SelfEnergy holds
+			//the input that the new SelfEnergy was calculated from,
+			//and is updated in place to the input for the next
+			//iteration.
+			selfEnergyMixer.setMixingParameter(
+				1 - selfEnergyMixingParameter
+			);
+			selfEnergyMixer.mix(
+				previousSelfEnergy.getDataRW(),
+				selfEnergy.getData()
+			);
+			selfEnergy = previousSelfEnergy;
 		}
 	}
 }
@@ -25,6 +25,18 @@
 
 using namespace std;
 
+//Lapack function for solving a general linear system using LU factorization.
+extern "C" void zgesv_(
+	int *n,			//Matrix size
+	int *nrhs,		//Number of right hand sides
+	complex<double> *a,	//Input matrix, overwritten by the LU factors
+	int *lda,		//Leading dimension of a
+	int *ipiv,		//Pivot indices
+	complex<double> *b,	//Right hand sides, overwritten by the solution
+	int *ldb,		//Leading dimension of b
+	int *info		//0 = successful, <0 = -info value was illegal, >0 = singular matrix.
+);
+
 namespace TBTK{
 namespace Solver{
 
@@ -573,120 +585,104 @@ Property::GreensFunction Greens::createNewGreensFunction() const{
 	return result;
 }
 
-void Greens::convertGreensFunctionToMatrix(
-	Matrix<complex<double>> &matrix,
-	unsigned int energy,
-	const IndexTree &intraBlockIndices
-) const{
-	unsigned int row = 0;
-	for(auto iterator0 : intraBlockIndices){
-		unsigned int column = 0;
-		for(auto iterator1 : intraBlockIndices){
-			Index compoundIndex = {iterator0, iterator1};
-
-			matrix.at(row, column) = (*greensFunction)(
-				compoundIndex,
-				energy
-			);
-
-			column++;
-		}
-
-		row++;
-	}
-}
-
-void Greens::addSelfEnergyToGreensFunctionMatrix(
-	Matrix<complex<double>> &matrix,
+void Greens::calculateInteractingGreensFunctionSingleBlock(
+	Property::GreensFunction &interactingGreensFunction,
 	const Property::SelfEnergy &selfEnergy,
-	unsigned int energy,
 	const IndexTree &intraBlockIndices
 ) const{
-	unsigned int row = 0;
-	for(auto iterator0 : intraBlockIndices){
-		unsigned int column = 0;
-		for(auto iterator1 : intraBlockIndices){
-			Index compoundIndex = {iterator0, iterator1};
-
-			matrix.at(row, column) -= selfEnergy(
-				compoundIndex,
-				energy
+	const unsigned int BLOCK_SIZE = intraBlockIndices.getSize();
+	const unsigned int NUM_ENERGIES = greensFunction->getNumEnergies();
+
+	//Lookup the offsets of the block elements once, rather than
+	//traversing the IndexTrees for every energy. The offsets are stored
+	//in column major order.
+	vector<int> greensFunctionOffsets;
+	vector<int> selfEnergyOffsets;
+	vector<int> interactingGreensFunctionOffsets;
+	for(auto index1 : intraBlockIndices){
+		for(auto index0 : intraBlockIndices){
+			Index compoundIndex = {index0, index1};
+			greensFunctionOffsets.push_back(
+				greensFunction->getOffset(compoundIndex)
+			);
+			selfEnergyOffsets.push_back(
+				selfEnergy.getOffset(compoundIndex)
+			);
+			interactingGreensFunctionOffsets.push_back(
+				interactingGreensFunction.getOffset(compoundIndex)
 			);
-
-			column++;
 		}
-
-		row++;
 	}
-}
-
+	const vector<complex<double>> &greensFunctionData
+		= greensFunction->getData();
+	const vector<complex<double>> &selfEnergyData = selfEnergy.getData();
+	vector<complex<double>> &interactingGreensFunctionData
+		= interactingGreensFunction.getDataRW();
+
+	#pragma omp parallel
+	{
+		//Workspace that is reused for all energies handled by the
+		//thread.
+		vector<complex<double>> G0(BLOCK_SIZE*BLOCK_SIZE);
+		vector<complex<double>> sigma(BLOCK_SIZE*BLOCK_SIZE);
+		vector<complex<double>> dysonMatrix(BLOCK_SIZE*BLOCK_SIZE);
+		vector<int> ipiv(BLOCK_SIZE);
+
+		#pragma omp for schedule(static)
+		for(unsigned int n = 0; n < NUM_ENERGIES; n++){
+			for(unsigned int c = 0; c < BLOCK_SIZE*BLOCK_SIZE; c++){
+				G0[c] = greensFunctionData[
+					greensFunctionOffsets[c] + n
+				];
+				sigma[c] = selfEnergyData[
+					selfEnergyOffsets[c] + n
+				];
+			}
 
-void Greens::writeGreensFunctionMatrixToInteractingGreensFunction(
-	Property::GreensFunction &interactingGreensFunction,
-	const Matrix<complex<double>> &matrix,
-	unsigned int energy,
-	const IndexTree &intraBlockIndices
-) const{
-	unsigned int row = 0;
-	for(auto iterator0 : intraBlockIndices){
-		unsigned int column = 0;
-		for(auto iterator1 : intraBlockIndices){
-			Index compoundIndex = {iterator0, iterator1};
+			//Setup 1 - G_0\Sigma.
+			for(unsigned int c = 0; c < BLOCK_SIZE*BLOCK_SIZE; c++)
+				dysonMatrix[c] = 0;
+			for(unsigned int c = 0; c < BLOCK_SIZE; c++){
+				dysonMatrix[c + BLOCK_SIZE*c] = 1;
+				for(unsigned int k = 0; k < BLOCK_SIZE; k++){
+					complex<double> s = sigma[k + BLOCK_SIZE*c];
+					if(s == 0.)
+						continue;
+
+					for(unsigned int r = 0; r < BLOCK_SIZE; r++){
+						dysonMatrix[r + BLOCK_SIZE*c]
+							-= G0[r + BLOCK_SIZE*k]*s;
+					}
+				}
+			}
 
-			interactingGreensFunction(
-				compoundIndex,
-				energy
-			) = matrix.at(row, column);
+			//Solve (1 - G_0\Sigma)G = G_0. G_0 is overwritten by G.
+			int size = BLOCK_SIZE;
+			int info;
+			zgesv_(
+				&size,
+				&size,
+				dysonMatrix.data(),
+				&size,
+				ipiv.data(),
+				G0.data(),
+				&size,
+				&info
+			);
+			TBTKAssert(
+				info == 0,
+				"Solver::Greens::calculateInteractingGreensFunction()",
+				"Unable to solve the Dyson equation. zgesv_()"
+				<< " returned 'INFO = " << info << "'.",
+				"The matrix 1 - G_0\\Sigma is singular."
+			);
 
-			column++;
+			for(unsigned int c = 0; c < BLOCK_SIZE*BLOCK_SIZE; c++){
+				interactingGreensFunctionData[
+					interactingGreensFunctionOffsets[c] + n
+				] = G0[c];
+			}
 		}
-
-		row++;
-	}
-}
-
-void Greens::calculateInteractingGreensFunctionSingleBlock(
-	Property::GreensFunction &interactingGreensFunction,
-	const Property::SelfEnergy &selfEnergy,
-	const IndexTree &intraBlockIndices
-) const{
-	double blockSize = intraBlockIndices.getSize();
-	Matrix<complex<double>> matrix(blockSize, blockSize);
-	for(
-		unsigned int n = 0;
-		n < greensFunction->getNumEnergies();
-		n++
-	){
-		//Convert one block of the Green's function to a
-		//matrix.
-		convertGreensFunctionToMatrix(
-			matrix,
-			n,
-			intraBlockIndices
-		);
-
-		//Invert the matrix.
-		matrix.invert();
-
-		//Add the self energy.
-		addSelfEnergyToGreensFunctionMatrix(
-			matrix,
-			selfEnergy,
-			n,
-			intraBlockIndices
-		);
-
-		//Invert matrix.
-		matrix.invert();
-
-		//Write the matrix back into the corresponding block of
-		//the full Green's function.
-		writeGreensFunctionMatrixToInteractingGreensFunction(
-			interactingGreensFunction,
-			matrix,
-			n,
-			intraBlockIndices
-		);
 	}
 }
 
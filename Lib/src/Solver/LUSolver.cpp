@@ -573,6 +573,155 @@ void LUSolver::solve(Matrix<complex<double>> &b){
 	}
 }
 
+void LUSolver::solve(double *b){
+	TBTKAssert(
+		L != nullptr,
+		"LUSolver::solve()",
+		"Left hand side matrix not yet set.",
+		"Use LUSolver::setMatrix() to set a matrix to use on the left"
+		<< " hand side."
+	);
+	TBTKAssert(
+		matrixDataType == DataType::Double,
+		"LUSolver::solve()",
+		"The matrix is complex, therefore 'b' must be complex.",
+		""
+	);
+
+	unsigned int numRows = L->nrow;
+	SuperMatrix sluB;
+	dCreate_Dense_Matrix(
+		&sluB,
+		numRows,
+		1,
+		b,
+		numRows,	//Leading dimension
+		SLU_DN,
+		SLU_D,
+		SLU_GE
+	);
+
+	int info;
+	dgstrs(
+		NOTRANS,
+		L,
+		U,
+		columnPermutations,
+		rowPermutations,
+		&sluB,
+		statistics,
+		&info
+	);
+	checkXgstrsErrors(info, "dgstrs");
+
+	//Only destroy the store since the values are owned by the caller.
+	Destroy_SuperMatrix_Store(&sluB);
+}
+
+void LUSolver::solve(complex<double> *b){
+	TBTKAssert(
+		L != nullptr,
+		"LUSolver::solve()",
+		"Left hand side matrix not yet set.",
+		"Use LUSolver::setMatrix() to set a matrix to use on the left"
+		<< " hand side."
+	);
+
+	unsigned int numRows = L->nrow;
+	switch(matrixDataType){
+	case DataType::Double:
+	{
+		//Solve for the real and imaginary parts as two right hand
+		//sides.
+		realWorkspace.resize(2*numRows);
+		for(unsigned int n = 0; n < numRows; n++){
+			realWorkspace[n] = real(b[n]);
+			realWorkspace[numRows + n] = imag(b[n]);
+		}
+
+		SuperMatrix sluB;
+		dCreate_Dense_Matrix(
+			&sluB,
+			numRows,
+			2,
+			realWorkspace.data(),
+			numRows,	//Leading dimension
+			SLU_DN,
+			SLU_D,
+			SLU_GE
+		);
+
+		int info;
+		dgstrs(
+			NOTRANS,
+			L,
+			U,
+			columnPermutations,
+			rowPermutations,
+			&sluB,
+			statistics,
+			&info
+		);
+		checkXgstrsErrors(info, "dgstrs");
+
+		for(unsigned int n = 0; n < numRows; n++){
+			b[n] = complex<double>(
+				realWorkspace[n],
+				realWorkspace[numRows + n]
+			);
+		}
+
+		//Only destroy the store since the values are owned by the
+		//workspace.
+		Destroy_SuperMatrix_Store(&sluB);
+
+		break;
+	}
+	case DataType::ComplexDouble:
+	{
+		//std::complex<double> has the same memory layout as
+		//doublecomplex.
+		SuperMatrix sluB;
+		zCreate_Dense_Matrix(
+			&sluB,
+			numRows,
+			1,
+			reinterpret_cast<doublecomplex*>(b),
+			numRows,	//Leading dimension
+			SLU_DN,
+			SLU_Z,
+			SLU_GE
+		);
+
+		int info;
+		zgstrs(
+			NOTRANS,
+			L,
+			U,
+			columnPermutations,
+			rowPermutations,
+			&sluB,
+			statistics,
+			&info
+		);
+		checkXgstrsErrors(info, "zgstrs");
+
+		//Only destroy the store since the values are owned by the
+		//caller.
+		Destroy_SuperMatrix_Store(&sluB);
+
+		break;
+	}
+	default:
+		TBTKExit(
+			"LUSolver::solve()",
+			"Only matrices of type double and complex<double> are"
+			<< " supported yet",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
 void LUSolver::checkSolveAssert(unsigned int numRows){
 	TBTKAssert(
 		L != nullptr,
@@ -0,0 +1,701 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file Lanczos.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+/* Note: The thick restart follows K. Wu and H. Simon, SIAM J. Matrix Anal.
+ * Appl. 22, 602 (2000), while the estimate of the loss of orthogonality used
+ * in the Selective mode is the omega-recurrence of H. Simon, Math. Comp. 42,
+ * 115 (1984). Instead of relying on the tridiagonal structure, the projected
+ * Hamiltonian is built from the Gram-Schmidt coefficients, which makes the
+ * block variant and the arrowhead structure that appears after a restart
+ * straight forward to handle. */
+
+#include "TBTK/Solver/Lanczos.h"
+#include "TBTK/Streams.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace TBTK{
+namespace Solver{
+
+namespace{
+	//Vectors with a norm smaller than this times the norm of the
+	//Hamiltonian after orthogonalization are considered to be linearly
+	//dependent on the current basis.
+	const double DEFLATION_TOLERANCE = 1e-10;
+}
+
+DynamicTypeInformation Lanczos::dynamicTypeInformation(
+	"Solver::Lanczos",
+	{&Solver::dynamicTypeInformation}
+);
+
+Lanczos::Lanczos() : Communicator(false){
+	target = Target::Lowest;
+	reorthogonalization = Reorthogonalization::Full;
+	numEigenValues = 0;
+	calculateEigenVectors = false;
+	numLanczosVectors = 0;
+	blockSize = 1;
+	tolerance = 1e-10;
+	maxIterations = 100;
+	numRestarts = 0;
+	numStates = 0;
+	hamiltonianNorm = 0;
+	basisSize = 0;
+	krylovSize = 0;
+}
+
+//Lapack function for divide-and-conquer diagonalization of a Hermitian
+//matrix.
+extern "C" void zheevd_(
+	char *jobz,		//'N' = Eigenvalues only, 'V' = Eigenvalues and eigenvectors.
+	char *uplo,		//'U' = Stored as upper triangular, 'L' = Stored as lower triangular.
+	int *n,			//n*n = Matrix size
+	complex<double> *a,	//Input matrix, overwritten by the eigenvectors
+	int *lda,		//Leading dimension of a
+	double *w,		//Eigenvalues, in accending order if info = 0
+	complex<double> *work,	//Workspace
+	int *lwork,		//Size of work, -1 for workspace query
+	double *rwork,		//Workspace
+	int *lrwork,		//Size of rwork, -1 for workspace query
+	int *iwork,		//Workspace
+	int *liwork,		//Size of iwork, -1 for workspace query
+	int *info);		//0 = successful, <0 = -info value was illegal, >0 = the algorithm failed to converge.
+
+void Lanczos::run(){
+	if(getGlobalVerbose() && getVerbose())
+		Streams::out << "Running Lanczos.\n";
+
+	basisSize = getModel().getBasisSize();
+	TBTKAssert(
+		numEigenValues > 0,
+		"Solver::Lanczos::run()",
+		"The number of eigenvalues must be positive.",
+		"Use Solver::Lanczos::setNumEigenValues() to set the number"
+		<< " of eigenvalues."
+	);
+	TBTKAssert(
+		reorthogonalization == Reorthogonalization::Full
+		|| blockSize == 1,
+		"Solver::Lanczos::run()",
+		"Selective reorthogonalization is only supported for block"
+		<< " size one.",
+		"Use Solver::Lanczos::setReorthogonalization() to select"
+		<< " full reorthogonalization or set the block size to one."
+	);
+
+	//Select the dimension of the Krylov space. The Krylov space together
+	//with the residual block must fit in the Hilbert space.
+	if(numLanczosVectors > 0){
+		krylovSize = numLanczosVectors;
+	}
+	else{
+		krylovSize = numEigenValues + max(numEigenValues, 20)
+			+ blockSize;
+		if(krylovSize + blockSize > basisSize){
+			krylovSize = max(
+				(int)basisSize - blockSize,
+				0
+			);
+		}
+	}
+	krylovSize -= krylovSize%blockSize;
+	TBTKAssert(
+		krylovSize >= (unsigned int)(numEigenValues + 2*blockSize),
+		"Solver::Lanczos::run()",
+		"The number of Lanczos vectors must be at least the number of"
+		<< " eigenvalues plus twice the block size.",
+		"Use Solver::Lanczos::setNumLanczosVectors() to increase the"
+		<< " number of Lanczos vectors, or use Solver::Diagonalizer"
+		<< " for small Models."
+	);
+	TBTKAssert(
+		krylovSize + blockSize <= basisSize,
+		"Solver::Lanczos::run()",
+		"The number of Lanczos vectors plus the block size must not"
+		<< " exceed the basis size.",
+		"Use Solver::Lanczos::setNumLanczosVectors() to decrease the"
+		<< " number of Lanczos vectors, or use Solver::Diagonalizer"
+		<< " for small Models."
+	);
+
+	setupHamiltonian();
+
+	lanczosVectors.assign(basisSize*(krylovSize + blockSize), 0.);
+	projectedHamiltonian.assign(krylovSize*krylovSize, 0.);
+	residualCoupling.assign(blockSize*blockSize, 0.);
+
+	//Random starting block. The seed is fixed to make the results
+	//reproducible.
+	randomEngine.seed(0);
+	for(int n = 0; n < blockSize; n++)
+		randomize(&lanczosVectors[n*basisSize], n);
+
+	const double tolerance
+		= this->tolerance > 0
+			? this->tolerance
+			: numeric_limits<double>::epsilon();
+	vector<double> ritzValues;
+	vector<complex<double>> ritzVectors;
+	vector<unsigned int> order(krylovSize);
+	unsigned int numKeptVectors = 0;
+	for(numRestarts = 0; true; numRestarts++){
+		if(getGlobalVerbose() && getVerbose()){
+			Streams::out << "." << flush;
+			if(numRestarts%10 == 9)
+				Streams::out << " ";
+			if(numRestarts%50 == 49)
+				Streams::out << "\n";
+		}
+
+		expand(numKeptVectors);
+		diagonalizeProjectedHamiltonian(ritzValues, ritzVectors);
+
+		//Order the Ritz states with the targeted states first.
+		for(unsigned int n = 0; n < krylovSize; n++){
+			if(target == Target::Lowest)
+				order[n] = n;
+			else
+				order[n] = krylovSize - 1 - n;
+		}
+
+		//The residual of a Ritz pair is given by the coupling to the
+		//residual block times the last block of the Ritz vector.
+		double scale = max(abs(ritzValues[0]), abs(ritzValues.back()));
+		if(scale == 0)
+			scale = 1;
+		int numConverged = 0;
+		for(int n = 0; n < numEigenValues; n++){
+			const complex<double> *ritzVector
+				= &ritzVectors[krylovSize*order[n]];
+			double residual = 0;
+			for(int r = 0; r < blockSize; r++){
+				complex<double> value = 0;
+				for(int c = 0; c < blockSize; c++){
+					value += residualCoupling[r + blockSize*c]
+						*ritzVector[
+							krylovSize - blockSize
+							+ c
+						];
+				}
+				residual += std::norm(value);
+			}
+			if(sqrt(residual) <= tolerance*scale)
+				numConverged++;
+		}
+		if(numConverged == numEigenValues)
+			break;
+
+		if(numRestarts == (unsigned int)maxIterations){
+			TBTKExit(
+				"Solver::Lanczos::run()",
+				"Maximum number of restarts reached.",
+				"Use Solver::Lanczos::setMaxIterations() to"
+				<< " increase the maximum number of restarts,"
+				<< " or Solver::Lanczos::setNumLanczosVectors()"
+				<< " to increase the size of the Krylov space."
+			);
+		}
+
+		//Thick restart. Keep the Ritz vectors closest to the target,
+		//such that the remaining part of the Krylov space is a multiple
+		//of the block size. The residual block is orthogonal to the
+		//full Krylov space and therefore also to the kept Ritz vectors.
+		numKeptVectors = numEigenValues
+			+ (krylovSize - numEigenValues - blockSize)/2;
+		numKeptVectors = krylovSize
+			- blockSize*((krylovSize - numKeptVectors)/blockSize);
+		vector<unsigned int> keptStates(
+			order.begin(),
+			order.begin() + numKeptVectors
+		);
+		calculateRitzVectors(
+			ritzVectors,
+			keptStates,
+			lanczosVectors.data()
+		);
+		copy(
+			lanczosVectors.begin() + basisSize*krylovSize,
+			lanczosVectors.end(),
+			lanczosVectors.begin() + basisSize*numKeptVectors
+		);
+		projectedHamiltonian.assign(krylovSize*krylovSize, 0.);
+		for(unsigned int n = 0; n < numKeptVectors; n++){
+			projectedHamiltonian[n + krylovSize*n]
+				= ritzValues[keptStates[n]];
+		}
+	}
+	if(getGlobalVerbose() && getVerbose())
+		Streams::out << "\n";
+
+	//Store the converged states in accending order.
+	numStates = numEigenValues;
+	vector<unsigned int> states(numStates);
+	for(unsigned int n = 0; n < numStates; n++){
+		if(target == Target::Lowest)
+			states[n] = n;
+		else
+			states[n] = krylovSize - numStates + n;
+	}
+	eigenValues = CArray<double>(numStates);
+	for(unsigned int n = 0; n < numStates; n++)
+		eigenValues[n] = ritzValues[states[n]];
+	if(calculateEigenVectors){
+		eigenVectors = CArray<complex<double>>(basisSize*numStates);
+		calculateRitzVectors(
+			ritzVectors,
+			states,
+			eigenVectors.getData()
+		);
+	}
+
+	//Release the workspace.
+	lanczosVectors = vector<complex<double>>();
+	projectedHamiltonian = vector<complex<double>>();
+	residualCoupling = vector<complex<double>>();
+	hamiltonian = Math::ParallelSparseMatrix<complex<double>>();
+}
+
+void Lanczos::setupHamiltonian(){
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel(
+		).getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices
+		= compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+
+	SparseMatrix<complex<double>> sparseMatrix(
+		SparseMatrix<complex<double>>::StorageFormat::CSR,
+		basisSize,
+		basisSize
+	);
+	vector<double> rowSums(basisSize, 0.);
+	for(
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
+	){
+		sparseMatrix.add(toIndices[n], fromIndices[n], amplitudes[n]);
+		rowSums[toIndices[n]] += abs(amplitudes[n]);
+	}
+	sparseMatrix.construct();
+	hamiltonian = Math::ParallelSparseMatrix<complex<double>>(
+		sparseMatrix
+	);
+
+	//The maximum absolute row sum is an upper bound for the spectral
+	//norm.
+	hamiltonianNorm = 0;
+	for(unsigned int n = 0; n < basisSize; n++)
+		hamiltonianNorm = max(hamiltonianNorm, rowSums[n]);
+}
+
+void Lanczos::expand(unsigned int numKeptVectors){
+	const bool selective
+		= reorthogonalization == Reorthogonalization::Selective;
+	const double epsilon = numeric_limits<double>::epsilon();
+
+	vector<complex<double>> block(basisSize*blockSize);
+	vector<complex<double>> packedInput;
+	vector<complex<double>> packedOutput;
+	if(blockSize > 1){
+		packedInput.resize(basisSize*blockSize);
+		packedOutput.resize(basisSize*blockSize);
+	}
+	vector<complex<double>> coupling(blockSize*blockSize);
+
+	//State for the omega-recurrence. omega[j][i] estimates the overlap
+	//between the Lanczos vectors j and i. The kept Ritz vectors are
+	//always explicitly orthogonalized against and are therefore assigned
+	//an overlap of the order of machine precision.
+	vector<double> omegaPrevious(krylovSize + 1, epsilon);
+	vector<double> omegaCurrent(krylovSize + 1, epsilon);
+	vector<double> omegaNext(krylovSize + 1, epsilon);
+	omegaCurrent[numKeptVectors] = 1;
+	vector<double> alpha(krylovSize, 0.);
+	vector<double> beta(krylovSize, 0.);
+	bool forceFullReorthogonalization = false;
+
+	vector<unsigned int> allRows;
+	for(
+		unsigned int j = numKeptVectors;
+		j < krylovSize;
+		j += blockSize
+	){
+		//Apply the Hamiltonian to the current block.
+		const complex<double> *current = &lanczosVectors[basisSize*j];
+		if(blockSize == 1){
+			hamiltonian.multiply(current, block.data());
+		}
+		else{
+			#pragma omp parallel for
+			for(unsigned int r = 0; r < basisSize; r++){
+				for(int c = 0; c < blockSize; c++){
+					packedInput[blockSize*r + c]
+						= current[basisSize*c + r];
+				}
+			}
+			hamiltonian.multiplyBlock(
+				packedInput.data(),
+				packedOutput.data(),
+				blockSize
+			);
+			#pragma omp parallel for
+			for(unsigned int r = 0; r < basisSize; r++){
+				for(int c = 0; c < blockSize; c++){
+					block[basisSize*c + r]
+						= packedOutput[blockSize*r + c];
+				}
+			}
+		}
+
+		while(allRows.size() < j + blockSize)
+			allRows.push_back(allRows.size());
+
+		bool fullReorthogonalization
+			= !selective || forceFullReorthogonalization;
+		forceFullReorthogonalization = false;
+		if(fullReorthogonalization){
+			reorthogonalize(block.data(), allRows, j);
+			alpha[j] = real(projectedHamiltonian[j + krylovSize*j]);
+		}
+		else{
+			//Orthogonalize against the kept Ritz vectors and the
+			//two most recent Lanczos vectors.
+			vector<unsigned int> rows;
+			for(unsigned int n = 0; n < numKeptVectors; n++)
+				rows.push_back(n);
+			if(j > numKeptVectors)
+				rows.push_back(j - 1);
+			rows.push_back(j);
+			reorthogonalize(block.data(), rows, j);
+
+			alpha[j] = real(projectedHamiltonian[j + krylovSize*j]);
+			double betaEstimate = norm(block.data());
+			if(betaEstimate > DEFLATION_TOLERANCE*hamiltonianNorm){
+				double maxOmega = 0;
+				for(unsigned int i = numKeptVectors; i < j; i++){
+					double value = beta[i]*omegaCurrent[i + 1]
+						+ (alpha[i] - alpha[j])*omegaCurrent[i];
+					if(i > numKeptVectors){
+						value += beta[i - 1]
+							*omegaCurrent[i - 1];
+					}
+					if(j > numKeptVectors){
+						value -= beta[j - 1]
+							*omegaPrevious[i];
+					}
+					value += (value < 0 ? -2 : 2)
+						*epsilon*hamiltonianNorm;
+					omegaNext[i] = value/betaEstimate;
+					maxOmega = max(maxOmega, abs(omegaNext[i]));
+				}
+
+				if(maxOmega > sqrt(epsilon)){
+					//Reorthogonalize this and the next
+					//Lanczos vector against the full basis.
+					reorthogonalize(block.data(), allRows, j);
+					fullReorthogonalization = true;
+					forceFullReorthogonalization = true;
+				}
+			}
+			else{
+				fullReorthogonalization = true;
+			}
+		}
+
+		if(selective){
+			if(fullReorthogonalization){
+				for(unsigned int i = 0; i <= j; i++)
+					omegaNext[i] = epsilon;
+			}
+			else{
+				for(unsigned int i = 0; i < numKeptVectors; i++)
+					omegaNext[i] = epsilon;
+				omegaNext[j] = epsilon;
+			}
+			omegaNext[j + 1] = 1;
+			swap(omegaPrevious, omegaCurrent);
+			swap(omegaCurrent, omegaNext);
+		}
+
+		//Store the next block. For the last block, the result is the
+		//residual block.
+		if(j + blockSize < krylovSize){
+			orthonormalize(block.data(), j + blockSize, coupling.data());
+		}
+		else{
+			orthonormalize(
+				block.data(),
+				j + blockSize,
+				residualCoupling.data()
+			);
+		}
+		if(selective)
+			beta[j] = real(coupling[0]);
+	}
+}
+
+void Lanczos::project(
+	complex<double> *block,
+	unsigned int numVectors,
+	const vector<unsigned int> &rows,
+	complex<double> *coefficients
+) const{
+	const unsigned int numRows = rows.size();
+	if(numRows == 0)
+		return;
+
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < numRows*numVectors; n++){
+		const complex<double> *row
+			= &lanczosVectors[basisSize*rows[n%numRows]];
+		const complex<double> *vector
+			= &block[basisSize*(n/numRows)];
+		complex<double> sum = 0;
+		for(unsigned int r = 0; r < basisSize; r++)
+			sum += conj(row[r])*vector[r];
+		coefficients[n] = sum;
+	}
+
+	#pragma omp parallel for
+	for(unsigned int r = 0; r < basisSize; r++){
+		for(unsigned int c = 0; c < numVectors; c++){
+			complex<double> sum = 0;
+			for(unsigned int n = 0; n < numRows; n++){
+				sum += lanczosVectors[basisSize*rows[n] + r]
+					*coefficients[n + numRows*c];
+			}
+			block[basisSize*c + r] -= sum;
+		}
+	}
+}
+
+void Lanczos::reorthogonalize(
+	complex<double> *block,
+	const vector<unsigned int> &rows,
+	unsigned int column
+){
+	//Two passes of classical Gram-Schmidt. The second pass removes the
+	//components that remain due to cancellation in the first pass, and
+	//its coefficients are added to the projected Hamiltonian as
+	//corrections.
+	vector<complex<double>> coefficients(rows.size()*blockSize);
+	for(unsigned int pass = 0; pass < 2; pass++){
+		project(block, blockSize, rows, coefficients.data());
+		for(int c = 0; c < blockSize; c++){
+			for(unsigned int n = 0; n < rows.size(); n++){
+				projectedHamiltonian[
+					rows[n] + krylovSize*(column + c)
+				] += coefficients[n + rows.size()*c];
+			}
+		}
+	}
+}
+
+void Lanczos::orthonormalize(
+	complex<double> *block,
+	unsigned int position,
+	complex<double> *coupling
+){
+	for(int n = 0; n < blockSize*blockSize; n++)
+		coupling[n] = 0;
+
+	vector<complex<double>> coefficients(blockSize);
+	for(int c = 0; c < blockSize; c++){
+		complex<double> *vector = &block[basisSize*c];
+
+		//Orthogonalize against the vectors in the new block that
+		//already have been stored.
+		std::vector<unsigned int> rows;
+		for(int n = 0; n < c; n++)
+			rows.push_back(position + n);
+		for(unsigned int pass = 0; pass < 2; pass++){
+			project(vector, 1, rows, coefficients.data());
+			for(int n = 0; n < c; n++)
+				coupling[n + blockSize*c] += coefficients[n];
+		}
+
+		double vectorNorm = norm(vector);
+		if(vectorNorm <= DEFLATION_TOLERANCE*hamiltonianNorm){
+			//The Krylov space has become invariant in this
+			//direction. Continue with a random vector, which does
+			//not couple to the current basis.
+			randomize(vector, position + c);
+		}
+		else{
+			coupling[c + blockSize*c] = vectorNorm;
+			#pragma omp parallel for
+			for(unsigned int r = 0; r < basisSize; r++)
+				vector[r] /= vectorNorm;
+		}
+
+		copy(
+			vector,
+			vector + basisSize,
+			lanczosVectors.begin() + basisSize*(position + c)
+		);
+	}
+}
+
+void Lanczos::randomize(complex<double> *vector, unsigned int numVectors){
+	uniform_real_distribution<double> distribution(-1, 1);
+	for(unsigned int r = 0; r < basisSize; r++){
+		double x = distribution(randomEngine);
+		double y = distribution(randomEngine);
+		vector[r] = complex<double>(x, y);
+	}
+
+	std::vector<unsigned int> rows;
+	for(unsigned int n = 0; n < numVectors; n++)
+		rows.push_back(n);
+	std::vector<complex<double>> coefficients(numVectors);
+	for(unsigned int pass = 0; pass < 2; pass++)
+		project(vector, 1, rows, coefficients.data());
+
+	double vectorNorm = norm(vector);
+	TBTKAssert(
+		vectorNorm > 0,
+		"Solver::Lanczos::randomize()",
+		"Unable to generate a random vector orthogonal to the"
+		<< " Krylov space.",
+		"This should never happen, contact the developer."
+	);
+	#pragma omp parallel for
+	for(unsigned int r = 0; r < basisSize; r++)
+		vector[r] /= vectorNorm;
+}
+
+double Lanczos::norm(const complex<double> *vector) const{
+	double sum = 0;
+	#pragma omp parallel for reduction(+:sum)
+	for(unsigned int r = 0; r < basisSize; r++)
+		sum += std::norm(vector[r]);
+
+	return sqrt(sum);
+}
+
+void Lanczos::diagonalizeProjectedHamiltonian(
+	vector<double> &ritzValues,
+	vector<complex<double>> &ritzVectors
+) const{
+	//Only the upper triangle of the projected Hamiltonian is referenced.
+	char jobz = 'V';
+	char uplo = 'U';
+	int n = krylovSize;
+	ritzValues.resize(krylovSize);
+	ritzVectors = projectedHamiltonian;
+
+	//Workspace query.
+	int lwork = -1;
+	int lrwork = -1;
+	int liwork = -1;
+	complex<double> workSize;
+	double rworkSize;
+	int iworkSize;
+	int info;
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		ritzVectors.data(),
+		&n,
+		ritzValues.data(),
+		&workSize,
+		&lwork,
+		&rworkSize,
+		&lrwork,
+		&iworkSize,
+		&liwork,
+		&info
+	);
+
+	//Diagonalize.
+	lwork = (int)real(workSize);
+	lrwork = (int)rworkSize;
+	liwork = iworkSize;
+	CArray<complex<double>> work(lwork);
+	CArray<double> rwork(lrwork);
+	CArray<int> iwork(liwork);
+	zheevd_(
+		&jobz,
+		&uplo,
+		&n,
+		ritzVectors.data(),
+		&n,
+		ritzValues.data(),
+		work.getData(),
+		&lwork,
+		rwork.getData(),
+		&lrwork,
+		iwork.getData(),
+		&liwork,
+		&info
+	);
+
+	TBTKAssert(
+		info == 0,
+		"Solver::Lanczos::diagonalizeProjectedHamiltonian()",
+		"Diagonalization routine zheevd exited with INFO="
+		<< info << ".",
+		"See LAPACK documentation for zheevd for further"
+		<< " information."
+	);
+}
+
+void Lanczos::calculateRitzVectors(
+	const vector<complex<double>> &ritzVectors,
+	const vector<unsigned int> &states,
+	complex<double> *result
+) const{
+	//Every row of the result only depends on the same row of the Lanczos
+	//vectors, which allows the result to overwrite the Lanczos vectors.
+	#pragma omp parallel
+	{
+		vector<complex<double>> row(states.size());
+		#pragma omp for
+		for(unsigned int r = 0; r < basisSize; r++){
+			for(unsigned int s = 0; s < states.size(); s++){
+				const complex<double> *ritzVector
+					= &ritzVectors[krylovSize*states[s]];
+				complex<double> sum = 0;
+				for(unsigned int n = 0; n < krylovSize; n++){
+					sum += lanczosVectors[basisSize*n + r]
+						*ritzVector[n];
+				}
+				row[s] = sum;
+			}
+			for(unsigned int s = 0; s < states.size(); s++)
+				result[basisSize*s + r] = row[s];
+		}
+	}
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
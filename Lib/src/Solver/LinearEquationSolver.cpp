@@ -19,25 +19,159 @@
  */
 
 #include "TBTK/Solver/LinearEquationSolver.h"
+#ifdef TBTK_LU_SOLVER_ENABLED
 #include "TBTK/Solver/LUSolver.h"
+#endif
+#include "TBTK/Streams.h"
+#include "TBTK/TBTKMacros.h"
+
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 
 namespace TBTK{
 namespace Solver{
 
+namespace{
+	//Hermitian inner product.
+	complex<double> dotc(
+		const vector<complex<double>> &x,
+		const vector<complex<double>> &y
+	){
+		double re = 0;
+		double im = 0;
+		#pragma omp parallel for reduction(+:re,im)
+		for(unsigned int n = 0; n < x.size(); n++){
+			complex<double> product = conj(x[n])*y[n];
+			re += real(product);
+			im += imag(product);
+		}
+
+		return complex<double>(re, im);
+	}
+
+	//Bilinear form used by COCG.
+	complex<double> dotu(
+		const vector<complex<double>> &x,
+		const vector<complex<double>> &y
+	){
+		double re = 0;
+		double im = 0;
+		#pragma omp parallel for reduction(+:re,im)
+		for(unsigned int n = 0; n < x.size(); n++){
+			complex<double> product = x[n]*y[n];
+			re += real(product);
+			im += imag(product);
+		}
+
+		return complex<double>(re, im);
+	}
+
+	double norm2(const vector<complex<double>> &x){
+		double sum = 0;
+		#pragma omp parallel for reduction(+:sum)
+		for(unsigned int n = 0; n < x.size(); n++)
+			sum += norm(x[n]);
+
+		return sqrt(sum);
+	}
+};
+
 DynamicTypeInformation LinearEquationSolver::dynamicTypeInformation(
 	"Solver::LinearEquationSolver",
 	{&Solver::dynamicTypeInformation}
 );
 
-LinearEquationSolver::LinearEquationSolver() : Communicator(true), source(0, 0){
+LinearEquationSolver::LinearEquationSolver(
+) :
+	Communicator(true),
+	source(0, 0),
+	matrix(SparseMatrix<complex<double>>::StorageFormat::CSR)
+{
+	mode = Mode::LU;
+	preconditioner = Preconditioner::None;
+	tolerance = 1e-10;
+	maxIterations = 1000;
+	restartLength = 30;
+	energyWindowIsSet = false;
+	energyInfinitesimal = 0;
+	numIterations = 0;
 }
 
 LinearEquationSolver::~LinearEquationSolver(){
 }
 
 void LinearEquationSolver::run(){
+	Model &model = getModel();
+	const SourceAmplitudeSet &sourceAmplitudeSet
+		= model.getSourceAmplitudeSet();
+
+	numIterations = 0;
+	if(mode == Mode::LU){
+		solveLU();
+		return;
+	}
+
+	vector<complex<double>> b(model.getBasisSize(), 0.);
+	for(
+		SourceAmplitudeSet::ConstIterator iterator
+			= sourceAmplitudeSet.cbegin();
+		iterator != sourceAmplitudeSet.cend();
+		++iterator
+	){
+		b[model.getBasisIndex((*iterator).getIndex())]
+			+= (*iterator).getAmplitude();
+	}
+
+	setupIterativeSolver();
+
+	if(mode == Mode::MultiShift){
+		solveMultiShift(b);
+	}
+	else{
+		vector<complex<double>> x;
+		switch(mode){
+		case Mode::COCG:
+			solveCOCG(b, x);
+			break;
+		case Mode::GMRES:
+			solveGMRES(b, x);
+			break;
+		case Mode::BiCGStab:
+			solveBiCGStab(b, x);
+			break;
+		default:
+			TBTKExit(
+				"Solver::LinearEquationSolver::run()",
+				"Unknown mode.",
+				"This should never happen, contact the"
+				<< " developer."
+			);
+		}
+
+		source = Matrix<complex<double>>(model.getBasisSize(), 1);
+		for(int n = 0; n < model.getBasisSize(); n++)
+			source.at(n, 0) = x[n];
+	}
+
+	if(getGlobalVerbose() && getVerbose()){
+		Streams::out << "LinearEquationSolver converged after "
+			<< numIterations << " iterations.\n";
+	}
+
+	//Release the workspace.
+	matrix = SparseMatrix<complex<double>>(
+		SparseMatrix<complex<double>>::StorageFormat::CSR
+	);
+	parallelMatrix = Math::ParallelSparseMatrix<complex<double>>();
+	inverseDiagonal = vector<complex<double>>();
+	iluValues = vector<complex<double>>();
+	iluDiagonalPositions = vector<unsigned int>();
+}
+
+void LinearEquationSolver::solveLU(){
+#ifdef TBTK_LU_SOLVER_ENABLED
 	Model &model = getModel();
 	const HoppingAmplitudeSet &hoppingAmplitudeSet
 		= model.getHoppingAmplitudeSet();
@@ -60,6 +194,642 @@ void LinearEquationSolver::run(){
 			+= (*iterator).getAmplitude();
 	}
 	luSolver.solve(source);
+#else
+	TBTKExit(
+		"Solver::LinearEquationSolver::solveLU()",
+		"The LU mode is not available.",
+		"TBTK was built without SuperLU. Install SuperLU and rebuild"
+		<< " TBTK, or use one of the iterative modes."
+	);
+#endif
+}
+
+void LinearEquationSolver::setupIterativeSolver(){
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel(
+		).getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int basisSize = compiledHoppingAmplitudes.getBasisSize();
+	const unsigned int *toIndices
+		= compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+
+	matrix = SparseMatrix<complex<double>>(
+		SparseMatrix<complex<double>>::StorageFormat::CSR,
+		basisSize,
+		basisSize
+	);
+	for(
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
+	){
+		matrix.add(toIndices[n], fromIndices[n], amplitudes[n]);
+	}
+	matrix.construct();
+	parallelMatrix = Math::ParallelSparseMatrix<complex<double>>(matrix);
+
+	if(mode == Mode::MultiShift){
+		TBTKAssert(
+			preconditioner == Preconditioner::None,
+			"Solver::LinearEquationSolver::run()",
+			"Preconditioning is not supported in the MultiShift"
+			<< " mode.",
+			"Use Solver::LinearEquationSolver::setPreconditioner()"
+			<< " to disable the preconditioner."
+		);
+
+		return;
+	}
+
+	if(mode == Mode::COCG){
+		TBTKAssert(
+			isComplexSymmetric(),
+			"Solver::LinearEquationSolver::run()",
+			"The COCG mode requires a complex symmetric matrix.",
+			"Use the GMRES or BiCGStab mode for matrices that are"
+			<< " not equal to their transpose."
+		);
+	}
+
+	switch(preconditioner){
+	case Preconditioner::None:
+		break;
+	case Preconditioner::Jacobi:
+	{
+		const unsigned int *rowPointers = matrix.getCSRRowPointers();
+		const unsigned int *columns = matrix.getCSRColumns();
+		const complex<double> *values = matrix.getCSRValues();
+		inverseDiagonal.assign(basisSize, 0.);
+		for(unsigned int row = 0; row < basisSize; row++){
+			for(
+				unsigned int n = rowPointers[row];
+				n < rowPointers[row + 1];
+				n++
+			){
+				if(columns[n] == row)
+					inverseDiagonal[row] += values[n];
+			}
+			TBTKAssert(
+				inverseDiagonal[row] != 0.,
+				"Solver::LinearEquationSolver::run()",
+				"Zero diagonal element encountered in the"
+				<< " Jacobi preconditioner.",
+				"Use a different preconditioner."
+			);
+			inverseDiagonal[row] = 1./inverseDiagonal[row];
+		}
+		break;
+	}
+	case Preconditioner::ILU:
+		setupILU();
+		break;
+	default:
+		TBTKExit(
+			"Solver::LinearEquationSolver::run()",
+			"Unknown preconditioner.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+void LinearEquationSolver::setupILU(){
+	const unsigned int basisSize = matrix.getNumRows();
+	const unsigned int *rowPointers = matrix.getCSRRowPointers();
+	const unsigned int *columns = matrix.getCSRColumns();
+	const complex<double> *values = matrix.getCSRValues();
+	iluValues.assign(values, values + matrix.getCSRNumMatrixElements());
+
+	//Locate the diagonal elements. The columns are sorted within each
+	//row.
+	iluDiagonalPositions.resize(basisSize);
+	for(unsigned int row = 0; row < basisSize; row++){
+		const unsigned int *position = lower_bound(
+			columns + rowPointers[row],
+			columns + rowPointers[row + 1],
+			row
+		);
+		TBTKAssert(
+			position != columns + rowPointers[row + 1]
+			&& *position == row,
+			"Solver::LinearEquationSolver::run()",
+			"Missing diagonal element encountered in the ILU"
+			<< " preconditioner.",
+			"Add the diagonal element to the Model, or use a"
+			<< " different preconditioner."
+		);
+		iluDiagonalPositions[row] = position - columns;
+	}
+
+	//IKJ variant of Gaussian elimination, restricted to the sparsity
+	//pattern of the matrix.
+	vector<int> positions(basisSize, -1);
+	for(unsigned int row = 0; row < basisSize; row++){
+		for(unsigned int n = rowPointers[row]; n < rowPointers[row + 1]; n++)
+			positions[columns[n]] = n;
+
+		for(
+			unsigned int n = rowPointers[row];
+			n < iluDiagonalPositions[row];
+			n++
+		){
+			const unsigned int k = columns[n];
+			const complex<double> &pivot
+				= iluValues[iluDiagonalPositions[k]];
+			TBTKAssert(
+				pivot != 0.,
+				"Solver::LinearEquationSolver::run()",
+				"Zero pivot encountered in the ILU"
+				<< " preconditioner.",
+				"Use a different preconditioner."
+			);
+			iluValues[n] /= pivot;
+			for(
+				unsigned int m = iluDiagonalPositions[k] + 1;
+				m < rowPointers[k + 1];
+				m++
+			){
+				if(positions[columns[m]] != -1){
+					iluValues[positions[columns[m]]]
+						-= iluValues[n]*iluValues[m];
+				}
+			}
+		}
+
+		for(unsigned int n = rowPointers[row]; n < rowPointers[row + 1]; n++)
+			positions[columns[n]] = -1;
+	}
+
+	for(unsigned int row = 0; row < basisSize; row++){
+		TBTKAssert(
+			iluValues[iluDiagonalPositions[row]] != 0.,
+			"Solver::LinearEquationSolver::run()",
+			"Zero pivot encountered in the ILU preconditioner.",
+			"Use a different preconditioner."
+		);
+	}
+}
+
+void LinearEquationSolver::applyPreconditioner(
+	const complex<double> *in,
+	complex<double> *out
+) const{
+	const unsigned int basisSize = matrix.getNumRows();
+	switch(preconditioner){
+	case Preconditioner::None:
+		copy(in, in + basisSize, out);
+		break;
+	case Preconditioner::Jacobi:
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			out[n] = inverseDiagonal[n]*in[n];
+		break;
+	case Preconditioner::ILU:
+	{
+		//Forward substitution with the unit lower triangular factor,
+		//followed by backward substitution with the upper triangular
+		//factor.
+		const unsigned int *rowPointers = matrix.getCSRRowPointers();
+		const unsigned int *columns = matrix.getCSRColumns();
+		for(unsigned int row = 0; row < basisSize; row++){
+			complex<double> sum = in[row];
+			for(
+				unsigned int n = rowPointers[row];
+				n < iluDiagonalPositions[row];
+				n++
+			){
+				sum -= iluValues[n]*out[columns[n]];
+			}
+			out[row] = sum;
+		}
+		for(int row = basisSize - 1; row >= 0; row--){
+			complex<double> sum = out[row];
+			for(
+				unsigned int n = iluDiagonalPositions[row] + 1;
+				n < rowPointers[row + 1];
+				n++
+			){
+				sum -= iluValues[n]*out[columns[n]];
+			}
+			out[row] = sum/iluValues[iluDiagonalPositions[row]];
+		}
+		break;
+	}
+	default:
+		TBTKExit(
+			"Solver::LinearEquationSolver::applyPreconditioner()",
+			"Unknown preconditioner.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+bool LinearEquationSolver::isComplexSymmetric() const{
+	const unsigned int basisSize = matrix.getNumRows();
+	const unsigned int *rowPointers = matrix.getCSRRowPointers();
+	const unsigned int *columns = matrix.getCSRColumns();
+	const complex<double> *values = matrix.getCSRValues();
+	for(unsigned int row = 0; row < basisSize; row++){
+		for(unsigned int n = rowPointers[row]; n < rowPointers[row + 1]; n++){
+			const unsigned int column = columns[n];
+			const unsigned int *position = lower_bound(
+				columns + rowPointers[column],
+				columns + rowPointers[column + 1],
+				row
+			);
+			complex<double> transposed = 0;
+			if(
+				position != columns + rowPointers[column + 1]
+				&& *position == row
+			){
+				transposed = values[position - columns];
+			}
+			if(abs(values[n] - transposed) > 1e-12*abs(values[n]))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void LinearEquationSolver::solveCOCG(
+	const vector<complex<double>> &b,
+	vector<complex<double>> &x
+){
+	//Preconditioned conjugate orthogonal conjugate gradient method. The
+	//ILU(0) factors of a complex symmetric matrix satisfy U = DL^T, which
+	//makes the preconditioner complex symmetric as required.
+	const unsigned int basisSize = b.size();
+	x.assign(basisSize, 0.);
+	const double bNorm = norm2(b);
+	if(bNorm == 0)
+		return;
+
+	vector<complex<double>> r = b;
+	vector<complex<double>> z(basisSize);
+	vector<complex<double>> q(basisSize);
+	applyPreconditioner(r.data(), z.data());
+	vector<complex<double>> p = z;
+	complex<double> rho = dotu(r, z);
+	while(true){
+		checkNumIterations("Solver::LinearEquationSolver::solveCOCG()");
+		numIterations++;
+
+		parallelMatrix.multiply(p.data(), q.data());
+		complex<double> mu = dotu(p, q);
+		TBTKAssert(
+			mu != 0. && rho != 0.,
+			"Solver::LinearEquationSolver::solveCOCG()",
+			"Breakdown in the COCG iteration.",
+			"Use the GMRES or BiCGStab mode instead."
+		);
+		complex<double> alpha = rho/mu;
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++){
+			x[n] += alpha*p[n];
+			r[n] -= alpha*q[n];
+		}
+		if(norm2(r) <= tolerance*bNorm)
+			break;
+
+		applyPreconditioner(r.data(), z.data());
+		complex<double> rhoNext = dotu(r, z);
+		complex<double> beta = rhoNext/rho;
+		rho = rhoNext;
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			p[n] = z[n] + beta*p[n];
+	}
+}
+
+void LinearEquationSolver::solveGMRES(
+	const vector<complex<double>> &b,
+	vector<complex<double>> &x
+){
+	//Right preconditioned GMRES(m). The Hessenberg matrix is reduced to
+	//upper triangular form using Givens rotations, which gives the
+	//residual norm without forming the solution.
+	const unsigned int basisSize = b.size();
+	x.assign(basisSize, 0.);
+	const double bNorm = norm2(b);
+	if(bNorm == 0)
+		return;
+
+	const unsigned int m = restartLength;
+	vector<vector<complex<double>>> v(
+		m + 1,
+		vector<complex<double>>(basisSize)
+	);
+	vector<complex<double>> hessenberg((m + 1)*m);
+	vector<double> cosines(m);
+	vector<complex<double>> sines(m);
+	vector<complex<double>> g(m + 1);
+	vector<complex<double>> z(basisSize);
+	vector<complex<double>> r = b;
+	double rNorm = bNorm;
+	while(true){
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			v[0][n] = r[n]/rNorm;
+		fill(g.begin(), g.end(), 0.);
+		g[0] = rNorm;
+
+		unsigned int numColumns = 0;
+		for(unsigned int j = 0; j < m; j++){
+			checkNumIterations(
+				"Solver::LinearEquationSolver::solveGMRES()"
+			);
+			numIterations++;
+			numColumns = j + 1;
+
+			applyPreconditioner(v[j].data(), z.data());
+			parallelMatrix.multiply(z.data(), v[j + 1].data());
+
+			//Modified Gram-Schmidt.
+			for(unsigned int i = 0; i <= j; i++){
+				complex<double> h = dotc(v[i], v[j + 1]);
+				hessenberg[i + (m + 1)*j] = h;
+				#pragma omp parallel for
+				for(unsigned int n = 0; n < basisSize; n++)
+					v[j + 1][n] -= h*v[i][n];
+			}
+			double h = norm2(v[j + 1]);
+			hessenberg[j + 1 + (m + 1)*j] = h;
+			if(h != 0){
+				#pragma omp parallel for
+				for(unsigned int n = 0; n < basisSize; n++)
+					v[j + 1][n] /= h;
+			}
+
+			//Apply the previous rotations to the new column and
+			//calculate a new rotation that eliminates the
+			//subdiagonal element.
+			complex<double> *column = &hessenberg[(m + 1)*j];
+			for(unsigned int i = 0; i < j; i++){
+				complex<double> a = column[i];
+				complex<double> c = column[i + 1];
+				column[i] = cosines[i]*a + sines[i]*c;
+				column[i + 1] = -conj(sines[i])*a + cosines[i]*c;
+			}
+			double diagonalNorm = abs(column[j]);
+			double denominator = sqrt(diagonalNorm*diagonalNorm + h*h);
+			if(diagonalNorm == 0){
+				cosines[j] = 0;
+				sines[j] = 1;
+			}
+			else{
+				cosines[j] = diagonalNorm/denominator;
+				sines[j] = column[j]/diagonalNorm*h/denominator;
+			}
+			column[j] = cosines[j]*column[j] + sines[j]*h;
+			column[j + 1] = 0;
+			g[j + 1] = -conj(sines[j])*g[j];
+			g[j] = cosines[j]*g[j];
+
+			if(abs(g[j + 1]) <= tolerance*bNorm || h == 0)
+				break;
+		}
+
+		//Solve the upper triangular system and update the solution.
+		vector<complex<double>> y(numColumns);
+		for(int i = numColumns - 1; i >= 0; i--){
+			complex<double> sum = g[i];
+			for(unsigned int k = i + 1; k < numColumns; k++)
+				sum -= hessenberg[i + (m + 1)*k]*y[k];
+			y[i] = sum/hessenberg[i + (m + 1)*i];
+		}
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++){
+			complex<double> sum = 0;
+			for(unsigned int k = 0; k < numColumns; k++)
+				sum += v[k][n]*y[k];
+			r[n] = sum;
+		}
+		applyPreconditioner(r.data(), z.data());
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			x[n] += z[n];
+
+		//Calculate the true residual.
+		parallelMatrix.multiply(x.data(), r.data(), -1.);
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			r[n] += b[n];
+		rNorm = norm2(r);
+		if(rNorm <= tolerance*bNorm)
+			break;
+	}
+}
+
+void LinearEquationSolver::solveBiCGStab(
+	const vector<complex<double>> &b,
+	vector<complex<double>> &x
+){
+	//Right preconditioned BiCGStab.
+	const unsigned int basisSize = b.size();
+	x.assign(basisSize, 0.);
+	const double bNorm = norm2(b);
+	if(bNorm == 0)
+		return;
+
+	vector<complex<double>> r = b;
+	vector<complex<double>> rHat = b;
+	vector<complex<double>> p(basisSize, 0.);
+	vector<complex<double>> v(basisSize, 0.);
+	vector<complex<double>> pHat(basisSize);
+	vector<complex<double>> s(basisSize);
+	vector<complex<double>> sHat(basisSize);
+	vector<complex<double>> t(basisSize);
+	complex<double> rho = 1;
+	complex<double> alpha = 1;
+	complex<double> omega = 1;
+	while(true){
+		checkNumIterations(
+			"Solver::LinearEquationSolver::solveBiCGStab()"
+		);
+		numIterations++;
+
+		complex<double> rhoNext = dotc(rHat, r);
+		TBTKAssert(
+			rhoNext != 0. && omega != 0.,
+			"Solver::LinearEquationSolver::solveBiCGStab()",
+			"Breakdown in the BiCGStab iteration.",
+			"Use the GMRES mode instead."
+		);
+		complex<double> beta = (rhoNext/rho)*(alpha/omega);
+		rho = rhoNext;
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			p[n] = r[n] + beta*(p[n] - omega*v[n]);
+
+		applyPreconditioner(p.data(), pHat.data());
+		parallelMatrix.multiply(pHat.data(), v.data());
+		alpha = rho/dotc(rHat, v);
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			s[n] = r[n] - alpha*v[n];
+		if(norm2(s) <= tolerance*bNorm){
+			#pragma omp parallel for
+			for(unsigned int n = 0; n < basisSize; n++)
+				x[n] += alpha*pHat[n];
+			break;
+		}
+
+		applyPreconditioner(s.data(), sHat.data());
+		parallelMatrix.multiply(sHat.data(), t.data());
+		omega = dotc(t, s)/dotc(t, t);
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++){
+			x[n] += alpha*pHat[n] + omega*sHat[n];
+			r[n] = s[n] - omega*t[n];
+		}
+		if(norm2(r) <= tolerance*bNorm)
+			break;
+	}
+}
+
+void LinearEquationSolver::solveMultiShift(const vector<complex<double>> &b){
+	TBTKAssert(
+		energyWindowIsSet,
+		"Solver::LinearEquationSolver::run()",
+		"The energy window has not been set.",
+		"Use Solver::LinearEquationSolver::setEnergyWindow() to set"
+		<< " the energy window."
+	);
+	TBTKAssert(
+		energyInfinitesimal > 0,
+		"Solver::LinearEquationSolver::run()",
+		"The energy infinitesimal must be positive.",
+		"Use Solver::LinearEquationSolver::setEnergyInfinitesimal() to"
+		<< " set the energy infinitesimal."
+	);
+
+	//The Hermitian Lanczos iteration for H generates the Krylov space for
+	//all shifted matrices z - H. For every shift, the Galerkin solution
+	//in the Krylov space is updated through the LU decomposition of the
+	//shifted tridiagonal matrix z - T (D-Lanczos). The imaginary part of
+	//the pivots have the same sign as the energy infinitesimal, which
+	//guarantees that the recurrences do not break down.
+	const unsigned int basisSize = b.size();
+	const unsigned int numEnergies = energyWindow.getResolution();
+	vector<complex<double>> energies(numEnergies);
+	for(unsigned int n = 0; n < numEnergies; n++){
+		energies[n] = complex<double>(
+			energyWindow[n],
+			energyInfinitesimal
+		);
+	}
+
+	source = Matrix<complex<double>>(basisSize, numEnergies);
+	for(unsigned int e = 0; e < numEnergies; e++)
+		for(unsigned int n = 0; n < basisSize; n++)
+			source.at(n, e) = 0;
+	const double bNorm = norm2(b);
+	if(bNorm == 0)
+		return;
+
+	//Solutions and search directions, stored with the values for the
+	//different energies for a given row consecutive in memory.
+	vector<complex<double>> x(basisSize*numEnergies, 0.);
+	vector<complex<double>> p(basisSize*numEnergies, 0.);
+	vector<complex<double>> zeta(numEnergies, bNorm);
+	vector<complex<double>> eta(numEnergies, 0.);
+	vector<complex<double>> pFactor(numEnergies);
+	vector<complex<double>> xFactor(numEnergies);
+	vector<bool> isConverged(numEnergies, false);
+
+	vector<complex<double>> vPrevious(basisSize, 0.);
+	vector<complex<double>> v(basisSize);
+	vector<complex<double>> w(basisSize);
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < basisSize; n++)
+		v[n] = b[n]/bNorm;
+	double beta = 0;
+	while(true){
+		checkNumIterations(
+			"Solver::LinearEquationSolver::solveMultiShift()"
+		);
+		numIterations++;
+
+		//Lanczos step.
+		parallelMatrix.multiply(v.data(), w.data());
+		double alpha = real(dotc(v, w));
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			w[n] -= alpha*v[n] + beta*vPrevious[n];
+
+		//Update the LU decomposition of z - T. The off-diagonal
+		//elements of z - T are -beta.
+		for(unsigned int e = 0; e < numEnergies; e++){
+			if(isConverged[e])
+				continue;
+
+			complex<double> lambda = 0;
+			if(numIterations > 1){
+				lambda = -beta/eta[e];
+				zeta[e] = -lambda*zeta[e];
+			}
+			eta[e] = energies[e] - alpha + lambda*beta;
+			pFactor[e] = beta;
+			xFactor[e] = zeta[e];
+		}
+
+		//Update the search directions and solutions.
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++){
+			complex<double> *pRow = &p[numEnergies*n];
+			complex<double> *xRow = &x[numEnergies*n];
+			for(unsigned int e = 0; e < numEnergies; e++){
+				if(isConverged[e])
+					continue;
+
+				pRow[e] = (v[n] + pFactor[e]*pRow[e])/eta[e];
+				xRow[e] += xFactor[e]*pRow[e];
+			}
+		}
+
+		//The residual for a given shift is beta_{j+1} times the last
+		//component of the solution in the Krylov space.
+		beta = norm2(w);
+		bool allConverged = true;
+		for(unsigned int e = 0; e < numEnergies; e++){
+			if(isConverged[e])
+				continue;
+
+			if(beta*abs(zeta[e]/eta[e]) <= tolerance*bNorm)
+				isConverged[e] = true;
+			else
+				allConverged = false;
+		}
+		if(allConverged || beta == 0)
+			break;
+
+		swap(vPrevious, v);
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize; n++)
+			v[n] = w[n]/beta;
+	}
+
+	for(unsigned int e = 0; e < numEnergies; e++)
+		for(unsigned int n = 0; n < basisSize; n++)
+			source.at(n, e) = x[numEnergies*n + e];
+}
+
+void LinearEquationSolver::checkNumIterations(
+	const string &functionName
+) const{
+	if(numIterations >= maxIterations){
+		TBTKExit(
+			functionName,
+			"Maximum number of iterations reached.",
+			"Use Solver::LinearEquationSolver::setMaxIterations() to"
+			<< " increase the maximum number of iterations, or use"
+			<< " a preconditioner."
+		);
+	}
 }
 
 };	//End of namespace Solver
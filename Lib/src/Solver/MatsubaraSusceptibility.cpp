@@ -297,6 +297,10 @@ Property::Susceptibility MatsubaraSusceptibility::calculateSusceptibilityAllBloc
 		""
 	);
 
+	//TODO
+	//The convolution is performed on the uniform Matsubara grid. Doing it
+	//at the sampling points of an IntermediateRepresentation would reduce
+	//the number of energies needed at low temperatures.
 	const vector<vector<double>> &mesh = momentumSpaceContext.getMesh();
 	const vector<unsigned int> &numMeshPoints
 		= momentumSpaceContext.getNumMeshPoints();
@@ -19,6 +19,7 @@
  */
 
 #include "TBTK/Functions.h"
+#include "TBTK/Math/BatchedMatrixInverter.h"
 #include "TBTK/Solver/RPASusceptibility.h"
 #include "TBTK/UnitHandler.h"
 
@@ -53,45 +54,6 @@ RPASusceptibility* RPASusceptibility::createSlave(){
 	);
 }
 
-extern "C" {
-	void zgetrf_(
-		int* M,
-		int *N,
-		complex<double> *A,
-		int *lda,
-		int *ipiv,
-		int *info
-	);
-	void zgetri_(
-		int *N,
-		complex<double> *A,
-		int *lda,
-		int *ipiv,
-		complex<double> *work,
-		int *lwork,
-		int *info
-	);
-}
-
-inline void RPASusceptibility::invertMatrix(
-	complex<double> *matrix,
-	unsigned int dimensions
-){
-	int numRows = dimensions;
-	int numCols = dimensions;
-
-	int *ipiv = new int[min(numRows, numCols)];
-	int lwork = numCols*numCols;
-	complex<double> *work = new complex<double>[lwork];
-	int info;
-
-	zgetrf_(&numRows, &numCols, matrix, &numRows, ipiv, &info);
-	zgetri_(&numRows, matrix, &numRows, ipiv, work, &lwork, &info);
-
-	delete [] ipiv;
-	delete [] work;
-}
-
 /*vector<vector<vector<complex<double>>>> RPASusceptibility::rpaSusceptibilityMainAlgorithm(
 	const Index &index,
 	const vector<InteractionAmplitude> &interactionAmplitudes
@@ -371,28 +333,14 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 		);
 	}
 
-	//Denominator in the expression chi_RPA = 1/(\chi_0^{-1} + U).
-	vector<complex<double>*> denominators;
-
-	//Initialize denominator matrices to zero.
-	for(
-		unsigned int e = 0;
-		e < energies.size();
-		e++
-	){
-		//Create denominator matrix.
-		denominators.push_back(
-			new complex<double>[matrixDimension*matrixDimension]
-		);
-		//Initialize denominator matrices to unit matrices.
-		for(
-			unsigned int c = 0;
-			c < matrixDimension*matrixDimension;
-			c++
-		){
-			denominators.at(e)[c] = 0.;
-		}
-	}
+	//Denominator in the expression chi_RPA = 1/(\chi_0^{-1} + U). The
+	//matrices for all energies are stored together, with the energy as the
+	//fastest changing index, to allow for batched inversion.
+	const unsigned int NUM_ENERGIES = energies.size();
+	vector<complex<double>> denominators(
+		matrixDimension*matrixDimension*NUM_ENERGIES,
+		0.
+	);
 
 	//Setup \chi_0.
 	for(unsigned int a = 0; a < intraBlockIndexList.size(); a++){
@@ -429,17 +377,18 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 							intraBlockIndexList[c],
 							intraBlockIndexList[d]
 						});
+					unsigned int denominatorOffset = (
+						matrixDimension*column + row
+					)*NUM_ENERGIES;
 					for(
 						unsigned int e = 0;
-						e < energies.size();
+						e < NUM_ENERGIES;
 						e++
 					){
-						denominators[e][
-							matrixDimension*column
-							+ row
-						] += bareSusceptibilityData[
-							offset + e
-						];
+						denominators[denominatorOffset + e]
+							+= bareSusceptibilityData[
+								offset + e
+							];
 					}
 				}
 			}
@@ -447,14 +396,11 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 	}
 
 	//Calculate \chi_0^{-1}
-	#pragma omp parallel for
-	for(
-		unsigned int e = 0;
-		e < energies.size();
-		e++
-	){
-		invertMatrix(denominators[e], matrixDimension);
-	}
+	Math::BatchedMatrixInverter::invert(
+		denominators,
+		matrixDimension,
+		NUM_ENERGIES
+	);
 
 	//Calculate (\chi_0^{-1} + U).
 	for(unsigned int n = 0; n < interactionAmplitudes.size(); n++){
@@ -492,26 +438,18 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 		int row = intraBlockIndexList.size()*c1LinearIntraBlockIndex
 			+ a0LinearIntraBlockIndex;
 
-		for(
-			unsigned int e = 0;
-			e < energies.size();
-			e++
-		){
-			denominators[e][
-				matrixDimension*col + row
-			] += amplitude;
-		}
+		unsigned int denominatorOffset
+			= (matrixDimension*col + row)*NUM_ENERGIES;
+		for(unsigned int e = 0; e < NUM_ENERGIES; e++)
+			denominators[denominatorOffset + e] += amplitude;
 	}
 
 	//calculate (\chi_0^{-1} + U)^{-1}.
-	#pragma omp parallel for
-	for(
-		unsigned int e = 0;
-		e < energies.size();
-		e++
-	){
-		invertMatrix(denominators[e], matrixDimension);
-	}
+	Math::BatchedMatrixInverter::invert(
+		denominators,
+		matrixDimension,
+		NUM_ENERGIES
+	);
 
 	//Initialize \chi_RPA.
 	vector<vector<vector<vector<vector<complex<double>>>>>> rpaSusceptibility;
@@ -554,13 +492,16 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 			for(unsigned int c = 0; c < intraBlockIndexList.size(); c++){
 				for(unsigned int d = 0; d < intraBlockIndexList.size(); d++){
 					unsigned int column = intraBlockIndexList.size()*c + d;
+					unsigned int denominatorOffset = (
+						matrixDimension*column + row
+					)*NUM_ENERGIES;
 					for(
 						unsigned int i = 0;
-						i < energies.size();
+						i < NUM_ENERGIES;
 						i++
 					){
-						rpaSusceptibility[a][b][c][d][i] = denominators[i][
-							matrixDimension*column + row
+						rpaSusceptibility[a][b][c][d][i] = denominators[
+							denominatorOffset + i
 						];
 					}
 				}
@@ -568,10 +509,6 @@ vector<vector<vector<vector<vector<complex<double>>>>>> RPASusceptibility::rpaSu
 		}
 	}
 
-	//Free memory allocated for denominators.
-	for(unsigned int n = 0; n < energies.size(); n++)
-		delete [] denominators.at(n);
-
 	return rpaSusceptibility;
 }
 
@@ -23,8 +23,10 @@
 #include "TBTK/TBTKMacros.h"
 #include "TBTK/Solver/TimeEvolver.h"
 
+#include <algorithm>
 #include <complex>
 #include <cmath>
+#include <map>
 
 using namespace std;
 
@@ -40,6 +42,7 @@ const complex<double> i(0, 1);
 
 vector<TimeEvolver*> TimeEvolver::timeEvolvers;
 vector<Diagonalizer*> TimeEvolver::dSolvers;
+TimeEvolver::SelfConsistencyCallback TimeEvolver::selfConsistencyCallback;
 
 TimeEvolver::TimeEvolver(){
 	eigenValues = NULL;
@@ -48,6 +51,11 @@ TimeEvolver::TimeEvolver(){
 	occupancy = NULL;
 	numberOfParticles = -1;
 	particleNumberIsFixed = true;
+	evolveOccupiedSubspace = false;
+	occupiedSubspaceMargin = 0;
+	diagonalizerIsRestricted = false;
+	unrestrictedAlgorithm = dSolver.getAlgorithm();
+	numEvolvedStates = 0;
 	decayMode = DecayMode::None;
 	callback = NULL;
 	numTimeSteps = 0;
@@ -55,12 +63,22 @@ TimeEvolver::TimeEvolver(){
 	currentTimeStep = -1;
 	orthogonalityError = 0.;
 	orthogonalityCheckInterval = 0;
+	propagator = Propagator::Chebyshev;
+	propagatorTolerance = 1e-12;
+	numChebyshevTerms = 0;
+	hamiltonianIsConstructed = false;
+	hamiltonianRevision = 0;
 
 	dSolvers.push_back(&dSolver);
 	timeEvolvers.push_back(this);
 }
 
 TimeEvolver::~TimeEvolver(){
+	if(eigenVectorsMap != NULL)
+		delete [] eigenVectorsMap;
+	if(occupancy != NULL)
+		delete [] occupancy;
+
 	int timeEvolverIndex = -1;
 	for(unsigned int n = 0; n < timeEvolvers.size(); n++){
 		if(timeEvolvers.at(n) == this){
@@ -85,63 +103,96 @@ TimeEvolver::~TimeEvolver(){
 void TimeEvolver::run(){
 	Model &model = getModel();
 	int basisSize = model.getBasisSize();
+	if(occupancy != NULL)
+		delete [] occupancy;
 	occupancy = new double[basisSize];
 
+	//Only calculate the states that are to be evolved.
+	if(evolveOccupiedSubspace){
+		TBTKAssert(
+			numberOfParticles >= 0 && particleNumberIsFixed,
+			"TimeEvolver::run()",
+			"Evolving only the occupied subspace requires a fixed"
+			<< " number of particles.",
+			"Use TimeEvolver::setNumberOfParticles() to set the number"
+			<< " of particles and TimeEvolver::fixParticleNumber() to"
+			<< " fix it."
+		);
+		unsigned int numStates
+			= numberOfParticles + occupiedSubspaceMargin;
+		if(numStates > (unsigned int)basisSize)
+			numStates = basisSize;
+		if(numStates == 0)
+			numStates = 1;
+		if(!diagonalizerIsRestricted){
+			unrestrictedAlgorithm = dSolver.getAlgorithm();
+			diagonalizerIsRestricted = true;
+		}
+		dSolver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+		dSolver.setStateRange(0, numStates - 1);
+	}
+	else if(diagonalizerIsRestricted){
+		dSolver.setAlgorithm(unrestrictedAlgorithm);
+		dSolver.setCalculateAllStates();
+		diagonalizerIsRestricted = false;
+	}
+
 	currentTimeStep = -1;
 	dSolver.setModel(model);
 	dSolver.setSelfConsistencyCallback(selfConsistencyCallback);
 	dSolver.run();
 
 	if(numberOfParticles < 0){
-		for(int n = 0; n < basisSize; n++){
+		for(unsigned int n = 0; n < numEvolvedStates; n++){
 			numberOfParticles++;
 			if(eigenValues[n] >= model.getChemicalPotential())
 				break;
 		}
 	}
 
-	double hbar = UnitHandler::getConstantInBaseUnits("hbar");
-	complex<double> *dPsi = new complex<double>[basisSize*basisSize];
+	setupDrivingTerms();
+	hamiltonianIsConstructed = false;
+	complex<double> *dPsi = nullptr;
+	switch(propagator){
+	case Propagator::Euler:
+		dPsi = new complex<double>[numEvolvedStates*basisSize];
+		break;
+	case Propagator::Chebyshev:
+	{
+		//The workspaces are distributed according to the partitioning
+		//of the Hamiltonian, which therefore is constructed first.
+		updateDrivingTerms(0);
+		model.updateCompiledCallbackAmplitudes();
+		getHamiltonian(
+			model.getHoppingAmplitudeSet(
+			).getCompiledHoppingAmplitudes()
+		);
+		chebyshevVector0 = hamiltonian.createVector(numEvolvedStates);
+		chebyshevVector1 = hamiltonian.createVector(numEvolvedStates);
+		chebyshevResult = hamiltonian.createVector(numEvolvedStates);
+		break;
+	}
+	default:
+		break;
+	}
 	for(int t = 0; t < numTimeSteps; t++){
 		currentTimeStep = t;
 		callback(this);
 
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize*basisSize; n++)
-			dPsi[n] = 0.;
-
-		for(
-			HoppingAmplitudeSet::ConstIterator iterator
-				= model.getHoppingAmplitudeSet().cbegin();
-			iterator != model.getHoppingAmplitudeSet().cend();
-			++iterator
-		){
-			int fromIndex = model.getHoppingAmplitudeSet().getBasisIndex((*iterator).getFromIndex());
-			int toIndex = model.getHoppingAmplitudeSet().getBasisIndex((*iterator).getToIndex());
-			complex<double> amplitude = (*iterator).getAmplitude();
-			#pragma omp parallel for
-			for(int n = 0; n < basisSize; n++){
-				dPsi[basisSize*n + toIndex] += amplitude*eigenVectorsMap[n][fromIndex];
-			}
-		}
-
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
-			double energy = 0.;
-			for(int c = 0; c < basisSize; c++){
-				energy += real(conj(eigenVectorsMap[n][c])*dPsi[basisSize*n + c]);
-			}
-			eigenValues[n] = energy;
-		}
-
-		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
-			for(int c = 0; c < basisSize; c++)
-				eigenVectorsMap[n][c] -= i*dPsi[
-					basisSize*n + c
-				]*UnitHandler::convertNaturalToBase<
-					Quantity::Time
-				>(dt)/hbar;
+		switch(propagator){
+		case Propagator::Euler:
+			stepEuler(dPsi);
+			break;
+		case Propagator::Chebyshev:
+			stepChebyshev();
+			break;
+		default:
+			TBTKExit(
+				"TimeEvolver::run()",
+				"Unknown Propagator.",
+				"This should never happen, contact the"
+				<< " developer."
+			);
 		}
 
 		sort();
@@ -149,7 +200,7 @@ void TimeEvolver::run(){
 		updateOccupancy();
 
 		#pragma omp parallel for
-		for(int n = 0; n < basisSize; n++){
+		for(int n = 0; n < (int)numEvolvedStates; n++){
 			//No need to use eigenVectorsMap here because
 			//noramlization procedure is independent of ordering.
 			double normalizationFactor = 0.;
@@ -164,6 +215,492 @@ void TimeEvolver::run(){
 		if(orthogonalityCheckInterval != 0 && t%orthogonalityCheckInterval == 0)
 			calculateOrthogonalityError();
 	}
+
+	if(dPsi != nullptr)
+		delete [] dPsi;
+	chebyshevVector0 = Math::ParallelSparseMatrix<complex<double>>::Vector();
+	chebyshevVector1 = Math::ParallelSparseMatrix<complex<double>>::Vector();
+	chebyshevResult = Math::ParallelSparseMatrix<complex<double>>::Vector();
+}
+
+void TimeEvolver::stepEuler(complex<double> *dPsi){
+	Model &model = getModel();
+	int basisSize = model.getBasisSize();
+	double hbar = UnitHandler::getConstantInBaseUnits("hbar");
+	numChebyshevTerms = 0;
+	updateDrivingTerms(currentTimeStep*dt);
+
+	#pragma omp parallel for
+	for(int n = 0; n < (int)numEvolvedStates*basisSize; n++)
+		dPsi[n] = 0.;
+
+	//The callback dependent amplitudes are reevaluated every time step
+	//since they can change between time steps.
+	model.updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices
+		= compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	const unsigned int numHoppingAmplitudes
+		= compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+	#pragma omp parallel for
+	for(int n = 0; n < (int)numEvolvedStates; n++){
+		for(unsigned int c = 0; c < numHoppingAmplitudes; c++){
+			dPsi[basisSize*n + toIndices[c]]
+				+= amplitudes[c]*eigenVectorsMap[n][
+					fromIndices[c]
+				];
+		}
+		for(unsigned int e = 0; e < drivenElements.size(); e++){
+			const DrivenElement &drivenElement = drivenElements[e];
+			dPsi[basisSize*n + drivenElement.row]
+				+= drivenElement.drivenValue*eigenVectorsMap[n][
+					drivenElement.column
+				];
+		}
+	}
+
+	#pragma omp parallel for
+	for(int n = 0; n < (int)numEvolvedStates; n++){
+		double energy = 0.;
+		for(int c = 0; c < basisSize; c++){
+			energy += real(conj(eigenVectorsMap[n][c])*dPsi[basisSize*n + c]);
+		}
+		eigenValues[n] = energy;
+	}
+
+	#pragma omp parallel for
+	for(int n = 0; n < (int)numEvolvedStates; n++){
+		for(int c = 0; c < basisSize; c++)
+			eigenVectorsMap[n][c] -= i*dPsi[
+				basisSize*n + c
+			]*UnitHandler::convertNaturalToBase<
+				Quantity::Time
+			>(dt)/hbar;
+	}
+}
+
+void TimeEvolver::stepChebyshev(){
+	const unsigned int basisSize = getModel().getBasisSize();
+	double hbar = UnitHandler::getConstantInBaseUnits("hbar");
+	double tau = UnitHandler::convertNaturalToBase<Quantity::Time>(dt)/hbar;
+
+	//The driving terms are evaluated at the middle of the time step,
+	//which makes the propagation second order accurate in the time step
+	//for time dependent Hamiltonians.
+	updateDrivingTerms((currentTimeStep + 0.5)*dt);
+
+	//The callback dependent amplitudes are reevaluated once per time
+	//step.
+	getModel().updateCompiledCallbackAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= getModel().getHoppingAmplitudeSet(
+		).getCompiledHoppingAmplitudes();
+	const Math::ParallelSparseMatrix<complex<double>> &hamiltonian
+		= getHamiltonian(compiledHoppingAmplitudes);
+
+	//Map the spectrum onto [-1, 1] using H = scale*H' + shift, which
+	//gives exp(-iH*tau) = exp(-i*shift*tau)*exp(-iH'*scale*tau).
+	double lowerBound;
+	double upperBound;
+	calculateSpectralBounds(
+		compiledHoppingAmplitudes,
+		lowerBound,
+		upperBound
+	);
+	double shift = (upperBound + lowerBound)/2.;
+	double scale = (upperBound - lowerBound)/2.;
+	if(scale < 1e-12*max(1., abs(shift)))
+		scale = 1e-12*max(1., abs(shift));
+
+	//The number of terms grows linearly with scale*tau.
+	TBTKAssert(
+		scale*tau < 1e6,
+		"TimeEvolver::stepChebyshev()",
+		"The time step is too large compared to the bandwidth of the"
+		<< " Hamiltonian. The Chebyshev expansion would require more"
+		<< " than 10^6 terms.",
+		"Use TimeEvolver::setTimeStep() to set a smaller time step, or"
+		<< " make sure the UnitHandler scales are set correctly."
+	);
+
+	//The expansion exp(-ix*H') = J_0(x) + 2 sum_k (-i)^k J_k(x) T_k(H').
+	vector<double> besselFunctions = calculateBesselFunctions(
+		scale*tau,
+		propagatorTolerance
+	);
+	numChebyshevTerms = besselFunctions.size();
+	vector<complex<double>> coefficients(numChebyshevTerms);
+	complex<double> phase = exp(-i*shift*tau);
+	complex<double> minusIPower = 1.;
+	for(unsigned int k = 0; k < numChebyshevTerms; k++){
+		coefficients[k] = (k == 0 ? 1. : 2.)*minusIPower
+			*besselFunctions[k]*phase;
+		minusIPower *= -i;
+	}
+
+	//The states are stored as a block with the elements of all states
+	//for a given basis index stored consecutively, which allows the
+	//Hamiltonian to be read once per iteration for all states. The
+	//workspaces are allocated once by run().
+	const unsigned int numVectors = numEvolvedStates;
+	Math::ParallelSparseMatrix<complex<double>>::Vector &result
+		= chebyshevResult;
+	Math::ParallelSparseMatrix<complex<double>>::Vector &jIn0
+		= chebyshevVector0;
+	Math::ParallelSparseMatrix<complex<double>>::Vector &jIn1
+		= chebyshevVector1;
+	#pragma omp parallel for
+	for(unsigned int c = 0; c < basisSize; c++)
+		for(unsigned int n = 0; n < numVectors; n++)
+			jIn0[c*numVectors + n] = eigenVectorsMap[n][c];
+
+	//|j1> = H|j0>, which also gives the energies <j0|H|j0>.
+	hamiltonian.multiplyBlock(jIn0, jIn1, numVectors);
+	for(unsigned int n = 0; n < numVectors; n++)
+		eigenValues[n] = 0.;
+	for(unsigned int c = 0; c < basisSize; c++){
+		for(unsigned int n = 0; n < numVectors; n++){
+			eigenValues[n] += real(
+				conj(jIn0[c*numVectors + n])
+				*jIn1[c*numVectors + n]
+			);
+		}
+	}
+
+	//|j1> = H'|j0> = (H|j0> - shift|j0>)/scale.
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < basisSize*numVectors; n++){
+		jIn1[n] = (jIn1[n] - shift*jIn0[n])/scale;
+		result[n] = coefficients[0]*jIn0[n];
+		if(numChebyshevTerms > 1)
+			result[n] += coefficients[1]*jIn1[n];
+	}
+
+	//|jk> = 2H'|j(k-1)> - |j(k-2)>. The result overwrites |j(k-2)>.
+	for(unsigned int k = 2; k < numChebyshevTerms; k++){
+		hamiltonian.multiplyBlock(
+			jIn1,
+			jIn0,
+			numVectors,
+			2/scale,
+			-1
+		);
+		#pragma omp parallel for
+		for(unsigned int n = 0; n < basisSize*numVectors; n++){
+			jIn0[n] -= 2*shift/scale*jIn1[n];
+			result[n] += coefficients[k]*jIn0[n];
+		}
+		swap(jIn0, jIn1);
+	}
+
+	#pragma omp parallel for
+	for(unsigned int c = 0; c < basisSize; c++)
+		for(unsigned int n = 0; n < numVectors; n++)
+			eigenVectorsMap[n][c] = result[c*numVectors + n];
+}
+
+const Math::ParallelSparseMatrix<complex<double>>&
+TimeEvolver::getHamiltonian(
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+){
+	const unsigned int *ranges
+		= compiledHoppingAmplitudes.getCallbackDependentElementRanges();
+	const unsigned int numCallbackDependentElements
+		= compiledHoppingAmplitudes.getNumCallbackDependentElements();
+
+	if(
+		!hamiltonianIsConstructed
+		|| hamiltonianRevision
+			!= compiledHoppingAmplitudes.getRevision()
+	){
+		//The matrix elements affected by the driving terms are added
+		//with zero value to include them in the sparsity pattern.
+		const unsigned int *toIndices
+			= compiledHoppingAmplitudes.getToIndices();
+		const unsigned int *fromIndices
+			= compiledHoppingAmplitudes.getFromIndices();
+		const complex<double> *amplitudes
+			= compiledHoppingAmplitudes.getAmplitudes();
+		SparseMatrix<complex<double>> sparseMatrix(
+			SparseMatrix<complex<double>>::StorageFormat::CSR,
+			compiledHoppingAmplitudes.getBasisSize(),
+			compiledHoppingAmplitudes.getBasisSize()
+		);
+		for(
+			unsigned int n = 0;
+			n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+			n++
+		){
+			sparseMatrix.add(
+				toIndices[n],
+				fromIndices[n],
+				amplitudes[n]
+			);
+		}
+		for(unsigned int n = 0; n < drivenElements.size(); n++){
+			sparseMatrix.add(
+				drivenElements[n].row,
+				drivenElements[n].column,
+				0
+			);
+		}
+		sparseMatrix.construct();
+		hamiltonian = Math::ParallelSparseMatrix<complex<double>>(
+			sparseMatrix
+		);
+
+		for(unsigned int n = 0; n < drivenElements.size(); n++){
+			drivenElements[n].position
+				= hamiltonian.getMatrixElementPosition(
+					drivenElements[n].row,
+					drivenElements[n].column
+				);
+		}
+
+		callbackDependentElementPositions.clear();
+		for(unsigned int n = 0; n < numCallbackDependentElements; n++){
+			int position = hamiltonian.getMatrixElementPosition(
+				toIndices[ranges[2*n]],
+				fromIndices[ranges[2*n]]
+			);
+			TBTKAssert(
+				position != -1,
+				"Solver::TimeEvolver::getHamiltonian()",
+				"Unable to find callback dependent matrix"
+				<< " element.",
+				"This should never happen, contact the"
+				<< " developer."
+			);
+			callbackDependentElementPositions.push_back(position);
+		}
+
+		hamiltonianRevision = compiledHoppingAmplitudes.getRevision();
+		hamiltonianIsConstructed = true;
+	}
+	else{
+		//Only the callback dependent matrix elements can have changed
+		//since the construction.
+		const complex<double> *amplitudes
+			= compiledHoppingAmplitudes.getAmplitudes();
+		for(unsigned int n = 0; n < numCallbackDependentElements; n++){
+			complex<double> value = 0;
+			for(unsigned int c = ranges[2*n]; c < ranges[2*n+1]; c++)
+				value += amplitudes[c];
+			hamiltonian.setMatrixElement(
+				callbackDependentElementPositions[n],
+				value
+			);
+		}
+	}
+
+	//Add the driving terms to the static part of the matrix elements.
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	for(unsigned int n = 0; n < drivenElements.size(); n++){
+		const DrivenElement &drivenElement = drivenElements[n];
+		complex<double> value = drivenElement.drivenValue;
+		for(
+			unsigned int c = drivenElement.compiledBegin;
+			c < drivenElement.compiledEnd;
+			c++
+		){
+			value += amplitudes[c];
+		}
+		hamiltonian.setMatrixElement(drivenElement.position, value);
+	}
+
+	return hamiltonian;
+}
+
+void TimeEvolver::setupDrivingTerms(){
+	const Model &model = getModel();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= model.getHoppingAmplitudeSet().getCompiledHoppingAmplitudes();
+	const unsigned int *rowPointers
+		= compiledHoppingAmplitudes.getRowPointers();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+
+	drivenElements.clear();
+	map<pair<unsigned int, unsigned int>, unsigned int> drivenElementMap;
+	for(unsigned int n = 0; n < drivingTerms.size(); n++){
+		DrivingTerm &drivingTerm = drivingTerms[n];
+		drivingTerm.drivenElementIndices.clear();
+		for(
+			unsigned int c = 0;
+			c < drivingTerm.hoppingAmplitudes.size();
+			c++
+		){
+			const HoppingAmplitude &hoppingAmplitude
+				= drivingTerm.hoppingAmplitudes[c];
+			unsigned int row = model.getBasisIndex(
+				hoppingAmplitude.getToIndex()
+			);
+			unsigned int column = model.getBasisIndex(
+				hoppingAmplitude.getFromIndex()
+			);
+
+			pair<unsigned int, unsigned int> key(row, column);
+			map<
+				pair<unsigned int, unsigned int>,
+				unsigned int
+			>::iterator iterator = drivenElementMap.find(key);
+			if(iterator != drivenElementMap.end()){
+				drivingTerm.drivenElementIndices.push_back(
+					iterator->second
+				);
+				continue;
+			}
+
+			//The entries of a row are sorted by column in the
+			//CompiledHoppingAmplitudes.
+			DrivenElement drivenElement;
+			drivenElement.row = row;
+			drivenElement.column = column;
+			drivenElement.compiledBegin = lower_bound(
+				fromIndices + rowPointers[row],
+				fromIndices + rowPointers[row+1],
+				column
+			) - fromIndices;
+			drivenElement.compiledEnd = upper_bound(
+				fromIndices + rowPointers[row],
+				fromIndices + rowPointers[row+1],
+				column
+			) - fromIndices;
+			drivenElement.position = 0;
+			drivenElement.drivenValue = 0;
+
+			drivenElementMap[key] = drivenElements.size();
+			drivingTerm.drivenElementIndices.push_back(
+				drivenElements.size()
+			);
+			drivenElements.push_back(drivenElement);
+		}
+	}
+}
+
+void TimeEvolver::updateDrivingTerms(double time){
+	for(unsigned int n = 0; n < drivenElements.size(); n++)
+		drivenElements[n].drivenValue = 0;
+
+	for(unsigned int n = 0; n < drivingTerms.size(); n++){
+		const DrivingTerm &drivingTerm = drivingTerms[n];
+		complex<double> value
+			= drivingTerm.drivingFunction->getValue(time);
+		for(
+			unsigned int c = 0;
+			c < drivingTerm.hoppingAmplitudes.size();
+			c++
+		){
+			drivenElements[
+				drivingTerm.drivenElementIndices[c]
+			].drivenValue += value*drivingTerm.hoppingAmplitudes[
+				c
+			].getAmplitude();
+		}
+	}
+}
+
+void TimeEvolver::calculateSpectralBounds(
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes,
+	double &lowerBound,
+	double &upperBound
+) const{
+	const unsigned int *rowPointers
+		= compiledHoppingAmplitudes.getRowPointers();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+
+	//Duplicate entries are added, which means that the radii are upper
+	//bounds for the Gershgorin radii.
+	const unsigned int basisSize = compiledHoppingAmplitudes.getBasisSize();
+	vector<double> centers(basisSize, 0.);
+	vector<double> radii(basisSize, 0.);
+	for(unsigned int row = 0; row < basisSize; row++){
+		for(unsigned int n = rowPointers[row]; n < rowPointers[row+1]; n++){
+			if(fromIndices[n] == row)
+				centers[row] += real(amplitudes[n]);
+			else
+				radii[row] += abs(amplitudes[n]);
+		}
+	}
+	for(unsigned int n = 0; n < drivenElements.size(); n++){
+		const DrivenElement &drivenElement = drivenElements[n];
+		if(drivenElement.row == drivenElement.column){
+			centers[drivenElement.row]
+				+= real(drivenElement.drivenValue);
+		}
+		else{
+			radii[drivenElement.row]
+				+= abs(drivenElement.drivenValue);
+		}
+	}
+
+	lowerBound = 0;
+	upperBound = 0;
+	for(unsigned int row = 0; row < basisSize; row++){
+		if(row == 0 || centers[row] - radii[row] < lowerBound)
+			lowerBound = centers[row] - radii[row];
+		if(row == 0 || centers[row] + radii[row] > upperBound)
+			upperBound = centers[row] + radii[row];
+	}
+}
+
+vector<double> TimeEvolver::calculateBesselFunctions(
+	double x,
+	double tolerance
+){
+	if(x == 0)
+		return vector<double>(1, 1.);
+
+	//J_k(x) decays faster than exponentially for k > x. Start the
+	//backward recurrence well inside the decaying region.
+	int numTerms = (int)(x + 10*cbrt(x)) + 30;
+	if(numTerms%2 == 1)
+		numTerms++;
+	vector<double> besselFunctions(numTerms + 1, 0.);
+
+	//J_{k-1}(x) = 2k/x J_k(x) - J_{k+1}(x), normalized using
+	//J_0(x) + 2 sum_k J_{2k}(x) = 1.
+	double jNext = 0;
+	double jCurrent = 1e-300;
+	double normalization = 0;
+	for(int k = numTerms; k > 0; k--){
+		double jPrevious = 2*k/x*jCurrent - jNext;
+		besselFunctions[k] = jCurrent;
+		if(k%2 == 0)
+			normalization += 2*jCurrent;
+		jNext = jCurrent;
+		jCurrent = jPrevious;
+
+		//Rescale to avoid overflow.
+		if(abs(jCurrent) > 1e250){
+			for(int c = k; c <= numTerms; c++)
+				besselFunctions[c] *= 1e-250;
+			jNext *= 1e-250;
+			jCurrent *= 1e-250;
+			normalization *= 1e-250;
+		}
+	}
+	besselFunctions[0] = jCurrent;
+	normalization += jCurrent;
+	for(int k = 0; k <= numTerms; k++)
+		besselFunctions[k] /= normalization;
+
+	//Truncate the expansion.
+	int lastTerm = numTerms;
+	while(lastTerm > 0 && abs(besselFunctions[lastTerm]) < tolerance)
+		lastTerm--;
+	besselFunctions.resize(lastTerm + 1);
+
+	return besselFunctions;
 }
 
 bool TimeEvolver::SelfConsistencyCallback::selfConsistencyCallback(
@@ -193,15 +730,19 @@ void TimeEvolver::onDiagonalizationFinished(){
 	eigenValues = dSolver.getEigenValuesRW().getData();
 	eigenVectors = dSolver.getEigenVectorsRW().getData();
 
+	numEvolvedStates = dSolver.getNumStates();
+
+	//The map is recreated since the number of states and the storage
+	//can change between diagonalizations.
 	const Model &model = getModel();
-	if(eigenVectorsMap == NULL){
-		int basisSize = model.getBasisSize();
-		eigenVectorsMap = new complex<double>*[basisSize];
-		for(int n = 0; n < basisSize; n++)
-			eigenVectorsMap[n] = &(eigenVectors[n*basisSize]);
-	}
+	int basisSize = model.getBasisSize();
+	if(eigenVectorsMap != NULL)
+		delete [] eigenVectorsMap;
+	eigenVectorsMap = new complex<double>*[numEvolvedStates];
+	for(unsigned int n = 0; n < numEvolvedStates; n++)
+		eigenVectorsMap[n] = &(eigenVectors[n*basisSize]);
 
-	for(int n = 0; n < model.getBasisSize(); n++){
+	for(int n = 0; n < (int)numEvolvedStates; n++){
 		if(numberOfParticles < 0){
 			if(eigenValues[n] < model.getChemicalPotential())
 				occupancy[n] = 1.;
@@ -218,10 +759,10 @@ void TimeEvolver::onDiagonalizationFinished(){
 }
 
 void TimeEvolver::sort(){
-	int basisSize = getModel().getBasisSize();
+	int numStates = numEvolvedStates;
 
-	for(int m = 0; m < basisSize; m++){
-		for(int n = m+1; n < basisSize; n++){
+	for(int m = 0; m < numStates; m++){
+		for(int n = m+1; n < numStates; n++){
 			if(eigenValues[n] < eigenValues[m]){
 				double tempEigenValue = eigenValues[n];
 				complex<double> *tempEigenVectorsMap = eigenVectorsMap[n];
@@ -263,9 +804,9 @@ void TimeEvolver::updateOccupancy(){
 
 void TimeEvolver::decayInstantly(){
 	const Model &model = getModel();
-	int basisSize = model.getBasisSize();
+	int numStates = numEvolvedStates;
 	if(particleNumberIsFixed){
-		for(int n = 0; n < basisSize; n++){
+		for(int n = 0; n < numStates; n++){
 			if(n < numberOfParticles)
 				occupancy[n] = 1.;
 			else
@@ -274,7 +815,7 @@ void TimeEvolver::decayInstantly(){
 	}
 	else{
 		numberOfParticles = 0;
-		for(int n = 0; n < basisSize; n++){
+		for(int n = 0; n < numStates; n++){
 			if(eigenValues[n] < model.getChemicalPotential()){
 				occupancy[n] = 1.;
 				numberOfParticles++;
@@ -295,9 +836,9 @@ void TimeEvolver::decayInterpolate(){
 	);
 
 	const Model &model = getModel();
-	int basisSize = model.getBasisSize();
+	int numStates = numEvolvedStates;
 
-	for(int n = 0; n < basisSize; n++){
+	for(int n = 0; n < numStates; n++){
 		if(eigenValues[n] < model.getChemicalPotential()){
 			occupancy[n] += 0.00000001;
 			if(occupancy[n] > 1)
@@ -313,11 +854,12 @@ void TimeEvolver::decayInterpolate(){
 
 void TimeEvolver::calculateOrthogonalityError(){
 	int basisSize = getModel().getBasisSize();
+	int numStates = numEvolvedStates;
 	CArray<complex<double>> &eigenVectors = dSolver.getEigenVectorsRW();
 
 	double maxOverlap = 0;
-	for(int i = 0; i < basisSize; i++){
-		for(int j = 0; j < basisSize; j++){
+	for(int i = 0; i < numStates; i++){
+		for(int j = 0; j < numStates; j++){
 			if(i == j)
 				continue;
 
@@ -27,6 +27,10 @@
 #include "TBTK/TBTKMacros.h"
 #include "TBTK/Timer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+
 using namespace std;
 
 namespace TBTK{
@@ -40,10 +44,135 @@ DynamicTypeInformation Transport::dynamicTypeInformation(
 Transport::Transport(
 ) :
 	Communicator(false),
+	method(Method::Diagonalization),
+	energyInfinitesimal(1e-10),
+	layerDirection(-1),
+	layerWidth(0),
 	energyRange(-1, 1, 1000)
 {
 }
 
+void Transport::addLead(
+	const Model &leadModel,
+	const vector<HoppingAmplitude> &couplings,
+	double chemicalPotential,
+	double temperature
+){
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= leadModel.getHoppingAmplitudeSet();
+	const unsigned int BASIS_SIZE = leadModel.getBasisSize();
+
+	Lead lead(chemicalPotential, temperature);
+
+	//Assign a position in the unit cell to every state. States in the
+	//second unit cell are given the position of the corresponding state
+	//in the first unit cell.
+	vector<unsigned int> positions(BASIS_SIZE);
+	lead.unitCellSize = 0;
+	for(unsigned int n = 0; n < BASIS_SIZE; n++){
+		Index index = hoppingAmplitudeSet.getPhysicalIndex(n);
+		TBTKAssert(
+			index[0] == 0 || index[0] == 1,
+			"Solver::Transport::addLead()",
+			"Invalid Index '" << index << "' in the lead Model. The"
+			<< " first subindex must be 0 or 1.",
+			""
+		);
+		if(index[0] == 0)
+			positions[n] = lead.unitCellSize++;
+	}
+	for(unsigned int n = 0; n < BASIS_SIZE; n++){
+		Index index = hoppingAmplitudeSet.getPhysicalIndex(n);
+		if(index[0] == 1){
+			index[0] = 0;
+			TBTKAssert(
+				hoppingAmplitudeSet.getBasisIndex(index) != -1,
+				"Solver::Transport::addLead()",
+				"The Index '" << index << "' is missing in the"
+				<< " lead Model.",
+				"The two unit cells of the lead must contain"
+				<< " the same Indices."
+			);
+			positions[n] = positions[
+				hoppingAmplitudeSet.getBasisIndex(index)
+			];
+		}
+	}
+
+	const unsigned int SIZE = lead.unitCellSize;
+	lead.unitCellHamiltonian.assign(SIZE*SIZE, 0);
+	lead.unitCellCoupling.assign(SIZE*SIZE, 0);
+	for(
+		HoppingAmplitudeSet::ConstIterator iterator
+			= hoppingAmplitudeSet.cbegin();
+		iterator != hoppingAmplitudeSet.cend();
+		++iterator
+	){
+		const Index &toIndex = (*iterator).getToIndex();
+		const Index &fromIndex = (*iterator).getFromIndex();
+		unsigned int row
+			= positions[hoppingAmplitudeSet.getBasisIndex(toIndex)];
+		unsigned int column = positions[
+			hoppingAmplitudeSet.getBasisIndex(fromIndex)
+		];
+		if(toIndex[0] == 0 && fromIndex[0] == 0){
+			lead.unitCellHamiltonian[row + SIZE*column]
+				+= (*iterator).getAmplitude();
+		}
+		else if(toIndex[0] == 0 && fromIndex[0] == 1){
+			lead.unitCellCoupling[row + SIZE*column]
+				+= (*iterator).getAmplitude();
+		}
+	}
+
+	IndexTree deviceIndexTree;
+	for(unsigned int n = 0; n < couplings.size(); n++)
+		deviceIndexTree.add(couplings[n].getToIndex());
+	deviceIndexTree.generateLinearMap();
+	for(auto index : deviceIndexTree)
+		lead.deviceIndices.push_back(index);
+
+	const unsigned int NUM_DEVICE_INDICES = lead.deviceIndices.size();
+	lead.deviceCoupling.assign(NUM_DEVICE_INDICES*SIZE, 0);
+	for(unsigned int n = 0; n < couplings.size(); n++){
+		const Index &fromIndex = couplings[n].getFromIndex();
+		int state = hoppingAmplitudeSet.getBasisIndex(fromIndex);
+		TBTKAssert(
+			state != -1 && fromIndex[0] == 0,
+			"Solver::Transport::addLead()",
+			"Invalid from-Index '" << fromIndex << "' in one of the"
+			<< " couplings.",
+			"The from-Index must be an Index in the first unit"
+			<< " cell of the lead Model."
+		);
+		unsigned int row = deviceIndexTree.getLinearIndex(
+			couplings[n].getToIndex()
+		);
+		lead.deviceCoupling[row + NUM_DEVICE_INDICES*positions[state]]
+			+= couplings[n].getAmplitude();
+	}
+
+	leads.push_back(lead);
+}
+
+const Property::SelfEnergy& Transport::calculateLeadSelfEnergy(
+	unsigned int lead
+){
+	TBTKAssert(
+		lead < leads.size(),
+		"Solver::Transport::calculateLeadSelfEnergy()",
+		"'lead' must be a number between 0 and one less than the"
+		<< " number of leads, but 'lead=" << lead << "' and the"
+		<< " number of leads is '" << leads.size() << "'.",
+		""
+	);
+
+	if(leads[lead].isSemiInfinite)
+		calculateSemiInfiniteLeadSelfEnergy(leads[lead]);
+
+	return leads[lead].selfEnergy;
+}
+
 double Transport::calculateCurrent(
 	unsigned int lead0/*,
 	unsigned int lead1*/
@@ -65,14 +194,29 @@ double Transport::calculateCurrent(
 		""
 	);*/
 
-	calculateGreensFunction();
-	calculateInteractingGreensFunction();
-	calculateBroadenings();
-	calculateInscatterings();
-	calculateFullInscattering();
-	calculateCorrelationFunction();
-	calculateSpectralFunction();
-	calculateEnergyResolvedCurrents();
+	calculateLeadSelfEnergies();
+	switch(method){
+	case Method::Diagonalization:
+		calculateGreensFunction();
+		calculateInteractingGreensFunction();
+		calculateBroadenings();
+		calculateInscatterings();
+		calculateFullInscattering();
+		calculateCorrelationFunction();
+		calculateSpectralFunction();
+		calculateEnergyResolvedCurrents();
+		break;
+	case Method::RecursiveGreensFunction:
+		calculateTransmissionRatesRecursively();
+		calculateLandauerButtikerCurrents();
+		break;
+	default:
+		TBTKExit(
+			"Solver::Transport::calculateCurrent()",
+			"Unknown method.",
+			"This should never happen, contact the developer."
+		);
+	}
 	calculateCurrents();
 
 /*	Greens solver;
@@ -86,6 +230,208 @@ double Transport::calculateCurrent(
 	return leads[lead0].current;
 }
 
+Property::TransmissionRate Transport::calculateTransmissionRate(
+	unsigned int lead0,
+	unsigned int lead1
+){
+	TBTKAssert(
+		lead0 < leads.size() && lead1 < leads.size(),
+		"Solver::Transport::calculateTransmissionRate()",
+		"'lead0' and 'lead1' must be numbers between 0 and one less"
+		<< " than the number of leads, but 'lead0=" << lead0 << "',"
+		<< " 'lead1=" << lead1 << "', and the number of leads is '"
+		<< leads.size() << "'.",
+		""
+	);
+	TBTKAssert(
+		method == Method::RecursiveGreensFunction,
+		"Solver::Transport::calculateTransmissionRate()",
+		"The transmission rate is only supported by the"
+		<< " RecursiveGreensFunction method.",
+		"Use Solver::Transport::setMethod() to change method."
+	);
+
+	calculateLeadSelfEnergies();
+	calculateTransmissionRatesRecursively();
+
+	const unsigned int NUM_LEADS = leads.size();
+	CArray<double> data(energyRange.getResolution());
+	for(unsigned int n = 0; n < energyRange.getResolution(); n++){
+		data[n] = transmissionRates[
+			(NUM_LEADS*n + lead0)*NUM_LEADS + lead1
+		];
+	}
+
+	return Property::TransmissionRate(energyRange, data);
+}
+
+void Transport::calculateLeadSelfEnergies(){
+	for(auto &lead : leads)
+		if(lead.isSemiInfinite)
+			calculateSemiInfiniteLeadSelfEnergy(lead);
+}
+
+void Transport::calculateSemiInfiniteLeadSelfEnergy(Lead &lead){
+	if(
+		lead.selfEnergyIsCached
+		&& lead.cachedEnergyRange == energyRange
+		&& lead.cachedEnergyInfinitesimal == energyInfinitesimal
+	){
+		return;
+	}
+
+	Timer::tick("Calculate semi-infinite lead self-energy");
+	const unsigned int SIZE = lead.unitCellSize;
+	const unsigned int NUM_DEVICE_INDICES = lead.deviceIndices.size();
+	const unsigned int NUM_ENERGIES = energyRange.getResolution();
+	const unsigned int MAX_ITERATIONS = 100;
+
+	//The decimation is considered converged when the effective coupling
+	//between the unit cells is negligible compared to the Hamiltonian.
+	double scale = 0;
+	for(unsigned int n = 0; n < SIZE*SIZE; n++){
+		scale = max(scale, abs(lead.unitCellHamiltonian[n]));
+		scale = max(scale, abs(lead.unitCellCoupling[n]));
+	}
+	const double TOLERANCE
+		= 10*numeric_limits<double>::epsilon()*max(scale, 1.);
+
+	IndexTree indexTree;
+	for(auto &index0 : lead.deviceIndices)
+		for(auto &index1 : lead.deviceIndices)
+			indexTree.add({index0, index1});
+	indexTree.generateLinearMap();
+	lead.selfEnergy = Property::SelfEnergy(indexTree, energyRange);
+
+	vector<unsigned int> offsets(NUM_DEVICE_INDICES*NUM_DEVICE_INDICES);
+	for(unsigned int row = 0; row < NUM_DEVICE_INDICES; row++){
+		for(unsigned int column = 0; column < NUM_DEVICE_INDICES; column++){
+			offsets[row + NUM_DEVICE_INDICES*column]
+				= lead.selfEnergy.getOffset({
+					lead.deviceIndices[row],
+					lead.deviceIndices[column]
+				});
+		}
+	}
+	vector<complex<double>> &data = lead.selfEnergy.getDataRW();
+
+	#pragma omp parallel for schedule(dynamic)
+	for(unsigned int energy = 0; energy < NUM_ENERGIES; energy++){
+		const complex<double> z(
+			energyRange[energy],
+			energyInfinitesimal
+		);
+
+		//Effective surface Hamiltonian, bulk Hamiltonian, and
+		//couplings to the next and previous unit cells.
+		Matrix<complex<double>> epsilonSurface(SIZE, SIZE);
+		Matrix<complex<double>> epsilon(SIZE, SIZE);
+		Matrix<complex<double>> alpha(SIZE, SIZE);
+		Matrix<complex<double>> beta(SIZE, SIZE);
+		for(unsigned int row = 0; row < SIZE; row++){
+			for(unsigned int column = 0; column < SIZE; column++){
+				epsilonSurface.at(row, column)
+					= lead.unitCellHamiltonian[
+						row + SIZE*column
+					];
+				epsilon.at(row, column)
+					= epsilonSurface.at(row, column);
+				alpha.at(row, column)
+					= lead.unitCellCoupling[
+						row + SIZE*column
+					];
+				beta.at(row, column) = conj(
+					lead.unitCellCoupling[
+						column + SIZE*row
+					]
+				);
+			}
+		}
+
+		//Every iteration eliminates every second unit cell, which
+		//doubles the distance between the remaining unit cells.
+		auto invert = [&](const Matrix<complex<double>> &hamiltonian){
+			Matrix<complex<double>> result(SIZE, SIZE);
+			for(unsigned int row = 0; row < SIZE; row++){
+				for(unsigned int column = 0; column < SIZE; column++){
+					result.at(row, column)
+						= -hamiltonian.at(row, column);
+				}
+				result.at(row, row) += z;
+			}
+			result.invert();
+
+			return result;
+		};
+		unsigned int iteration = 0;
+		while(true){
+			double couplingNorm = 0;
+			for(unsigned int n = 0; n < SIZE*SIZE; n++){
+				couplingNorm = max(
+					couplingNorm,
+					abs(alpha.at(n%SIZE, n/SIZE))
+				);
+			}
+			if(couplingNorm < TOLERANCE)
+				break;
+
+			TBTKAssert(
+				iteration < MAX_ITERATIONS,
+				"Solver::Transport::calculateSemiInfiniteLeadSelfEnergy()",
+				"The decimation did not converge.",
+				"Use a larger energy infinitesimal."
+			);
+			iteration++;
+
+			Matrix<complex<double>> g = invert(epsilon);
+			Matrix<complex<double>> alphaG = alpha*g;
+			Matrix<complex<double>> betaG = beta*g;
+			Matrix<complex<double>> alphaGBeta = alphaG*beta;
+			Matrix<complex<double>> betaGAlpha = betaG*alpha;
+			for(unsigned int row = 0; row < SIZE; row++){
+				for(unsigned int column = 0; column < SIZE; column++){
+					epsilonSurface.at(row, column)
+						+= alphaGBeta.at(row, column);
+					epsilon.at(row, column)
+						+= alphaGBeta.at(row, column)
+						+ betaGAlpha.at(row, column);
+				}
+			}
+			alpha = alphaG*alpha;
+			beta = betaG*beta;
+		}
+
+		//Sigma = V g_s V^{\dagger}.
+		Matrix<complex<double>> surfaceGreensFunction
+			= invert(epsilonSurface);
+		Matrix<complex<double>> V(NUM_DEVICE_INDICES, SIZE);
+		Matrix<complex<double>> VDagger(SIZE, NUM_DEVICE_INDICES);
+		for(unsigned int row = 0; row < NUM_DEVICE_INDICES; row++){
+			for(unsigned int column = 0; column < SIZE; column++){
+				V.at(row, column) = lead.deviceCoupling[
+					row + NUM_DEVICE_INDICES*column
+				];
+				VDagger.at(column, row) = conj(V.at(row, column));
+			}
+		}
+		Matrix<complex<double>> selfEnergy
+			= V*surfaceGreensFunction*VDagger;
+		for(unsigned int row = 0; row < NUM_DEVICE_INDICES; row++){
+			for(unsigned int column = 0; column < NUM_DEVICE_INDICES; column++){
+				data[
+					offsets[row + NUM_DEVICE_INDICES*column]
+					+ energy
+				] = selfEnergy.at(row, column);
+			}
+		}
+	}
+
+	lead.selfEnergyIsCached = true;
+	lead.cachedEnergyRange = energyRange;
+	lead.cachedEnergyInfinitesimal = energyInfinitesimal;
+	Timer::tock();
+}
+
 void Transport::calculateGreensFunction(){
 	Timer::tick("Calculate Green's function");
 	Diagonalizer solver;
@@ -94,9 +440,8 @@ void Transport::calculateGreensFunction(){
 
 	PropertyExtractor::Diagonalizer propertyExtractor;
 	propertyExtractor.setSolver(solver);
-	propertyExtractor.setSolver(solver);
 	Property::EigenValues eigenValues = propertyExtractor.getEigenValues();
-	propertyExtractor.setEnergyInfinitesimal(1e-10);
+	propertyExtractor.setEnergyInfinitesimal(energyInfinitesimal);
 	propertyExtractor.setEnergyWindow(
 		energyRange[0],
 		energyRange[energyRange.getResolution()-1],
@@ -433,5 +778,441 @@ void Transport::calculateCurrents(){
 	Timer::tock();
 }
 
+void Transport::setupLayers(){
+	Timer::tick("Setup layers");
+	Model &model = getModel();
+	model.updateCompiledCallbackAmplitudes();
+	const HoppingAmplitudeSet &hoppingAmplitudeSet
+		= model.getHoppingAmplitudeSet();
+	const unsigned int BASIS_SIZE = model.getBasisSize();
+
+	layerStates.clear();
+	if(layerDirection < 0){
+		TBTKAssert(
+			layers.size() > 0,
+			"Solver::Transport::setupLayers()",
+			"No layers specified.",
+			"Use Solver::Transport::setLayers() to specify the"
+			<< " layers."
+		);
+		for(unsigned int layer = 0; layer < layers.size(); layer++){
+			layerStates.push_back(vector<unsigned int>());
+			for(unsigned int n = 0; n < layers[layer].size(); n++){
+				layerStates.back().push_back(
+					model.getBasisIndex(layers[layer][n])
+				);
+			}
+		}
+	}
+	else{
+		const Geometry &geometry = model.getGeometry();
+		TBTKAssert(
+			layerDirection < geometry.getDimensions(),
+			"Solver::Transport::setupLayers()",
+			"Invalid direction '" << layerDirection << "'. The"
+			<< " Geometry only has '" << geometry.getDimensions()
+			<< "' dimensions.",
+			""
+		);
+
+		//Sort the states into slabs. The map keeps the slabs ordered
+		//and leaves out empty slabs.
+		double minimum = numeric_limits<double>::max();
+		for(unsigned int n = 0; n < BASIS_SIZE; n++){
+			minimum = min(
+				minimum,
+				geometry.getCoordinate(
+					hoppingAmplitudeSet.getPhysicalIndex(n)
+				)[layerDirection]
+			);
+		}
+		map<long, vector<unsigned int>> slabs;
+		for(unsigned int n = 0; n < BASIS_SIZE; n++){
+			double coordinate = geometry.getCoordinate(
+				hoppingAmplitudeSet.getPhysicalIndex(n)
+			)[layerDirection];
+			long slab = floor((coordinate - minimum)/layerWidth);
+			slabs[slab].push_back(n);
+		}
+		for(auto &slab : slabs)
+			layerStates.push_back(slab.second);
+	}
+
+	stateLayers.assign(BASIS_SIZE, layerStates.size());
+	statePositions.assign(BASIS_SIZE, 0);
+	for(unsigned int layer = 0; layer < layerStates.size(); layer++){
+		for(unsigned int n = 0; n < layerStates[layer].size(); n++){
+			unsigned int state = layerStates[layer][n];
+			TBTKAssert(
+				stateLayers[state] == layerStates.size(),
+				"Solver::Transport::setupLayers()",
+				"The Index '"
+				<< hoppingAmplitudeSet.getPhysicalIndex(
+					state
+				) << "' is contained in more than one"
+				<< " layer.",
+				""
+			);
+			stateLayers[state] = layer;
+			statePositions[state] = n;
+		}
+	}
+	for(unsigned int n = 0; n < BASIS_SIZE; n++){
+		TBTKAssert(
+			stateLayers[n] != layerStates.size(),
+			"Solver::Transport::setupLayers()",
+			"The Index '" << hoppingAmplitudeSet.getPhysicalIndex(n)
+			<< "' is not contained in any layer.",
+			""
+		);
+	}
+
+	const unsigned int NUM_LAYERS = layerStates.size();
+	diagonalBlocks.clear();
+	lowerBlocks.clear();
+	upperBlocks.clear();
+	for(unsigned int layer = 0; layer < NUM_LAYERS; layer++){
+		const unsigned int SIZE = layerStates[layer].size();
+		diagonalBlocks.push_back(Matrix<complex<double>>(SIZE, SIZE));
+		for(unsigned int n = 0; n < SIZE*SIZE; n++)
+			diagonalBlocks.back().at(n%SIZE, n/SIZE) = 0;
+
+		if(layer + 1 < NUM_LAYERS){
+			const unsigned int NEXT_SIZE
+				= layerStates[layer + 1].size();
+			lowerBlocks.push_back(
+				Matrix<complex<double>>(NEXT_SIZE, SIZE)
+			);
+			upperBlocks.push_back(
+				Matrix<complex<double>>(SIZE, NEXT_SIZE)
+			);
+			for(unsigned int n = 0; n < SIZE*NEXT_SIZE; n++){
+				lowerBlocks.back().at(n%NEXT_SIZE, n/NEXT_SIZE)
+					= 0;
+				upperBlocks.back().at(n%SIZE, n/SIZE) = 0;
+			}
+		}
+	}
+
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	const unsigned int *toIndices
+		= compiledHoppingAmplitudes.getToIndices();
+	const unsigned int *fromIndices
+		= compiledHoppingAmplitudes.getFromIndices();
+	const complex<double> *amplitudes
+		= compiledHoppingAmplitudes.getAmplitudes();
+	for(
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes.getNumHoppingAmplitudes();
+		n++
+	){
+		unsigned int toLayer = stateLayers[toIndices[n]];
+		unsigned int fromLayer = stateLayers[fromIndices[n]];
+		unsigned int row = statePositions[toIndices[n]];
+		unsigned int column = statePositions[fromIndices[n]];
+		if(toLayer == fromLayer){
+			diagonalBlocks[toLayer].at(row, column)
+				+= amplitudes[n];
+		}
+		else if(toLayer == fromLayer + 1){
+			lowerBlocks[fromLayer].at(row, column)
+				+= amplitudes[n];
+		}
+		else if(fromLayer == toLayer + 1){
+			upperBlocks[toLayer].at(row, column)
+				+= amplitudes[n];
+		}
+		else{
+			TBTKExit(
+				"Solver::Transport::setupLayers()",
+				"Found a HoppingAmplitude between the layers '"
+				<< fromLayer << "' and '" << toLayer << "', but"
+				<< " only neighboring layers can be coupled.",
+				"Use thicker layers."
+			);
+		}
+	}
+	Timer::tock();
+}
+
+unsigned int Transport::getLeadLayer(const Lead &lead) const{
+	const Model &model = getModel();
+	const unsigned int LAST_LAYER = layerStates.size() - 1;
+	bool inFirstLayer = true;
+	bool inLastLayer = true;
+	for(auto index : lead.selfEnergy.getIndexDescriptor().getIndexTree()){
+		vector<Index> components = index.split();
+		for(unsigned int n = 0; n < 2; n++){
+			unsigned int layer
+				= stateLayers[model.getBasisIndex(components[n])];
+			if(layer != 0)
+				inFirstLayer = false;
+			if(layer != LAST_LAYER)
+				inLastLayer = false;
+		}
+	}
+	TBTKAssert(
+		inFirstLayer || inLastLayer,
+		"Solver::Transport::getLeadLayer()",
+		"Found a lead that is not attached to the first or last"
+		<< " layer.",
+		"The RecursiveGreensFunction method requires all leads to be"
+		<< " attached to the first and/or the last layer."
+	);
+
+	if(inFirstLayer)
+		return 0;
+	else
+		return LAST_LAYER;
+}
+
+void Transport::calculateTransmissionRatesRecursively(){
+	setupLayers();
+
+	Timer::tick("Calculate transmission rates recursively");
+	const Model &model = getModel();
+	const unsigned int NUM_LAYERS = layerStates.size();
+	const unsigned int LAST_LAYER = NUM_LAYERS - 1;
+	const unsigned int NUM_LEADS = leads.size();
+	const unsigned int NUM_ENERGIES = energyRange.getResolution();
+
+	//Setup the lookup from the lead self-energies to the blocks of the
+	//first and last layers.
+	class LeadElement{
+	public:
+		unsigned int row;
+		unsigned int column;
+		unsigned int offset;
+	};
+	vector<unsigned int> leadLayers;
+	vector<vector<LeadElement>> leadElements(NUM_LEADS);
+	for(unsigned int lead = 0; lead < NUM_LEADS; lead++){
+		const Property::SelfEnergy &selfEnergy = leads[lead].selfEnergy;
+		TBTKAssert(
+			selfEnergy.getResolution() == NUM_ENERGIES,
+			"Solver::Transport::calculateTransmissionRatesRecursively()",
+			"One of the lead self-energies has a different energy"
+			<< " resolution than the energy window.",
+			""
+		);
+		leadLayers.push_back(getLeadLayer(leads[lead]));
+		for(auto index : selfEnergy.getIndexDescriptor().getIndexTree()){
+			vector<Index> components = index.split();
+			leadElements[lead].push_back({
+				statePositions[
+					model.getBasisIndex(components[0])
+				],
+				statePositions[
+					model.getBasisIndex(components[1])
+				],
+				(unsigned int)selfEnergy.getOffset(index)
+			});
+		}
+	}
+
+	transmissionRates.assign(NUM_ENERGIES*NUM_LEADS*NUM_LEADS, 0);
+	#pragma omp parallel for schedule(dynamic)
+	for(unsigned int energy = 0; energy < NUM_ENERGIES; energy++){
+		const complex<double> z(
+			energyRange[energy],
+			energyInfinitesimal
+		);
+
+		//Self-energies and broadenings of the leads.
+		vector<Matrix<complex<double>>> selfEnergies;
+		vector<Matrix<complex<double>>> broadenings;
+		for(unsigned int lead = 0; lead < NUM_LEADS; lead++){
+			const unsigned int SIZE
+				= layerStates[leadLayers[lead]].size();
+			selfEnergies.push_back(
+				Matrix<complex<double>>(SIZE, SIZE)
+			);
+			Matrix<complex<double>> &selfEnergy
+				= selfEnergies.back();
+			for(unsigned int n = 0; n < SIZE*SIZE; n++)
+				selfEnergy.at(n%SIZE, n/SIZE) = 0;
+			const vector<complex<double>> &data
+				= leads[lead].selfEnergy.getData();
+			for(auto &element : leadElements[lead]){
+				selfEnergy.at(element.row, element.column)
+					+= data[element.offset + energy];
+			}
+
+			broadenings.push_back(
+				Matrix<complex<double>>(SIZE, SIZE)
+			);
+			for(unsigned int row = 0; row < SIZE; row++){
+				for(unsigned int column = 0; column < SIZE; column++){
+					broadenings.back().at(row, column)
+						= complex<double>(0, 1)*(
+							selfEnergy.at(
+								row,
+								column
+							) - conj(
+								selfEnergy.at(
+									column,
+									row
+								)
+							)
+						);
+				}
+			}
+		}
+
+		//Calculates (z - H_{l,l} - Sigma_l - coupling)^{-1}, where
+		//Sigma_l is the self-energy of the leads attached to the given
+		//layer.
+		auto invertLayer = [&](
+			unsigned int layer,
+			const Matrix<complex<double>> *coupling
+		){
+			const unsigned int SIZE = layerStates[layer].size();
+			Matrix<complex<double>> result(SIZE, SIZE);
+			for(unsigned int row = 0; row < SIZE; row++){
+				for(unsigned int column = 0; column < SIZE; column++){
+					result.at(row, column)
+						= -diagonalBlocks[layer].at(
+							row,
+							column
+						);
+					if(coupling != nullptr){
+						result.at(row, column)
+							-= coupling->at(
+								row,
+								column
+							);
+					}
+				}
+				result.at(row, row) += z;
+			}
+			for(unsigned int lead = 0; lead < NUM_LEADS; lead++){
+				if(leadLayers[lead] != layer)
+					continue;
+
+				for(unsigned int n = 0; n < SIZE*SIZE; n++){
+					result.at(n%SIZE, n/SIZE)
+						-= selfEnergies[lead].at(
+							n%SIZE,
+							n/SIZE
+						);
+				}
+			}
+			result.invert();
+
+			return result;
+		};
+
+		//Sweep from the first to the last layer. The left-connected
+		//Green's function of the last layer is the full G_{N,N}, and
+		//G_{1,N} and G_{N,1} are accumulated along the way.
+		Matrix<complex<double>> g = invertLayer(0, nullptr);
+		Matrix<complex<double>> G_1N = g;
+		Matrix<complex<double>> G_N1 = g;
+		for(unsigned int layer = 1; layer < NUM_LAYERS; layer++){
+			Matrix<complex<double>> coupling
+				= lowerBlocks[layer-1]*g*upperBlocks[layer-1];
+			g = invertLayer(layer, &coupling);
+			G_1N = G_1N*upperBlocks[layer-1]*g;
+			G_N1 = g*lowerBlocks[layer-1]*G_N1;
+		}
+		Matrix<complex<double>> G_NN = g;
+
+		//Sweep from the last to the first layer to obtain G_{1,1}.
+		g = invertLayer(LAST_LAYER, nullptr);
+		for(int layer = LAST_LAYER - 1; layer >= 0; layer--){
+			Matrix<complex<double>> coupling
+				= upperBlocks[layer]*g*lowerBlocks[layer];
+			g = invertLayer(layer, &coupling);
+		}
+		Matrix<complex<double>> G_11 = g;
+
+		//T_{ij} = Tr[Gamma_i G_{ij} Gamma_j G_{ij}^{\dagger}].
+		for(unsigned int lead0 = 0; lead0 < NUM_LEADS; lead0++){
+			for(unsigned int lead1 = 0; lead1 < NUM_LEADS; lead1++){
+				const Matrix<complex<double>> *G;
+				if(leadLayers[lead0] == 0){
+					if(leadLayers[lead1] == 0)
+						G = &G_11;
+					else
+						G = &G_1N;
+				}
+				else{
+					if(leadLayers[lead1] == 0)
+						G = &G_N1;
+					else
+						G = &G_NN;
+				}
+
+				Matrix<complex<double>> GDagger(
+					G->getNumCols(),
+					G->getNumRows()
+				);
+				for(unsigned int row = 0; row < G->getNumRows(); row++){
+					for(
+						unsigned int column = 0;
+						column < G->getNumCols();
+						column++
+					){
+						GDagger.at(column, row)
+							= conj(G->at(row, column));
+					}
+				}
+				Matrix<complex<double>> product
+					= broadenings[lead0]*(*G)
+						*broadenings[lead1]*GDagger;
+				complex<double> trace = 0;
+				for(unsigned int n = 0; n < product.getNumRows(); n++)
+					trace += product.at(n, n);
+
+				transmissionRates[
+					(NUM_LEADS*energy + lead0)*NUM_LEADS
+					+ lead1
+				] = real(trace);
+			}
+		}
+	}
+	Timer::tock();
+}
+
+void Transport::calculateLandauerButtikerCurrents(){
+	Timer::tick("Calculate Landauer-Buttiker currents");
+	double hbar = UnitHandler::getConstantInNaturalUnits("hbar");
+	double e = UnitHandler::getConstantInNaturalUnits("e");
+	const unsigned int NUM_LEADS = leads.size();
+	for(unsigned int lead0 = 0; lead0 < NUM_LEADS; lead0++){
+		Lead &lead = leads[lead0];
+		lead.energyResolvedCurrent
+			= Property::EnergyResolvedProperty<double>(energyRange);
+		for(
+			unsigned int energy = 0;
+			energy < energyRange.getResolution();
+			energy++
+		){
+			double f0 = Functions::fermiDiracDistribution(
+				energyRange[energy],
+				lead.chemicalPotential,
+				lead.temperature
+			);
+			for(unsigned int lead1 = 0; lead1 < NUM_LEADS; lead1++){
+				if(lead1 == lead0)
+					continue;
+
+				double f1 = Functions::fermiDiracDistribution(
+					energyRange[energy],
+					leads[lead1].chemicalPotential,
+					leads[lead1].temperature
+				);
+				lead.energyResolvedCurrent(energy)
+					+= transmissionRates[
+						(NUM_LEADS*energy + lead0)
+						*NUM_LEADS + lead1
+					]*(f0 - f1)*e/(2*M_PI*hbar);
+			}
+		}
+	}
+	Timer::tock();
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
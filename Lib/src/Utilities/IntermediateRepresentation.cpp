@@ -0,0 +1,910 @@
+/* Copyright 2020 Kristofer Björnson
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file IntermediateRepresentation.cpp
+ *
+ *  @author Kristofer Björnson
+ */
+
+#include "TBTK/IntermediateRepresentation.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+extern "C" {
+	void dgesvd_(
+		char *jobu,		//'S' = Calculate the first min(m, n) columns of u
+		char *jobvt,		//'S' = Calculate the first min(m, n) rows of vt
+		int *m,			//Number of rows
+		int *n,			//Number of columns
+		double *a,		//Input matrix, overwritten
+		int *lda,		//Leading dimension of a
+		double *s,		//Singular values in descending order
+		double *u,		//Left singular vectors
+		int *ldu,		//Leading dimension of u
+		double *vt,		//Right singular vectors (transposed)
+		int *ldvt,		//Leading dimension of vt
+		double *work,		//Workspace
+		int *lwork,		//Workspace size, -1 = workspace query
+		int *info		//0 = successful, <0 = -info value was illegal, >0 = did not converge.
+	);
+	void dgeqp3_(
+		int *m,			//Number of rows
+		int *n,			//Number of columns
+		double *a,		//Input matrix, overwritten
+		int *lda,		//Leading dimension of a
+		int *jpvt,		//Column pivots (one-based)
+		double *tau,		//Scalar factors of the reflectors
+		double *work,		//Workspace
+		int *lwork,		//Workspace size, -1 = workspace query
+		int *info		//0 = successful, <0 = -info value was illegal.
+	);
+	void zgeqp3_(
+		int *m,			//Number of rows
+		int *n,			//Number of columns
+		complex<double> *a,	//Input matrix, overwritten
+		int *lda,		//Leading dimension of a
+		int *jpvt,		//Column pivots (one-based)
+		complex<double> *tau,	//Scalar factors of the reflectors
+		complex<double> *work,	//Workspace
+		int *lwork,		//Workspace size, -1 = workspace query
+		double *rwork,		//Workspace of size 2*n
+		int *info		//0 = successful, <0 = -info value was illegal.
+	);
+	void zgetrf_(
+		int *m,			//Number of rows
+		int *n,			//Number of columns
+		complex<double> *a,	//Input matrix, overwritten by the LU factors
+		int *lda,		//Leading dimension of a
+		int *ipiv,		//Pivot indices
+		int *info		//0 = successful, <0 = -info value was illegal, >0 = singular matrix.
+	);
+	void zgetrs_(
+		char *trans,		//'N' = Solve AX = B
+		int *n,			//Matrix size
+		int *nrhs,		//Number of right hand sides
+		complex<double> *a,	//LU factors from zgetrf
+		int *lda,		//Leading dimension of a
+		int *ipiv,		//Pivot indices from zgetrf
+		complex<double> *b,	//Right hand sides, overwritten by the solution
+		int *ldb,		//Leading dimension of b
+		int *info		//0 = successful, <0 = -info value was illegal.
+	);
+	void zgemm_(
+		char *transa,		//'N' = Use A
+		char *transb,		//'N' = Use B
+		int *m,			//Number of rows in C
+		int *n,			//Number of columns in C
+		int *k,			//Inner dimension
+		complex<double> *alpha,	//Prefactor for AB
+		const complex<double> *a,	//Matrix A
+		int *lda,		//Leading dimension of a
+		const complex<double> *b,	//Matrix B
+		int *ldb,		//Leading dimension of b
+		complex<double> *beta,	//Prefactor for C
+		complex<double> *c,	//Matrix C, overwritten by the result
+		int *ldc		//Leading dimension of c
+	);
+}
+
+namespace TBTK{
+
+namespace{
+	//Number of Gauss-Legendre nodes per quadrature segment.
+	const unsigned int NUM_NODES_PER_SEGMENT = 24;
+
+	//Relative tolerance for imaginary times outside of [0, beta].
+	const double IMAGINARY_TIME_TOLERANCE = 1e-12;
+
+	//Calculate the Gauss-Legendre nodes and weights on [-1, 1].
+	void calculateGaussLegendreNodes(
+		unsigned int numNodes,
+		vector<double> &nodes,
+		vector<double> &weights
+	){
+		nodes.resize(numNodes);
+		weights.resize(numNodes);
+		for(unsigned int n = 0; n < (numNodes + 1)/2; n++){
+			double x = cos(M_PI*(n + 0.75)/(numNodes + 0.5));
+			double derivative = 0;
+			for(unsigned int iteration = 0; iteration < 100; iteration++){
+				double p0 = 1;
+				double p1 = 0;
+				for(unsigned int k = 1; k <= numNodes; k++){
+					double p2 = p1;
+					p1 = p0;
+					p0 = ((2*k - 1)*x*p1 - (k - 1)*p2)/k;
+				}
+				derivative = numNodes*(x*p0 - p1)/(x*x - 1);
+				double dx = p0/derivative;
+				x -= dx;
+				if(abs(dx) < 1e-15)
+					break;
+			}
+			nodes[n] = -x;
+			nodes[numNodes - 1 - n] = x;
+			weights[n] = 2/((1 - x*x)*derivative*derivative);
+			weights[numNodes - 1 - n] = weights[n];
+		}
+	}
+
+	//Calculate quadrature nodes and weights on [0, upperBound] using
+	//Gauss-Legendre quadrature on segments that are refined
+	//geometrically towards zero until the smallest segment is smaller
+	//than the given resolution.
+	void calculateQuadrature(
+		double upperBound,
+		double resolution,
+		vector<double> &nodes,
+		vector<double> &weights
+	){
+		vector<double> boundaries = {upperBound};
+		while(boundaries.back() > resolution || boundaries.size() < 2)
+			boundaries.push_back(boundaries.back()/2);
+		boundaries.push_back(0);
+		reverse(boundaries.begin(), boundaries.end());
+
+		vector<double> gaussLegendreNodes;
+		vector<double> gaussLegendreWeights;
+		calculateGaussLegendreNodes(
+			NUM_NODES_PER_SEGMENT,
+			gaussLegendreNodes,
+			gaussLegendreWeights
+		);
+
+		nodes.clear();
+		weights.clear();
+		for(unsigned int s = 0; s + 1 < boundaries.size(); s++){
+			double center = (boundaries[s + 1] + boundaries[s])/2;
+			double halfWidth = (boundaries[s + 1] - boundaries[s])/2;
+			for(unsigned int n = 0; n < NUM_NODES_PER_SEGMENT; n++){
+				nodes.push_back(
+					center + halfWidth*gaussLegendreNodes[n]
+				);
+				weights.push_back(halfWidth*gaussLegendreWeights[n]);
+			}
+		}
+	}
+};
+
+IntermediateRepresentation::IntermediateRepresentation(
+	Statistics statistics,
+	double fundamentalMatsubaraEnergy,
+	double energyCutoff,
+	double tolerance
+){
+	TBTKAssert(
+		fundamentalMatsubaraEnergy > 0,
+		"IntermediateRepresentation::IntermediateRepresentation()",
+		"The fundamental Matsubara energy must be positive.",
+		""
+	);
+	TBTKAssert(
+		energyCutoff > 0,
+		"IntermediateRepresentation::IntermediateRepresentation()",
+		"The energy cutoff must be positive.",
+		""
+	);
+	TBTKAssert(
+		tolerance > 0 && tolerance < 1,
+		"IntermediateRepresentation::IntermediateRepresentation()",
+		"The tolerance must be in the interval (0, 1).",
+		""
+	);
+
+	this->statistics = statistics;
+	beta = M_PI/fundamentalMatsubaraEnergy;
+	this->energyCutoff = energyCutoff;
+
+	//Quadrature for the imaginary time, refined towards both ends of the
+	//interval on the scale 1/energyCutoff.
+	vector<double> halfNodes;
+	vector<double> halfWeights;
+	calculateQuadrature(beta/2, 0.1/energyCutoff, halfNodes, halfWeights);
+	vector<double> imaginaryTimeNodes = halfNodes;
+	vector<double> imaginaryTimeWeights = halfWeights;
+	for(unsigned int n = halfNodes.size(); n-- > 0;){
+		imaginaryTimeNodes.push_back(beta - halfNodes[n]);
+		imaginaryTimeWeights.push_back(halfWeights[n]);
+	}
+
+	//Quadrature for the energy, refined towards zero on the scale 1/beta.
+	calculateQuadrature(energyCutoff, 0.1/beta, halfNodes, halfWeights);
+	energyNodes.clear();
+	vector<double> energyWeights;
+	for(unsigned int n = halfNodes.size(); n-- > 0;){
+		energyNodes.push_back(-halfNodes[n]);
+		energyWeights.push_back(halfWeights[n]);
+	}
+	for(unsigned int n = 0; n < halfNodes.size(); n++){
+		energyNodes.push_back(halfNodes[n]);
+		energyWeights.push_back(halfWeights[n]);
+	}
+
+	//Singular value decomposition of the kernel.
+	int numRows = imaginaryTimeNodes.size();
+	int numColumns = energyNodes.size();
+	int numSingularValues = min(numRows, numColumns);
+	vector<double> kernel(numRows*numColumns);
+	for(int col = 0; col < numColumns; col++){
+		for(int row = 0; row < numRows; row++){
+			kernel[row + numRows*col] = sqrt(
+				imaginaryTimeWeights[row]*energyWeights[col]
+			)*calculateKernel(
+				imaginaryTimeNodes[row],
+				energyNodes[col]
+			);
+		}
+	}
+
+	vector<double> allSingularValues(numSingularValues);
+	vector<double> u(numRows*numSingularValues);
+	vector<double> vt(numSingularValues*numColumns);
+	char job = 'S';
+	int lwork = -1;
+	double workSize;
+	int info;
+	dgesvd_(
+		&job,
+		&job,
+		&numRows,
+		&numColumns,
+		kernel.data(),
+		&numRows,
+		allSingularValues.data(),
+		u.data(),
+		&numRows,
+		vt.data(),
+		&numSingularValues,
+		&workSize,
+		&lwork,
+		&info
+	);
+	lwork = (int)workSize;
+	vector<double> work(lwork);
+	dgesvd_(
+		&job,
+		&job,
+		&numRows,
+		&numColumns,
+		kernel.data(),
+		&numRows,
+		allSingularValues.data(),
+		u.data(),
+		&numRows,
+		vt.data(),
+		&numSingularValues,
+		work.data(),
+		&lwork,
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"IntermediateRepresentation::IntermediateRepresentation()",
+		"The singular value decomposition failed with error code '"
+		<< info << "'.",
+		"This should never happen, contact the developer."
+	);
+
+	singularValues.clear();
+	for(int n = 0; n < numSingularValues; n++){
+		if(allSingularValues[n] <= tolerance*allSingularValues[0])
+			break;
+		singularValues.push_back(allSingularValues[n]);
+	}
+
+	const unsigned int NUM_BASIS_FUNCTIONS = singularValues.size();
+	weightedRightSingularFunctions.resize(numColumns*NUM_BASIS_FUNCTIONS);
+	for(unsigned int l = 0; l < NUM_BASIS_FUNCTIONS; l++){
+		for(int n = 0; n < numColumns; n++){
+			weightedRightSingularFunctions[n + numColumns*l]
+				= sqrt(energyWeights[n])
+				*vt[l + numSingularValues*n]/singularValues[l];
+		}
+	}
+
+	vector<double> leftSingularFunctions(NUM_BASIS_FUNCTIONS*numRows);
+	for(int n = 0; n < numRows; n++){
+		for(unsigned int l = 0; l < NUM_BASIS_FUNCTIONS; l++){
+			leftSingularFunctions[l + NUM_BASIS_FUNCTIONS*n]
+				= u[n + numRows*l]/sqrt(imaginaryTimeWeights[n]);
+		}
+	}
+
+	setupImaginaryTimeSamplingPoints(
+		imaginaryTimeNodes,
+		leftSingularFunctions
+	);
+	setupMatsubaraSamplingPoints();
+}
+
+double IntermediateRepresentation::evaluateImaginaryTimeBasisFunction(
+	unsigned int basisFunction,
+	double imaginaryTime
+) const{
+	TBTKAssert(
+		basisFunction < singularValues.size(),
+		"IntermediateRepresentation::evaluateImaginaryTimeBasisFunction()",
+		"The basis function '" << basisFunction << "' is out of range"
+		<< " [0, " << singularValues.size() << ").",
+		""
+	);
+	TBTKAssert(
+		imaginaryTime >= -IMAGINARY_TIME_TOLERANCE*beta
+		&& imaginaryTime <= (1 + IMAGINARY_TIME_TOLERANCE)*beta,
+		"IntermediateRepresentation::evaluateImaginaryTimeBasisFunction()",
+		"The imaginary time '" << imaginaryTime << "' is out of range"
+		<< " [0, " << beta << "].",
+		""
+	);
+
+	const double *rightSingularFunction
+		= &weightedRightSingularFunctions[
+			energyNodes.size()*basisFunction
+		];
+	double result = 0;
+	for(unsigned int n = 0; n < energyNodes.size(); n++){
+		result += calculateKernel(imaginaryTime, energyNodes[n])
+			*rightSingularFunction[n];
+	}
+
+	return result;
+}
+
+complex<double> IntermediateRepresentation::evaluateMatsubaraBasisFunction(
+	unsigned int basisFunction,
+	int matsubaraEnergyIndex
+) const{
+	TBTKAssert(
+		basisFunction < singularValues.size(),
+		"IntermediateRepresentation::evaluateMatsubaraBasisFunction()",
+		"The basis function '" << basisFunction << "' is out of range"
+		<< " [0, " << singularValues.size() << ").",
+		""
+	);
+	TBTKAssert(
+		abs(matsubaraEnergyIndex)%2
+			== (statistics == Statistics::FermiDirac ? 1 : 0),
+		"IntermediateRepresentation::evaluateMatsubaraBasisFunction()",
+		"Invalid Matsubara energy index '" << matsubaraEnergyIndex
+		<< "'. The index must be odd for Fermions and even for"
+		<< " Bosons.",
+		""
+	);
+
+	const double *rightSingularFunction
+		= &weightedRightSingularFunctions[
+			energyNodes.size()*basisFunction
+		];
+	complex<double> result = 0;
+	for(unsigned int n = 0; n < energyNodes.size(); n++){
+		result += calculateKernel(matsubaraEnergyIndex, energyNodes[n])
+			*rightSingularFunction[n];
+	}
+
+	return result;
+}
+
+vector<complex<double>> IntermediateRepresentation::fitMatsubara(
+	const vector<complex<double>> &values
+) const{
+	return solveFittingProblem(
+		matsubaraFittingMatrix,
+		matsubaraPivots,
+		values
+	);
+}
+
+vector<complex<double>> IntermediateRepresentation::fitImaginaryTime(
+	const vector<complex<double>> &values
+) const{
+	return solveFittingProblem(
+		imaginaryTimeFittingMatrix,
+		imaginaryTimePivots,
+		values
+	);
+}
+
+vector<complex<double>> IntermediateRepresentation::evaluateMatsubara(
+	const vector<complex<double>> &coefficients,
+	const vector<int> &matsubaraEnergyIndices
+) const{
+	const unsigned int NUM_ARGUMENTS = matsubaraEnergyIndices.size();
+	vector<complex<double>> basisFunctionValues(
+		NUM_ARGUMENTS*singularValues.size()
+	);
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < NUM_ARGUMENTS; n++){
+		for(unsigned int l = 0; l < singularValues.size(); l++){
+			basisFunctionValues[n + NUM_ARGUMENTS*l]
+				= evaluateMatsubaraBasisFunction(
+					l,
+					matsubaraEnergyIndices[n]
+				);
+		}
+	}
+
+	return multiplyCoefficients(
+		basisFunctionValues,
+		NUM_ARGUMENTS,
+		coefficients
+	);
+}
+
+vector<complex<double>> IntermediateRepresentation::evaluateImaginaryTime(
+	const vector<complex<double>> &coefficients,
+	const vector<double> &imaginaryTimes
+) const{
+	const unsigned int NUM_ARGUMENTS = imaginaryTimes.size();
+	vector<complex<double>> basisFunctionValues(
+		NUM_ARGUMENTS*singularValues.size()
+	);
+	#pragma omp parallel for
+	for(unsigned int n = 0; n < NUM_ARGUMENTS; n++){
+		for(unsigned int l = 0; l < singularValues.size(); l++){
+			basisFunctionValues[n + NUM_ARGUMENTS*l]
+				= evaluateImaginaryTimeBasisFunction(
+					l,
+					imaginaryTimes[n]
+				);
+		}
+	}
+
+	return multiplyCoefficients(
+		basisFunctionValues,
+		NUM_ARGUMENTS,
+		coefficients
+	);
+}
+
+vector<complex<double>> IntermediateRepresentation::fit(
+	const Property::EnergyResolvedProperty<complex<double>> &property
+) const{
+	typedef Property::EnergyResolvedProperty<complex<double>>::EnergyType
+		EnergyType;
+
+	TBTKAssert(
+		property.getEnergyType() == (
+			statistics == Statistics::FermiDirac
+			? EnergyType::FermionicMatsubara
+			: EnergyType::BosonicMatsubara
+		),
+		"IntermediateRepresentation::fit()",
+		"The energy type of the Property is incompatible with the"
+		<< " statistics of the IntermediateRepresentation.",
+		""
+	);
+	TBTKAssert(
+		abs(property.getFundamentalMatsubaraEnergy()*beta/M_PI - 1)
+			< 1e-10,
+		"IntermediateRepresentation::fit()",
+		"The fundamental Matsubara energy of the Property is"
+		<< " incompatible with the IntermediateRepresentation.",
+		""
+	);
+
+	const int LOWER_INDEX = property.getLowerMatsubaraEnergyIndex();
+	const unsigned int NUM_ENERGIES = property.getNumMatsubaraEnergies();
+	const vector<complex<double>> &data = property.getData();
+	const unsigned int NUM_BLOCKS = data.size()/NUM_ENERGIES;
+	const unsigned int NUM_SAMPLES = matsubaraSamplingPoints.size();
+
+	vector<unsigned int> energies;
+	for(unsigned int n = 0; n < NUM_SAMPLES; n++){
+		int energy = (matsubaraSamplingPoints[n] - LOWER_INDEX)/2;
+		TBTKAssert(
+			energy >= 0 && energy < (int)NUM_ENERGIES,
+			"IntermediateRepresentation::fit()",
+			"The Matsubara sampling point '"
+			<< matsubaraSamplingPoints[n] << "' is outside the"
+			<< " energy window [" << LOWER_INDEX << ", "
+			<< property.getUpperMatsubaraEnergyIndex() << "] of"
+			<< " the Property.",
+			"Increase the energy window of the Property or"
+			<< " decrease the energy cutoff of the"
+			<< " IntermediateRepresentation."
+		);
+		energies.push_back(energy);
+	}
+
+	vector<complex<double>> values(NUM_SAMPLES*NUM_BLOCKS);
+	for(unsigned int block = 0; block < NUM_BLOCKS; block++){
+		for(unsigned int n = 0; n < NUM_SAMPLES; n++){
+			values[n + NUM_SAMPLES*block]
+				= data[energies[n] + NUM_ENERGIES*block];
+		}
+	}
+
+	return fitMatsubara(values);
+}
+
+void IntermediateRepresentation::evaluate(
+	const vector<complex<double>> &coefficients,
+	Property::EnergyResolvedProperty<complex<double>> &property
+) const{
+	typedef Property::EnergyResolvedProperty<complex<double>>::EnergyType
+		EnergyType;
+
+	TBTKAssert(
+		property.getEnergyType() == (
+			statistics == Statistics::FermiDirac
+			? EnergyType::FermionicMatsubara
+			: EnergyType::BosonicMatsubara
+		),
+		"IntermediateRepresentation::evaluate()",
+		"The energy type of the Property is incompatible with the"
+		<< " statistics of the IntermediateRepresentation.",
+		""
+	);
+	TBTKAssert(
+		abs(property.getFundamentalMatsubaraEnergy()*beta/M_PI - 1)
+			< 1e-10,
+		"IntermediateRepresentation::evaluate()",
+		"The fundamental Matsubara energy of the Property is"
+		<< " incompatible with the IntermediateRepresentation.",
+		""
+	);
+
+	vector<complex<double>> &data = property.getDataRW();
+	const unsigned int NUM_ENERGIES = property.getNumMatsubaraEnergies();
+	TBTKAssert(
+		coefficients.size()*NUM_ENERGIES
+			== data.size()*singularValues.size(),
+		"IntermediateRepresentation::evaluate()",
+		"The number of coefficients is incompatible with the number"
+		<< " of blocks in the Property.",
+		""
+	);
+
+	vector<int> matsubaraEnergyIndices;
+	for(unsigned int n = 0; n < NUM_ENERGIES; n++){
+		matsubaraEnergyIndices.push_back(
+			property.getLowerMatsubaraEnergyIndex() + 2*n
+		);
+	}
+
+	data = evaluateMatsubara(coefficients, matsubaraEnergyIndices);
+}
+
+double IntermediateRepresentation::calculateKernel(
+	double imaginaryTime,
+	double energy
+) const{
+	switch(statistics){
+	case Statistics::FermiDirac:
+		if(energy >= 0){
+			return -exp(-imaginaryTime*energy)
+				/(1 + exp(-beta*energy));
+		}
+		else{
+			return -exp((beta - imaginaryTime)*energy)
+				/(1 + exp(beta*energy));
+		}
+	case Statistics::BoseEinstein:
+		if(energy > 0){
+			return -energy*exp(-imaginaryTime*energy)
+				/(-expm1(-beta*energy));
+		}
+		else if(energy < 0){
+			return -energy*exp((beta - imaginaryTime)*energy)
+				/expm1(beta*energy);
+		}
+		else{
+			return -1/beta;
+		}
+	default:
+		TBTKExit(
+			"IntermediateRepresentation::calculateKernel()",
+			"Unknown statistics.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+complex<double> IntermediateRepresentation::calculateKernel(
+	int matsubaraEnergyIndex,
+	double energy
+) const{
+	complex<double> matsubaraEnergy(0, matsubaraEnergyIndex*M_PI/beta);
+	switch(statistics){
+	case Statistics::FermiDirac:
+		return 1./(matsubaraEnergy - energy);
+	case Statistics::BoseEinstein:
+		if(matsubaraEnergyIndex == 0)
+			return -1;
+		else
+			return energy/(matsubaraEnergy - energy);
+	default:
+		TBTKExit(
+			"IntermediateRepresentation::calculateKernel()",
+			"Unknown statistics.",
+			"This should never happen, contact the developer."
+		);
+	}
+}
+
+void IntermediateRepresentation::setupMatsubaraSamplingPoints(){
+	const unsigned int NUM_BASIS_FUNCTIONS = singularValues.size();
+	const int OFFSET = (statistics == Statistics::FermiDirac ? 1 : 0);
+
+	//All Matsubara energies are candidates up to a multiple of the number
+	//of basis functions, after which the candidates are spaced
+	//logarithmically up to ten times the energy cutoff.
+	int maxIndex = max(
+		(int)(10*energyCutoff*beta/M_PI),
+		(int)(8*NUM_BASIS_FUNCTIONS)
+	);
+	vector<int> candidates;
+	for(int n = 0; 2*n + OFFSET <= maxIndex;){
+		candidates.push_back(2*n + OFFSET);
+		candidates.push_back(-2*n - OFFSET);
+		if(n < (int)(4*NUM_BASIS_FUNCTIONS))
+			n++;
+		else
+			n = max(n + 1, (int)(1.05*n));
+	}
+	if(OFFSET == 0)
+		candidates.erase(candidates.begin() + 1);
+
+	//Select the sampling points using QR factorization with column
+	//pivoting.
+	int numRows = NUM_BASIS_FUNCTIONS;
+	int numColumns = candidates.size();
+	vector<complex<double>> matrix(numRows*numColumns);
+	#pragma omp parallel for
+	for(int col = 0; col < numColumns; col++){
+		for(int row = 0; row < numRows; row++){
+			matrix[row + numRows*col]
+				= evaluateMatsubaraBasisFunction(
+					row,
+					candidates[col]
+				);
+		}
+	}
+
+	vector<int> columnPivots(numColumns, 0);
+	vector<complex<double>> tau(min(numRows, numColumns));
+	vector<double> rwork(2*numColumns);
+	int lwork = -1;
+	complex<double> workSize;
+	int info;
+	zgeqp3_(
+		&numRows,
+		&numColumns,
+		matrix.data(),
+		&numRows,
+		columnPivots.data(),
+		tau.data(),
+		&workSize,
+		&lwork,
+		rwork.data(),
+		&info
+	);
+	lwork = (int)real(workSize);
+	vector<complex<double>> work(lwork);
+	zgeqp3_(
+		&numRows,
+		&numColumns,
+		matrix.data(),
+		&numRows,
+		columnPivots.data(),
+		tau.data(),
+		work.data(),
+		&lwork,
+		rwork.data(),
+		&info
+	);
+
+	matsubaraSamplingPoints.clear();
+	for(unsigned int n = 0; n < NUM_BASIS_FUNCTIONS; n++)
+		matsubaraSamplingPoints.push_back(
+			candidates[columnPivots[n] - 1]
+		);
+	sort(matsubaraSamplingPoints.begin(), matsubaraSamplingPoints.end());
+
+	//Setup the fitting matrix.
+	matsubaraFittingMatrix.resize(
+		NUM_BASIS_FUNCTIONS*NUM_BASIS_FUNCTIONS
+	);
+	for(unsigned int l = 0; l < NUM_BASIS_FUNCTIONS; l++){
+		for(unsigned int n = 0; n < NUM_BASIS_FUNCTIONS; n++){
+			matsubaraFittingMatrix[n + NUM_BASIS_FUNCTIONS*l]
+				= evaluateMatsubaraBasisFunction(
+					l,
+					matsubaraSamplingPoints[n]
+				);
+		}
+	}
+	matsubaraPivots.resize(NUM_BASIS_FUNCTIONS);
+	zgetrf_(
+		&numRows,
+		&numRows,
+		matsubaraFittingMatrix.data(),
+		&numRows,
+		matsubaraPivots.data(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"IntermediateRepresentation::setupMatsubaraSamplingPoints()",
+		"The Matsubara fitting matrix is singular.",
+		"This should never happen, contact the developer."
+	);
+}
+
+void IntermediateRepresentation::setupImaginaryTimeSamplingPoints(
+	const vector<double> &imaginaryTimeNodes,
+	const vector<double> &leftSingularFunctions
+){
+	const unsigned int NUM_BASIS_FUNCTIONS = singularValues.size();
+
+	//Select the sampling points using QR factorization with column
+	//pivoting.
+	int numRows = NUM_BASIS_FUNCTIONS;
+	int numColumns = imaginaryTimeNodes.size();
+	vector<double> matrix = leftSingularFunctions;
+	vector<int> columnPivots(numColumns, 0);
+	vector<double> tau(min(numRows, numColumns));
+	int lwork = -1;
+	double workSize;
+	int info;
+	dgeqp3_(
+		&numRows,
+		&numColumns,
+		matrix.data(),
+		&numRows,
+		columnPivots.data(),
+		tau.data(),
+		&workSize,
+		&lwork,
+		&info
+	);
+	lwork = (int)workSize;
+	vector<double> work(lwork);
+	dgeqp3_(
+		&numRows,
+		&numColumns,
+		matrix.data(),
+		&numRows,
+		columnPivots.data(),
+		tau.data(),
+		work.data(),
+		&lwork,
+		&info
+	);
+
+	imaginaryTimeSamplingPoints.clear();
+	for(unsigned int n = 0; n < NUM_BASIS_FUNCTIONS; n++){
+		imaginaryTimeSamplingPoints.push_back(
+			imaginaryTimeNodes[columnPivots[n] - 1]
+		);
+	}
+	sort(
+		imaginaryTimeSamplingPoints.begin(),
+		imaginaryTimeSamplingPoints.end()
+	);
+
+	//Setup the fitting matrix.
+	imaginaryTimeFittingMatrix.resize(
+		NUM_BASIS_FUNCTIONS*NUM_BASIS_FUNCTIONS
+	);
+	for(unsigned int l = 0; l < NUM_BASIS_FUNCTIONS; l++){
+		for(unsigned int n = 0; n < NUM_BASIS_FUNCTIONS; n++){
+			imaginaryTimeFittingMatrix[n + NUM_BASIS_FUNCTIONS*l]
+				= evaluateImaginaryTimeBasisFunction(
+					l,
+					imaginaryTimeSamplingPoints[n]
+				);
+		}
+	}
+	imaginaryTimePivots.resize(NUM_BASIS_FUNCTIONS);
+	zgetrf_(
+		&numRows,
+		&numRows,
+		imaginaryTimeFittingMatrix.data(),
+		&numRows,
+		imaginaryTimePivots.data(),
+		&info
+	);
+	TBTKAssert(
+		info == 0,
+		"IntermediateRepresentation::setupImaginaryTimeSamplingPoints()",
+		"The imaginary time fitting matrix is singular.",
+		"This should never happen, contact the developer."
+	);
+}
+
+vector<complex<double>> IntermediateRepresentation::solveFittingProblem(
+	const vector<complex<double>> &fittingMatrix,
+	const vector<int> &pivots,
+	const vector<complex<double>> &values
+) const{
+	int numSamples = singularValues.size();
+	TBTKAssert(
+		values.size()%numSamples == 0,
+		"IntermediateRepresentation::fit()",
+		"The number of values '" << values.size() << "' is not a"
+		<< " multiple of the number of sampling points '"
+		<< numSamples << "'.",
+		""
+	);
+
+	vector<complex<double>> coefficients = values;
+	vector<complex<double>> matrix = fittingMatrix;
+	vector<int> ipiv = pivots;
+	int numRightHandSides = values.size()/numSamples;
+	char trans = 'N';
+	int info;
+	zgetrs_(
+		&trans,
+		&numSamples,
+		&numRightHandSides,
+		matrix.data(),
+		&numSamples,
+		ipiv.data(),
+		coefficients.data(),
+		&numSamples,
+		&info
+	);
+
+	return coefficients;
+}
+
+vector<complex<double>> IntermediateRepresentation::multiplyCoefficients(
+	const vector<complex<double>> &basisFunctionValues,
+	unsigned int numArguments,
+	const vector<complex<double>> &coefficients
+) const{
+	int numBasisFunctions = singularValues.size();
+	TBTKAssert(
+		coefficients.size()%numBasisFunctions == 0,
+		"IntermediateRepresentation::evaluate()",
+		"The number of coefficients '" << coefficients.size() << "' is"
+		<< " not a multiple of the number of basis functions '"
+		<< numBasisFunctions << "'.",
+		""
+	);
+
+	int numRows = numArguments;
+	int numColumns = coefficients.size()/numBasisFunctions;
+	vector<complex<double>> result(numRows*numColumns);
+	if(result.size() == 0)
+		return result;
+
+	char trans = 'N';
+	complex<double> alpha = 1;
+	complex<double> zero = 0;
+	zgemm_(
+		&trans,
+		&trans,
+		&numRows,
+		&numColumns,
+		&numBasisFunctions,
+		&alpha,
+		basisFunctionValues.data(),
+		&numRows,
+		coefficients.data(),
+		&numBasisFunctions,
+		&zero,
+		result.data(),
+		&numRows
+	);
+
+	return result;
+}
+
+};	//End of namespace TBTK
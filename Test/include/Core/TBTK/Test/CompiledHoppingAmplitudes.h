@@ -0,0 +1,215 @@
+#include "TBTK/CompiledHoppingAmplitudes.h"
+#include "TBTK/HoppingAmplitudeSet.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+
+class CompiledHoppingAmplitudesTest : public ::testing::Test{
+protected:
+	class Callback : public HoppingAmplitude::AmplitudeCallback{
+	public:
+		std::complex<double> getHoppingAmplitude(
+			const Index &to,
+			const Index &from
+		) const{
+			return value;
+		}
+
+		double value;
+	};
+
+	Callback callback;
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+
+	void SetUp() override{
+		callback.value = 7;
+
+		//The HoppingAmplitudes are added out of order and {1} <- {0}
+		//is added twice.
+		hoppingAmplitudeSet.add(HoppingAmplitude(1, {1}, {0}));
+		hoppingAmplitudeSet.add(HoppingAmplitude(2, {0}, {1}));
+		hoppingAmplitudeSet.add(HoppingAmplitude(3, {2}, {2}));
+		hoppingAmplitudeSet.add(HoppingAmplitude(4, {1}, {0}));
+		hoppingAmplitudeSet.add(HoppingAmplitude(callback, {0}, {2}));
+		hoppingAmplitudeSet.add(HoppingAmplitude(5, {0}, {0}));
+		hoppingAmplitudeSet.construct();
+	}
+};
+
+TEST_F(CompiledHoppingAmplitudesTest, Constructor){
+	CompiledHoppingAmplitudes compiledHoppingAmplitudes;
+	EXPECT_EQ(compiledHoppingAmplitudes.getBasisSize(), 0);
+	EXPECT_EQ(compiledHoppingAmplitudes.getNumHoppingAmplitudes(), 0);
+	EXPECT_EQ(compiledHoppingAmplitudes.getRowPointers()[0], 0);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getBasisSize){
+	EXPECT_EQ(
+		hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getBasisSize(),
+		3
+	);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getNumHoppingAmplitudes){
+	EXPECT_EQ(
+		hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getNumHoppingAmplitudes(),
+		6
+	);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getRowPointers){
+	const unsigned int *rowPointers
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getRowPointers();
+	EXPECT_EQ(rowPointers[0], 0);
+	EXPECT_EQ(rowPointers[1], 3);
+	EXPECT_EQ(rowPointers[2], 5);
+	EXPECT_EQ(rowPointers[3], 6);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getToIndices){
+	const unsigned int *toIndices
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getToIndices();
+	unsigned int reference[6] = {0, 0, 0, 1, 1, 2};
+	for(unsigned int n = 0; n < 6; n++)
+		EXPECT_EQ(toIndices[n], reference[n]);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getFromIndices){
+	const unsigned int *fromIndices
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getFromIndices();
+	unsigned int reference[6] = {0, 1, 2, 0, 0, 2};
+	for(unsigned int n = 0; n < 6; n++)
+		EXPECT_EQ(fromIndices[n], reference[n]);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getAmplitudes){
+	const std::complex<double> *amplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getAmplitudes();
+	double reference[6] = {5, 2, 7, 1, 4, 3};
+	for(unsigned int n = 0; n < 6; n++){
+		EXPECT_DOUBLE_EQ(real(amplitudes[n]), reference[n]);
+		EXPECT_DOUBLE_EQ(imag(amplitudes[n]), 0);
+	}
+
+	//Callback dependent amplitudes are not reevaluated on access.
+	callback.value = 8;
+	amplitudes = hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+	).getAmplitudes();
+	EXPECT_DOUBLE_EQ(real(amplitudes[2]), 7);
+
+	//Callback dependent amplitudes are reevaluated on request.
+	hoppingAmplitudeSet.updateCompiledCallbackAmplitudes();
+	EXPECT_DOUBLE_EQ(real(amplitudes[2]), 8);
+
+	//The callback dependent amplitudes are reevaluated also for copies of
+	//the HoppingAmplitudeSet.
+	HoppingAmplitudeSet copy = hoppingAmplitudeSet;
+	callback.value = 9;
+	copy.updateCompiledCallbackAmplitudes();
+	amplitudes = copy.getCompiledHoppingAmplitudes().getAmplitudes();
+	EXPECT_DOUBLE_EQ(real(amplitudes[2]), 9);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getRevision){
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	unsigned long long revision = compiledHoppingAmplitudes.getRevision();
+
+	//Reevaluation of the callback dependent amplitudes does not change the
+	//revision.
+	callback.value = 8;
+	hoppingAmplitudeSet.updateCompiledCallbackAmplitudes();
+	EXPECT_EQ(compiledHoppingAmplitudes.getRevision(), revision);
+
+	//Copies have the same revision.
+	HoppingAmplitudeSet copy = hoppingAmplitudeSet;
+	EXPECT_EQ(copy.getCompiledHoppingAmplitudes().getRevision(), revision);
+
+	//A separately constructed HoppingAmplitudeSet with the same content
+	//has a different revision.
+	HoppingAmplitudeSet hoppingAmplitudeSet1;
+	hoppingAmplitudeSet1.add(HoppingAmplitude(1, {0}, {0}));
+	hoppingAmplitudeSet1.construct();
+	EXPECT_NE(
+		hoppingAmplitudeSet1.getCompiledHoppingAmplitudes(
+		).getRevision(),
+		revision
+	);
+	hoppingAmplitudeSet = hoppingAmplitudeSet1;
+	EXPECT_NE(
+		hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getRevision(),
+		revision
+	);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getNumCallbackDependentElements){
+	EXPECT_EQ(
+		hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getNumCallbackDependentElements(),
+		1
+	);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getCallbackDependentElementRanges){
+	const unsigned int *ranges
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getCallbackDependentElementRanges();
+	EXPECT_EQ(ranges[0], 2);
+	EXPECT_EQ(ranges[1], 3);
+
+	//The ranges cover every entry of a matrix element that has at least
+	//one callback dependent entry.
+	HoppingAmplitudeSet hoppingAmplitudeSet1;
+	hoppingAmplitudeSet1.add(HoppingAmplitude(1, {1}, {0}));
+	hoppingAmplitudeSet1.add(HoppingAmplitude(callback, {0}, {0}));
+	hoppingAmplitudeSet1.add(HoppingAmplitude(callback, {1}, {0}));
+	hoppingAmplitudeSet1.add(HoppingAmplitude(2, {1}, {1}));
+	hoppingAmplitudeSet1.add(HoppingAmplitude(callback, {1}, {0}));
+	hoppingAmplitudeSet1.construct();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet1.getCompiledHoppingAmplitudes();
+	EXPECT_EQ(compiledHoppingAmplitudes.getNumCallbackDependentElements(), 2);
+	ranges = compiledHoppingAmplitudes.getCallbackDependentElementRanges();
+	EXPECT_EQ(ranges[0], 0);
+	EXPECT_EQ(ranges[1], 1);
+	EXPECT_EQ(ranges[2], 1);
+	EXPECT_EQ(ranges[3], 4);
+}
+
+TEST_F(CompiledHoppingAmplitudesTest, getSizeInBytes){
+	EXPECT_TRUE(
+		hoppingAmplitudeSet.getCompiledHoppingAmplitudes(
+		).getSizeInBytes() > 0
+	);
+}
+
+TEST(CompiledHoppingAmplitudes, Serialization){
+	HoppingAmplitudeSet hoppingAmplitudeSet0;
+	hoppingAmplitudeSet0.add(HoppingAmplitude(1, {1}, {0}));
+	hoppingAmplitudeSet0.add(HoppingAmplitude(2, {0}, {1}));
+	hoppingAmplitudeSet0.construct();
+	HoppingAmplitudeSet hoppingAmplitudeSet1(
+		hoppingAmplitudeSet0.serialize(Serializable::Mode::JSON),
+		Serializable::Mode::JSON
+	);
+
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet1.getCompiledHoppingAmplitudes();
+	ASSERT_EQ(compiledHoppingAmplitudes.getNumHoppingAmplitudes(), 2);
+	EXPECT_EQ(compiledHoppingAmplitudes.getToIndices()[0], 0);
+	EXPECT_EQ(compiledHoppingAmplitudes.getFromIndices()[0], 1);
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[0]), 2);
+	EXPECT_EQ(compiledHoppingAmplitudes.getToIndices()[1], 1);
+	EXPECT_EQ(compiledHoppingAmplitudes.getFromIndices()[1], 0);
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[1]), 1);
+}
+
+};
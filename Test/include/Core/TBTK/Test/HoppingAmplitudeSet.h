@@ -2,6 +2,8 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+
 namespace TBTK{
 
 //TODO
@@ -151,6 +153,169 @@ TEST(HoppingAmplitudeSet, add){
 	);
 }
 
+TEST(HoppingAmplitudeSet, addConcurrently){
+	const int SIZE_X = 20;
+	const int SIZE_Y = 10;
+	HoppingAmplitudeSet hoppingAmplitudeSet0;
+	HoppingAmplitudeSet hoppingAmplitudeSet1;
+	for(int x = 0; x < SIZE_X; x++){
+		for(int y = 0; y < SIZE_Y; y++){
+			hoppingAmplitudeSet0.add(
+				HoppingAmplitude(x + y, {x, y}, {x, y})
+			);
+			hoppingAmplitudeSet0.add(
+				HoppingAmplitude(
+					1,
+					{(x+1)%SIZE_X, y},
+					{x, y}
+				)
+			);
+		}
+	}
+	#pragma omp parallel for
+	for(int x = 0; x < SIZE_X; x++){
+		for(int y = 0; y < SIZE_Y; y++){
+			hoppingAmplitudeSet1.addConcurrently(
+				HoppingAmplitude(x + y, {x, y}, {x, y})
+			);
+			hoppingAmplitudeSet1.addConcurrently(
+				HoppingAmplitude(
+					1,
+					{(x+1)%SIZE_X, y},
+					{x, y}
+				)
+			);
+		}
+	}
+	//Mix with serial insertion.
+	hoppingAmplitudeSet0.add(HoppingAmplitude(2, {SIZE_X, 0}, {SIZE_X, 0}));
+	hoppingAmplitudeSet1.add(HoppingAmplitude(2, {SIZE_X, 0}, {SIZE_X, 0}));
+	hoppingAmplitudeSet0.construct();
+	hoppingAmplitudeSet1.construct();
+
+	EXPECT_EQ(
+		hoppingAmplitudeSet1.getBasisSize(),
+		hoppingAmplitudeSet0.getBasisSize()
+	);
+	for(int x = 0; x < SIZE_X; x++){
+		for(int y = 0; y < SIZE_Y; y++){
+			EXPECT_EQ(
+				hoppingAmplitudeSet1.getBasisIndex({x, y}),
+				hoppingAmplitudeSet0.getBasisIndex({x, y})
+			);
+		}
+	}
+
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes0
+		= hoppingAmplitudeSet0.getCompiledHoppingAmplitudes();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes1
+		= hoppingAmplitudeSet1.getCompiledHoppingAmplitudes();
+	ASSERT_EQ(
+		compiledHoppingAmplitudes1.getNumHoppingAmplitudes(),
+		compiledHoppingAmplitudes0.getNumHoppingAmplitudes()
+	);
+	for(
+		unsigned int n = 0;
+		n < compiledHoppingAmplitudes0.getNumHoppingAmplitudes();
+		n++
+	){
+		EXPECT_EQ(
+			compiledHoppingAmplitudes1.getToIndices()[n],
+			compiledHoppingAmplitudes0.getToIndices()[n]
+		);
+		EXPECT_EQ(
+			compiledHoppingAmplitudes1.getFromIndices()[n],
+			compiledHoppingAmplitudes0.getFromIndices()[n]
+		);
+		EXPECT_EQ(
+			compiledHoppingAmplitudes1.getAmplitudes()[n],
+			compiledHoppingAmplitudes0.getAmplitudes()[n]
+		);
+	}
+
+	//Fail to add HoppingAmplitudes after construction.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet1.addConcurrently(
+				HoppingAmplitude(1, {0, 0}, {0, 0})
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail to add incompatible HoppingAmplitudes.
+	HoppingAmplitudeSet hoppingAmplitudeSet2;
+	hoppingAmplitudeSet2.addConcurrently(
+		HoppingAmplitude(1, {0, 0}, {0, 0})
+	);
+	hoppingAmplitudeSet2.addConcurrently(HoppingAmplitude(1, {0}, {0}));
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet2.construct();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(HoppingAmplitudeSet, addConcurrentlyFromThreads){
+	//Threads that are not managed by OpenMP share one staging buffer.
+	//HoppingAmplitudes with the same to- and from-Indices are kept as
+	//separate entries.
+	const int NUM_THREADS = 4;
+	const int SIZE = 50;
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	std::vector<std::thread> threads;
+	for(int t = 0; t < NUM_THREADS; t++){
+		threads.push_back(std::thread([&hoppingAmplitudeSet, t](){
+			for(int x = t*SIZE; x < (t + 1)*SIZE; x++){
+				hoppingAmplitudeSet.addConcurrently(
+					HoppingAmplitude(1, {x}, {x})
+				);
+				hoppingAmplitudeSet.addConcurrently(
+					HoppingAmplitude(x, {x}, {x})
+				);
+			}
+		}));
+	}
+	for(unsigned int n = 0; n < threads.size(); n++)
+		threads[n].join();
+	hoppingAmplitudeSet.construct();
+
+	EXPECT_EQ(hoppingAmplitudeSet.getBasisSize(), NUM_THREADS*SIZE);
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	ASSERT_EQ(
+		compiledHoppingAmplitudes.getNumHoppingAmplitudes(),
+		2*NUM_THREADS*SIZE
+	);
+	for(int x = 0; x < NUM_THREADS*SIZE; x++){
+		unsigned int basisIndex = hoppingAmplitudeSet.getBasisIndex({x});
+		const unsigned int *rowPointers
+			= compiledHoppingAmplitudes.getRowPointers();
+		ASSERT_EQ(
+			rowPointers[basisIndex + 1] - rowPointers[basisIndex],
+			2
+		);
+		std::complex<double> sum = 0;
+		for(
+			unsigned int n = rowPointers[basisIndex];
+			n < rowPointers[basisIndex + 1];
+			n++
+		){
+			EXPECT_EQ(
+				compiledHoppingAmplitudes.getFromIndices()[n],
+				basisIndex
+			);
+			sum += compiledHoppingAmplitudes.getAmplitudes()[n];
+		}
+		EXPECT_DOUBLE_EQ(real(sum), x + 1);
+	}
+}
+
 /*TEST(HoppingAmplitudeSet, addHoppingAmplitudeAndHermitianConjugate){
 	HoppingAmplitudeSet hoppingAmplitudeSet;
 	hoppingAmplitudeSet.addHoppingAmplitudeAndHermitianConjugate(HoppingAmplitude(1, {1, 2}, {3, 4}));
@@ -539,6 +704,75 @@ TEST(HoppingAmplitudeSet, getSparseMatrix){
 	EXPECT_DOUBLE_EQ(imag(values[4]), 0);
 }
 
+TEST(HoppingAmplitudeSet, getCompiledHoppingAmplitudes){
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	hoppingAmplitudeSet.add(HoppingAmplitude(1, {1}, {0}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(2, {0}, {1}));
+
+	//Fail if the HoppingAmplitudeSet is not constructed.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	hoppingAmplitudeSet.construct();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	EXPECT_EQ(compiledHoppingAmplitudes.getBasisSize(), 2);
+	EXPECT_EQ(compiledHoppingAmplitudes.getNumHoppingAmplitudes(), 2);
+}
+
+TEST(HoppingAmplitudeSet, updateCompiledCallbackAmplitudes){
+	class Callback : public HoppingAmplitude::AmplitudeCallback{
+	public:
+		std::complex<double> getHoppingAmplitude(
+			const Index &to,
+			const Index &from
+		) const{
+			return value;
+		}
+
+		double value;
+	} callback;
+	callback.value = 1;
+
+	HoppingAmplitudeSet hoppingAmplitudeSet;
+	hoppingAmplitudeSet.add(HoppingAmplitude(callback, {1}, {0}));
+	hoppingAmplitudeSet.add(HoppingAmplitude(2, {0}, {1}));
+
+	//Fail if the HoppingAmplitudeSet is not constructed.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			hoppingAmplitudeSet.updateCompiledCallbackAmplitudes();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	hoppingAmplitudeSet.construct();
+	const CompiledHoppingAmplitudes &compiledHoppingAmplitudes
+		= hoppingAmplitudeSet.getCompiledHoppingAmplitudes();
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[1]), 1);
+
+	//The const getters leave the stored amplitudes unchanged, while
+	//getSparseMatrix() uses the current callback values.
+	callback.value = 3;
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[1]), 1);
+	SparseMatrix<std::complex<double>> sparseMatrix
+		= hoppingAmplitudeSet.getSparseMatrix();
+	EXPECT_DOUBLE_EQ(real(sparseMatrix.getCSCValues()[0]), 3);
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[1]), 1);
+
+	hoppingAmplitudeSet.updateCompiledCallbackAmplitudes();
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[1]), 3);
+	EXPECT_DOUBLE_EQ(real(compiledHoppingAmplitudes.getAmplitudes()[0]), 2);
+}
+
 TEST(HoppingAmplitudeSet, serialize){
 	//Already tested through serializeToJSON
 }
@@ -0,0 +1,112 @@
+#include "TBTK/Index.h"
+#include "TBTK/Model.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+//Count every allocation made through the global operator new.
+std::atomic<unsigned long long> numAllocations(0);
+
+void* operator new(std::size_t size){
+	numAllocations++;
+	void *pointer = std::malloc(size == 0 ? 1 : size);
+	if(pointer == nullptr)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+void operator delete(void *pointer) noexcept{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t size) noexcept{
+	std::free(pointer);
+}
+
+namespace TBTK{
+
+const unsigned int SIZE_X = 40;
+const unsigned int SIZE_Y = 40;
+const unsigned int NUM_REPETITIONS = 10000;
+
+//Create and copy a typical three-component Index.
+TEST(IndexAllocationBenchmark, createAndCopy){
+	numAllocations = 0;
+	for(unsigned int n = 0; n < NUM_REPETITIONS; n++){
+		std::vector<Subindex> indices({(int)n, 2, 1});
+		std::vector<Subindex> copy = indices;
+		EXPECT_EQ(copy.size(), 3);
+	}
+	unsigned long long numVectorAllocations = numAllocations;
+
+	numAllocations = 0;
+	for(unsigned int n = 0; n < NUM_REPETITIONS; n++){
+		Index index({(int)n, 2, 1});
+		Index copy = index;
+		EXPECT_EQ(copy.getSize(), 3);
+	}
+	unsigned long long numIndexAllocations = numAllocations;
+
+	std::cout << "Allocations for creating and copying "
+		<< NUM_REPETITIONS << " three-component Indices:\n"
+		<< "\tstd::vector<Subindex>:\t" << numVectorAllocations << "\n"
+		<< "\tIndex:\t\t\t" << numIndexAllocations << "\n";
+
+	EXPECT_EQ(numVectorAllocations, 2*NUM_REPETITIONS);
+	EXPECT_EQ(numIndexAllocations, 0);
+}
+
+//Indices that are longer than the inline capacity fall back to the heap.
+TEST(IndexAllocationBenchmark, createAndCopyLong){
+	numAllocations = 0;
+	for(unsigned int n = 0; n < NUM_REPETITIONS; n++){
+		Index index({(int)n, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+		Index copy = index;
+		EXPECT_EQ(copy.getSize(), 10);
+	}
+
+	EXPECT_EQ(numAllocations, 2*NUM_REPETITIONS);
+}
+
+//Construct a two-dimensional square lattice model with spin.
+TEST(IndexAllocationBenchmark, modelConstruction){
+	numAllocations = 0;
+	Model model;
+	for(unsigned int x = 0; x < SIZE_X; x++){
+		for(unsigned int y = 0; y < SIZE_Y; y++){
+			for(unsigned int s = 0; s < 2; s++){
+				model << HoppingAmplitude(
+					-1,
+					{(x+1)%SIZE_X, y, s},
+					{x, y, s}
+				) + HC;
+				model << HoppingAmplitude(
+					-1,
+					{x, (y+1)%SIZE_Y, s},
+					{x, y, s}
+				) + HC;
+			}
+		}
+	}
+	unsigned long long numAdditionAllocations = numAllocations;
+
+	numAllocations = 0;
+	model.construct();
+	unsigned long long numConstructionAllocations = numAllocations;
+
+	std::cout << "Allocations for setting up a " << SIZE_X << "x"
+		<< SIZE_Y << " model with spin ("
+		<< model.getBasisSize() << " basis states):\n"
+		<< "\tAdding HoppingAmplitudes:\t" << numAdditionAllocations
+		<< "\n"
+		<< "\tModel::construct():\t\t" << numConstructionAllocations
+		<< "\n";
+}
+
+};
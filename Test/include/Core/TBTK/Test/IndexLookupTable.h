@@ -0,0 +1,76 @@
+#include "TBTK/IndexLookupTable.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+
+TEST(IndexLookupTable, Constructor){
+	IndexLookupTable indexLookupTable;
+	EXPECT_EQ(indexLookupTable.getSize(), 0);
+	EXPECT_EQ(indexLookupTable.get({0, 1}), -1);
+}
+
+TEST(IndexLookupTable, add){
+	IndexLookupTable indexLookupTable;
+	indexLookupTable.add({0, 1}, 3);
+	indexLookupTable.add({1, 0}, 7);
+	indexLookupTable.add({0, 1, 2}, 5);
+	EXPECT_EQ(indexLookupTable.getSize(), 3);
+
+	//Adding an Index a second time replaces the value.
+	indexLookupTable.add({1, 0}, 2);
+	EXPECT_EQ(indexLookupTable.getSize(), 3);
+	EXPECT_EQ(indexLookupTable.get({1, 0}), 2);
+
+	//Negative values are not allowed.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			indexLookupTable.add({2, 2}, -1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(IndexLookupTable, get){
+	IndexLookupTable indexLookupTable;
+	for(int x = 0; x < 50; x++)
+		for(int y = 0; y < 50; y++)
+			for(int s = 0; s < 2; s++)
+				indexLookupTable.add({x, y, s}, 100*x + 2*y + s);
+	indexLookupTable.add({1, 2, IDX_SEPARATOR, 3}, 10000);
+	indexLookupTable.add({1, IDX_ALL}, 10001);
+	indexLookupTable.add({}, 10002);
+	EXPECT_EQ(indexLookupTable.getSize(), 50*50*2 + 3);
+
+	for(int x = 0; x < 50; x++){
+		for(int y = 0; y < 50; y++){
+			for(int s = 0; s < 2; s++){
+				EXPECT_EQ(
+					indexLookupTable.get({x, y, s}),
+					100*x + 2*y + s
+				);
+			}
+		}
+	}
+	EXPECT_EQ(indexLookupTable.get({1, 2, IDX_SEPARATOR, 3}), 10000);
+	EXPECT_EQ(indexLookupTable.get({1, IDX_ALL}), 10001);
+	EXPECT_EQ(indexLookupTable.get({}), 10002);
+
+	//Missing Indices.
+	EXPECT_EQ(indexLookupTable.get({50, 0, 0}), -1);
+	EXPECT_EQ(indexLookupTable.get({0, 0}), -1);
+	EXPECT_EQ(indexLookupTable.get({0, 0, 0, 0}), -1);
+	EXPECT_EQ(indexLookupTable.get({1, 2, 3}), -1);
+	EXPECT_EQ(indexLookupTable.get({1, 2}), -1);
+}
+
+TEST(IndexLookupTable, getSizeInBytes){
+	IndexLookupTable indexLookupTable;
+	unsigned int emptySize = indexLookupTable.getSizeInBytes();
+	indexLookupTable.add({0, 1}, 0);
+	EXPECT_TRUE(indexLookupTable.getSizeInBytes() > emptySize);
+}
+
+};
@@ -214,6 +214,30 @@ TEST(Model, operatorMoveAssignment){
 TEST(Model, add){
 }
 
+TEST(Model, addConcurrently){
+	Model model0;
+	model0.setVerbose(false);
+	Model model1;
+	model1.setVerbose(false);
+	for(int x = 0; x < 10; x++)
+		model0 << HoppingAmplitude(1, {(x+1)%10}, {x}) + HC;
+	#pragma omp parallel for
+	for(int x = 0; x < 10; x++)
+		model1.addConcurrently(HoppingAmplitude(1, {(x+1)%10}, {x}) + HC);
+	model0.construct();
+	model1.construct();
+
+	EXPECT_EQ(model1.getBasisSize(), model0.getBasisSize());
+	for(int x = 0; x < 10; x++){
+		EXPECT_EQ(
+			model1.getHoppingAmplitudeSet().getHoppingAmplitudes(
+				{x}
+			).size(),
+			2
+		);
+	}
+}
+
 TEST(Model, addModel){
 	Model model0;
 	model0 << HoppingAmplitude(0, {0}, {0});
@@ -343,6 +367,10 @@ TEST(Model, getStatistics){
 TEST(Model, getHoppingAmplitudeSet){
 }
 
+TEST(Model, updateCompiledCallbackAmplitudes){
+	//Tested through HoppingAmplitudeSet::updateCompiledCallbackAmplitudes().
+}
+
 //TODO
 //Should possibly be removed completely by making the Model inherit from the
 //Geometry.
@@ -0,0 +1,148 @@
+#include "TBTK/Math/BatchedMatrixInverter.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Math{
+
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
+
+//Create a batch of well conditioned matrices with a dominant cyclic
+//subdiagonal. The diagonal is set to zero for every third matrix of dimension
+//larger than one, which requires pivoting.
+std::vector<std::complex<double>> createBatch(
+	unsigned int dimension,
+	unsigned int batchSize
+){
+	std::vector<std::complex<double>> data(
+		dimension*dimension*batchSize
+	);
+	for(unsigned int b = 0; b < batchSize; b++){
+		for(unsigned int row = 0; row < dimension; row++){
+			for(unsigned int col = 0; col < dimension; col++){
+				std::complex<double> element(
+					cos(row + 2*col + 3*b),
+					sin(row*col + b)
+				);
+				if(b%3 == 0 && dimension > 1 && row == col)
+					element = 0;
+				else if(row == (col + 1)%dimension)
+					element += 2.*dimension;
+
+				data[(row + dimension*col)*batchSize + b]
+					= element;
+			}
+		}
+	}
+
+	return data;
+}
+
+//Check that the product of the bth original and inverted matrices is the
+//unit matrix.
+void checkInverse(
+	const std::vector<std::complex<double>> &original,
+	const std::vector<std::complex<double>> &inverse,
+	unsigned int dimension,
+	unsigned int batchSize,
+	unsigned int b
+){
+	for(unsigned int row = 0; row < dimension; row++){
+		for(unsigned int col = 0; col < dimension; col++){
+			std::complex<double> product = 0;
+			for(unsigned int n = 0; n < dimension; n++){
+				product += original[
+					(row + dimension*n)*batchSize + b
+				]*inverse[(n + dimension*col)*batchSize + b];
+			}
+			EXPECT_NEAR(
+				std::abs(product - (row == col ? 1. : 0.)),
+				0,
+				EPSILON_10000
+			);
+		}
+	}
+}
+
+TEST(BatchedMatrixInverter, invert0){
+	//Dimensions with specialized kernels as well as dimensions that are
+	//handled by the generic kernel. Batch sizes that are not multiples of
+	//the chunk size.
+	const unsigned int DIMENSIONS[7] = {1, 2, 3, 4, 9, 16, 25};
+	const unsigned int BATCH_SIZES[3] = {
+		1,
+		BatchedMatrixInverter::getChunkSize(),
+		2*BatchedMatrixInverter::getChunkSize() + 3
+	};
+	for(unsigned int d = 0; d < 7; d++){
+		for(unsigned int s = 0; s < 3; s++){
+			std::vector<std::complex<double>> original = createBatch(
+				DIMENSIONS[d],
+				BATCH_SIZES[s]
+			);
+			std::vector<std::complex<double>> inverse = original;
+			BatchedMatrixInverter::invert(
+				inverse,
+				DIMENSIONS[d],
+				BATCH_SIZES[s]
+			);
+			for(unsigned int b = 0; b < BATCH_SIZES[s]; b++){
+				checkInverse(
+					original,
+					inverse,
+					DIMENSIONS[d],
+					BATCH_SIZES[s],
+					b
+				);
+			}
+		}
+	}
+}
+
+TEST(BatchedMatrixInverter, invert1){
+	//A singular matrix does not affect the other matrices in the batch.
+	const unsigned int DIMENSION = 4;
+	const unsigned int BATCH_SIZE = 5;
+	std::vector<std::complex<double>> original = createBatch(
+		DIMENSION,
+		BATCH_SIZE
+	);
+	for(unsigned int row = 0; row < DIMENSION; row++)
+		original[(row + DIMENSION*2)*BATCH_SIZE + 1] = 0;
+	std::vector<std::complex<double>> inverse = original;
+	BatchedMatrixInverter::invert(inverse, DIMENSION, BATCH_SIZE);
+
+	bool isFinite = true;
+	for(unsigned int n = 0; n < DIMENSION*DIMENSION; n++)
+		if(!std::isfinite(std::abs(inverse[n*BATCH_SIZE + 1])))
+			isFinite = false;
+	EXPECT_FALSE(isFinite);
+
+	for(unsigned int b = 0; b < BATCH_SIZE; b++)
+		if(b != 1)
+			checkInverse(original, inverse, DIMENSION, BATCH_SIZE, b);
+}
+
+TEST(BatchedMatrixInverter, invert2){
+	//Fail for incompatible sizes.
+	std::vector<std::complex<double>> data(10);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			BatchedMatrixInverter::invert(data, 2, 3);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(BatchedMatrixInverter, getChunkSize){
+	EXPECT_GT(BatchedMatrixInverter::getChunkSize(), 0);
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
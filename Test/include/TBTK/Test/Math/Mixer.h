@@ -0,0 +1,181 @@
+#include "TBTK/Math/Mixer.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Math{
+
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
+
+//Linear fixed-point problem x = Ax + b with a slowly converging linear
+//iteration.
+const unsigned int SIZE = 6;
+
+std::vector<std::complex<double>> evaluate(
+	const std::vector<std::complex<double>> &x
+){
+	std::vector<std::complex<double>> result(SIZE);
+	for(unsigned int row = 0; row < SIZE; row++){
+		result[row] = std::complex<double>(1, 0.5*row);
+		for(unsigned int col = 0; col < SIZE; col++){
+			std::complex<double> element
+				= std::complex<double>(
+					0.05*cos(row + 2*col),
+					0.03*sin(row*col)
+				);
+			if(row == col)
+				element += 0.9;
+			result[row] += element*x[col];
+		}
+	}
+
+	return result;
+}
+
+double calculateResidualNorm(const std::vector<std::complex<double>> &x){
+	std::vector<std::complex<double>> output = evaluate(x);
+	double norm = 0;
+	for(unsigned int n = 0; n < SIZE; n++)
+		norm += pow(std::abs(output[n] - x[n]), 2);
+
+	return sqrt(norm);
+}
+
+unsigned int solve(Mixer<std::complex<double>> &mixer){
+	std::vector<std::complex<double>> x(SIZE, 0);
+	unsigned int iteration = 0;
+	while(iteration < 10000 && calculateResidualNorm(x) > 1e-10){
+		mixer.mix(x, evaluate(x));
+		iteration++;
+	}
+
+	return iteration;
+}
+
+TEST(Mixer, Constructor){
+	Mixer<std::complex<double>> mixer0;
+	EXPECT_EQ(mixer0.getMethod(), Mixer<std::complex<double>>::Method::Linear);
+	EXPECT_DOUBLE_EQ(mixer0.getMixingParameter(), 1);
+	EXPECT_EQ(mixer0.getHistorySize(), 5);
+
+	Mixer<double> mixer1(Mixer<double>::Method::Anderson, 0.3, 8);
+	EXPECT_EQ(mixer1.getMethod(), Mixer<double>::Method::Anderson);
+	EXPECT_DOUBLE_EQ(mixer1.getMixingParameter(), 0.3);
+	EXPECT_EQ(mixer1.getHistorySize(), 8);
+}
+
+TEST(Mixer, setMethod){
+	//Tested through Mixer::getMethod().
+}
+
+TEST(Mixer, getMethod){
+	Mixer<double> mixer;
+	mixer.setMethod(Mixer<double>::Method::Broyden);
+	EXPECT_EQ(mixer.getMethod(), Mixer<double>::Method::Broyden);
+}
+
+TEST(Mixer, setMixingParameter){
+	//Tested through Mixer::getMixingParameter().
+}
+
+TEST(Mixer, getMixingParameter){
+	Mixer<double> mixer;
+	mixer.setMixingParameter(0.2);
+	EXPECT_DOUBLE_EQ(mixer.getMixingParameter(), 0.2);
+}
+
+TEST(Mixer, setHistorySize){
+	//Tested through Mixer::getHistorySize().
+}
+
+TEST(Mixer, getHistorySize){
+	Mixer<double> mixer;
+	mixer.setHistorySize(3);
+	EXPECT_EQ(mixer.getHistorySize(), 3);
+}
+
+TEST(Mixer, reset){
+	Mixer<double> mixer;
+	std::vector<double> x = {1, 2};
+	mixer.mix(x, {2, 2});
+	EXPECT_EQ(mixer.getResidualNormHistory().size(), 1);
+	mixer.reset();
+	EXPECT_EQ(mixer.getResidualNormHistory().size(), 0);
+}
+
+TEST(Mixer, mix0){
+	//Linear mixing.
+	Mixer<double> mixer(Mixer<double>::Method::Linear, 0.25);
+	std::vector<double> x = {1, 2};
+	mixer.mix(x, {3, -2});
+	EXPECT_DOUBLE_EQ(x[0], 1.5);
+	EXPECT_DOUBLE_EQ(x[1], 1);
+}
+
+TEST(Mixer, mix1){
+	//Anderson and Broyden mixing converge to the same fixed point as
+	//linear mixing, but in considerably fewer iterations.
+	Mixer<std::complex<double>> linearMixer(
+		Mixer<std::complex<double>>::Method::Linear,
+		0.5
+	);
+	Mixer<std::complex<double>> andersonMixer(
+		Mixer<std::complex<double>>::Method::Anderson,
+		0.5
+	);
+	Mixer<std::complex<double>> broydenMixer(
+		Mixer<std::complex<double>>::Method::Broyden,
+		0.5
+	);
+	unsigned int linearIterations = solve(linearMixer);
+	unsigned int andersonIterations = solve(andersonMixer);
+	unsigned int broydenIterations = solve(broydenMixer);
+
+	EXPECT_LT(linearIterations, 10000);
+	EXPECT_LT(3*andersonIterations, linearIterations);
+	EXPECT_LT(3*broydenIterations, linearIterations);
+}
+
+TEST(Mixer, mix2){
+	//Anderson mixing with a history that is at least as large as the
+	//problem solves a linear problem in a finite number of steps.
+	Mixer<std::complex<double>> mixer(
+		Mixer<std::complex<double>>::Method::Anderson,
+		0.5,
+		SIZE
+	);
+	EXPECT_LE(solve(mixer), SIZE + 3);
+}
+
+TEST(Mixer, mix3){
+	//Fail for incompatible sizes.
+	Mixer<double> mixer;
+	std::vector<double> x = {1, 2};
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			mixer.mix(x, {1, 2, 3});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Mixer, getResidualNormHistory){
+	Mixer<double> mixer(Mixer<double>::Method::Anderson);
+	std::vector<double> x = {0, 0};
+	mixer.mix(x, {3, 4});
+	mixer.mix(x, {3, 4});
+	const std::vector<double> &residualNormHistory
+		= mixer.getResidualNormHistory();
+	ASSERT_EQ(residualNormHistory.size(), 2);
+	EXPECT_NEAR(residualNormHistory[0], 5, EPSILON_10000);
+	EXPECT_NEAR(residualNormHistory[1], 0, EPSILON_10000);
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
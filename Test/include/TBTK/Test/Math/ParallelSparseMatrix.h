@@ -0,0 +1,320 @@
+#include "TBTK/Math/ParallelSparseMatrix.h"
+
+#include "gtest/gtest.h"
+
+#include <complex>
+
+namespace TBTK{
+namespace Math{
+
+const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+class ParallelSparseMatrixTest : public ::testing::Test{
+protected:
+	SparseMatrix<std::complex<double>> sparseMatrix;
+	std::complex<double> denseMatrix[4][4];
+	std::complex<double> x[4];
+	std::complex<double> y[4];
+
+	void SetUp() override{
+		for(unsigned int row = 0; row < 4; row++)
+			for(unsigned int col = 0; col < 4; col++)
+				denseMatrix[row][col] = 0;
+
+		denseMatrix[0][0] = std::complex<double>(1, 0);
+		denseMatrix[0][2] = std::complex<double>(2, -1);
+		denseMatrix[1][1] = std::complex<double>(-3, 0);
+		denseMatrix[2][0] = std::complex<double>(2, 1);
+		denseMatrix[2][3] = std::complex<double>(0, 4);
+		denseMatrix[3][2] = std::complex<double>(0, -4);
+		denseMatrix[3][3] = std::complex<double>(5, 0);
+
+		sparseMatrix = SparseMatrix<std::complex<double>>(
+			SparseMatrix<std::complex<double>>::StorageFormat::CSR,
+			4,
+			4
+		);
+		for(unsigned int row = 0; row < 4; row++){
+			for(unsigned int col = 0; col < 4; col++){
+				if(denseMatrix[row][col] != 0.){
+					sparseMatrix.add(
+						row,
+						col,
+						denseMatrix[row][col]
+					);
+				}
+			}
+		}
+		sparseMatrix.construct();
+
+		for(unsigned int n = 0; n < 4; n++){
+			x[n] = std::complex<double>(n + 1, 1 - (int)n);
+			y[n] = std::complex<double>(2*n, n);
+		}
+	}
+
+	void verify(
+		const ParallelSparseMatrix<std::complex<double>> &matrix,
+		const std::complex<double> &alpha,
+		const std::complex<double> &beta
+	){
+		std::complex<double> result[4];
+		for(unsigned int n = 0; n < 4; n++)
+			result[n] = y[n];
+		matrix.multiply(x, result, alpha, beta);
+
+		for(unsigned int row = 0; row < 4; row++){
+			std::complex<double> reference = beta*y[row];
+			for(unsigned int col = 0; col < 4; col++)
+				reference += alpha*denseMatrix[row][col]*x[col];
+
+			EXPECT_NEAR(real(result[row]), real(reference), EPSILON_100);
+			EXPECT_NEAR(imag(result[row]), imag(reference), EPSILON_100);
+		}
+	}
+};
+
+//TBTKFeature Math.ParallelSparseMatrix.construction.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, Constructor0){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 3);
+	EXPECT_EQ(matrix.getNumRows(), 4);
+	EXPECT_EQ(matrix.getNumColumns(), 4);
+	EXPECT_EQ(matrix.getNumMatrixElements(), 7);
+	EXPECT_EQ(matrix.getNumPartitions(), 3);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.construction.1 2020-06-01
+TEST_F(ParallelSparseMatrixTest, Constructor1){
+	//The number of partitions is limited by the number of rows.
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 10);
+	EXPECT_EQ(matrix.getNumPartitions(), 4);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.construction.2 2020-06-01
+TEST_F(ParallelSparseMatrixTest, Constructor2){
+	//The source is left empty by the move constructor.
+	ParallelSparseMatrix<std::complex<double>> source(sparseMatrix, 3);
+	ParallelSparseMatrix<std::complex<double>> matrix(std::move(source));
+	EXPECT_EQ(matrix.getNumRows(), 4);
+	EXPECT_EQ(matrix.getNumColumns(), 4);
+	EXPECT_EQ(matrix.getNumMatrixElements(), 7);
+	EXPECT_EQ(matrix.getNumPartitions(), 3);
+	EXPECT_EQ(source.getNumRows(), 0);
+	EXPECT_EQ(source.getNumColumns(), 0);
+	EXPECT_EQ(source.getNumMatrixElements(), 0);
+	EXPECT_EQ(source.getNumPartitions(), 0);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.operatorAssignment.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, operatorAssignment){
+	//The right hand side is left empty by the move assignment.
+	ParallelSparseMatrix<std::complex<double>> source(sparseMatrix, 3);
+	ParallelSparseMatrix<std::complex<double>> matrix;
+	matrix = std::move(source);
+	EXPECT_EQ(matrix.getNumRows(), 4);
+	EXPECT_EQ(matrix.getNumColumns(), 4);
+	EXPECT_EQ(matrix.getNumMatrixElements(), 7);
+	EXPECT_EQ(matrix.getNumPartitions(), 3);
+	EXPECT_EQ(source.getNumRows(), 0);
+	EXPECT_EQ(source.getNumColumns(), 0);
+	EXPECT_EQ(source.getNumMatrixElements(), 0);
+	EXPECT_EQ(source.getNumPartitions(), 0);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.getMatrixElementPosition.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, getMatrixElementPosition0){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	EXPECT_EQ(matrix.getMatrixElementPosition(0, 0), 0);
+	EXPECT_EQ(matrix.getMatrixElementPosition(0, 2), 1);
+	EXPECT_EQ(matrix.getMatrixElementPosition(1, 1), 2);
+	EXPECT_EQ(matrix.getMatrixElementPosition(2, 3), 4);
+	EXPECT_EQ(matrix.getMatrixElementPosition(3, 3), 6);
+
+	//Matrix elements that are not stored.
+	EXPECT_EQ(matrix.getMatrixElementPosition(0, 1), -1);
+	EXPECT_EQ(matrix.getMatrixElementPosition(3, 0), -1);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.getMatrixElementPosition.1 2020-06-01
+TEST_F(ParallelSparseMatrixTest, getMatrixElementPosition1){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.getMatrixElementPosition(4, 0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.getMatrixElementPosition(0, 4);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.setMatrixElement.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, setMatrixElement0){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	denseMatrix[2][3] = std::complex<double>(1, 2);
+	denseMatrix[3][2] = std::complex<double>(1, -2);
+	matrix.setMatrixElement(
+		matrix.getMatrixElementPosition(2, 3),
+		denseMatrix[2][3]
+	);
+	matrix.setMatrixElement(
+		matrix.getMatrixElementPosition(3, 2),
+		denseMatrix[3][2]
+	);
+	verify(matrix, 1, 0);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.setMatrixElement.1 2020-06-01
+TEST_F(ParallelSparseMatrixTest, setMatrixElement1){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.setMatrixElement(7, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.createVector.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, createVector0){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	ParallelSparseMatrix<std::complex<double>>::Vector vector
+		= matrix.createVector();
+	EXPECT_EQ(vector.getSize(), 4);
+	for(unsigned int n = 0; n < 4; n++)
+		EXPECT_EQ(vector[n], std::complex<double>(0));
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.multiply.0 2020-06-01
+TEST_F(ParallelSparseMatrixTest, multiply0){
+	for(unsigned int numPartitions = 1; numPartitions < 5; numPartitions++){
+		ParallelSparseMatrix<std::complex<double>> matrix(
+			sparseMatrix,
+			numPartitions
+		);
+		verify(matrix, 1, 0);
+	}
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.multiply.1 2020-06-01
+TEST_F(ParallelSparseMatrixTest, multiply1){
+	for(unsigned int numPartitions = 1; numPartitions < 5; numPartitions++){
+		ParallelSparseMatrix<std::complex<double>> matrix(
+			sparseMatrix,
+			numPartitions
+		);
+		verify(matrix, 2, -1);
+		verify(matrix, std::complex<double>(0.5, 1), 0.25);
+	}
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.multiply.2 2020-06-01
+TEST_F(ParallelSparseMatrixTest, multiply2){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	ParallelSparseMatrix<std::complex<double>>::Vector vector
+		= matrix.createVector();
+
+	//Fail for incompatible dimensions.
+	ParallelSparseMatrix<std::complex<double>>::Vector emptyVector;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.multiply(vector, emptyVector);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the input and output vectors are the same.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.multiply(vector, vector);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.multiplyBlock.0 2020-06-02
+TEST_F(ParallelSparseMatrixTest, multiplyBlock0){
+	const unsigned int NUM_VECTORS = 3;
+	std::complex<double> xBlock[4*NUM_VECTORS];
+	std::complex<double> yBlock[4*NUM_VECTORS];
+	for(unsigned int row = 0; row < 4; row++){
+		for(unsigned int k = 0; k < NUM_VECTORS; k++){
+			xBlock[row*NUM_VECTORS + k]
+				= x[row]*std::complex<double>(k + 1, k);
+			yBlock[row*NUM_VECTORS + k]
+				= y[row]*std::complex<double>(k, -1);
+		}
+	}
+
+	const std::complex<double> alpha(2, 0.5);
+	const std::complex<double> beta(-1, 0);
+	for(unsigned int numPartitions = 1; numPartitions < 5; numPartitions++){
+		ParallelSparseMatrix<std::complex<double>> matrix(
+			sparseMatrix,
+			numPartitions
+		);
+		std::complex<double> result[4*NUM_VECTORS];
+		for(unsigned int n = 0; n < 4*NUM_VECTORS; n++)
+			result[n] = yBlock[n];
+		matrix.multiplyBlock(xBlock, result, NUM_VECTORS, alpha, beta);
+
+		for(unsigned int row = 0; row < 4; row++){
+			for(unsigned int k = 0; k < NUM_VECTORS; k++){
+				std::complex<double> reference
+					= beta*yBlock[row*NUM_VECTORS + k];
+				for(unsigned int col = 0; col < 4; col++){
+					reference += alpha*denseMatrix[row][col]
+						*xBlock[col*NUM_VECTORS + k];
+				}
+
+				EXPECT_NEAR(
+					real(result[row*NUM_VECTORS + k]),
+					real(reference),
+					EPSILON_100
+				);
+				EXPECT_NEAR(
+					imag(result[row*NUM_VECTORS + k]),
+					imag(reference),
+					EPSILON_100
+				);
+			}
+		}
+	}
+}
+
+//TBTKFeature Math.ParallelSparseMatrix.multiplyBlock.1 2020-06-02
+TEST_F(ParallelSparseMatrixTest, multiplyBlock1){
+	ParallelSparseMatrix<std::complex<double>> matrix(sparseMatrix, 2);
+	ParallelSparseMatrix<std::complex<double>>::Vector input
+		= matrix.createVector(2);
+	ParallelSparseMatrix<std::complex<double>>::Vector output
+		= matrix.createVector(3);
+	EXPECT_EQ(input.getSize(), 8);
+
+	//Fail for incompatible dimensions.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			matrix.multiplyBlock(input, output, 2);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+};	//End of namespace Math
+};	//End of namespace TBTK
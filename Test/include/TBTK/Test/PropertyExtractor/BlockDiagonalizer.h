@@ -643,5 +643,119 @@ TEST(BlockDiagonalizer, calculateSpinPolarizedLDOS){
 TEST(BlockDiagonalizer, calculateEntropy){
 }
 
+TEST(BlockDiagonalizer, Accumulator){
+	SETUP_MODEL();
+
+	//Reference solver that stores all eigenvectors.
+	Solver::BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.run();
+
+	BlockDiagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(-100, 100, 1000);
+
+	//Solver that streams the eigenvectors.
+	Solver::BlockDiagonalizer streamingSolver;
+	streamingSolver.setVerbose(false);
+	streamingSolver.setModel(model);
+	streamingSolver.setStreamEigenVectors(true);
+
+	BlockDiagonalizer streamingPropertyExtractor;
+	streamingPropertyExtractor.setSolver(streamingSolver);
+	streamingPropertyExtractor.setEnergyWindow(-100, 100, 1000);
+
+	BlockDiagonalizer::Accumulator accumulator(streamingPropertyExtractor);
+	accumulator.addDensity({{IDX_ALL, IDX_ALL}});
+	accumulator.addLDOS({{IDX_SUM_ALL, IDX_ALL}});
+	accumulator.addSpinPolarizedLDOS({{IDX_ALL, IDX_SPIN}});
+	streamingSolver.addBlockCallback(accumulator);
+
+	//Running twice verifies that the Properties are reset between the
+	//diagonalizations.
+	streamingSolver.run();
+	streamingSolver.run();
+
+	Property::Density density
+		= propertyExtractor.calculateDensity({{IDX_ALL, IDX_ALL}});
+	const Property::Density &streamedDensity = accumulator.getDensity();
+	for(int k = 0; k < SIZE; k++){
+		for(int n = 0; n < 2; n++){
+			EXPECT_NEAR(
+				streamedDensity({k, n}),
+				density({k, n}),
+				EPSILON_100
+			);
+		}
+	}
+
+	Property::LDOS ldos
+		= propertyExtractor.calculateLDOS({{IDX_SUM_ALL, IDX_ALL}});
+	const Property::LDOS &streamedLDOS = accumulator.getLDOS();
+	for(int n = 0; n < 2; n++){
+		for(unsigned int e = 0; e < ldos.getResolution(); e++){
+			EXPECT_NEAR(
+				streamedLDOS({IDX_SUM_ALL, n}, e),
+				ldos({IDX_SUM_ALL, n}, e),
+				EPSILON_10000
+			);
+		}
+	}
+
+	Property::SpinPolarizedLDOS spinPolarizedLDOS
+		= propertyExtractor.calculateSpinPolarizedLDOS(
+			{{IDX_ALL, IDX_SPIN}}
+		);
+	const Property::SpinPolarizedLDOS &streamedSpinPolarizedLDOS
+		= accumulator.getSpinPolarizedLDOS();
+	for(int k = 0; k < SIZE; k++){
+		for(
+			unsigned int e = 0;
+			e < spinPolarizedLDOS.getResolution();
+			e++
+		){
+			for(unsigned int r = 0; r < 2; r++){
+				for(unsigned int c = 0; c < 2; c++){
+					EXPECT_NEAR(
+						abs(
+							streamedSpinPolarizedLDOS(
+								{k, IDX_SPIN},
+								e
+							).at(r, c)
+							- spinPolarizedLDOS(
+								{k, IDX_SPIN},
+								e
+							).at(r, c)
+						),
+						0,
+						EPSILON_10000
+					);
+				}
+			}
+		}
+	}
+
+	//The DOS is calculated from the eigenvalues, which are stored for all
+	//blocks.
+	Property::DOS dos = propertyExtractor.calculateDOS();
+	Property::DOS streamedDOS = streamingPropertyExtractor.calculateDOS();
+	for(unsigned int e = 0; e < dos.getResolution(); e++)
+		EXPECT_NEAR(streamedDOS(e), dos(e), EPSILON_100);
+
+	//Fail to get a Property that is not accumulated.
+	BlockDiagonalizer::Accumulator emptyAccumulator(
+		streamingPropertyExtractor
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			emptyAccumulator.getDensity();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
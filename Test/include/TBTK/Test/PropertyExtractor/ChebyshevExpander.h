@@ -103,5 +103,129 @@ TEST(ChebyshevExpander, calculateLDOS1){
 	}
 }
 
+TEST(ChebyshevExpander, setNumRandomVectors){
+	Model model;
+	model << HoppingAmplitude(-1, {0}, {1}) + HC;
+	model.construct();
+
+	Solver::ChebyshevExpander solver;
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+
+	ChebyshevExpander propertyExtractor(solver);
+	propertyExtractor.setNumRandomVectors(5);
+	EXPECT_EQ(propertyExtractor.getNumRandomVectors(), 5);
+
+	//Fail for zero random vectors.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			propertyExtractor.setNumRandomVectors(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getNumRandomVectors){
+	//Tested through setNumRandomVectors.
+}
+
+TEST(ChebyshevExpander, calculateDOS0){
+	const unsigned int SIZE = 10;
+	Model model;
+	for(unsigned int n = 0; n < SIZE; n++)
+		model << HoppingAmplitude(-1, {n}, {(n+1)%SIZE}) + HC;
+	model.construct();
+
+	Solver::ChebyshevExpander solver;
+	solver.setModel(model);
+	const double SCALE_FACTOR = 10;
+	solver.setScaleFactor(SCALE_FACTOR);
+
+	ChebyshevExpander propertyExtractor(solver);
+	propertyExtractor.setRandomSeed(0);
+	const double LOWER_BOUND = -SCALE_FACTOR*0.9;
+	const double UPPER_BOUND = SCALE_FACTOR*0.9;
+	const unsigned int RESOLUTION = 1000;
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+
+	//The zeroth moment is exact for every random vector, which means that
+	//the DOS integrates to the basis size.
+	Property::DOS dos = propertyExtractor.calculateDOS();
+	double dE = dos.getDeltaE();
+	double integratedDOS = 0;
+	for(unsigned int n = 0; n < dos.getResolution(); n++)
+		integratedDOS += dos(n)*dE;
+	EXPECT_NEAR(integratedDOS, SIZE, 0.01);
+}
+
+TEST(ChebyshevExpander, calculateDOS1){
+	const unsigned int SIZE = 10;
+	Model model;
+	for(unsigned int n = 0; n < SIZE; n++)
+		model << HoppingAmplitude(-1, {n}, {(n+1)%SIZE}) + HC;
+	model.construct();
+
+	Solver::ChebyshevExpander solver;
+	solver.setModel(model);
+	const double SCALE_FACTOR = 10;
+	solver.setScaleFactor(SCALE_FACTOR);
+	solver.setNumCoefficients(200);
+
+	ChebyshevExpander propertyExtractor(solver);
+	propertyExtractor.setNumRandomVectors(50);
+	propertyExtractor.setRandomSeed(0);
+	const double LOWER_BOUND = -2.5;
+	const double UPPER_BOUND = 2.5;
+	const unsigned int RESOLUTION = 100;
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+
+	//The DOS calculated with and without the statistical error agree.
+	Property::DOS statisticalError;
+	Property::DOS dos = propertyExtractor.calculateDOS(statisticalError);
+	Property::DOS dosWithoutError = propertyExtractor.calculateDOS();
+	ASSERT_EQ(statisticalError.getResolution(), RESOLUTION);
+	for(unsigned int n = 0; n < RESOLUTION; n++)
+		EXPECT_NEAR(dos(n), dosWithoutError(n), EPSILON_10000);
+
+	//The DOS agrees with the sum of the LDOS within the statistical error.
+	Property::LDOS ldos = propertyExtractor.calculateLDOS({{IDX_ALL}});
+	bool hasNonZeroError = false;
+	for(unsigned int n = 0; n < RESOLUTION; n++){
+		double reference = 0;
+		for(unsigned int x = 0; x < SIZE; x++)
+			reference += ldos({x}, n);
+		EXPECT_NEAR(
+			dos(n),
+			reference,
+			5*statisticalError(n) + EPSILON_10000
+		);
+		if(statisticalError(n) > EPSILON_10000)
+			hasNonZeroError = true;
+	}
+	EXPECT_TRUE(hasNonZeroError);
+
+	//Fail if the statistical error is requested using a single random
+	//vector.
+	propertyExtractor.setNumRandomVectors(1);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			propertyExtractor.calculateDOS(statisticalError);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 };	//End of namespace PropertyExtractor
 };	//End of namespace TBTK
@@ -487,6 +487,33 @@ TEST(Diagonalizer, calculateDensity){
 		EXPECT_NEAR(density1(n), densityBenchmark, EPSILON_100);
 }
 
+TEST(Diagonalizer, calculateDensityPartialSpectrum){
+	//The density only depends on the occupied states, which all have
+	//energies in the range (-3, 1.5].
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+	Diagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	Property::Density density0
+		= propertyExtractor.calculateDensity({{IDX_ALL}});
+
+	Solver::Diagonalizer partialSolver;
+	partialSolver.setVerbose(false);
+	partialSolver.setModel(model);
+	partialSolver.setAlgorithm(Solver::Diagonalizer::Algorithm::MRRR);
+	partialSolver.setEnergyRange(-3, 1.5);
+	partialSolver.run();
+	EXPECT_LT(partialSolver.getNumStates(), SIZE);
+
+	Diagonalizer partialPropertyExtractor;
+	partialPropertyExtractor.setSolver(partialSolver);
+	Property::Density density1
+		= partialPropertyExtractor.calculateDensity({{IDX_ALL}});
+	ASSERT_EQ(density1.getSize(), SIZE);
+	for(unsigned int n = 0; n < density1.getSize(); n++)
+		EXPECT_NEAR(density1(n), density0(n), EPSILON_10000);
+}
+
 //TODO
 //...
 TEST(Diagonalizer, calculateMagnetization){
@@ -532,6 +559,52 @@ TEST(Diagonalizer, calculateLDOS){
 			EXPECT_NEAR(ldos1({x}, n), dos(n)/SIZE, EPSILON_10000);
 }
 
+TEST(Diagonalizer, calculateLDOSPartialSpectrum){
+	//The LDOS in an energy window only depends on the states with
+	//energies inside the window.
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+	const double LOWER_BOUND = -1;
+	const double UPPER_BOUND = 1;
+	const int RESOLUTION = 100;
+
+	Diagonalizer propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+	Property::LDOS ldos0 = propertyExtractor.calculateLDOS({{IDX_ALL}});
+
+	Solver::Diagonalizer partialSolver;
+	partialSolver.setVerbose(false);
+	partialSolver.setModel(model);
+	partialSolver.setAlgorithm(Solver::Diagonalizer::Algorithm::MRRR);
+	partialSolver.setEnergyRange(LOWER_BOUND, UPPER_BOUND);
+	partialSolver.run();
+	EXPECT_LT(partialSolver.getNumStates(), SIZE);
+
+	Diagonalizer partialPropertyExtractor;
+	partialPropertyExtractor.setSolver(partialSolver);
+	partialPropertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+	Property::LDOS ldos1
+		= partialPropertyExtractor.calculateLDOS({{IDX_ALL}});
+	for(unsigned int n = 0; n < RESOLUTION; n++){
+		for(int x = 0; x < SIZE; x++){
+			EXPECT_NEAR(
+				ldos1({x}, n),
+				ldos0({x}, n),
+				EPSILON_10000
+			);
+		}
+	}
+}
+
 //TODO
 //...
 TEST(Diagonalizer, calculateSpinPolarizedLDOS){
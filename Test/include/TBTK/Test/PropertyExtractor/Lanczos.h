@@ -0,0 +1,283 @@
+#include "TBTK/PropertyExtractor/Lanczos.h"
+#include <cmath>
+#include <complex>
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+namespace PropertyExtractor{
+
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
+
+#define SETUP_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 50; \
+	for(int x = 0; x + 1 < SIZE; x++) \
+		model << HoppingAmplitude(-1, {x+1}, {x}) + HC; \
+	model.construct();
+
+#define SETUP_AND_RUN_SOLVER() \
+	const int NUM_STATES = 4; \
+	Solver::Lanczos solver; \
+	solver.setVerbose(false); \
+	solver.setModel(model); \
+	solver.setNumEigenValues(NUM_STATES); \
+	solver.setNumLanczosVectors(20); \
+	solver.setMaxIterations(1000); \
+	solver.setCalculateEigenVectors(true); \
+	solver.run();
+
+//Eigenvalues and eigenvectors of an open chain.
+double analyticalEigenValue(int state, int size){
+	return -2*cos(M_PI*(state + 1)/(size + 1));
+}
+
+double analyticalAmplitude(int state, int x, int size){
+	return sqrt(2./(size + 1))*sin(M_PI*(state + 1)*(x + 1)/(size + 1));
+}
+
+TEST(Lanczos, Constructor0){
+	//Not testable on its own.
+}
+
+TEST(Lanczos, getEigenValues){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	Property::EigenValues eigenValues = propertyExtractor.getEigenValues();
+
+	ASSERT_EQ(eigenValues.getSize(), NUM_STATES);
+	for(int n = 0; n < NUM_STATES; n++){
+		EXPECT_NEAR(
+			eigenValues(n),
+			analyticalEigenValue(n, SIZE),
+			EPSILON_10000
+		);
+	}
+}
+
+TEST(Lanczos, getEigenValue){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	for(int n = 0; n < NUM_STATES; n++){
+		EXPECT_NEAR(
+			propertyExtractor.getEigenValue(n),
+			analyticalEigenValue(n, SIZE),
+			EPSILON_10000
+		);
+	}
+}
+
+TEST(Lanczos, getAmplitude){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+
+	//The eigenvectors are only determined up to a phase.
+	for(int n = 0; n < NUM_STATES; n++){
+		for(int x = 0; x < SIZE; x++){
+			EXPECT_NEAR(
+				abs(propertyExtractor.getAmplitude(n, {x})),
+				std::abs(analyticalAmplitude(n, x, SIZE)),
+				EPSILON_10000
+			);
+		}
+	}
+}
+
+TEST(Lanczos, calculateWaveFunctions){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	Property::WaveFunctions waveFunctions
+		= propertyExtractor.calculateWaveFunctions(
+			{{IDX_ALL}},
+			{IDX_ALL}
+		);
+
+	ASSERT_EQ(waveFunctions.getStates().size(), NUM_STATES);
+	for(int n = 0; n < NUM_STATES; n++){
+		for(int x = 0; x < SIZE; x++){
+			EXPECT_DOUBLE_EQ(
+				real(waveFunctions({x}, n)),
+				real(propertyExtractor.getAmplitude(n, {x}))
+			);
+			EXPECT_DOUBLE_EQ(
+				imag(waveFunctions({x}, n)),
+				imag(propertyExtractor.getAmplitude(n, {x}))
+			);
+		}
+	}
+}
+
+TEST(Lanczos, calculateDOS){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+	const double LOWER_BOUND = -10;
+	const double UPPER_BOUND = 10;
+	const int RESOLUTION = 1000;
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+	Property::DOS dos = propertyExtractor.calculateDOS();
+
+	//Check that the DOS integrates to the number of calculated states.
+	double dE = dos.getDeltaE();
+	double integratedDOS = 0;
+	for(unsigned int n = 0; n < RESOLUTION; n++)
+		integratedDOS += dos(n)*dE;
+	EXPECT_NEAR(integratedDOS, NUM_STATES, EPSILON_10000);
+}
+
+TEST(Lanczos, calculateLDOS){
+	SETUP_MODEL();
+	SETUP_AND_RUN_SOLVER();
+	const double LOWER_BOUND = -10;
+	const double UPPER_BOUND = 10;
+	const int RESOLUTION = 1000;
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+
+	//Check that the LDOS on every site integrates to the weight of the
+	//calculated states on that site, and that the total weight is equal
+	//to the number of calculated states. Both for the Ranges and Custom
+	//format.
+	Property::LDOS ldos0 = propertyExtractor.calculateLDOS(
+		{IDX_X},
+		{SIZE}
+	);
+	Property::LDOS ldos1 = propertyExtractor.calculateLDOS({{IDX_ALL}});
+	const std::vector<double> &data = ldos0.getData();
+	double dE = ldos0.getDeltaE();
+	double integratedLDOS0 = 0;
+	double integratedLDOS1 = 0;
+	for(int x = 0; x < SIZE; x++){
+		double weight = 0;
+		for(int n = 0; n < NUM_STATES; n++)
+			weight += pow(analyticalAmplitude(n, x, SIZE), 2);
+
+		double siteIntegral0 = 0;
+		double siteIntegral1 = 0;
+		for(unsigned int n = 0; n < RESOLUTION; n++){
+			siteIntegral0 += data[RESOLUTION*x + n]*dE;
+			siteIntegral1 += ldos1({x}, n)*dE;
+		}
+		EXPECT_NEAR(siteIntegral0, weight, EPSILON_10000);
+		EXPECT_NEAR(siteIntegral1, weight, EPSILON_10000);
+		integratedLDOS0 += siteIntegral0;
+		integratedLDOS1 += siteIntegral1;
+	}
+	EXPECT_NEAR(integratedLDOS0, NUM_STATES, EPSILON_10000);
+	EXPECT_NEAR(integratedLDOS1, NUM_STATES, EPSILON_10000);
+}
+
+TEST(Lanczos, calculateSpinPolarizedLDOS){
+	//Open chain in a transverse magnetic field. The lowest states all have
+	//their spin anti-parallel to the field.
+	Model model;
+	model.setVerbose(false);
+	const int SIZE = 50;
+	const double B = 0.5;
+	for(int x = 0; x < SIZE; x++){
+		for(int s = 0; s < 2; s++){
+			if(x + 1 < SIZE){
+				model << HoppingAmplitude(
+					-1,
+					{x+1, s},
+					{x, s}
+				) + HC;
+			}
+		}
+		model << HoppingAmplitude(B, {x, 0}, {x, 1}) + HC;
+	}
+	model.construct();
+	SETUP_AND_RUN_SOLVER();
+	const double LOWER_BOUND = -10;
+	const double UPPER_BOUND = 10;
+	const int RESOLUTION = 1000;
+
+	Lanczos propertyExtractor;
+	propertyExtractor.setSolver(solver);
+	propertyExtractor.setEnergyWindow(
+		LOWER_BOUND,
+		UPPER_BOUND,
+		RESOLUTION
+	);
+
+	//Check that the trace of the spin-polarized LDOS is equal to the LDOS
+	//summed over spin, that the spin-polarized LDOS is Hermitian, and
+	//that the total spin along the field is minus the number of
+	//calculated states. Both for the Ranges and Custom format.
+	Property::SpinPolarizedLDOS spinPolarizedLDOS0
+		= propertyExtractor.calculateSpinPolarizedLDOS(
+			{IDX_X, IDX_SPIN},
+			{SIZE, 2}
+		);
+	Property::SpinPolarizedLDOS spinPolarizedLDOS1
+		= propertyExtractor.calculateSpinPolarizedLDOS(
+			{{IDX_ALL, IDX_SPIN}}
+		);
+	Property::LDOS ldos = propertyExtractor.calculateLDOS(
+		{{IDX_ALL, IDX_SUM_ALL}}
+	);
+	const std::vector<SpinMatrix> &data = spinPolarizedLDOS0.getData();
+	double dE = spinPolarizedLDOS0.getDeltaE();
+	double spin0 = 0;
+	double spin1 = 0;
+	for(int x = 0; x < SIZE; x++){
+		for(unsigned int n = 0; n < RESOLUTION; n++){
+			const SpinMatrix &spinMatrix0 = data[RESOLUTION*x + n];
+			const SpinMatrix &spinMatrix1
+				= spinPolarizedLDOS1({x, IDX_SPIN}, n);
+			double ldosValue = ldos({x, IDX_SUM_ALL}, n);
+
+			EXPECT_NEAR(
+				real(spinMatrix0.at(0, 0) + spinMatrix0.at(1, 1))*dE,
+				ldosValue*dE,
+				EPSILON_10000
+			);
+			EXPECT_NEAR(
+				real(spinMatrix1.at(0, 0) + spinMatrix1.at(1, 1))*dE,
+				ldosValue*dE,
+				EPSILON_10000
+			);
+			EXPECT_NEAR(
+				abs(
+					spinMatrix0.at(0, 1)
+					- conj(spinMatrix0.at(1, 0))
+				)*dE,
+				0,
+				EPSILON_10000
+			);
+
+			spin0 += 2*real(spinMatrix0.at(0, 1))*dE;
+			spin1 += 2*real(spinMatrix1.at(0, 1))*dE;
+		}
+	}
+	EXPECT_NEAR(spin0, -NUM_STATES, EPSILON_10000);
+	EXPECT_NEAR(spin1, -NUM_STATES, EPSILON_10000);
+}
+
+};	//End of namespace PropertyExtractor
+};	//End of namespace TBTK
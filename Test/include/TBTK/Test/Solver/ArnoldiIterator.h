@@ -1,4 +1,5 @@
 #include "TBTK/Solver/ArnoldiIterator.h"
+#include "TBTK/Streams.h"
 
 #include "gtest/gtest.h"
 
@@ -134,6 +135,101 @@ TEST(ArnoldiIterator, setCentralValue){
 	EXPECT_NEAR(solver.getEigenValue(0), 2, 1e-5);
 }
 
+TEST(ArnoldiIterator, setCentralValues){
+	//Tested through ArnoldiIterator::getCentralValues().
+}
+
+TEST(ArnoldiIterator, getCentralValues){
+	ArnoldiIterator solver;
+	EXPECT_EQ(solver.getCentralValues().size(), 1);
+	EXPECT_DOUBLE_EQ(solver.getCentralValues()[0], 0);
+	solver.setCentralValues({-1, 2, 3});
+	EXPECT_EQ(solver.getCentralValues().size(), 3);
+	EXPECT_DOUBLE_EQ(solver.getCentralValues()[0], -1);
+	EXPECT_DOUBLE_EQ(solver.getCentralValues()[1], 2);
+	EXPECT_DOUBLE_EQ(solver.getCentralValues()[2], 3);
+	solver.setCentralValue(4);
+	EXPECT_EQ(solver.getCentralValues().size(), 1);
+	EXPECT_DOUBLE_EQ(solver.getCentralValues()[0], 4);
+
+	//Fail for an empty list of central values.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setCentralValues({});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ArnoldiIterator, getNumStates){
+	//Tested through ArnoldiIterator::spectrumSlicing.
+}
+
+TEST(ArnoldiIterator, getSlicesAreContiguous){
+	//Also tested through ArnoldiIterator::spectrumSlicing.
+	ArnoldiIterator solver;
+	EXPECT_TRUE(solver.getSlicesAreContiguous());
+}
+
+TEST(ArnoldiIterator, spectrumSlicing){
+	const int SIZE = 30;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++)
+		model << HoppingAmplitude(x, {x}, {x});
+	model.construct();
+
+	ArnoldiIterator solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMode(ArnoldiIterator::Mode::ShiftAndInvert);
+	solver.setNumLanczosVectors(25);
+	solver.setMaxIterations(20);
+	solver.setCalculateEigenVectors(true);
+
+	//Non-overlapping slices. The six eigenvalues closest to each central
+	//value are kept, while the eigenvalues in the gaps between the slices
+	//are missing, which is reported.
+	solver.setNumEigenValues(6);
+	solver.setCentralValues({4.5, 14.5, 24.5});
+	solver.run();
+	EXPECT_FALSE(solver.getSlicesAreContiguous());
+	EXPECT_EQ(solver.getNumStates(), 18);
+	for(unsigned int slice = 0; slice < 3; slice++){
+		for(unsigned int n = 0; n < 6; n++){
+			EXPECT_NEAR(
+				solver.getEigenValue(6*slice + n),
+				10*slice + 2 + n,
+				1e-5
+			);
+		}
+	}
+
+	//Overlapping slices. The duplicates are removed and every eigenvalue
+	//is found exactly once.
+	solver.setNumEigenValues(12);
+	solver.run();
+	EXPECT_TRUE(solver.getSlicesAreContiguous());
+	EXPECT_EQ(solver.getNumStates(), SIZE);
+	for(int n = 0; n < SIZE; n++){
+		EXPECT_NEAR(solver.getEigenValue(n), n, 1e-5);
+		EXPECT_NEAR(abs(solver.getAmplitude(n, {n})), 1, 1e-5);
+	}
+
+	//Fail in the normal mode.
+	solver.setMode(ArnoldiIterator::Mode::Normal);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 TEST(ArnoldiIterator, run){
 	//Already tested through
 	//ArnoldiIterator::setCentralValue()
@@ -292,5 +292,447 @@ TEST(BlockDiagonalizer, setParallelExecution){
 	//Tested through all other implemented tests.
 }
 
+TEST(BlockDiagonalizer, setLargeBlockThreshold){
+	//Tested through BlockDiagonalizer::getLargeBlockThreshold() and
+	//BlockDiagonalizer::parallelExecutionVaryingBlockSizes.
+}
+
+TEST(BlockDiagonalizer, getLargeBlockThreshold){
+	BlockDiagonalizer solver;
+	EXPECT_EQ(solver.getLargeBlockThreshold(), 0);
+	solver.setLargeBlockThreshold(100);
+	EXPECT_EQ(solver.getLargeBlockThreshold(), 100);
+}
+
+TEST(BlockDiagonalizer, getBlockSolveTime){
+	Model model;
+	model.setVerbose(false);
+	model << HoppingAmplitude(1, {0, 0}, {0, 1}) + HC;
+	model << HoppingAmplitude(1, {1, 0}, {1, 1}) + HC;
+	model.construct();
+
+	BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+
+	//Fail before the solver has been run.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.getBlockSolveTime({0, 0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	solver.run();
+	EXPECT_GE(solver.getBlockSolveTime({0, 0}), 0);
+	EXPECT_GE(solver.getBlockSolveTime({1, 1}), 0);
+}
+
+TEST(BlockDiagonalizer, parallelExecutionVaryingBlockSizes){
+	//Blocks of varying size give the same result independently of the
+	//scheduling.
+	Model model;
+	model.setVerbose(false);
+	srand(1);
+	const int NUM_BLOCKS = 6;
+	const int BLOCK_SIZES[NUM_BLOCKS] = {3, 40, 1, 12, 25, 5};
+	for(int block = 0; block < NUM_BLOCKS; block++){
+		for(int row = 0; row < BLOCK_SIZES[block]; row++){
+			model << HoppingAmplitude(
+				rand()/(double)RAND_MAX,
+				{block, row},
+				{block, row}
+			);
+			for(int col = row + 1; col < BLOCK_SIZES[block]; col++){
+				model << HoppingAmplitude(
+					std::complex<double>(
+						rand()/(double)RAND_MAX - 0.5,
+						rand()/(double)RAND_MAX - 0.5
+					),
+					{block, row},
+					{block, col}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+	BlockDiagonalizer solvers[3];
+	for(unsigned int n = 0; n < 3; n++){
+		solvers[n].setVerbose(false);
+		solvers[n].setModel(model);
+	}
+	solvers[1].setParallelExecution(true);
+	solvers[2].setParallelExecution(true);
+	solvers[2].setLargeBlockThreshold(20);
+	for(unsigned int n = 0; n < 3; n++)
+		solvers[n].run();
+
+	for(unsigned int n = 1; n < 3; n++){
+		for(int block = 0; block < NUM_BLOCKS; block++){
+			for(int state = 0; state < BLOCK_SIZES[block]; state++){
+				EXPECT_DOUBLE_EQ(
+					solvers[n].getEigenValue({block}, state),
+					solvers[0].getEigenValue({block}, state)
+				);
+				for(int c = 0; c < BLOCK_SIZES[block]; c++){
+					EXPECT_EQ(
+						solvers[n].getAmplitude(
+							{block},
+							state,
+							{c}
+						),
+						solvers[0].getAmplitude(
+							{block},
+							state,
+							{c}
+						)
+					);
+				}
+			}
+		}
+	}
+}
+
+TEST(BlockDiagonalizer, setStreamEigenVectors){
+	//Tested through BlockDiagonalizer::getStreamEigenVectors() and
+	//BlockDiagonalizer::addBlockCallback().
+}
+
+TEST(BlockDiagonalizer, getStreamEigenVectors){
+	BlockDiagonalizer solver;
+	EXPECT_FALSE(solver.getStreamEigenVectors());
+	solver.setStreamEigenVectors(true);
+	EXPECT_TRUE(solver.getStreamEigenVectors());
+}
+
+//BlockCallback that compares the streamed eigenstates with those of a solver
+//that stores all eigenstates.
+class ComparingBlockCallback : public BlockDiagonalizer::BlockCallback{
+public:
+	ComparingBlockCallback(const BlockDiagonalizer &referenceSolver) :
+		referenceSolver(referenceSolver),
+		numDiagonalizations(0),
+		numProcessedStates(0)
+	{
+	}
+
+	virtual void beginDiagonalization(){
+		numDiagonalizations++;
+		numProcessedStates = 0;
+	}
+
+	virtual void processBlock(
+		const BlockDiagonalizer &blockDiagonalizer,
+		unsigned int firstState,
+		unsigned int lastState
+	){
+		EXPECT_EQ(firstState, numProcessedStates);
+		int block = firstState/2;
+		EXPECT_EQ(
+			blockDiagonalizer.getFirstStateInBlock({block, 0}),
+			firstState
+		);
+		EXPECT_EQ(
+			blockDiagonalizer.getLastStateInBlock({block, 0}),
+			lastState
+		);
+		for(unsigned int n = firstState; n <= lastState; n++){
+			EXPECT_DOUBLE_EQ(
+				blockDiagonalizer.getEigenValue(n),
+				referenceSolver.getEigenValue(n)
+			);
+			for(int c = 0; c < 2; c++){
+				EXPECT_EQ(
+					blockDiagonalizer.getAmplitude(n, {block, c}),
+					referenceSolver.getAmplitude(n, {block, c})
+				);
+			}
+		}
+		numProcessedStates += lastState - firstState + 1;
+	}
+
+	const BlockDiagonalizer &referenceSolver;
+	unsigned int numDiagonalizations;
+	unsigned int numProcessedStates;
+};
+
+TEST(BlockDiagonalizer, addBlockCallback){
+	Model model;
+	model.setVerbose(false);
+	const int NUM_BLOCKS = 5;
+	for(int k = 0; k < NUM_BLOCKS; k++){
+		model << HoppingAmplitude(k, {k, 0}, {k, 0});
+		model << HoppingAmplitude(-k, {k, 1}, {k, 1});
+		model << HoppingAmplitude(
+			std::complex<double>(1, 1),
+			{k, 0},
+			{k, 1}
+		) + HC;
+	}
+	model.construct();
+
+	BlockDiagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	ComparingBlockCallback blockCallback(referenceSolver);
+	BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setStreamEigenVectors(true);
+	solver.addBlockCallback(blockCallback);
+	solver.run();
+	EXPECT_EQ(blockCallback.numDiagonalizations, 1);
+	EXPECT_EQ(blockCallback.numProcessedStates, 2*NUM_BLOCKS);
+
+	//The eigenvalues are available for all blocks after the run.
+	for(int n = 0; n < 2*NUM_BLOCKS; n++){
+		EXPECT_DOUBLE_EQ(
+			solver.getEigenValue(n),
+			referenceSolver.getEigenValue(n)
+		);
+	}
+
+	//The eigenvectors are only available for the last block.
+	EXPECT_EQ(
+		solver.getAmplitude(2*NUM_BLOCKS - 1, {NUM_BLOCKS - 1, 0}),
+		referenceSolver.getAmplitude(
+			2*NUM_BLOCKS - 1,
+			{NUM_BLOCKS - 1, 0}
+		)
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.getAmplitude(0, {0, 0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Disabling streaming does not change how the eigenvectors from the
+	//last run are stored.
+	solver.setStreamEigenVectors(false);
+	EXPECT_EQ(
+		solver.getAmplitude(2*NUM_BLOCKS - 1, {NUM_BLOCKS - 1, 0}),
+		referenceSolver.getAmplitude(
+			2*NUM_BLOCKS - 1,
+			{NUM_BLOCKS - 1, 0}
+		)
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.getAmplitude(0, {0, 0});
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Real Hamiltonian.
+	Model realModel;
+	realModel.setVerbose(false);
+	for(int k = 0; k < NUM_BLOCKS; k++){
+		realModel << HoppingAmplitude(k, {k, 0}, {k, 0});
+		realModel << HoppingAmplitude(-k, {k, 1}, {k, 1});
+		realModel << HoppingAmplitude(1, {k, 0}, {k, 1}) + HC;
+	}
+	realModel.construct();
+
+	BlockDiagonalizer realReferenceSolver;
+	realReferenceSolver.setVerbose(false);
+	realReferenceSolver.setModel(realModel);
+	realReferenceSolver.run();
+
+	ComparingBlockCallback realBlockCallback(realReferenceSolver);
+	BlockDiagonalizer realSolver;
+	realSolver.setVerbose(false);
+	realSolver.setModel(realModel);
+	realSolver.setStreamEigenVectors(true);
+	realSolver.addBlockCallback(realBlockCallback);
+	realSolver.run();
+	EXPECT_TRUE(realSolver.getHamiltonianIsReal());
+	EXPECT_EQ(realBlockCallback.numProcessedStates, 2*NUM_BLOCKS);
+}
+
+TEST(BlockDiagonalizer, clearBlockCallbacks){
+	Model model;
+	model.setVerbose(false);
+	model << HoppingAmplitude(1, {0, 0}, {0, 1}) + HC;
+	model.construct();
+
+	BlockDiagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	ComparingBlockCallback blockCallback(referenceSolver);
+	BlockDiagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setStreamEigenVectors(true);
+	solver.addBlockCallback(blockCallback);
+	solver.clearBlockCallbacks();
+	solver.run();
+	EXPECT_EQ(blockCallback.numDiagonalizations, 0);
+}
+
+TEST(BlockDiagonalizer, setUseRealArithmetic){
+	//Tested through BlockDiagonalizer::getUseRealArithmetic() and
+	//BlockDiagonalizer::realArithmetic.
+}
+
+TEST(BlockDiagonalizer, getUseRealArithmetic){
+	BlockDiagonalizer solver;
+	EXPECT_TRUE(solver.getUseRealArithmetic());
+	solver.setUseRealArithmetic(false);
+	EXPECT_FALSE(solver.getUseRealArithmetic());
+}
+
+TEST(BlockDiagonalizer, getHamiltonianIsReal){
+	//Tested through BlockDiagonalizer::realArithmetic.
+}
+
+TEST(BlockDiagonalizer, realArithmetic){
+	//Real and complex arithmetic gives the same eigenstates for a real
+	//Hamiltonian.
+	const int NUM_BLOCKS = 4;
+	const int BLOCK_SIZE = 10;
+	Model model;
+	model.setVerbose(false);
+	srand(1);
+	for(int block = 0; block < NUM_BLOCKS; block++){
+		for(int row = 0; row < BLOCK_SIZE; row++){
+			model << HoppingAmplitude(
+				rand()/(double)RAND_MAX,
+				{block, row},
+				{block, row}
+			);
+			for(int col = row + 1; col < BLOCK_SIZE; col++){
+				model << HoppingAmplitude(
+					rand()/(double)RAND_MAX - 0.5,
+					{block, row},
+					{block, col}
+				) + HC;
+			}
+		}
+	}
+	model.construct();
+
+	BlockDiagonalizer solver0;
+	solver0.setVerbose(false);
+	solver0.setModel(model);
+	solver0.run();
+	EXPECT_TRUE(solver0.getHamiltonianIsReal());
+
+	BlockDiagonalizer solver1;
+	solver1.setVerbose(false);
+	solver1.setModel(model);
+	solver1.setUseRealArithmetic(false);
+	solver1.run();
+	EXPECT_FALSE(solver1.getHamiltonianIsReal());
+
+	const double EPSILON_10000
+		= 10000*std::numeric_limits<double>::epsilon();
+	for(int block = 0; block < NUM_BLOCKS; block++){
+		for(int state = 0; state < BLOCK_SIZE; state++){
+			EXPECT_NEAR(
+				solver0.getEigenValue({block}, state),
+				solver1.getEigenValue({block}, state),
+				EPSILON_10000
+			);
+
+			//The eigenvectors are only defined up to a phase, so
+			//the overlap is compared instead.
+			std::complex<double> overlap = 0;
+			for(int c = 0; c < BLOCK_SIZE; c++){
+				overlap += conj(
+					solver0.getAmplitude({block}, state, {c})
+				)*solver1.getAmplitude({block}, state, {c});
+			}
+			EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+		}
+	}
+
+	//A complex Hamiltonian is diagonalized using complex arithmetic.
+	Model model1;
+	model1.setVerbose(false);
+	model1 << HoppingAmplitude(std::complex<double>(0, 1), {0, 0}, {0, 1}) + HC;
+	model1.construct();
+
+	BlockDiagonalizer solver2;
+	solver2.setVerbose(false);
+	solver2.setModel(model1);
+	solver2.run();
+	EXPECT_FALSE(solver2.getHamiltonianIsReal());
+	EXPECT_DOUBLE_EQ(solver2.getEigenValue(0), -1);
+	EXPECT_DOUBLE_EQ(solver2.getEigenValue(1), 1);
+}
+
+//Hopping amplitude 1 + i*phase between {0, 0} and {0, 1}.
+class ComplexifyingAmplitude : public HoppingAmplitude::AmplitudeCallback{
+public:
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		if(to[1] == 0)
+			return std::complex<double>(1, phase);
+		else
+			return std::complex<double>(1, -phase);
+	}
+
+	double phase;
+};
+
+//Makes the ComplexifyingAmplitude complex after the first iteration.
+class ComplexifyingCallback :
+	public BlockDiagonalizer::SelfConsistencyCallback
+{
+public:
+	bool selfConsistencyCallback(BlockDiagonalizer &diagonalizer){
+		if(amplitude->phase != 0)
+			return true;
+
+		amplitude->phase = 1;
+		return false;
+	}
+
+	ComplexifyingAmplitude *amplitude;
+};
+
+TEST(BlockDiagonalizer, realArithmeticSelfConsistency){
+	//The Hamiltonian is real in the first iteration and complex in the
+	//second. The second diagonalization must use complex arithmetic.
+	ComplexifyingAmplitude amplitude;
+	amplitude.phase = 0;
+	Model model;
+	model.setVerbose(false);
+	model << HoppingAmplitude(amplitude, {0, 0}, {0, 1});
+	model << HoppingAmplitude(amplitude, {0, 1}, {0, 0});
+	model.construct();
+
+	ComplexifyingCallback callback;
+	callback.amplitude = &amplitude;
+	const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+	for(unsigned int n = 0; n < 2; n++){
+		amplitude.phase = 0;
+		BlockDiagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setStreamEigenVectors(n == 1);
+		solver.setSelfConsistencyCallback(callback);
+		solver.setMaxIterations(2);
+		solver.run();
+		EXPECT_FALSE(solver.getHamiltonianIsReal());
+		EXPECT_NEAR(solver.getEigenValue(0), -sqrt(2.), EPSILON_100);
+		EXPECT_NEAR(solver.getEigenValue(1), sqrt(2.), EPSILON_100);
+	}
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
@@ -181,6 +181,29 @@ TEST(ChebyshevExpander, getUseLookupTable){
 	EXPECT_TRUE(solver.getUseLookupTable());
 }
 
+TEST(ChebyshevExpander, setBlockSize){
+	ChebyshevExpander solver;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setBlockSize(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(ChebyshevExpander, getBlockSize){
+	ChebyshevExpander solver;
+
+	//Default value is 16.
+	EXPECT_EQ(solver.getBlockSize(), 16);
+
+	//Test setting and getting.
+	solver.setBlockSize(4);
+	EXPECT_EQ(solver.getBlockSize(), 4);
+}
+
 TEST(ChebyshevExpander, calculateCoefficients){
 	const int SIZE = 5;
 	const double mu = -2;
@@ -368,6 +391,461 @@ TEST(ChebyshevExpander, calculateCoefficients){
 	#endif
 }
 
+TEST(ChebyshevExpander, calculateCoefficientsBlock){
+	const int SIZE = 5;
+	const double mu = -2;
+	const double t = 1;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(-mu, {x,		y},		{x, y});
+			model << HoppingAmplitude(-t, {(x+1)%SIZE,	y},		{x, y}) + HC;
+			model << HoppingAmplitude(
+				std::complex<double>(0, t),
+				{x,		(y+1)%SIZE},
+				{x, y}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(100);
+	solver.setBroadening(1e-3);
+
+	const double EPSILON_1000
+		= 1000*std::numeric_limits<double>::epsilon();
+
+	std::vector<Index> toIndices;
+	toIndices.push_back({0, 0});
+	toIndices.push_back({1, 0});
+	toIndices.push_back({2, 3});
+	std::vector<Index> fromIndices;
+	fromIndices.push_back({0, 0});
+	fromIndices.push_back({0, 1});
+	fromIndices.push_back({3, 2});
+	fromIndices.push_back({4, 4});
+	fromIndices.push_back({1, 0});
+
+	//Use a block size that does not divide the number of from-Indices to
+	//also test the last partial block.
+	for(unsigned int blockSize = 1; blockSize < 7; blockSize += 2){
+		solver.setBlockSize(blockSize);
+		std::vector<
+			std::vector<std::vector<std::complex<double>>>
+		> coefficients = solver.calculateCoefficients(
+			toIndices,
+			fromIndices
+		);
+		ASSERT_EQ(coefficients.size(), fromIndices.size());
+		for(unsigned int f = 0; f < fromIndices.size(); f++){
+			std::vector<
+				std::vector<std::complex<double>>
+			> reference = solver.calculateCoefficients(
+				toIndices,
+				fromIndices[f]
+			);
+			ASSERT_EQ(coefficients[f].size(), toIndices.size());
+			for(unsigned int c = 0; c < toIndices.size(); c++){
+				ASSERT_EQ(coefficients[f][c].size(), 100);
+				for(unsigned int n = 0; n < 100; n++){
+					EXPECT_NEAR(
+						real(coefficients[f][c][n]),
+						real(reference[c][n]),
+						EPSILON_1000
+					);
+					EXPECT_NEAR(
+						imag(coefficients[f][c][n]),
+						imag(reference[c][n]),
+						EPSILON_1000
+					);
+				}
+			}
+		}
+	}
+}
+
+TEST(ChebyshevExpander, calculateDiagonalCoefficients){
+	const int SIZE = 5;
+	const double mu = -2;
+	const double t = 1;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(-mu, {x,		y},		{x, y});
+			model << HoppingAmplitude(-t, {(x+1)%SIZE,	y},		{x, y}) + HC;
+			model << HoppingAmplitude(
+				std::complex<double>(0, t),
+				{x,		(y+1)%SIZE},
+				{x, y}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(100);
+	solver.setBroadening(1e-3);
+
+	const double EPSILON_1000
+		= 1000*std::numeric_limits<double>::epsilon();
+
+	std::vector<Index> indices;
+	indices.push_back({0, 0});
+	indices.push_back({0, 1});
+	indices.push_back({3, 2});
+	indices.push_back({4, 4});
+	indices.push_back({1, 0});
+
+	//Compare to the single Index calculation, using a block size that does
+	//not divide the number of Indices to also test the last partial block.
+	for(unsigned int blockSize = 1; blockSize < 7; blockSize += 2){
+		solver.setBlockSize(blockSize);
+		std::vector<std::vector<std::complex<double>>> coefficients
+			= solver.calculateDiagonalCoefficients(indices);
+		ASSERT_EQ(coefficients.size(), indices.size());
+		for(unsigned int c = 0; c < indices.size(); c++){
+			std::vector<std::complex<double>> reference
+				= solver.calculateCoefficients(
+					indices[c],
+					indices[c]
+				);
+			ASSERT_EQ(coefficients[c].size(), 100);
+			for(unsigned int n = 0; n < 100; n++){
+				EXPECT_NEAR(
+					real(coefficients[c][n]),
+					real(reference[n]),
+					EPSILON_1000
+				);
+				EXPECT_NEAR(
+					imag(coefficients[c][n]),
+					imag(reference[n]),
+					EPSILON_1000
+				);
+			}
+		}
+	}
+}
+
+TEST(ChebyshevExpander, calculateCoefficientsCallbackUpdate){
+	//Coefficients calculated after a parameter change that only affects
+	//callback dependent HoppingAmplitudes agree with those calculated by
+	//a new solver.
+	class PotentialCallback : public HoppingAmplitude::AmplitudeCallback{
+	public:
+		std::complex<double> getHoppingAmplitude(
+			const Index &to,
+			const Index &from
+		) const{
+			return potential*(to[0] + 1);
+		}
+
+		double potential;
+	} potentialCallback;
+	potentialCallback.potential = 0.5;
+
+	const int SIZE = 10;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(-1, {(x+1)%SIZE}, {x}) + HC;
+		model << HoppingAmplitude(potentialCallback, {x}, {x});
+	}
+	model << HoppingAmplitude(potentialCallback, {0}, {0});
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(30);
+	solver.setNumCoefficients(100);
+
+	std::vector<Index> toIndices;
+	for(int x = 0; x < SIZE; x++)
+		toIndices.push_back({x});
+
+	const double EPSILON_1000
+		= 1000*std::numeric_limits<double>::epsilon();
+	for(unsigned int n = 0; n < 3; n++){
+		potentialCallback.potential = (int)n - 1;
+		std::vector<
+			std::vector<std::complex<double>>
+		> coefficients = solver.calculateCoefficients(
+			toIndices,
+			Index({0})
+		);
+
+		ChebyshevExpander referenceSolver;
+		referenceSolver.setVerbose(false);
+		referenceSolver.setModel(model);
+		referenceSolver.setScaleFactor(30);
+		referenceSolver.setNumCoefficients(100);
+		std::vector<
+			std::vector<std::complex<double>>
+		> reference = referenceSolver.calculateCoefficients(
+			toIndices,
+			Index({0})
+		);
+
+		for(unsigned int c = 0; c < toIndices.size(); c++){
+			for(unsigned int m = 0; m < 100; m++){
+				EXPECT_NEAR(
+					real(coefficients[c][m]),
+					real(reference[c][m]),
+					EPSILON_1000
+				);
+				EXPECT_NEAR(
+					imag(coefficients[c][m]),
+					imag(reference[c][m]),
+					EPSILON_1000
+				);
+			}
+		}
+	}
+
+	//The coefficients for a potential of one are not the same as for a
+	//potential of zero, which ensures that the update takes effect.
+	potentialCallback.potential = 0;
+	std::vector<
+		std::vector<std::complex<double>>
+	> coefficients0 = solver.calculateCoefficients(
+		toIndices,
+		Index({0})
+	);
+	potentialCallback.potential = 1;
+	std::vector<
+		std::vector<std::complex<double>>
+	> coefficients1 = solver.calculateCoefficients(
+		toIndices,
+		Index({0})
+	);
+	EXPECT_GT(std::abs(coefficients1[0][1] - coefficients0[0][1]), 0.01);
+}
+
+TEST(ChebyshevExpander, calculateCoefficientsModelUpdate){
+	//Coefficients calculated after the Model has been replaced by a Model
+	//with the same structure but different amplitudes agree with those
+	//calculated by a new solver.
+	const int SIZE = 10;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++)
+		model << HoppingAmplitude(-1, {(x+1)%SIZE}, {x}) + HC;
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(100);
+
+	std::vector<Index> toIndices;
+	for(int x = 0; x < SIZE; x++)
+		toIndices.push_back({x});
+	solver.calculateCoefficients(toIndices, Index({0}));
+
+	Model updatedModel;
+	updatedModel.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		updatedModel << HoppingAmplitude(-2, {(x+1)%SIZE}, {x}) + HC;
+	}
+	updatedModel.construct();
+	model = updatedModel;
+
+	std::vector<
+		std::vector<std::complex<double>>
+	> coefficients = solver.calculateCoefficients(
+		toIndices,
+		Index({0})
+	);
+
+	ChebyshevExpander referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(updatedModel);
+	referenceSolver.setScaleFactor(10);
+	referenceSolver.setNumCoefficients(100);
+	std::vector<
+		std::vector<std::complex<double>>
+	> reference = referenceSolver.calculateCoefficients(
+		toIndices,
+		Index({0})
+	);
+
+	const double EPSILON_1000
+		= 1000*std::numeric_limits<double>::epsilon();
+	for(unsigned int c = 0; c < toIndices.size(); c++){
+		for(unsigned int m = 0; m < 100; m++){
+			EXPECT_NEAR(
+				real(coefficients[c][m]),
+				real(reference[c][m]),
+				EPSILON_1000
+			);
+			EXPECT_NEAR(
+				imag(coefficients[c][m]),
+				imag(reference[c][m]),
+				EPSILON_1000
+			);
+		}
+	}
+}
+
+TEST(ChebyshevExpander, calculateTraceCoefficients0){
+	//For a diagonal Hamiltonian every random-phase vector gives the exact
+	//trace.
+	const int SIZE = 7;
+	const double SCALE_FACTOR = 10;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++)
+		model << HoppingAmplitude(x - 3.5, {x}, {x});
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(SCALE_FACTOR);
+	solver.setBroadening(0);
+	solver.setBlockSize(2);
+
+	const double EPSILON_10000
+		= 10000*std::numeric_limits<double>::epsilon();
+
+	//Test both an even and an odd number of coefficients.
+	for(int numCoefficients = 100; numCoefficients < 102; numCoefficients++){
+		solver.setNumCoefficients(numCoefficients);
+		std::vector<std::vector<std::complex<double>>> coefficients
+			= solver.calculateTraceCoefficients(3, 0);
+		ASSERT_EQ(coefficients.size(), 3);
+		for(unsigned int r = 0; r < coefficients.size(); r++){
+			ASSERT_EQ(coefficients[r].size(), numCoefficients);
+			for(int n = 0; n < numCoefficients; n++){
+				double reference = 0;
+				for(int x = 0; x < SIZE; x++){
+					reference += cos(
+						n*acos((x - 3.5)/SCALE_FACTOR)
+					);
+				}
+				EXPECT_NEAR(
+					real(coefficients[r][n]),
+					reference,
+					EPSILON_10000
+				);
+				EXPECT_NEAR(
+					imag(coefficients[r][n]),
+					0,
+					EPSILON_10000
+				);
+			}
+		}
+	}
+}
+
+TEST(ChebyshevExpander, calculateTraceCoefficients1){
+	const int SIZE = 5;
+	const double t = 1;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		for(int y = 0; y < SIZE; y++){
+			model << HoppingAmplitude(-t, {(x+1)%SIZE, y}, {x, y}) + HC;
+			model << HoppingAmplitude(
+				std::complex<double>(0, t),
+				{x,		(y+1)%SIZE},
+				{x, y}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	ChebyshevExpander solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setScaleFactor(10);
+	solver.setNumCoefficients(51);
+	solver.setBroadening(1e-3);
+
+	const unsigned int NUM_RANDOM_VECTORS = 200;
+	const double EPSILON_10000
+		= 10000*std::numeric_limits<double>::epsilon();
+
+	//The result does not depend on the block size.
+	solver.setBlockSize(1);
+	std::vector<std::vector<std::complex<double>>> reference
+		= solver.calculateTraceCoefficients(NUM_RANDOM_VECTORS, 1);
+	for(unsigned int blockSize = 3; blockSize < 20; blockSize += 8){
+		solver.setBlockSize(blockSize);
+		std::vector<std::vector<std::complex<double>>> coefficients
+			= solver.calculateTraceCoefficients(
+				NUM_RANDOM_VECTORS,
+				1
+			);
+		ASSERT_EQ(coefficients.size(), NUM_RANDOM_VECTORS);
+		for(unsigned int r = 0; r < NUM_RANDOM_VECTORS; r++){
+			for(unsigned int n = 0; n < 51; n++){
+				EXPECT_NEAR(
+					real(coefficients[r][n]),
+					real(reference[r][n]),
+					EPSILON_10000
+				);
+				EXPECT_NEAR(
+					imag(coefficients[r][n]),
+					imag(reference[r][n]),
+					EPSILON_10000
+				);
+			}
+		}
+	}
+
+	//The zeroth coefficient is exactly the basis size.
+	for(unsigned int r = 0; r < NUM_RANDOM_VECTORS; r++)
+		EXPECT_NEAR(real(reference[r][0]), SIZE*SIZE, EPSILON_10000);
+
+	//The average agrees with the exact trace within the statistical
+	//error.
+	std::vector<Index> indices;
+	for(int x = 0; x < SIZE; x++)
+		for(int y = 0; y < SIZE; y++)
+			indices.push_back({x, y});
+	std::vector<std::complex<double>> trace(51, 0);
+	for(unsigned int n = 0; n < indices.size(); n++){
+		std::vector<std::complex<double>> coefficients
+			= solver.calculateCoefficients(indices[n], indices[n]);
+		for(unsigned int c = 0; c < 51; c++)
+			trace[c] += coefficients[c];
+	}
+	for(unsigned int c = 0; c < 51; c++){
+		double mean = 0;
+		double meanSquared = 0;
+		for(unsigned int r = 0; r < NUM_RANDOM_VECTORS; r++){
+			mean += real(reference[r][c])/NUM_RANDOM_VECTORS;
+			meanSquared += pow(real(reference[r][c]), 2)
+				/NUM_RANDOM_VECTORS;
+		}
+		double error = sqrt(
+			(meanSquared - mean*mean)/(NUM_RANDOM_VECTORS - 1)
+		);
+		EXPECT_NEAR(mean, real(trace[c]), 5*error + EPSILON_10000);
+	}
+
+	//Fail for zero random vectors.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.calculateTraceCoefficients(0, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 TEST(ChebyshevExpander, generateGreensFunction0){
 	const double SCALE_FACTOR = 10;
 	Range energyWindow(-5, 5, 10);
@@ -62,6 +62,401 @@ TEST(Diagonalizer, setMaxIterations){
 	//Tested through Diagonalizer::setSelfConsistencyCallback
 }
 
+TEST(Diagonalizer, setAlgorithm){
+	//Tested through Diagonalizer::getAlgorithm().
+}
+
+TEST(Diagonalizer, getAlgorithm){
+	Diagonalizer solver;
+	EXPECT_EQ(solver.getAlgorithm(), Diagonalizer::Algorithm::PackedQR);
+	solver.setAlgorithm(Diagonalizer::Algorithm::DivideAndConquer);
+	EXPECT_EQ(
+		solver.getAlgorithm(),
+		Diagonalizer::Algorithm::DivideAndConquer
+	);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	EXPECT_EQ(solver.getAlgorithm(), Diagonalizer::Algorithm::MRRR);
+}
+
+//Model with a random Hermitian Hamiltonian that is used to compare the
+//different algorithms. The Hamiltonian is real symmetric if isReal is true.
+Model createRandomModel(unsigned int size, bool isReal = false){
+	Model model;
+	model.setVerbose(false);
+	srand(1);
+	for(unsigned int row = 0; row < size; row++){
+		model << HoppingAmplitude(
+			rand()/(double)RAND_MAX - 0.5,
+			{(int)row},
+			{(int)row}
+		);
+		for(unsigned int col = row + 1; col < size; col++){
+			model << HoppingAmplitude(
+				std::complex<double>(
+					rand()/(double)RAND_MAX - 0.5,
+					isReal ? 0 : rand()/(double)RAND_MAX - 0.5
+				),
+				{(int)row},
+				{(int)col}
+			) + HC;
+		}
+	}
+	model.construct();
+
+	return model;
+}
+
+//Verify that the eigenstates of the solver are eigenstates of the
+//reference solver, starting at the given state in the reference solver.
+void verifyEigenStates(
+	const Diagonalizer &solver,
+	const Diagonalizer &referenceSolver,
+	unsigned int firstReferenceState
+){
+	const double EPSILON_10000
+		= 10000*std::numeric_limits<double>::epsilon();
+	const unsigned int basisSize
+		= referenceSolver.getModel().getBasisSize();
+	for(unsigned int n = 0; n < solver.getNumStates(); n++){
+		const unsigned int reference = n + firstReferenceState;
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			referenceSolver.getEigenValue(reference),
+			EPSILON_10000
+		);
+
+		//The eigenvectors are only defined up to a phase, so the
+		//overlap is compared instead.
+		std::complex<double> overlap = 0;
+		for(unsigned int c = 0; c < basisSize; c++){
+			overlap += conj(
+				solver.getAmplitude(n, {(int)c})
+			)*referenceSolver.getAmplitude(reference, {(int)c});
+		}
+		EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+	}
+}
+
+TEST(Diagonalizer, DivideAndConquer){
+	Model model = createRandomModel(50);
+
+	Diagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::DivideAndConquer);
+	solver.run();
+
+	EXPECT_EQ(solver.getNumStates(), 50);
+	verifyEigenStates(solver, referenceSolver, 0);
+}
+
+TEST(Diagonalizer, MRRR){
+	Model model = createRandomModel(50);
+
+	Diagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.run();
+
+	EXPECT_EQ(solver.getNumStates(), 50);
+	verifyEigenStates(solver, referenceSolver, 0);
+}
+
+TEST(Diagonalizer, setStateRange0){
+	Model model = createRandomModel(50);
+
+	Diagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setStateRange(10, 19);
+	solver.run();
+
+	EXPECT_EQ(solver.getNumStates(), 10);
+	EXPECT_EQ(solver.getEigenVectors().getSize(), 50*10);
+	verifyEigenStates(solver, referenceSolver, 10);
+}
+
+TEST(Diagonalizer, setStateRange1){
+	Model model = createRandomModel(10);
+
+	//Fail for first > last.
+	Diagonalizer solver0;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver0.setStateRange(2, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for algorithms that do not support partial spectra.
+	Diagonalizer solver1;
+	solver1.setVerbose(false);
+	solver1.setModel(model);
+	solver1.setStateRange(0, 1);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver1.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for states outside of the basis.
+	Diagonalizer solver2;
+	solver2.setVerbose(false);
+	solver2.setModel(model);
+	solver2.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver2.setStateRange(5, 10);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver2.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, setEnergyRange0){
+	Model model = createRandomModel(50);
+
+	Diagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.run();
+
+	const double LOWER_BOUND = -1;
+	const double UPPER_BOUND = 0.5;
+	unsigned int firstState = 0;
+	while(referenceSolver.getEigenValue(firstState) <= LOWER_BOUND)
+		firstState++;
+	unsigned int lastState = firstState;
+	while(referenceSolver.getEigenValue(lastState + 1) <= UPPER_BOUND)
+		lastState++;
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setEnergyRange(LOWER_BOUND, UPPER_BOUND);
+	solver.run();
+
+	EXPECT_EQ(solver.getNumStates(), lastState - firstState + 1);
+	verifyEigenStates(solver, referenceSolver, firstState);
+}
+
+TEST(Diagonalizer, setEnergyRange1){
+	//Fail for lower >= upper.
+	Diagonalizer solver;
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setEnergyRange(1, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Diagonalizer, setCalculateAllStates){
+	Model model = createRandomModel(20);
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setStateRange(0, 4);
+	solver.run();
+	EXPECT_EQ(solver.getNumStates(), 5);
+
+	solver.setCalculateAllStates();
+	solver.run();
+	EXPECT_EQ(solver.getNumStates(), 20);
+}
+
+TEST(Diagonalizer, setUseRealArithmetic){
+	//Tested through Diagonalizer::getUseRealArithmetic() and
+	//Diagonalizer::getHamiltonianIsReal().
+}
+
+TEST(Diagonalizer, getUseRealArithmetic){
+	Diagonalizer solver;
+	EXPECT_TRUE(solver.getUseRealArithmetic());
+	solver.setUseRealArithmetic(false);
+	EXPECT_FALSE(solver.getUseRealArithmetic());
+}
+
+TEST(Diagonalizer, getHamiltonianIsReal){
+	Model model0 = createRandomModel(10, true);
+	Model model1 = createRandomModel(10, false);
+
+	Diagonalizer solver0;
+	solver0.setVerbose(false);
+	solver0.setModel(model0);
+	solver0.run();
+	EXPECT_TRUE(solver0.getHamiltonianIsReal());
+
+	Diagonalizer solver1;
+	solver1.setVerbose(false);
+	solver1.setModel(model1);
+	solver1.run();
+	EXPECT_FALSE(solver1.getHamiltonianIsReal());
+
+	Diagonalizer solver2;
+	solver2.setVerbose(false);
+	solver2.setModel(model0);
+	solver2.setUseRealArithmetic(false);
+	solver2.run();
+	EXPECT_FALSE(solver2.getHamiltonianIsReal());
+}
+
+TEST(Diagonalizer, realArithmetic){
+	//Every algorithm gives the same eigenstates using real and complex
+	//arithmetic.
+	Model model = createRandomModel(50, true);
+
+	Diagonalizer referenceSolver;
+	referenceSolver.setVerbose(false);
+	referenceSolver.setModel(model);
+	referenceSolver.setUseRealArithmetic(false);
+	referenceSolver.run();
+
+	Diagonalizer::Algorithm algorithms[3] = {
+		Diagonalizer::Algorithm::PackedQR,
+		Diagonalizer::Algorithm::DivideAndConquer,
+		Diagonalizer::Algorithm::MRRR
+	};
+	for(unsigned int n = 0; n < 3; n++){
+		Diagonalizer solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setAlgorithm(algorithms[n]);
+		solver.run();
+
+		EXPECT_TRUE(solver.getHamiltonianIsReal());
+		EXPECT_EQ(solver.getNumStates(), 50);
+		verifyEigenStates(solver, referenceSolver, 0);
+	}
+
+	//Partial spectrum.
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setStateRange(5, 14);
+	solver.run();
+	EXPECT_EQ(solver.getNumStates(), 10);
+	verifyEigenStates(solver, referenceSolver, 5);
+
+	//The eigenvectors are kept real by default.
+	EXPECT_TRUE(solver.getEigenVectorsAreReal());
+	const CArray<double> &realEigenVectors = solver.getRealEigenVectors();
+	EXPECT_EQ(realEigenVectors.getSize(), 50*10);
+
+	//A complex copy is created on request through getEigenVectors(),
+	//leaving the real eigenvectors untouched.
+	const CArray<std::complex<double>> &eigenVectors
+		= solver.getEigenVectors();
+	EXPECT_EQ(eigenVectors.getSize(), 50*10);
+	EXPECT_TRUE(solver.getEigenVectorsAreReal());
+	for(unsigned int n = 0; n < eigenVectors.getSize(); n++){
+		EXPECT_DOUBLE_EQ(real(eigenVectors[n]), realEigenVectors[n]);
+		EXPECT_DOUBLE_EQ(imag(eigenVectors[n]), 0);
+	}
+
+	//The real eigenvectors are converted to complex numbers through
+	//getEigenVectorsRW(), after which they are no longer real.
+	std::complex<double> amplitude = solver.getAmplitude(3, {7});
+	const CArray<std::complex<double>> &convertedEigenVectors
+		= solver.getEigenVectorsRW();
+	EXPECT_FALSE(solver.getEigenVectorsAreReal());
+	EXPECT_EQ(&convertedEigenVectors, &eigenVectors);
+	EXPECT_EQ(convertedEigenVectors.getSize(), 50*10);
+	EXPECT_DOUBLE_EQ(
+		real(convertedEigenVectors[3*50 + 7]),
+		real(amplitude)
+	);
+	EXPECT_DOUBLE_EQ(imag(convertedEigenVectors[3*50 + 7]), 0);
+	EXPECT_DOUBLE_EQ(
+		real(solver.getAmplitude(3, {7})),
+		real(amplitude)
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.getRealEigenVectors();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//The eigenvectors can be converted to complex numbers directly after
+	//the diagonalization.
+	Diagonalizer complexSolver;
+	complexSolver.setVerbose(false);
+	complexSolver.setModel(model);
+	complexSolver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	complexSolver.setStateRange(5, 14);
+	complexSolver.setKeepRealEigenVectors(false);
+	complexSolver.run();
+	verifyEigenStates(complexSolver, referenceSolver, 5);
+	EXPECT_TRUE(complexSolver.getHamiltonianIsReal());
+	EXPECT_FALSE(complexSolver.getEigenVectorsAreReal());
+	EXPECT_EQ(complexSolver.getEigenVectors().getSize(), 50*10);
+}
+
+TEST(Diagonalizer, setKeepRealEigenVectors){
+	//Tested through Diagonalizer::realArithmetic.
+}
+
+TEST(Diagonalizer, getKeepRealEigenVectors){
+	Diagonalizer solver;
+	EXPECT_TRUE(solver.getKeepRealEigenVectors());
+	solver.setKeepRealEigenVectors(false);
+	EXPECT_FALSE(solver.getKeepRealEigenVectors());
+}
+
+TEST(Diagonalizer, getEigenVectorsAreReal){
+	//Tested through Diagonalizer::realArithmetic.
+}
+
+TEST(Diagonalizer, getRealEigenVectors){
+	//Tested through Diagonalizer::realArithmetic.
+}
+
+TEST(Diagonalizer, getNumStates){
+	//Also tested through Diagonalizer::setStateRange(),
+	//Diagonalizer::setEnergyRange(), and
+	//Diagonalizer::setCalculateAllStates().
+	Model model = createRandomModel(10);
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.run();
+	EXPECT_EQ(solver.getNumStates(), 10);
+}
+
 TEST(Diagonalizer, run){
 	//Tested through
 	//Diagonalizer::setSelfConsistencyCallback
@@ -242,5 +637,35 @@ TEST(Diagonalizer, getAmplitude){
 	);
 }
 
+TEST(Diagonalizer, partialSpectrumNonOrthonormalBasis){
+	//Same problem as in Diagonalizer::getEigenVectors(), but only the
+	//state with the positive eigenvalue is calculated. The eigenvector in
+	//the non-orthonormal basis is [0 1].
+	Model model;
+	model.setVerbose(false);
+	model << HoppingAmplitude(1/sqrt(2), {0}, {1}) + HC;
+	model << HoppingAmplitude(1, {1}, {1});
+	model.construct();
+
+	model << OverlapAmplitude(1, {0}, {0});
+	model << OverlapAmplitude(1/sqrt(2), {0}, {1});
+	model << OverlapAmplitude(1/sqrt(2), {1}, {0});
+	model << OverlapAmplitude(1, {1}, {1});
+
+	Diagonalizer solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setAlgorithm(Diagonalizer::Algorithm::MRRR);
+	solver.setStateRange(1, 1);
+	solver.run();
+
+	ASSERT_EQ(solver.getNumStates(), 1);
+	EXPECT_NEAR(solver.getEigenValue(0), 1, EPSILON_100);
+	std::complex<double> amplitude0 = solver.getAmplitude(0, {0});
+	std::complex<double> amplitude1 = solver.getAmplitude(0, {1});
+	EXPECT_NEAR(abs(amplitude0), 0, EPSILON_100);
+	EXPECT_NEAR(abs(amplitude1), 1, EPSILON_100);
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
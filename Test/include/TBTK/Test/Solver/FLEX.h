@@ -0,0 +1,113 @@
+#include "TBTK/BrillouinZone.h"
+#include "TBTK/Model.h"
+#include "TBTK/MomentumSpaceContext.h"
+#include "TBTK/Solver/FLEX.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Solver{
+
+const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+TEST(FLEX, DynamicTypeInformation){
+	BrillouinZone brillouinZone(
+		{{2*M_PI, 0}, {0, 2*M_PI}},
+		SpacePartition::MeshType::Nodal
+	);
+	MomentumSpaceContext momentumSpaceContext(brillouinZone, {2, 2});
+	FLEX solver(momentumSpaceContext);
+	const DynamicTypeInformation typeInformation
+		= solver.getDynamicTypeInformation();
+	EXPECT_EQ(typeInformation.getName(), "Solver::FLEX");
+	EXPECT_EQ(typeInformation.getNumParents(), 1);
+	EXPECT_EQ(typeInformation.getParent(0).getName(), "Solver::Solver");
+}
+
+unsigned int flexCallbackCounter;
+void flexCallback(FLEX &solver){
+	flexCallbackCounter++;
+}
+
+//Runs FLEX for a one-band square lattice with the bosonic energies split
+//into two slices, with or without slice pipelining.
+Property::SelfEnergy runFLEXTestCalculation(bool slicePipelining){
+	const unsigned int SIZE_X = 4;
+	const unsigned int SIZE_Y = 4;
+	BrillouinZone brillouinZone(
+		{{2*M_PI, 0}, {0, 2*M_PI}},
+		SpacePartition::MeshType::Nodal
+	);
+	MomentumSpaceContext momentumSpaceContext(
+		brillouinZone,
+		{SIZE_X, SIZE_Y}
+	);
+
+	Model model;
+	model.setVerbose(false);
+	model.setTemperature(1000);
+	const std::vector<std::vector<double>> &mesh
+		= momentumSpaceContext.getMesh();
+	for(unsigned int n = 0; n < mesh.size(); n++){
+		Index kIndex = momentumSpaceContext.getKIndex(mesh[n]);
+		model << HoppingAmplitude(
+			-2*(cos(mesh[n][0]) + cos(mesh[n][1])),
+			{kIndex[0], kIndex[1], 0},
+			{kIndex[0], kIndex[1], 0}
+		);
+	}
+	model.construct();
+
+	FLEX solver(momentumSpaceContext);
+	solver.setModel(model);
+	solver.setEnergyWindow(-5, 5, -4, 4);
+	solver.setU(1);
+	solver.setNumOrbitals(1);
+	solver.setMaxIterations(2);
+	solver.setNumSlices(2);
+	solver.setSlicePipelining(slicePipelining);
+	solver.setCallback(flexCallback);
+	flexCallbackCounter = 0;
+	solver.run();
+
+	return solver.getSelfEnergy();
+}
+
+TEST(FLEX, setSlicePipelining){
+	Property::SelfEnergy sequentialSelfEnergy
+		= runFLEXTestCalculation(false);
+	unsigned int sequentialCallbackCounter = flexCallbackCounter;
+	Property::SelfEnergy pipelinedSelfEnergy
+		= runFLEXTestCalculation(true);
+
+	//The callback is called equally many times with and without
+	//pipelining.
+	EXPECT_EQ(flexCallbackCounter, sequentialCallbackCounter);
+
+	//The self-energy does not depend on whether the slices are
+	//pipelined.
+	const std::vector<std::complex<double>> &sequentialData
+		= sequentialSelfEnergy.getData();
+	const std::vector<std::complex<double>> &pipelinedData
+		= pipelinedSelfEnergy.getData();
+	ASSERT_NE(sequentialData.size(), 0);
+	ASSERT_EQ(pipelinedData.size(), sequentialData.size());
+	for(unsigned int n = 0; n < sequentialData.size(); n++){
+		EXPECT_NEAR(
+			real(pipelinedData[n]),
+			real(sequentialData[n]),
+			EPSILON_100
+		);
+		EXPECT_NEAR(
+			imag(pipelinedData[n]),
+			imag(sequentialData[n]),
+			EPSILON_100
+		);
+	}
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
@@ -173,5 +173,86 @@ TEST(LUSolver, solve){
 	EXPECT_DOUBLE_EQ(imag(b1.at(1, 0)), -0.2);
 }
 
+TEST(LUSolver, solveInPlace){
+	LUSolver solver;
+
+	//Real matrix.
+	SparseMatrix<double> sparseMatrix0(
+		SparseMatrix<double>::StorageFormat::CSC
+	);
+	sparseMatrix0.add(0, 0, 1);
+	sparseMatrix0.add(0, 1, 2);
+	sparseMatrix0.add(1, 0, 3);
+	sparseMatrix0.add(1, 1, 4);
+	sparseMatrix0.constructCSX();
+
+	//Complex matrix.
+	SparseMatrix<std::complex<double>> sparseMatrix1(
+		SparseMatrix<std::complex<double>>::StorageFormat::CSC
+	);
+	sparseMatrix1.add(0, 0, 1);
+	sparseMatrix1.add(0, 1, std::complex<double>(0, 1));
+	sparseMatrix1.add(1, 0, std::complex<double>(0, 2));
+	sparseMatrix1.add(1, 1, 3);
+	sparseMatrix1.constructCSX();
+
+	//Real vector.
+	double b0[2];
+
+	//Complex vector.
+	std::complex<double> b1[2];
+
+	//Real matrix, real vector.
+	solver.setMatrix(sparseMatrix0);
+	b0[0] = 2;
+	b0[1] = 1;
+	solver.solve(b0);
+	EXPECT_DOUBLE_EQ(b0[0], -3);
+	EXPECT_DOUBLE_EQ(b0[1], 2.5);
+
+	//Real matrix, complex vector.
+	b1[0] = 1;
+	b1[1] = std::complex<double>(0, 1);
+	solver.solve(b1);
+	EXPECT_DOUBLE_EQ(real(b1[0]), -2);
+	EXPECT_DOUBLE_EQ(imag(b1[0]), 1);
+	EXPECT_DOUBLE_EQ(real(b1[1]), 1.5);
+	EXPECT_DOUBLE_EQ(imag(b1[1]), -0.5);
+
+	//Complex matrix, real vector. (Fail because it is not generally
+	//possible to solve such a problemand get a real answer)
+	solver.setMatrix(sparseMatrix1);
+	::testing::FLAGS_gtest_death_test_style = "threadsafe";
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.solve(b0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+	::testing::FLAGS_gtest_death_test_style = "fast";
+
+	//Complex matrix, complex vector.
+	b1[0] = 1;
+	b1[1] = std::complex<double>(0, 1);
+	solver.solve(b1);
+	EXPECT_DOUBLE_EQ(real(b1[0]), 0.8);
+	EXPECT_DOUBLE_EQ(imag(b1[0]), 0);
+	EXPECT_DOUBLE_EQ(real(b1[1]), 0);
+	EXPECT_DOUBLE_EQ(imag(b1[1]), -0.2);
+
+	//Fail if no matrix has been set.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			LUSolver solver;
+			solver.solve(b1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
 };	//End of namespace Solver
 };	//End of namespace TBTK
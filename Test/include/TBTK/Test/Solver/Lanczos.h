@@ -0,0 +1,387 @@
+#include "TBTK/Solver/Diagonalizer.h"
+#include "TBTK/Solver/Lanczos.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Solver{
+
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
+
+//Chain with site dependent on-site energies and complex hopping amplitudes,
+//which results in a non-degenerate spectrum.
+#define SETUP_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 200; \
+	for(int x = 0; x < SIZE; x++){ \
+		model << HoppingAmplitude(sin(x), {x}, {x}); \
+		if(x + 1 < SIZE){ \
+			model << HoppingAmplitude( \
+				std::complex<double>(-1, 0.3*cos(x)), \
+				{x + 1}, \
+				{x} \
+			) + HC; \
+		} \
+	} \
+	model.construct();
+
+//Two identical and decoupled chains, which results in a doubly degenerate
+//spectrum.
+#define SETUP_DEGENERATE_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 100; \
+	for(int s = 0; s < 2; s++){ \
+		for(int x = 0; x < SIZE; x++){ \
+			model << HoppingAmplitude(sin(x), {s, x}, {s, x}); \
+			if(x + 1 < SIZE){ \
+				model << HoppingAmplitude( \
+					-1, \
+					{s, x + 1}, \
+					{s, x} \
+				) + HC; \
+			} \
+		} \
+	} \
+	model.construct();
+
+#define SETUP_AND_RUN_DIAGONALIZER() \
+	Diagonalizer diagonalizer; \
+	diagonalizer.setVerbose(false); \
+	diagonalizer.setModel(model); \
+	diagonalizer.run();
+
+TEST(Lanczos, DynamicTypeInformation){
+	Lanczos solver;
+	const DynamicTypeInformation &typeInformation
+		= solver.getDynamicTypeInformation();
+	EXPECT_EQ(typeInformation.getName(), "Solver::Lanczos");
+	EXPECT_EQ(typeInformation.getNumParents(), 1);
+	EXPECT_EQ(typeInformation.getParent(0).getName(), "Solver::Solver");
+}
+
+TEST(Lanczos, Constructor){
+	//Not testable on its own.
+}
+
+TEST(Lanczos, setTarget){
+	//Tested through Lanczos::getTarget().
+}
+
+TEST(Lanczos, getTarget){
+	Lanczos solver;
+	EXPECT_EQ(solver.getTarget(), Lanczos::Target::Lowest);
+	solver.setTarget(Lanczos::Target::Highest);
+	EXPECT_EQ(solver.getTarget(), Lanczos::Target::Highest);
+	solver.setTarget(Lanczos::Target::Lowest);
+	EXPECT_EQ(solver.getTarget(), Lanczos::Target::Lowest);
+}
+
+TEST(Lanczos, setReorthogonalization){
+	//Tested through Lanczos::getReorthogonalization().
+}
+
+TEST(Lanczos, getReorthogonalization){
+	Lanczos solver;
+	EXPECT_EQ(
+		solver.getReorthogonalization(),
+		Lanczos::Reorthogonalization::Full
+	);
+	solver.setReorthogonalization(Lanczos::Reorthogonalization::Selective);
+	EXPECT_EQ(
+		solver.getReorthogonalization(),
+		Lanczos::Reorthogonalization::Selective
+	);
+}
+
+TEST(Lanczos, setNumEigenValues){
+	//Tested through Lanczos::getNumEigenValues().
+}
+
+TEST(Lanczos, getNumEigenValues){
+	Lanczos solver;
+	solver.setNumEigenValues(10);
+	EXPECT_EQ(solver.getNumEigenValues(), 10);
+	solver.setNumEigenValues(20);
+	EXPECT_EQ(solver.getNumEigenValues(), 20);
+}
+
+TEST(Lanczos, setCalculateEigenVectors){
+	//Tested through Lanczos::getCalculateEigenVectors().
+}
+
+TEST(Lanczos, getCalculateEigenVectors){
+	Lanczos solver;
+	EXPECT_FALSE(solver.getCalculateEigenVectors());
+	solver.setCalculateEigenVectors(true);
+	EXPECT_TRUE(solver.getCalculateEigenVectors());
+}
+
+TEST(Lanczos, setNumLanczosVectors){
+	//Tested through Lanczos::getNumLanczosVectors().
+}
+
+TEST(Lanczos, getNumLanczosVectors){
+	Lanczos solver;
+	EXPECT_EQ(solver.getNumLanczosVectors(), 0);
+	solver.setNumLanczosVectors(10);
+	EXPECT_EQ(solver.getNumLanczosVectors(), 10);
+}
+
+TEST(Lanczos, setBlockSize){
+	Lanczos solver;
+
+	//Fail for non-positive block sizes.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setBlockSize(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Lanczos, getBlockSize){
+	Lanczos solver;
+	EXPECT_EQ(solver.getBlockSize(), 1);
+	solver.setBlockSize(3);
+	EXPECT_EQ(solver.getBlockSize(), 3);
+}
+
+TEST(Lanczos, setTolerance){
+	//Tested through Lanczos::getTolerance().
+}
+
+TEST(Lanczos, getTolerance){
+	Lanczos solver;
+	solver.setTolerance(1e-8);
+	EXPECT_DOUBLE_EQ(solver.getTolerance(), 1e-8);
+}
+
+TEST(Lanczos, setMaxIterations){
+	//Tested through Lanczos::getMaxIterations().
+}
+
+TEST(Lanczos, getMaxIterations){
+	Lanczos solver;
+	solver.setMaxIterations(5);
+	EXPECT_EQ(solver.getMaxIterations(), 5);
+}
+
+void testLanczos(
+	Lanczos::Target target,
+	Lanczos::Reorthogonalization reorthogonalization,
+	int blockSize
+){
+	SETUP_MODEL();
+	SETUP_AND_RUN_DIAGONALIZER();
+
+	const int NUM_EIGEN_VALUES = 6;
+	Lanczos solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setTarget(target);
+	solver.setReorthogonalization(reorthogonalization);
+	solver.setBlockSize(blockSize);
+	solver.setNumEigenValues(NUM_EIGEN_VALUES);
+	solver.setNumLanczosVectors(12 + 12*blockSize);
+	solver.setCalculateEigenVectors(true);
+	solver.run();
+
+	ASSERT_EQ(solver.getNumStates(), NUM_EIGEN_VALUES);
+	int offset = 0;
+	if(target == Lanczos::Target::Highest)
+		offset = SIZE - NUM_EIGEN_VALUES;
+	for(int n = 0; n < NUM_EIGEN_VALUES; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			diagonalizer.getEigenValue(offset + n),
+			EPSILON_10000
+		);
+		EXPECT_NEAR(
+			solver.getEigenValues()[n],
+			diagonalizer.getEigenValue(offset + n),
+			EPSILON_10000
+		);
+
+		//The eigenvectors agree up to a phase.
+		std::complex<double> overlap = 0;
+		for(int x = 0; x < SIZE; x++){
+			overlap += conj(
+				diagonalizer.getAmplitude(offset + n, {x})
+			)*solver.getAmplitude(n, {x});
+		}
+		EXPECT_NEAR(abs(overlap), 1, EPSILON_10000);
+	}
+}
+
+TEST(Lanczos, run){
+	//Lowest eigenvalues.
+	testLanczos(
+		Lanczos::Target::Lowest,
+		Lanczos::Reorthogonalization::Full,
+		1
+	);
+
+	//Highest eigenvalues.
+	testLanczos(
+		Lanczos::Target::Highest,
+		Lanczos::Reorthogonalization::Full,
+		1
+	);
+
+	//Selective reorthogonalization.
+	testLanczos(
+		Lanczos::Target::Lowest,
+		Lanczos::Reorthogonalization::Selective,
+		1
+	);
+	testLanczos(
+		Lanczos::Target::Highest,
+		Lanczos::Reorthogonalization::Selective,
+		1
+	);
+
+	//Block Lanczos.
+	testLanczos(
+		Lanczos::Target::Lowest,
+		Lanczos::Reorthogonalization::Full,
+		2
+	);
+	testLanczos(
+		Lanczos::Target::Highest,
+		Lanczos::Reorthogonalization::Full,
+		3
+	);
+}
+
+TEST(Lanczos, runDegenerate){
+	SETUP_DEGENERATE_MODEL();
+	SETUP_AND_RUN_DIAGONALIZER();
+
+	//A single starting vector only spans one state in each degenerate
+	//subspace, while a block of two starting vectors resolves the
+	//degeneracy.
+	Lanczos solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setBlockSize(2);
+	solver.setNumEigenValues(6);
+	solver.setNumLanczosVectors(30);
+	solver.run();
+
+	for(int n = 0; n < 6; n++){
+		EXPECT_NEAR(
+			solver.getEigenValue(n),
+			diagonalizer.getEigenValue(n),
+			EPSILON_10000
+		);
+	}
+	EXPECT_NEAR(
+		solver.getEigenValue(0),
+		solver.getEigenValue(1),
+		EPSILON_10000
+	);
+}
+
+TEST(Lanczos, runInvalidParameters){
+	SETUP_MODEL();
+
+	//Fail if the number of eigenvalues has not been set.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Lanczos solver;
+			solver.setModel(model);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for selective reorthogonalization with a block size larger
+	//than one.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Lanczos solver;
+			solver.setModel(model);
+			solver.setNumEigenValues(4);
+			solver.setBlockSize(2);
+			solver.setReorthogonalization(
+				Lanczos::Reorthogonalization::Selective
+			);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the Krylov space is too small.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Lanczos solver;
+			solver.setModel(model);
+			solver.setNumEigenValues(4);
+			solver.setNumLanczosVectors(5);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the maximum number of restarts is exceeded.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Lanczos solver;
+			solver.setModel(model);
+			solver.setNumEigenValues(4);
+			solver.setNumLanczosVectors(8);
+			solver.setMaxIterations(1);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Lanczos, getNumRestarts){
+	SETUP_MODEL();
+
+	//A small Krylov space requires several restarts.
+	Lanczos solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setNumEigenValues(4);
+	solver.setNumLanczosVectors(16);
+	solver.setMaxIterations(1000);
+	solver.run();
+	EXPECT_GT(solver.getNumRestarts(), 0);
+}
+
+TEST(Lanczos, getNumStates){
+	//Tested through Lanczos::run().
+}
+
+TEST(Lanczos, getEigenValues){
+	//Tested through Lanczos::run().
+}
+
+TEST(Lanczos, getEigenValue){
+	//Tested through Lanczos::run().
+}
+
+TEST(Lanczos, getAmplitude){
+	//Tested through Lanczos::run().
+}
+
+};
+};
@@ -0,0 +1,446 @@
+#include "TBTK/Solver/LinearEquationSolver.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Solver{
+
+const double EPSILON_100 = 100*std::numeric_limits<double>::epsilon();
+
+//Chain with complex on-site energies and equal forward and backward hopping
+//amplitudes, which results in a complex symmetric matrix.
+#define SETUP_SYMMETRIC_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 200; \
+	for(int x = 0; x < SIZE; x++){ \
+		model << HoppingAmplitude( \
+			std::complex<double>(4 + sin(x), 0.5*cos(x)), \
+			{x}, \
+			{x} \
+		); \
+		if(x + 1 < SIZE){ \
+			model << HoppingAmplitude(-1, {x + 1}, {x}); \
+			model << HoppingAmplitude(-1, {x}, {x + 1}); \
+		} \
+		model << SourceAmplitude(std::complex<double>(cos(x), sin(x)), {x}); \
+	} \
+	model.construct();
+
+//Chain with different forward and backward hopping amplitudes, which results
+//in a matrix that is neither Hermitian nor complex symmetric.
+#define SETUP_NONSYMMETRIC_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 200; \
+	for(int x = 0; x < SIZE; x++){ \
+		model << HoppingAmplitude(3 + sin(x), {x}, {x}); \
+		if(x + 1 < SIZE){ \
+			model << HoppingAmplitude(-1, {x + 1}, {x}); \
+			model << HoppingAmplitude( \
+				std::complex<double>(-0.5, 0.5), \
+				{x}, \
+				{x + 1} \
+			); \
+		} \
+		model << SourceAmplitude(std::complex<double>(cos(x), sin(x)), {x}); \
+	} \
+	model.construct();
+
+//Hermitian chain with a source on the first site.
+#define SETUP_HERMITIAN_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 200; \
+	for(int x = 0; x < SIZE; x++){ \
+		model << HoppingAmplitude(0.5*sin(x), {x}, {x}); \
+		if(x + 1 < SIZE){ \
+			model << HoppingAmplitude( \
+				std::complex<double>(-1, 0.3*cos(x)), \
+				{x + 1}, \
+				{x} \
+			) + HC; \
+		} \
+	} \
+	model << SourceAmplitude(1, {0}); \
+	model.construct();
+
+//Calculate the relative residual |(shift - H)x - y|/|y| for the solution
+//returned by the solver for the given energy. H is replaced by -H and the
+//shift is zero for the non-MultiShift modes.
+double calculateRelativeResidual(
+	const Model &model,
+	const LinearEquationSolver &solver,
+	std::complex<double> shift = 0,
+	unsigned int energy = 0
+){
+	const int BASIS_SIZE = model.getBasisSize();
+	double sign = (solver.getMode() == LinearEquationSolver::Mode::MultiShift)
+		? -1
+		: 1;
+	std::vector<std::complex<double>> residual(BASIS_SIZE, 0.);
+	for(
+		HoppingAmplitudeSet::ConstIterator iterator
+			= model.getHoppingAmplitudeSet().cbegin();
+		iterator != model.getHoppingAmplitudeSet().cend();
+		++iterator
+	){
+		int to = model.getBasisIndex((*iterator).getToIndex());
+		residual[to] += sign*(*iterator).getAmplitude()*solver.getAmplitude(
+			(*iterator).getFromIndex(),
+			energy
+		);
+	}
+	for(int n = 0; n < BASIS_SIZE; n++)
+		residual[n] += shift*solver.getResult().at(n, energy);
+
+	double sourceNorm = 0;
+	for(
+		SourceAmplitudeSet::ConstIterator iterator
+			= model.getSourceAmplitudeSet().cbegin();
+		iterator != model.getSourceAmplitudeSet().cend();
+		++iterator
+	){
+		residual[model.getBasisIndex((*iterator).getIndex())]
+			-= (*iterator).getAmplitude();
+		sourceNorm += std::norm((*iterator).getAmplitude());
+	}
+
+	double residualNorm = 0;
+	for(int n = 0; n < BASIS_SIZE; n++)
+		residualNorm += std::norm(residual[n]);
+
+	return sqrt(residualNorm/sourceNorm);
+}
+
+TEST(LinearEquationSolver, DynamicTypeInformation){
+	LinearEquationSolver solver;
+	const DynamicTypeInformation &typeInformation
+		= solver.getDynamicTypeInformation();
+	EXPECT_EQ(typeInformation.getName(), "Solver::LinearEquationSolver");
+	EXPECT_EQ(typeInformation.getNumParents(), 1);
+	EXPECT_EQ(typeInformation.getParent(0).getName(), "Solver::Solver");
+}
+
+TEST(LinearEquationSolver, Constructor){
+	//Not testable on its own.
+}
+
+TEST(LinearEquationSolver, Destructor){
+	//Not testable on its own.
+}
+
+TEST(LinearEquationSolver, setMode){
+	//Tested through LinearEquationSolver::getMode().
+}
+
+TEST(LinearEquationSolver, getMode){
+	LinearEquationSolver solver;
+	EXPECT_EQ(solver.getMode(), LinearEquationSolver::Mode::LU);
+	solver.setMode(LinearEquationSolver::Mode::GMRES);
+	EXPECT_EQ(solver.getMode(), LinearEquationSolver::Mode::GMRES);
+}
+
+TEST(LinearEquationSolver, setPreconditioner){
+	//Tested through LinearEquationSolver::getPreconditioner().
+}
+
+TEST(LinearEquationSolver, getPreconditioner){
+	LinearEquationSolver solver;
+	EXPECT_EQ(
+		solver.getPreconditioner(),
+		LinearEquationSolver::Preconditioner::None
+	);
+	solver.setPreconditioner(LinearEquationSolver::Preconditioner::ILU);
+	EXPECT_EQ(
+		solver.getPreconditioner(),
+		LinearEquationSolver::Preconditioner::ILU
+	);
+}
+
+TEST(LinearEquationSolver, setTolerance){
+	//Tested through LinearEquationSolver::getTolerance().
+}
+
+TEST(LinearEquationSolver, getTolerance){
+	LinearEquationSolver solver;
+	EXPECT_DOUBLE_EQ(solver.getTolerance(), 1e-10);
+	solver.setTolerance(1e-8);
+	EXPECT_DOUBLE_EQ(solver.getTolerance(), 1e-8);
+}
+
+TEST(LinearEquationSolver, setMaxIterations){
+	//Tested through LinearEquationSolver::getMaxIterations().
+}
+
+TEST(LinearEquationSolver, getMaxIterations){
+	LinearEquationSolver solver;
+	EXPECT_EQ(solver.getMaxIterations(), 1000);
+	solver.setMaxIterations(5);
+	EXPECT_EQ(solver.getMaxIterations(), 5);
+}
+
+TEST(LinearEquationSolver, setRestartLength){
+	LinearEquationSolver solver;
+
+	//Fail for zero restart length.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setRestartLength(0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(LinearEquationSolver, getRestartLength){
+	LinearEquationSolver solver;
+	EXPECT_EQ(solver.getRestartLength(), 30);
+	solver.setRestartLength(10);
+	EXPECT_EQ(solver.getRestartLength(), 10);
+}
+
+TEST(LinearEquationSolver, setEnergyWindow){
+	//Tested through LinearEquationSolver::getEnergyWindow().
+}
+
+TEST(LinearEquationSolver, getEnergyWindow){
+	LinearEquationSolver solver;
+	solver.setEnergyWindow(Range(-1, 1, 5));
+	EXPECT_EQ(solver.getEnergyWindow(), Range(-1, 1, 5));
+}
+
+TEST(LinearEquationSolver, setEnergyInfinitesimal){
+	//Tested through LinearEquationSolver::getEnergyInfinitesimal().
+}
+
+TEST(LinearEquationSolver, getEnergyInfinitesimal){
+	LinearEquationSolver solver;
+	solver.setEnergyInfinitesimal(0.1);
+	EXPECT_DOUBLE_EQ(solver.getEnergyInfinitesimal(), 0.1);
+}
+
+void testIterativeSolver(
+	Model &model,
+	LinearEquationSolver::Mode mode,
+	LinearEquationSolver::Preconditioner preconditioner
+){
+	LinearEquationSolver solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMode(mode);
+	solver.setPreconditioner(preconditioner);
+	solver.setRestartLength(10);
+	solver.run();
+
+	EXPECT_GT(solver.getNumIterations(), 0);
+	EXPECT_LT(calculateRelativeResidual(model, solver), 1e-9);
+}
+
+TEST(LinearEquationSolver, runCOCG){
+	SETUP_SYMMETRIC_MODEL();
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::COCG,
+		LinearEquationSolver::Preconditioner::None
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::COCG,
+		LinearEquationSolver::Preconditioner::Jacobi
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::COCG,
+		LinearEquationSolver::Preconditioner::ILU
+	);
+}
+
+TEST(LinearEquationSolver, runGMRES){
+	SETUP_NONSYMMETRIC_MODEL();
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::GMRES,
+		LinearEquationSolver::Preconditioner::None
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::GMRES,
+		LinearEquationSolver::Preconditioner::Jacobi
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::GMRES,
+		LinearEquationSolver::Preconditioner::ILU
+	);
+}
+
+TEST(LinearEquationSolver, runBiCGStab){
+	SETUP_NONSYMMETRIC_MODEL();
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::BiCGStab,
+		LinearEquationSolver::Preconditioner::None
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::BiCGStab,
+		LinearEquationSolver::Preconditioner::Jacobi
+	);
+	testIterativeSolver(
+		model,
+		LinearEquationSolver::Mode::BiCGStab,
+		LinearEquationSolver::Preconditioner::ILU
+	);
+}
+
+TEST(LinearEquationSolver, runILU){
+	SETUP_NONSYMMETRIC_MODEL();
+
+	//ILU(0) is exact for a tridiagonal matrix, which means that the
+	//preconditioned GMRES converges in a single iteration.
+	LinearEquationSolver solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMode(LinearEquationSolver::Mode::GMRES);
+	solver.setPreconditioner(LinearEquationSolver::Preconditioner::ILU);
+	solver.run();
+	EXPECT_EQ(solver.getNumIterations(), 1);
+	EXPECT_LT(calculateRelativeResidual(model, solver), 1e-9);
+}
+
+TEST(LinearEquationSolver, runMultiShift){
+	SETUP_HERMITIAN_MODEL();
+
+	const double ENERGY_INFINITESIMAL = 0.05;
+	const Range ENERGY_WINDOW(-3, 3, 61);
+	LinearEquationSolver solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMode(LinearEquationSolver::Mode::MultiShift);
+	solver.setEnergyWindow(ENERGY_WINDOW);
+	solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+	solver.run();
+
+	ASSERT_EQ(solver.getResult().getNumRows(), SIZE);
+	ASSERT_EQ(solver.getResult().getNumCols(), 61);
+	for(unsigned int n = 0; n < ENERGY_WINDOW.getResolution(); n++){
+		EXPECT_LT(
+			calculateRelativeResidual(
+				model,
+				solver,
+				std::complex<double>(
+					ENERGY_WINDOW[n],
+					ENERGY_INFINITESIMAL
+				),
+				n
+			),
+			1e-9
+		);
+	}
+
+	//The imaginary part of the diagonal element of the retarded Green's
+	//function is non-positive.
+	for(unsigned int n = 0; n < ENERGY_WINDOW.getResolution(); n++)
+		EXPECT_LE(imag(solver.getAmplitude({0}, n)), EPSILON_100);
+}
+
+TEST(LinearEquationSolver, runInvalidParameters){
+	//Fail for COCG with a matrix that is not complex symmetric.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_NONSYMMETRIC_MODEL();
+			LinearEquationSolver solver;
+			solver.setModel(model);
+			solver.setMode(LinearEquationSolver::Mode::COCG);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if the maximum number of iterations is exceeded.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_NONSYMMETRIC_MODEL();
+			LinearEquationSolver solver;
+			solver.setModel(model);
+			solver.setMode(LinearEquationSolver::Mode::GMRES);
+			solver.setMaxIterations(2);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for MultiShift without energy window.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_HERMITIAN_MODEL();
+			LinearEquationSolver solver;
+			solver.setModel(model);
+			solver.setMode(LinearEquationSolver::Mode::MultiShift);
+			solver.setEnergyInfinitesimal(0.1);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for MultiShift without positive energy infinitesimal.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_HERMITIAN_MODEL();
+			LinearEquationSolver solver;
+			solver.setModel(model);
+			solver.setMode(LinearEquationSolver::Mode::MultiShift);
+			solver.setEnergyWindow(Range(-1, 1, 10));
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for MultiShift with a preconditioner.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_HERMITIAN_MODEL();
+			LinearEquationSolver solver;
+			solver.setModel(model);
+			solver.setMode(LinearEquationSolver::Mode::MultiShift);
+			solver.setPreconditioner(
+				LinearEquationSolver::Preconditioner::Jacobi
+			);
+			solver.setEnergyWindow(Range(-1, 1, 10));
+			solver.setEnergyInfinitesimal(0.1);
+			solver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(LinearEquationSolver, getNumIterations){
+	//Tested through LinearEquationSolver::run().
+}
+
+TEST(LinearEquationSolver, getAmplitude){
+	//Tested through LinearEquationSolver::run().
+}
+
+TEST(LinearEquationSolver, getResult){
+	//Tested through LinearEquationSolver::run().
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
@@ -0,0 +1,584 @@
+#include "TBTK/Solver/Diagonalizer.h"
+#include "TBTK/Solver/TimeEvolver.h"
+#include "TBTK/Streams.h"
+#include "TBTK/UnitHandler.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+namespace Solver{
+
+TEST(TimeEvolver, setPropagator){
+	//Tested through TimeEvolver::getPropagator().
+}
+
+TEST(TimeEvolver, getPropagator){
+	TimeEvolver timeEvolver;
+	EXPECT_TRUE(
+		timeEvolver.getPropagator() == TimeEvolver::Propagator::Chebyshev
+	);
+	timeEvolver.setPropagator(TimeEvolver::Propagator::Euler);
+	EXPECT_TRUE(
+		timeEvolver.getPropagator() == TimeEvolver::Propagator::Euler
+	);
+}
+
+TEST(TimeEvolver, setPropagatorTolerance){
+	//Tested through TimeEvolver::getPropagatorTolerance().
+}
+
+TEST(TimeEvolver, getPropagatorTolerance){
+	TimeEvolver timeEvolver;
+	EXPECT_DOUBLE_EQ(timeEvolver.getPropagatorTolerance(), 1e-12);
+	timeEvolver.setPropagatorTolerance(1e-6);
+	EXPECT_DOUBLE_EQ(timeEvolver.getPropagatorTolerance(), 1e-6);
+}
+
+//Potential that is removed once the time evolution starts.
+class QuenchedPotential : public HoppingAmplitude::AmplitudeCallback{
+public:
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		if(isQuenched)
+			return 0;
+		else
+			return (to[0] < 4 ? -1 : 1);
+	}
+
+	static bool isQuenched;
+};
+
+bool QuenchedPotential::isQuenched = false;
+
+bool quenchCallback(TimeEvolver *timeEvolver){
+	QuenchedPotential::isQuenched = (timeEvolver->getCurrentTimeStep() >= 0);
+
+	return true;
+}
+
+//Calculate the density of the occupied states after a quench using the
+//TimeEvolver and compare it to the exact result.
+void testQuench(
+	TimeEvolver::Propagator propagator,
+	double timeStep,
+	int numTimeSteps,
+	double tolerance
+){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	const int SIZE = 8;
+	const int NUM_PARTICLES = 4;
+	QuenchedPotential quenchedPotential;
+	QuenchedPotential::isQuenched = false;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(quenchedPotential, {x}, {x});
+		if(x + 1 < SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(quenchCallback);
+	timeEvolver.setPropagator(propagator);
+	timeEvolver.setTimeStep(timeStep);
+	timeEvolver.setNumTimeSteps(numTimeSteps);
+	timeEvolver.setNumberOfParticles(NUM_PARTICLES);
+	timeEvolver.run();
+
+	//Initial occupied states.
+	QuenchedPotential::isQuenched = false;
+	Diagonalizer initialSolver;
+	initialSolver.setVerbose(false);
+	initialSolver.setModel(model);
+	initialSolver.run();
+
+	//Eigenstates after the quench.
+	QuenchedPotential::isQuenched = true;
+	Diagonalizer finalSolver;
+	finalSolver.setVerbose(false);
+	finalSolver.setModel(model);
+	finalSolver.run();
+
+	//Exact density at the final time.
+	double hbar = UnitHandler::getConstantInBaseUnits("hbar");
+	double time = numTimeSteps*UnitHandler::convertNaturalToBase<
+		Quantity::Time
+	>(timeStep)/hbar;
+	std::vector<double> exactDensity(SIZE, 0);
+	for(int n = 0; n < NUM_PARTICLES; n++){
+		std::vector<std::complex<double>> state(SIZE, 0);
+		for(int m = 0; m < SIZE; m++){
+			std::complex<double> overlap = 0;
+			for(int x = 0; x < SIZE; x++){
+				overlap += conj(finalSolver.getAmplitude(m, {x}))
+					*initialSolver.getAmplitude(n, {x});
+			}
+			std::complex<double> phase = exp(
+				-std::complex<double>(0, 1)
+				*finalSolver.getEigenValue(m)*time
+			);
+			for(int x = 0; x < SIZE; x++){
+				state[x] += phase*overlap
+					*finalSolver.getAmplitude(m, {x});
+			}
+		}
+		for(int x = 0; x < SIZE; x++)
+			exactDensity[x] += pow(abs(state[x]), 2);
+	}
+
+	//Density calculated by the TimeEvolver.
+	std::vector<double> density(SIZE, 0);
+	for(int n = 0; n < SIZE; n++){
+		for(int x = 0; x < SIZE; x++){
+			density[x] += timeEvolver.getOccupancy(n)*pow(
+				abs(timeEvolver.getAmplitude(n, {x})),
+				2
+			);
+		}
+	}
+
+	for(int x = 0; x < SIZE; x++)
+		EXPECT_NEAR(density[x], exactDensity[x], tolerance);
+}
+
+TEST(TimeEvolver, runChebyshev){
+	//Large time steps give the exact result.
+	testQuench(TimeEvolver::Propagator::Chebyshev, 0.5, 20, 1e-8);
+}
+
+TEST(TimeEvolver, runEuler){
+	//Small time steps are required for the Euler propagator.
+	testQuench(TimeEvolver::Propagator::Euler, 0.0005, 2000, 1e-2);
+}
+
+TEST(TimeEvolver, getNumChebyshevTerms){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	QuenchedPotential quenchedPotential;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < 8; x++){
+		model << HoppingAmplitude(quenchedPotential, {x}, {x});
+		if(x + 1 < 8)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	//The number of terms grows with the time step.
+	unsigned int numChebyshevTerms[2];
+	double timeSteps[2] = {0.1, 1};
+	for(unsigned int n = 0; n < 2; n++){
+		TimeEvolver timeEvolver;
+		timeEvolver.getDiagonalizer()->setVerbose(false);
+		timeEvolver.setModel(model);
+		timeEvolver.setCallback(quenchCallback);
+		timeEvolver.setTimeStep(timeSteps[n]);
+		timeEvolver.setNumTimeSteps(1);
+		EXPECT_EQ(timeEvolver.getNumChebyshevTerms(), 0);
+		timeEvolver.run();
+		numChebyshevTerms[n] = timeEvolver.getNumChebyshevTerms();
+	}
+	EXPECT_GT(numChebyshevTerms[0], 0);
+	EXPECT_GT(numChebyshevTerms[1], numChebyshevTerms[0]);
+}
+
+//Driving function sin(t).
+class SineDrivingFunction : public TimeEvolver::DrivingFunction{
+public:
+	std::complex<double> getValue(double time) const{
+		return sin(time);
+	}
+};
+
+//Driving function cos(t).
+class CosineDrivingFunction : public TimeEvolver::DrivingFunction{
+public:
+	std::complex<double> getValue(double time) const{
+		return cos(time);
+	}
+};
+
+//The same driving as created by the DrivingFunctions above, but implemented
+//through an AmplitudeCallback. The driving is switched on once the time
+//evolution starts.
+class DrivenAmplitude : public HoppingAmplitude::AmplitudeCallback{
+public:
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		std::complex<double> amplitude = 0;
+		if(to[0] == from[0]){
+			if(to[0]%2 == 0)
+				amplitude += 0.5;
+			if(isDriven && to[0] < 4)
+				amplitude += sin(time);
+		}
+		else{
+			amplitude += -1.;
+			if(isDriven)
+				amplitude += 0.5*cos(time);
+		}
+
+		return amplitude;
+	}
+
+	static bool isDriven;
+	static double time;
+	static double timeOffset;
+	static double timeStep;
+};
+
+bool DrivenAmplitude::isDriven = false;
+double DrivenAmplitude::time = 0;
+double DrivenAmplitude::timeOffset = 0;
+double DrivenAmplitude::timeStep = 0;
+
+bool drivenAmplitudeCallback(TimeEvolver *timeEvolver){
+	DrivenAmplitude::isDriven = (timeEvolver->getCurrentTimeStep() >= 0);
+	DrivenAmplitude::time = (
+		timeEvolver->getCurrentTimeStep() + DrivenAmplitude::timeOffset
+	)*DrivenAmplitude::timeStep;
+
+	return true;
+}
+
+bool emptyCallback(TimeEvolver *timeEvolver){
+	return true;
+}
+
+//Compare the time evolution for driving terms with the time evolution for
+//the same Hamiltonian implemented using AmplitudeCallbacks.
+void testDrivingTerms(
+	TimeEvolver::Propagator propagator,
+	double timeOffset,
+	double timeStep,
+	int numTimeSteps
+){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	const int SIZE = 8;
+	const int NUM_PARTICLES = 4;
+
+	//Model with the driving implemented through AmplitudeCallbacks.
+	DrivenAmplitude drivenAmplitude;
+	DrivenAmplitude::isDriven = false;
+	DrivenAmplitude::timeOffset = timeOffset;
+	DrivenAmplitude::timeStep = timeStep;
+	Model callbackModel;
+	callbackModel.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		callbackModel << HoppingAmplitude(drivenAmplitude, {x}, {x});
+		if(x + 1 < SIZE){
+			callbackModel << HoppingAmplitude(
+				drivenAmplitude,
+				{x+1},
+				{x}
+			);
+			callbackModel << HoppingAmplitude(
+				drivenAmplitude,
+				{x},
+				{x+1}
+			);
+		}
+	}
+	callbackModel.construct();
+
+	TimeEvolver callbackTimeEvolver;
+	callbackTimeEvolver.getDiagonalizer()->setVerbose(false);
+	callbackTimeEvolver.setModel(callbackModel);
+	callbackTimeEvolver.setCallback(drivenAmplitudeCallback);
+	callbackTimeEvolver.setPropagator(propagator);
+	callbackTimeEvolver.setTimeStep(timeStep);
+	callbackTimeEvolver.setNumTimeSteps(numTimeSteps);
+	callbackTimeEvolver.setNumberOfParticles(NUM_PARTICLES);
+	callbackTimeEvolver.run();
+
+	//Model with the driving implemented through driving terms. The
+	//driven on-site terms are added both to sites with and without static
+	//on-site terms.
+	Model model;
+	model.setVerbose(false);
+	std::vector<HoppingAmplitude> potential;
+	std::vector<HoppingAmplitude> hopping;
+	for(int x = 0; x < SIZE; x++){
+		if(x%2 == 0)
+			model << HoppingAmplitude(0.5, {x}, {x});
+		if(x < 4)
+			potential.push_back(HoppingAmplitude(1, {x}, {x}));
+		if(x + 1 < SIZE){
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+			hopping.push_back(HoppingAmplitude(0.5, {x+1}, {x}));
+			hopping.push_back(HoppingAmplitude(0.5, {x}, {x+1}));
+		}
+	}
+	model.construct();
+
+	SineDrivingFunction sineDrivingFunction;
+	CosineDrivingFunction cosineDrivingFunction;
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(emptyCallback);
+	timeEvolver.setPropagator(propagator);
+	timeEvolver.setTimeStep(timeStep);
+	timeEvolver.setNumTimeSteps(numTimeSteps);
+	timeEvolver.setNumberOfParticles(NUM_PARTICLES);
+	timeEvolver.addDrivingTerm(potential, sineDrivingFunction);
+	timeEvolver.addDrivingTerm(hopping, cosineDrivingFunction);
+	timeEvolver.run();
+
+	for(int x = 0; x < SIZE; x++){
+		double density = 0;
+		double callbackDensity = 0;
+		for(int n = 0; n < SIZE; n++){
+			density += timeEvolver.getOccupancy(n)*pow(
+				abs(timeEvolver.getAmplitude(n, {x})),
+				2
+			);
+			callbackDensity += callbackTimeEvolver.getOccupancy(
+				n
+			)*pow(abs(callbackTimeEvolver.getAmplitude(n, {x})), 2);
+		}
+		EXPECT_NEAR(density, callbackDensity, 1e-10);
+	}
+}
+
+TEST(TimeEvolver, addDrivingTerm){
+	//The Chebyshev propagator evaluates the driving terms at the middle
+	//of the time step.
+	testDrivingTerms(TimeEvolver::Propagator::Chebyshev, 0.5, 0.5, 20);
+
+	//The Euler propagator evaluates the driving terms at the beginning of
+	//the time step.
+	testDrivingTerms(TimeEvolver::Propagator::Euler, 0, 0.001, 200);
+}
+
+TEST(TimeEvolver, clearDrivingTerms){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	//A time evolution without driving terms leaves the ground state
+	//density unchanged.
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < 8; x++){
+		model << HoppingAmplitude(x%2 == 0 ? 0.5 : 0, {x}, {x});
+		if(x + 1 < 8)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	std::vector<HoppingAmplitude> potential;
+	for(int x = 0; x < 4; x++)
+		potential.push_back(HoppingAmplitude(1, {x}, {x}));
+	SineDrivingFunction sineDrivingFunction;
+
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(emptyCallback);
+	timeEvolver.setTimeStep(0.5);
+	timeEvolver.setNumTimeSteps(1);
+	timeEvolver.setNumberOfParticles(4);
+	timeEvolver.run();
+	std::vector<double> groundStateDensity(8, 0);
+	for(int x = 0; x < 8; x++){
+		for(int n = 0; n < 8; n++){
+			groundStateDensity[x] += timeEvolver.getOccupancy(
+				n
+			)*pow(abs(timeEvolver.getAmplitude(n, {x})), 2);
+		}
+	}
+
+	timeEvolver.addDrivingTerm(potential, sineDrivingFunction);
+	timeEvolver.clearDrivingTerms();
+	timeEvolver.setNumTimeSteps(20);
+	timeEvolver.run();
+	for(int x = 0; x < 8; x++){
+		double density = 0;
+		for(int n = 0; n < 8; n++){
+			density += timeEvolver.getOccupancy(n)*pow(
+				abs(timeEvolver.getAmplitude(n, {x})),
+				2
+			);
+		}
+		EXPECT_NEAR(density, groundStateDensity[x], 1e-10);
+	}
+}
+
+TEST(TimeEvolver, setEvolveOccupiedSubspace){
+	//Tested through TimeEvolver::getEvolveOccupiedSubspace().
+}
+
+TEST(TimeEvolver, getEvolveOccupiedSubspace){
+	TimeEvolver timeEvolver;
+	EXPECT_FALSE(timeEvolver.getEvolveOccupiedSubspace());
+	timeEvolver.setEvolveOccupiedSubspace(true);
+	EXPECT_TRUE(timeEvolver.getEvolveOccupiedSubspace());
+}
+
+TEST(TimeEvolver, setOccupiedSubspaceMargin){
+	//Tested through TimeEvolver::getOccupiedSubspaceMargin().
+}
+
+TEST(TimeEvolver, getOccupiedSubspaceMargin){
+	TimeEvolver timeEvolver;
+	EXPECT_EQ(timeEvolver.getOccupiedSubspaceMargin(), 0);
+	timeEvolver.setOccupiedSubspaceMargin(2);
+	EXPECT_EQ(timeEvolver.getOccupiedSubspaceMargin(), 2);
+}
+
+//Calculate the density after a quench when evolving all states and when
+//evolving only the occupied subspace.
+void testOccupiedSubspace(
+	TimeEvolver::Propagator propagator,
+	double timeStep,
+	int numTimeSteps,
+	unsigned int margin
+){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	const int SIZE = 8;
+	const int NUM_PARTICLES = 4;
+	QuenchedPotential quenchedPotential;
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < SIZE; x++){
+		model << HoppingAmplitude(quenchedPotential, {x}, {x});
+		if(x + 1 < SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	std::vector<double> densities[2];
+	for(unsigned int n = 0; n < 2; n++){
+		QuenchedPotential::isQuenched = false;
+		TimeEvolver timeEvolver;
+		timeEvolver.getDiagonalizer()->setVerbose(false);
+		timeEvolver.setModel(model);
+		timeEvolver.setCallback(quenchCallback);
+		timeEvolver.setPropagator(propagator);
+		timeEvolver.setTimeStep(timeStep);
+		timeEvolver.setNumTimeSteps(numTimeSteps);
+		timeEvolver.setNumberOfParticles(NUM_PARTICLES);
+		timeEvolver.setEvolveOccupiedSubspace(n == 1);
+		timeEvolver.setOccupiedSubspaceMargin(margin);
+		timeEvolver.run();
+
+		if(n == 0)
+			EXPECT_EQ(timeEvolver.getNumEvolvedStates(), SIZE);
+		else
+			EXPECT_EQ(
+				timeEvolver.getNumEvolvedStates(),
+				NUM_PARTICLES + margin
+			);
+
+		densities[n].assign(SIZE, 0);
+		for(
+			unsigned int state = 0;
+			state < timeEvolver.getNumEvolvedStates();
+			state++
+		){
+			for(int x = 0; x < SIZE; x++){
+				densities[n][x] += timeEvolver.getOccupancy(
+					state
+				)*pow(
+					abs(timeEvolver.getAmplitude(state, {x})),
+					2
+				);
+			}
+		}
+	}
+
+	for(int x = 0; x < SIZE; x++)
+		EXPECT_NEAR(densities[1][x], densities[0][x], 1e-10);
+}
+
+TEST(TimeEvolver, evolveOccupiedSubspace){
+	testOccupiedSubspace(TimeEvolver::Propagator::Chebyshev, 0.5, 20, 0);
+	testOccupiedSubspace(TimeEvolver::Propagator::Chebyshev, 0.5, 20, 2);
+	testOccupiedSubspace(TimeEvolver::Propagator::Euler, 0.001, 200, 1);
+
+	//The full spectrum and the previous algorithm are restored when the
+	//option is disabled.
+	Model model;
+	model.setVerbose(false);
+	for(int x = 0; x < 8; x++){
+		model << HoppingAmplitude(0, {x}, {x});
+		if(x + 1 < 8)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.getDiagonalizer()->setAlgorithm(
+		Diagonalizer::Algorithm::DivideAndConquer
+	);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(emptyCallback);
+	timeEvolver.setNumberOfParticles(4);
+	timeEvolver.setEvolveOccupiedSubspace(true);
+	timeEvolver.run();
+	EXPECT_EQ(timeEvolver.getNumEvolvedStates(), 4);
+	EXPECT_TRUE(
+		timeEvolver.getDiagonalizer()->getAlgorithm()
+		== Diagonalizer::Algorithm::MRRR
+	);
+
+	timeEvolver.setNumberOfParticles(2);
+	timeEvolver.run();
+	EXPECT_EQ(timeEvolver.getNumEvolvedStates(), 2);
+
+	timeEvolver.setEvolveOccupiedSubspace(false);
+	timeEvolver.run();
+	EXPECT_EQ(timeEvolver.getNumEvolvedStates(), 8);
+	EXPECT_TRUE(
+		timeEvolver.getDiagonalizer()->getAlgorithm()
+		== Diagonalizer::Algorithm::DivideAndConquer
+	);
+
+	//Fail if the number of particles is not set.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Model model;
+			model.setVerbose(false);
+			for(int x = 0; x < 8; x++)
+				model << HoppingAmplitude(-1, {x}, {x});
+			model.construct();
+
+			TimeEvolver timeEvolver;
+			timeEvolver.getDiagonalizer()->setVerbose(false);
+			timeEvolver.setModel(model);
+			timeEvolver.setCallback(emptyCallback);
+			timeEvolver.setEvolveOccupiedSubspace(true);
+			timeEvolver.run();
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(TimeEvolver, getNumEvolvedStates){
+	//Tested through TimeEvolver::evolveOccupiedSubspace.
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
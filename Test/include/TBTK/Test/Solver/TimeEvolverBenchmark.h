@@ -0,0 +1,208 @@
+#include "TBTK/Solver/TimeEvolver.h"
+#include "TBTK/UnitHandler.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace TBTK{
+namespace Solver{
+
+const int BENCHMARK_SIZE = 200;
+const int BENCHMARK_NUM_PARTICLES = 100;
+const int BENCHMARK_NUM_TIME_STEPS = 100;
+const double BENCHMARK_TIME_STEP = 0.1;
+const double GATE_VOLTAGE = 0.5;
+const double GATE_FREQUENCY = 2;
+
+//Gate voltage V0*sin(omega*t) implemented through an AmplitudeCallback.
+class GateVoltage : public HoppingAmplitude::AmplitudeCallback{
+public:
+	std::complex<double> getHoppingAmplitude(
+		const Index &to,
+		const Index &from
+	) const{
+		if(isSwitchedOn)
+			return GATE_VOLTAGE*sin(GATE_FREQUENCY*time);
+		else
+			return 0;
+	}
+
+	static bool isSwitchedOn;
+	static double time;
+};
+
+bool GateVoltage::isSwitchedOn = false;
+double GateVoltage::time = 0;
+
+//Time at which the first time step starts. Used to exclude the initial
+//diagonalization from the timings.
+std::chrono::steady_clock::time_point firstTimeStepStart;
+
+bool gateVoltageCallback(TimeEvolver *timeEvolver){
+	if(timeEvolver->getCurrentTimeStep() == 0)
+		firstTimeStepStart = std::chrono::steady_clock::now();
+	GateVoltage::isSwitchedOn = (timeEvolver->getCurrentTimeStep() >= 0);
+	GateVoltage::time
+		= (timeEvolver->getCurrentTimeStep() + 0.5)*BENCHMARK_TIME_STEP;
+
+	return true;
+}
+
+bool benchmarkCallback(TimeEvolver *timeEvolver){
+	if(timeEvolver->getCurrentTimeStep() == 0)
+		firstTimeStepStart = std::chrono::steady_clock::now();
+
+	return true;
+}
+
+//Gate voltage V0*sin(omega*t) implemented through a driving term.
+class GateVoltageDrivingFunction : public TimeEvolver::DrivingFunction{
+public:
+	std::complex<double> getValue(double time) const{
+		return GATE_VOLTAGE*sin(GATE_FREQUENCY*time);
+	}
+};
+
+//Calculate the site resolved density.
+std::vector<double> calculateDensity(TimeEvolver &timeEvolver){
+	std::vector<double> density(BENCHMARK_SIZE, 0);
+	for(int n = 0; n < (int)timeEvolver.getNumEvolvedStates(); n++){
+		if(timeEvolver.getOccupancy(n) == 0)
+			continue;
+		for(int x = 0; x < BENCHMARK_SIZE; x++){
+			density[x] += timeEvolver.getOccupancy(n)*pow(
+				abs(timeEvolver.getAmplitude(n, {x})),
+				2
+			);
+		}
+	}
+
+	return density;
+}
+
+//Compare the number of time steps per second for a chain with a time
+//dependent gate voltage on every site when the time dependence is
+//implemented through AmplitudeCallbacks and through a driving term.
+TEST(TimeEvolverBenchmark, gateVoltage){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	//Time dependence through AmplitudeCallbacks.
+	GateVoltage gateVoltage;
+	GateVoltage::isSwitchedOn = false;
+	Model callbackModel;
+	callbackModel.setVerbose(false);
+	for(int x = 0; x < BENCHMARK_SIZE; x++){
+		callbackModel << HoppingAmplitude(gateVoltage, {x}, {x});
+		if(x + 1 < BENCHMARK_SIZE)
+			callbackModel << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	callbackModel.construct();
+
+	TimeEvolver callbackTimeEvolver;
+	callbackTimeEvolver.getDiagonalizer()->setVerbose(false);
+	callbackTimeEvolver.setModel(callbackModel);
+	callbackTimeEvolver.setCallback(gateVoltageCallback);
+	callbackTimeEvolver.setTimeStep(BENCHMARK_TIME_STEP);
+	callbackTimeEvolver.setNumTimeSteps(BENCHMARK_NUM_TIME_STEPS);
+	callbackTimeEvolver.setNumberOfParticles(BENCHMARK_NUM_PARTICLES);
+	callbackTimeEvolver.run();
+	double callbackTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - firstTimeStepStart
+	).count();
+
+	//Time dependence through a driving term.
+	Model model;
+	model.setVerbose(false);
+	std::vector<HoppingAmplitude> gate;
+	for(int x = 0; x < BENCHMARK_SIZE; x++){
+		gate.push_back(HoppingAmplitude(1, {x}, {x}));
+		if(x + 1 < BENCHMARK_SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	GateVoltageDrivingFunction gateVoltageDrivingFunction;
+	TimeEvolver timeEvolver;
+	timeEvolver.getDiagonalizer()->setVerbose(false);
+	timeEvolver.setModel(model);
+	timeEvolver.setCallback(benchmarkCallback);
+	timeEvolver.setTimeStep(BENCHMARK_TIME_STEP);
+	timeEvolver.setNumTimeSteps(BENCHMARK_NUM_TIME_STEPS);
+	timeEvolver.setNumberOfParticles(BENCHMARK_NUM_PARTICLES);
+	timeEvolver.addDrivingTerm(gate, gateVoltageDrivingFunction);
+	timeEvolver.run();
+	double drivingTermTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - firstTimeStepStart
+	).count();
+
+	std::cout << "Time steps per second for a " << BENCHMARK_SIZE
+		<< " site chain with a time dependent gate voltage:\n"
+		<< "\tAmplitudeCallbacks:\t"
+		<< BENCHMARK_NUM_TIME_STEPS/callbackTime << "\n"
+		<< "\tDriving term:\t\t"
+		<< BENCHMARK_NUM_TIME_STEPS/drivingTermTime << "\n";
+
+	std::vector<double> callbackDensity
+		= calculateDensity(callbackTimeEvolver);
+	std::vector<double> density = calculateDensity(timeEvolver);
+	for(int x = 0; x < BENCHMARK_SIZE; x++)
+		EXPECT_NEAR(density[x], callbackDensity[x], 1e-8);
+}
+
+//Compare the number of time steps per second for a half filled chain with a
+//time dependent gate voltage when evolving all states and when evolving only
+//the occupied subspace.
+TEST(TimeEvolverBenchmark, occupiedSubspace){
+	UnitHandler::setScales(
+		{"1 rad", "1 C", "1 pcs", "1 eV", "1 m", "1 K", "1 fs"}
+	);
+
+	Model model;
+	model.setVerbose(false);
+	std::vector<HoppingAmplitude> gate;
+	for(int x = 0; x < BENCHMARK_SIZE; x++){
+		gate.push_back(HoppingAmplitude(1, {x}, {x}));
+		if(x + 1 < BENCHMARK_SIZE)
+			model << HoppingAmplitude(-1, {x+1}, {x}) + HC;
+	}
+	model.construct();
+
+	GateVoltageDrivingFunction gateVoltageDrivingFunction;
+	double times[2];
+	std::vector<double> densities[2];
+	for(unsigned int n = 0; n < 2; n++){
+		TimeEvolver timeEvolver;
+		timeEvolver.getDiagonalizer()->setVerbose(false);
+		timeEvolver.setModel(model);
+		timeEvolver.setCallback(benchmarkCallback);
+		timeEvolver.setTimeStep(BENCHMARK_TIME_STEP);
+		timeEvolver.setNumTimeSteps(BENCHMARK_NUM_TIME_STEPS);
+		timeEvolver.setNumberOfParticles(BENCHMARK_NUM_PARTICLES);
+		timeEvolver.setEvolveOccupiedSubspace(n == 1);
+		timeEvolver.addDrivingTerm(gate, gateVoltageDrivingFunction);
+		timeEvolver.run();
+		times[n] = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - firstTimeStepStart
+		).count();
+		densities[n] = calculateDensity(timeEvolver);
+	}
+
+	std::cout << "Time steps per second for a half filled "
+		<< BENCHMARK_SIZE << " site chain with a time dependent gate"
+		<< " voltage:\n"
+		<< "\tAll states:\t\t"
+		<< BENCHMARK_NUM_TIME_STEPS/times[0] << "\n"
+		<< "\tOccupied subspace:\t"
+		<< BENCHMARK_NUM_TIME_STEPS/times[1] << "\n";
+
+	for(int x = 0; x < BENCHMARK_SIZE; x++)
+		EXPECT_NEAR(densities[1][x], densities[0][x], 1e-8);
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
@@ -0,0 +1,602 @@
+#include "TBTK/Functions.h"
+#include "TBTK/Matrix.h"
+#include "TBTK/Solver/Transport.h"
+#include "TBTK/Streams.h"
+#include "TBTK/UnitHandler.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+namespace Solver{
+
+const double EPSILON_10000 = 10000*std::numeric_limits<double>::epsilon();
+
+const double LOWER_BOUND = -3;
+const double UPPER_BOUND = 3;
+const int RESOLUTION = 61;
+const double ENERGY_INFINITESIMAL = 1e-10;
+
+//Ladder with two legs and site dependent on-site energies. The Geometry
+//places the sites along the x-axis.
+#define SETUP_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE_X = 20; \
+	const int SIZE_Y = 2; \
+	for(int x = 0; x < SIZE_X; x++){ \
+		for(int y = 0; y < SIZE_Y; y++){ \
+			model << HoppingAmplitude(0.5*sin(x + y), {x, y}, {x, y}); \
+			if(x + 1 < SIZE_X){ \
+				model << HoppingAmplitude( \
+					-1, \
+					{x + 1, y}, \
+					{x, y} \
+				) + HC; \
+			} \
+		} \
+		model << HoppingAmplitude( \
+			std::complex<double>(-0.5, 0.2), \
+			{x, 1}, \
+			{x, 0} \
+		) + HC; \
+	} \
+	model.construct(); \
+	for(int x = 0; x < SIZE_X; x++) \
+		for(int y = 0; y < SIZE_Y; y++) \
+			model.getGeometry().setCoordinate({x, y}, {(double)x, (double)y});
+
+//Wide band lead self-energy -i(gamma/2) on the given Indices.
+Property::SelfEnergy createLeadSelfEnergy(
+	const std::vector<Index> &indices,
+	double gamma
+){
+	IndexTree indexTree;
+	for(unsigned int n = 0; n < indices.size(); n++)
+		indexTree.add({indices[n], indices[n]});
+	indexTree.generateLinearMap();
+
+	Property::SelfEnergy selfEnergy(
+		indexTree,
+		Range(LOWER_BOUND, UPPER_BOUND, RESOLUTION)
+	);
+	for(unsigned int n = 0; n < indices.size(); n++)
+		for(int energy = 0; energy < RESOLUTION; energy++)
+			selfEnergy({indices[n], indices[n]}, energy)
+				= std::complex<double>(0, -gamma/2);
+
+	return selfEnergy;
+}
+
+//Calculate the transmission rate Tr[Gamma_0 G Gamma_1 G^{\dagger}] by
+//inverting the full matrix z - H - Sigma_0 - Sigma_1.
+double calculateTransmissionRateDirectly(
+	const Model &model,
+	const std::vector<Index> &lead0,
+	const std::vector<Index> &lead1,
+	double gamma,
+	double energy
+){
+	const int BASIS_SIZE = model.getBasisSize();
+	Matrix<std::complex<double>> G(BASIS_SIZE, BASIS_SIZE);
+	for(int row = 0; row < BASIS_SIZE; row++)
+		for(int column = 0; column < BASIS_SIZE; column++)
+			G.at(row, column) = 0;
+	for(
+		HoppingAmplitudeSet::ConstIterator iterator
+			= model.getHoppingAmplitudeSet().cbegin();
+		iterator != model.getHoppingAmplitudeSet().cend();
+		++iterator
+	){
+		G.at(
+			model.getBasisIndex((*iterator).getToIndex()),
+			model.getBasisIndex((*iterator).getFromIndex())
+		) -= (*iterator).getAmplitude();
+	}
+	for(int n = 0; n < BASIS_SIZE; n++)
+		G.at(n, n) += std::complex<double>(energy, ENERGY_INFINITESIMAL);
+	for(unsigned int n = 0; n < lead0.size(); n++){
+		int state = model.getBasisIndex(lead0[n]);
+		G.at(state, state) += std::complex<double>(0, gamma/2);
+	}
+	for(unsigned int n = 0; n < lead1.size(); n++){
+		int state = model.getBasisIndex(lead1[n]);
+		G.at(state, state) += std::complex<double>(0, gamma/2);
+	}
+	G.invert();
+
+	double transmissionRate = 0;
+	for(unsigned int n = 0; n < lead0.size(); n++){
+		for(unsigned int c = 0; c < lead1.size(); c++){
+			transmissionRate += gamma*gamma*std::norm(
+				G.at(
+					model.getBasisIndex(lead0[n]),
+					model.getBasisIndex(lead1[c])
+				)
+			);
+		}
+	}
+
+	return transmissionRate;
+}
+
+//Semi-infinite chain with hopping amplitude -1, described by two unit cells
+//with one site each.
+#define SETUP_LEAD_MODEL() \
+	Model leadModel; \
+	leadModel.setVerbose(false); \
+	leadModel << HoppingAmplitude(-1, {1, 0}, {0, 0}) + HC; \
+	leadModel.construct();
+
+//Clean chain with hopping amplitude -1.
+#define SETUP_CHAIN_MODEL() \
+	Model model; \
+	model.setVerbose(false); \
+	const int SIZE = 10; \
+	for(int x = 0; x + 1 < SIZE; x++) \
+		model << HoppingAmplitude(-1, {x + 1}, {x}) + HC; \
+	model.construct();
+
+//Surface Green's function for a semi-infinite chain with hopping amplitude
+//-1.
+std::complex<double> analyticalSurfaceGreensFunction(double energy){
+	if(std::abs(energy) < 2){
+		return std::complex<double>(
+			energy/2,
+			-sqrt(4 - energy*energy)/2
+		);
+	}
+	else{
+		return (energy - (energy > 0 ? 1 : -1)*sqrt(energy*energy - 4))/2;
+	}
+}
+
+TEST(Transport, DynamicTypeInformation){
+	Transport solver;
+	const DynamicTypeInformation &typeInformation
+		= solver.getDynamicTypeInformation();
+	EXPECT_EQ(typeInformation.getName(), "Solver::Transport");
+	EXPECT_EQ(typeInformation.getNumParents(), 1);
+	EXPECT_EQ(typeInformation.getParent(0).getName(), "Solver::Solver");
+}
+
+TEST(Transport, Constructor){
+	//Not testable on its own.
+}
+
+TEST(Transport, setMethod){
+	//Tested through Transport::getMethod().
+}
+
+TEST(Transport, getMethod){
+	Transport solver;
+	EXPECT_EQ(solver.getMethod(), Transport::Method::Diagonalization);
+	solver.setMethod(Transport::Method::RecursiveGreensFunction);
+	EXPECT_EQ(
+		solver.getMethod(),
+		Transport::Method::RecursiveGreensFunction
+	);
+}
+
+TEST(Transport, addLead0){
+	//Tested through Transport::calculateTransmissionRate().
+}
+
+TEST(Transport, addLead1){
+	SETUP_CHAIN_MODEL();
+
+	//Fail for lead Models with Indices that do not start with 0 or 1.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Model leadModel;
+			leadModel << HoppingAmplitude(-1, {2, 0}, {0, 0}) + HC;
+			leadModel.construct();
+
+			Transport solver;
+			solver.setModel(model);
+			solver.addLead(
+				leadModel,
+				{HoppingAmplitude(-1, {0}, {0, 0})},
+				0,
+				0
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for unit cells with different Indices.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			Model leadModel;
+			leadModel << HoppingAmplitude(-1, {1, 1}, {0, 0}) + HC;
+			leadModel.construct();
+
+			Transport solver;
+			solver.setModel(model);
+			solver.addLead(
+				leadModel,
+				{HoppingAmplitude(-1, {0}, {0, 0})},
+				0,
+				0
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for couplings from the second unit cell.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_LEAD_MODEL();
+
+			Transport solver;
+			solver.setModel(model);
+			solver.addLead(
+				leadModel,
+				{HoppingAmplitude(-1, {0}, {1, 0})},
+				0,
+				0
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Transport, calculateLeadSelfEnergy){
+	SETUP_CHAIN_MODEL();
+	SETUP_LEAD_MODEL();
+
+	//Energies that avoid the band edges, where the self-energy is
+	//singular.
+	const int NUM_ENERGIES = 50;
+	Transport solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, NUM_ENERGIES);
+	solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+	solver.addLead(
+		leadModel,
+		{HoppingAmplitude(-0.5, {0}, {0, 0})},
+		0,
+		0
+	);
+
+	const Property::SelfEnergy &selfEnergy
+		= solver.calculateLeadSelfEnergy(0);
+	ASSERT_EQ(selfEnergy.getResolution(), NUM_ENERGIES);
+	for(int n = 0; n < NUM_ENERGIES; n++){
+		std::complex<double> reference
+			= 0.25*analyticalSurfaceGreensFunction(
+				selfEnergy.getEnergy(n)
+			);
+		EXPECT_NEAR(
+			std::real(selfEnergy({Index({0}), Index({0})}, n)),
+			std::real(reference),
+			1e-8
+		);
+		EXPECT_NEAR(
+			std::imag(selfEnergy({Index({0}), Index({0})}, n)),
+			std::imag(reference),
+			1e-8
+		);
+	}
+
+	//The self-energy is reused as long as the energy window is
+	//unchanged.
+	const std::complex<double> *data = selfEnergy.getData().data();
+	EXPECT_EQ(solver.calculateLeadSelfEnergy(0).getData().data(), data);
+
+	//The self-energy is recalculated when the energy window changes.
+	solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, 2*NUM_ENERGIES);
+	EXPECT_EQ(
+		solver.calculateLeadSelfEnergy(0).getResolution(),
+		2*NUM_ENERGIES
+	);
+
+	//Fail for invalid lead number.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.calculateLeadSelfEnergy(1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Transport, setLayers0){
+	//Tested through Transport::calculateTransmissionRate().
+}
+
+TEST(Transport, setLayers1){
+	Transport solver;
+
+	//Fail for non-positive layer width.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			solver.setLayers(0, 0);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Transport, setEnergyInfinitesimal){
+	//Tested through Transport::calculateTransmissionRate().
+}
+
+void testTransmissionRate(
+	Transport &solver,
+	const Model &model,
+	const std::vector<Index> &lead0,
+	const std::vector<Index> &lead1,
+	double gamma
+){
+	solver.addLead(createLeadSelfEnergy(lead0, gamma), 0, 0);
+	solver.addLead(createLeadSelfEnergy(lead1, gamma), 0, 0);
+	Property::TransmissionRate transmissionRate
+		= solver.calculateTransmissionRate(0, 1);
+	Property::TransmissionRate reverseTransmissionRate
+		= solver.calculateTransmissionRate(1, 0);
+
+	ASSERT_EQ(transmissionRate.getResolution(), RESOLUTION);
+	for(int n = 0; n < RESOLUTION; n++){
+		double reference = calculateTransmissionRateDirectly(
+			model,
+			lead0,
+			lead1,
+			gamma,
+			transmissionRate.getEnergy(n)
+		);
+		EXPECT_NEAR(transmissionRate(n), reference, EPSILON_10000);
+		EXPECT_NEAR(
+			reverseTransmissionRate(n),
+			reference,
+			EPSILON_10000
+		);
+	}
+}
+
+TEST(Transport, calculateTransmissionRate){
+	//Layers specified explicitly.
+	{
+		SETUP_MODEL();
+		std::vector<std::vector<Index>> layers;
+		for(int x = 0; x < SIZE_X; x++)
+			layers.push_back({{x, 0}, {x, 1}});
+
+		Transport solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setMethod(Transport::Method::RecursiveGreensFunction);
+		solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, RESOLUTION);
+		solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+		solver.setLayers(layers);
+		testTransmissionRate(
+			solver,
+			model,
+			{{0, 0}, {0, 1}},
+			{{SIZE_X - 1, 0}, {SIZE_X - 1, 1}},
+			1
+		);
+	}
+
+	//Layers obtained from the Geometry, with two columns per layer and
+	//only one leg coupled to each lead.
+	{
+		SETUP_MODEL();
+		Transport solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setMethod(Transport::Method::RecursiveGreensFunction);
+		solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, RESOLUTION);
+		solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+		solver.setLayers(0, 2);
+		testTransmissionRate(
+			solver,
+			model,
+			{{0, 0}},
+			{{SIZE_X - 1, 1}},
+			0.5
+		);
+	}
+
+	//A single layer.
+	{
+		SETUP_MODEL();
+		Transport solver;
+		solver.setVerbose(false);
+		solver.setModel(model);
+		solver.setMethod(Transport::Method::RecursiveGreensFunction);
+		solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, RESOLUTION);
+		solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+		solver.setLayers(0, 2*SIZE_X);
+		testTransmissionRate(solver, model, {{0, 0}}, {{3, 1}}, 1);
+	}
+}
+
+TEST(Transport, calculateTransmissionRateSemiInfiniteLeads){
+	SETUP_CHAIN_MODEL();
+	SETUP_LEAD_MODEL();
+	std::vector<std::vector<Index>> layers;
+	for(int x = 0; x < SIZE; x++)
+		layers.push_back({{x}});
+
+	//A clean chain coupled to two leads that continue the chain has
+	//perfect transmission inside the band and zero transmission outside.
+	const int NUM_ENERGIES = 50;
+	Transport solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMethod(Transport::Method::RecursiveGreensFunction);
+	solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, NUM_ENERGIES);
+	solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+	solver.setLayers(layers);
+	solver.addLead(
+		leadModel,
+		{HoppingAmplitude(-1, {0}, {0, 0})},
+		0,
+		0
+	);
+	solver.addLead(
+		leadModel,
+		{HoppingAmplitude(-1, {SIZE - 1}, {0, 0})},
+		0,
+		0
+	);
+	Property::TransmissionRate transmissionRate
+		= solver.calculateTransmissionRate(0, 1);
+	for(int n = 0; n < NUM_ENERGIES; n++){
+		if(std::abs(transmissionRate.getEnergy(n)) < 2)
+			EXPECT_NEAR(transmissionRate(n), 1, 1e-6);
+		else
+			EXPECT_NEAR(transmissionRate(n), 0, 1e-6);
+	}
+}
+
+TEST(Transport, calculateTransmissionRateInvalidParameters){
+	//Fail for the Diagonalization method.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_MODEL();
+			Transport solver;
+			solver.setModel(model);
+			solver.setEnergyWindow(
+				LOWER_BOUND,
+				UPPER_BOUND,
+				RESOLUTION
+			);
+			solver.addLead(createLeadSelfEnergy({{0, 0}}, 1), 0, 0);
+			solver.addLead(createLeadSelfEnergy({{0, 1}}, 1), 0, 0);
+			solver.calculateTransmissionRate(0, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for a lead that is not attached to the first or last layer.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_MODEL();
+			Transport solver;
+			solver.setModel(model);
+			solver.setMethod(
+				Transport::Method::RecursiveGreensFunction
+			);
+			solver.setEnergyWindow(
+				LOWER_BOUND,
+				UPPER_BOUND,
+				RESOLUTION
+			);
+			solver.setLayers(0, 1);
+			solver.addLead(createLeadSelfEnergy({{0, 0}}, 1), 0, 0);
+			solver.addLead(createLeadSelfEnergy({{1, 0}}, 1), 0, 0);
+			solver.calculateTransmissionRate(0, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if non-neighboring layers are coupled.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_MODEL();
+			Transport solver;
+			solver.setModel(model);
+			solver.setMethod(
+				Transport::Method::RecursiveGreensFunction
+			);
+			solver.setEnergyWindow(
+				LOWER_BOUND,
+				UPPER_BOUND,
+				RESOLUTION
+			);
+			std::vector<std::vector<Index>> layers;
+			layers.push_back({{0, 0}, {0, 1}});
+			layers.push_back({{2, 0}, {2, 1}});
+			layers.push_back({{1, 0}, {1, 1}});
+			for(int x = 3; x < SIZE_X; x++)
+				layers.push_back({{x, 0}, {x, 1}});
+			solver.setLayers(layers);
+			solver.addLead(createLeadSelfEnergy({{0, 0}}, 1), 0, 0);
+			solver.addLead(
+				createLeadSelfEnergy({{SIZE_X - 1, 0}}, 1),
+				0,
+				0
+			);
+			solver.calculateTransmissionRate(0, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail if an Index is missing from the layers.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			SETUP_MODEL();
+			Transport solver;
+			solver.setModel(model);
+			solver.setMethod(
+				Transport::Method::RecursiveGreensFunction
+			);
+			solver.setEnergyWindow(
+				LOWER_BOUND,
+				UPPER_BOUND,
+				RESOLUTION
+			);
+			solver.setLayers({{{0, 0}, {0, 1}}});
+			solver.addLead(createLeadSelfEnergy({{0, 0}}, 1), 0, 0);
+			solver.addLead(createLeadSelfEnergy({{0, 1}}, 1), 0, 0);
+			solver.calculateTransmissionRate(0, 1);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(Transport, calculateCurrent){
+	SETUP_MODEL();
+	Transport solver;
+	solver.setVerbose(false);
+	solver.setModel(model);
+	solver.setMethod(Transport::Method::RecursiveGreensFunction);
+	solver.setEnergyWindow(LOWER_BOUND, UPPER_BOUND, RESOLUTION);
+	solver.setEnergyInfinitesimal(ENERGY_INFINITESIMAL);
+	solver.setLayers(0, 1);
+	solver.addLead(createLeadSelfEnergy({{0, 0}}, 1), 1, 0.1);
+	solver.addLead(createLeadSelfEnergy({{SIZE_X - 1, 1}}, 1), -1, 0.1);
+	Property::TransmissionRate transmissionRate
+		= solver.calculateTransmissionRate(0, 1);
+
+	//Landauer formula.
+	double hbar = UnitHandler::getConstantInNaturalUnits("hbar");
+	double e = UnitHandler::getConstantInNaturalUnits("e");
+	double current = 0;
+	for(int n = 0; n < RESOLUTION; n++){
+		double E = transmissionRate.getEnergy(n);
+		current += transmissionRate(n)*(
+			Functions::fermiDiracDistribution(E, 1, 0.1)
+			- Functions::fermiDiracDistribution(E, -1, 0.1)
+		)*transmissionRate.getDeltaE();
+	}
+	current *= e/(2*M_PI*hbar);
+
+	EXPECT_GT(current, 0);
+	EXPECT_NEAR(solver.calculateCurrent(0), current, EPSILON_10000);
+	EXPECT_NEAR(solver.calculateCurrent(1), -current, EPSILON_10000);
+}
+
+};	//End of namespace Solver
+};	//End of namespace TBTK
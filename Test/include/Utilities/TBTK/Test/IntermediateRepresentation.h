@@ -0,0 +1,479 @@
+#include "TBTK/IntermediateRepresentation.h"
+#include "TBTK/IndexTree.h"
+#include "TBTK/Streams.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+
+namespace TBTK{
+
+const double EPSILON = 1e-8;
+
+//Parameters for the tests. The fundamental Matsubara energy corresponds to
+//beta = 100 and the energy cutoff to betaOmegaMax = 200.
+const double FUNDAMENTAL_MATSUBARA_ENERGY = M_PI/100.;
+const double ENERGY_CUTOFF = 2;
+
+//Green's function with two poles inside the energy window, in imaginary
+//time and Matsubara energy.
+const double POLE_ENERGIES[2] = {-0.7, 0.3};
+const double POLE_WEIGHTS[2] = {0.4, 0.6};
+
+std::complex<double> greensFunction(
+	Statistics statistics,
+	int matsubaraEnergyIndex
+){
+	std::complex<double> matsubaraEnergy(
+		0,
+		matsubaraEnergyIndex*FUNDAMENTAL_MATSUBARA_ENERGY
+	);
+	std::complex<double> result = 0;
+	for(unsigned int n = 0; n < 2; n++)
+		result += POLE_WEIGHTS[n]/(matsubaraEnergy - POLE_ENERGIES[n]);
+
+	return result;
+}
+
+std::complex<double> greensFunction(
+	Statistics statistics,
+	double imaginaryTime
+){
+	const double BETA = M_PI/FUNDAMENTAL_MATSUBARA_ENERGY;
+	std::complex<double> result = 0;
+	for(unsigned int n = 0; n < 2; n++){
+		double sign = (statistics == Statistics::FermiDirac ? 1 : -1);
+		result -= POLE_WEIGHTS[n]*exp(-imaginaryTime*POLE_ENERGIES[n])
+			/(1 + sign*exp(-BETA*POLE_ENERGIES[n]));
+	}
+
+	return result;
+}
+
+TEST(IntermediateRepresentation, Constructor0){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+	EXPECT_EQ(
+		intermediateRepresentation.getStatistics(),
+		Statistics::FermiDirac
+	);
+	EXPECT_NEAR(
+		intermediateRepresentation.getInverseTemperature(),
+		100,
+		EPSILON
+	);
+
+	//The number of basis functions grows slowly with decreasing
+	//temperature, while the number of Matsubara energies below the energy
+	//cutoff grows linearly with the inverse temperature.
+	IntermediateRepresentation lowTemperatureRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY/10,
+		ENERGY_CUTOFF
+	);
+	unsigned int numBasisFunctions
+		= intermediateRepresentation.getNumBasisFunctions();
+	unsigned int lowTemperatureNumBasisFunctions
+		= lowTemperatureRepresentation.getNumBasisFunctions();
+	unsigned int lowTemperatureNumMatsubaraEnergies
+		= 10*ENERGY_CUTOFF/FUNDAMENTAL_MATSUBARA_ENERGY;
+	EXPECT_LT(lowTemperatureNumBasisFunctions, 2*numBasisFunctions);
+	EXPECT_LT(
+		5*lowTemperatureNumBasisFunctions,
+		lowTemperatureNumMatsubaraEnergies
+	);
+}
+
+TEST(IntermediateRepresentation, Constructor1){
+	//Fail for non-positive fundamental Matsubara energy.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IntermediateRepresentation intermediateRepresentation(
+				Statistics::FermiDirac,
+				0,
+				ENERGY_CUTOFF
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for non-positive energy cutoff.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			IntermediateRepresentation intermediateRepresentation(
+				Statistics::FermiDirac,
+				FUNDAMENTAL_MATSUBARA_ENERGY,
+				0
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(IntermediateRepresentation, getStatistics){
+	//Tested through IntermediateRepresentation::Constructor0.
+}
+
+TEST(IntermediateRepresentation, getInverseTemperature){
+	//Tested through IntermediateRepresentation::Constructor0.
+}
+
+TEST(IntermediateRepresentation, getNumBasisFunctions){
+	//Tested through IntermediateRepresentation::Constructor0.
+}
+
+TEST(IntermediateRepresentation, getSingularValues){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF,
+		1e-6
+	);
+	const std::vector<double> &singularValues
+		= intermediateRepresentation.getSingularValues();
+	ASSERT_EQ(
+		singularValues.size(),
+		intermediateRepresentation.getNumBasisFunctions()
+	);
+	for(unsigned int n = 1; n < singularValues.size(); n++)
+		EXPECT_LE(singularValues[n], singularValues[n-1]);
+	EXPECT_GT(singularValues.back(), 1e-6*singularValues[0]);
+}
+
+TEST(IntermediateRepresentation, getMatsubaraSamplingPoints){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+	const std::vector<int> &samplingPoints
+		= intermediateRepresentation.getMatsubaraSamplingPoints();
+	ASSERT_EQ(
+		samplingPoints.size(),
+		intermediateRepresentation.getNumBasisFunctions()
+	);
+	for(unsigned int n = 0; n < samplingPoints.size(); n++){
+		EXPECT_EQ(abs(samplingPoints[n])%2, 1);
+		if(n > 0)
+			EXPECT_LT(samplingPoints[n-1], samplingPoints[n]);
+	}
+}
+
+TEST(IntermediateRepresentation, getImaginaryTimeSamplingPoints){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+	const std::vector<double> &samplingPoints
+		= intermediateRepresentation.getImaginaryTimeSamplingPoints();
+	ASSERT_EQ(
+		samplingPoints.size(),
+		intermediateRepresentation.getNumBasisFunctions()
+	);
+	for(unsigned int n = 0; n < samplingPoints.size(); n++){
+		EXPECT_GE(samplingPoints[n], 0);
+		EXPECT_LE(samplingPoints[n], 100);
+		if(n > 0)
+			EXPECT_LT(samplingPoints[n-1], samplingPoints[n]);
+	}
+}
+
+TEST(IntermediateRepresentation, evaluateImaginaryTimeBasisFunction){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+
+	//The basis functions are orthonormal on [0, beta]. Check using the
+	//trapezoidal rule on a fine grid.
+	const unsigned int NUM_POINTS = 20000;
+	const double DELTA_TAU = 100./NUM_POINTS;
+	std::vector<double> u0;
+	std::vector<double> u1;
+	for(unsigned int n = 0; n <= NUM_POINTS; n++){
+		u0.push_back(
+			intermediateRepresentation.evaluateImaginaryTimeBasisFunction(
+				0,
+				n*DELTA_TAU
+			)
+		);
+		u1.push_back(
+			intermediateRepresentation.evaluateImaginaryTimeBasisFunction(
+				1,
+				n*DELTA_TAU
+			)
+		);
+	}
+	double overlap00 = 0;
+	double overlap01 = 0;
+	for(unsigned int n = 0; n <= NUM_POINTS; n++){
+		double weight = (n == 0 || n == NUM_POINTS) ? 0.5 : 1;
+		overlap00 += weight*u0[n]*u0[n]*DELTA_TAU;
+		overlap01 += weight*u0[n]*u1[n]*DELTA_TAU;
+	}
+	EXPECT_NEAR(overlap00, 1, 1e-4);
+	EXPECT_NEAR(overlap01, 0, 1e-4);
+
+	//Fail for imaginary times outside [0, beta].
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			intermediateRepresentation.evaluateImaginaryTimeBasisFunction(
+				0,
+				-1
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(IntermediateRepresentation, evaluateMatsubaraBasisFunction){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+
+	//Fail for even Matsubara energy indices for Fermions.
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			intermediateRepresentation.evaluateMatsubaraBasisFunction(
+				0,
+				2
+			);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+void testFitAndEvaluate(Statistics statistics){
+	IntermediateRepresentation intermediateRepresentation(
+		statistics,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+	const std::vector<int> &matsubaraSamplingPoints
+		= intermediateRepresentation.getMatsubaraSamplingPoints();
+	const std::vector<double> &imaginaryTimeSamplingPoints
+		= intermediateRepresentation.getImaginaryTimeSamplingPoints();
+
+	//Fit from Matsubara energies and imaginary times. Use two functions
+	//where the second is twice the first.
+	std::vector<std::complex<double>> matsubaraValues;
+	std::vector<std::complex<double>> imaginaryTimeValues;
+	for(unsigned int block = 0; block < 2; block++){
+		for(unsigned int n = 0; n < matsubaraSamplingPoints.size(); n++){
+			matsubaraValues.push_back(
+				(block + 1.)*greensFunction(
+					statistics,
+					matsubaraSamplingPoints[n]
+				)
+			);
+			imaginaryTimeValues.push_back(
+				(block + 1.)*greensFunction(
+					statistics,
+					imaginaryTimeSamplingPoints[n]
+				)
+			);
+		}
+	}
+	std::vector<std::complex<double>> coefficients[2] = {
+		intermediateRepresentation.fitMatsubara(matsubaraValues),
+		intermediateRepresentation.fitImaginaryTime(imaginaryTimeValues)
+	};
+
+	//Evaluate at Matsubara energies and imaginary times that are not
+	//sampling points.
+	const int OFFSET = (statistics == Statistics::FermiDirac ? 1 : 0);
+	std::vector<int> matsubaraEnergyIndices;
+	for(int n = -500; n < 500; n += 7)
+		matsubaraEnergyIndices.push_back(2*n + OFFSET);
+	std::vector<double> imaginaryTimes;
+	for(unsigned int n = 0; n <= 100; n++)
+		imaginaryTimes.push_back(n);
+
+	for(unsigned int c = 0; c < 2; c++){
+		std::vector<std::complex<double>> matsubaraResult
+			= intermediateRepresentation.evaluateMatsubara(
+				coefficients[c],
+				matsubaraEnergyIndices
+			);
+		std::vector<std::complex<double>> imaginaryTimeResult
+			= intermediateRepresentation.evaluateImaginaryTime(
+				coefficients[c],
+				imaginaryTimes
+			);
+		ASSERT_EQ(
+			matsubaraResult.size(),
+			2*matsubaraEnergyIndices.size()
+		);
+		ASSERT_EQ(imaginaryTimeResult.size(), 2*imaginaryTimes.size());
+		for(unsigned int block = 0; block < 2; block++){
+			for(
+				unsigned int n = 0;
+				n < matsubaraEnergyIndices.size();
+				n++
+			){
+				std::complex<double> reference
+					= (block + 1.)*greensFunction(
+						statistics,
+						matsubaraEnergyIndices[n]
+					);
+				EXPECT_NEAR(
+					std::abs(
+						matsubaraResult[
+							n + matsubaraEnergyIndices.size()*block
+						] - reference
+					),
+					0,
+					EPSILON
+				);
+			}
+			for(unsigned int n = 0; n < imaginaryTimes.size(); n++){
+				std::complex<double> reference
+					= (block + 1.)*greensFunction(
+						statistics,
+						imaginaryTimes[n]
+					);
+				EXPECT_NEAR(
+					std::abs(
+						imaginaryTimeResult[
+							n + imaginaryTimes.size()*block
+						] - reference
+					),
+					0,
+					EPSILON
+				);
+			}
+		}
+	}
+}
+
+TEST(IntermediateRepresentation, fitMatsubara){
+	testFitAndEvaluate(Statistics::FermiDirac);
+	testFitAndEvaluate(Statistics::BoseEinstein);
+}
+
+TEST(IntermediateRepresentation, fitImaginaryTime){
+	//Tested through IntermediateRepresentation::fitMatsubara().
+}
+
+TEST(IntermediateRepresentation, evaluateMatsubara){
+	//Tested through IntermediateRepresentation::fitMatsubara().
+}
+
+TEST(IntermediateRepresentation, evaluateImaginaryTime){
+	//Tested through IntermediateRepresentation::fitMatsubara().
+}
+
+TEST(IntermediateRepresentation, fit){
+	IntermediateRepresentation intermediateRepresentation(
+		Statistics::FermiDirac,
+		FUNDAMENTAL_MATSUBARA_ENERGY,
+		ENERGY_CUTOFF
+	);
+
+	IndexTree indexTree;
+	indexTree.add({0});
+	indexTree.add({1});
+	indexTree.generateLinearMap();
+	const int LOWER_INDEX = -2001;
+	const int UPPER_INDEX = 2001;
+	Property::EnergyResolvedProperty<std::complex<double>> property(
+		Property::EnergyResolvedProperty<
+			std::complex<double>
+		>::EnergyType::FermionicMatsubara,
+		indexTree,
+		LOWER_INDEX,
+		UPPER_INDEX,
+		FUNDAMENTAL_MATSUBARA_ENERGY
+	);
+	for(unsigned int n = 0; n < property.getNumMatsubaraEnergies(); n++){
+		property({0}, n) = greensFunction(
+			Statistics::FermiDirac,
+			LOWER_INDEX + 2*(int)n
+		);
+		property({1}, n) = 2.*property({0}, n);
+	}
+
+	//Fit, clear, and evaluate the Property.
+	std::vector<std::complex<double>> coefficients
+		= intermediateRepresentation.fit(property);
+	ASSERT_EQ(
+		coefficients.size(),
+		2*intermediateRepresentation.getNumBasisFunctions()
+	);
+	std::vector<std::complex<double>> &data = property.getDataRW();
+	for(unsigned int n = 0; n < data.size(); n++)
+		data[n] = 0;
+	intermediateRepresentation.evaluate(coefficients, property);
+	for(unsigned int n = 0; n < property.getNumMatsubaraEnergies(); n++){
+		std::complex<double> reference = greensFunction(
+			Statistics::FermiDirac,
+			LOWER_INDEX + 2*(int)n
+		);
+		EXPECT_NEAR(std::abs(property({0}, n) - reference), 0, EPSILON);
+		EXPECT_NEAR(
+			std::abs(property({1}, n) - 2.*reference),
+			0,
+			EPSILON
+		);
+	}
+
+	//Fail if the sampling points are not contained in the energy window.
+	Property::EnergyResolvedProperty<std::complex<double>> smallProperty(
+		Property::EnergyResolvedProperty<
+			std::complex<double>
+		>::EnergyType::FermionicMatsubara,
+		indexTree,
+		-1,
+		1,
+		FUNDAMENTAL_MATSUBARA_ENERGY
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			intermediateRepresentation.fit(smallProperty);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+
+	//Fail for incompatible statistics.
+	Property::EnergyResolvedProperty<std::complex<double>> bosonicProperty(
+		Property::EnergyResolvedProperty<
+			std::complex<double>
+		>::EnergyType::BosonicMatsubara,
+		indexTree,
+		LOWER_INDEX - 1,
+		UPPER_INDEX + 1,
+		FUNDAMENTAL_MATSUBARA_ENERGY
+	);
+	EXPECT_EXIT(
+		{
+			Streams::setStdMuteErr();
+			intermediateRepresentation.fit(bosonicProperty);
+		},
+		::testing::ExitedWithCode(1),
+		""
+	);
+}
+
+TEST(IntermediateRepresentation, evaluate){
+	//Tested through IntermediateRepresentation::fit().
+}
+
+};
@@ -0,0 +1,200 @@
+#include "TBTK/SmallVector.h"
+
+#include "gtest/gtest.h"
+
+namespace TBTK{
+
+TEST(SmallVector, constructor0){
+	SmallVector<int, 4> smallVector;
+	EXPECT_EQ(smallVector.getSize(), 0);
+	EXPECT_EQ(smallVector.getCapacity(), 4);
+	EXPECT_TRUE(smallVector.getIsInline());
+}
+
+TEST(SmallVector, constructor1){
+	SmallVector<int, 4> smallVector0({0, 1, 2});
+	EXPECT_EQ(smallVector0.getSize(), 3);
+	EXPECT_TRUE(smallVector0.getIsInline());
+	for(unsigned int n = 0; n < 3; n++)
+		EXPECT_EQ(smallVector0[n], n);
+
+	SmallVector<int, 4> smallVector1({0, 1, 2, 3, 4, 5});
+	EXPECT_EQ(smallVector1.getSize(), 6);
+	EXPECT_FALSE(smallVector1.getIsInline());
+	for(unsigned int n = 0; n < 6; n++)
+		EXPECT_EQ(smallVector1[n], n);
+}
+
+TEST(SmallVector, constructor2){
+	SmallVector<int, 4> smallVector(std::vector<int>({0, 1, 2, 3, 4}));
+	EXPECT_EQ(smallVector.getSize(), 5);
+	EXPECT_FALSE(smallVector.getIsInline());
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(smallVector[n], n);
+}
+
+TEST(SmallVector, copyConstructor0){
+	SmallVector<int, 4> smallVector0({0, 1, 2});
+	SmallVector<int, 4> copy0 = smallVector0;
+	EXPECT_EQ(copy0.getSize(), 3);
+	EXPECT_TRUE(copy0.getIsInline());
+	for(unsigned int n = 0; n < 3; n++)
+		EXPECT_EQ(copy0[n], n);
+
+	SmallVector<int, 4> smallVector1({0, 1, 2, 3, 4});
+	SmallVector<int, 4> copy1 = smallVector1;
+	EXPECT_EQ(copy1.getSize(), 5);
+	EXPECT_FALSE(copy1.getIsInline());
+	EXPECT_NE(copy1.getData(), smallVector1.getData());
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(copy1[n], n);
+}
+
+TEST(SmallVector, moveConstructor0){
+	SmallVector<int, 4> smallVector0({0, 1, 2});
+	SmallVector<int, 4> moved0 = std::move(smallVector0);
+	EXPECT_EQ(moved0.getSize(), 3);
+	for(unsigned int n = 0; n < 3; n++)
+		EXPECT_EQ(moved0[n], n);
+
+	SmallVector<int, 4> smallVector1({0, 1, 2, 3, 4});
+	const int *data = smallVector1.getData();
+	SmallVector<int, 4> moved1 = std::move(smallVector1);
+	EXPECT_EQ(moved1.getSize(), 5);
+	EXPECT_EQ(moved1.getData(), data);
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(moved1[n], n);
+}
+
+TEST(SmallVector, operatorAssignment0){
+	SmallVector<int, 4> smallVector0({0, 1, 2, 3, 4});
+	SmallVector<int, 4> smallVector1({5, 6});
+	smallVector1 = smallVector0;
+	EXPECT_EQ(smallVector1.getSize(), 5);
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(smallVector1[n], n);
+
+	smallVector0 = SmallVector<int, 4>({7, 8});
+	EXPECT_EQ(smallVector0.getSize(), 2);
+	EXPECT_EQ(smallVector0[0], 7);
+	EXPECT_EQ(smallVector0[1], 8);
+}
+
+TEST(SmallVector, operatorMoveAssignment0){
+	SmallVector<int, 4> smallVector0({0, 1, 2, 3, 4});
+	SmallVector<int, 4> smallVector1({5, 6});
+	smallVector1 = std::move(smallVector0);
+	EXPECT_EQ(smallVector1.getSize(), 5);
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(smallVector1[n], n);
+
+	SmallVector<int, 4> smallVector2({7, 8});
+	smallVector1 = std::move(smallVector2);
+	EXPECT_EQ(smallVector1.getSize(), 2);
+	EXPECT_EQ(smallVector1[0], 7);
+	EXPECT_EQ(smallVector1[1], 8);
+}
+
+TEST(SmallVector, at0){
+	SmallVector<int, 4> smallVector({0, 1, 2});
+	EXPECT_EQ(smallVector.at(2), 2);
+	EXPECT_THROW(smallVector.at(3), std::out_of_range);
+}
+
+TEST(SmallVector, back0){
+	SmallVector<int, 4> smallVector({0, 1, 2});
+	EXPECT_EQ(smallVector.back(), 2);
+}
+
+TEST(SmallVector, reserve0){
+	SmallVector<int, 4> smallVector({0, 1, 2});
+	smallVector.reserve(2);
+	EXPECT_TRUE(smallVector.getIsInline());
+	smallVector.reserve(10);
+	EXPECT_FALSE(smallVector.getIsInline());
+	EXPECT_EQ(smallVector.getCapacity(), 10);
+	EXPECT_EQ(smallVector.getSize(), 3);
+	for(unsigned int n = 0; n < 3; n++)
+		EXPECT_EQ(smallVector[n], n);
+}
+
+TEST(SmallVector, pushBack0){
+	SmallVector<int, 4> smallVector;
+	for(unsigned int n = 0; n < 4; n++)
+		smallVector.pushBack(n);
+	EXPECT_TRUE(smallVector.getIsInline());
+	for(unsigned int n = 4; n < 20; n++)
+		smallVector.pushBack(n);
+	EXPECT_FALSE(smallVector.getIsInline());
+	EXPECT_EQ(smallVector.getSize(), 20);
+	for(unsigned int n = 0; n < 20; n++)
+		EXPECT_EQ(smallVector[n], n);
+
+	//Push back an element of the SmallVector itself when the storage
+	//needs to be reallocated.
+	SmallVector<int, 4> smallVector1({0, 1, 2, 3});
+	smallVector1.pushBack(smallVector1[1]);
+	EXPECT_EQ(smallVector1.getSize(), 5);
+	EXPECT_EQ(smallVector1[4], 1);
+}
+
+TEST(SmallVector, popBack0){
+	SmallVector<int, 4> smallVector({0, 1, 2});
+	smallVector.popBack();
+	EXPECT_EQ(smallVector.getSize(), 2);
+	EXPECT_EQ(smallVector.back(), 1);
+}
+
+TEST(SmallVector, insert0){
+	SmallVector<int, 4> smallVector({0, 1, 3, 4});
+	smallVector.insert(2, 2);
+	EXPECT_EQ(smallVector.getSize(), 5);
+	for(unsigned int n = 0; n < 5; n++)
+		EXPECT_EQ(smallVector[n], n);
+
+	smallVector.insert(5, 5);
+	smallVector.insert(0, -1);
+	EXPECT_EQ(smallVector.getSize(), 7);
+	for(unsigned int n = 0; n < 7; n++)
+		EXPECT_EQ(smallVector[n], (int)n - 1);
+}
+
+TEST(SmallVector, erase0){
+	SmallVector<int, 4> smallVector({0, 1, 2, 3, 4});
+	smallVector.erase(0);
+	smallVector.erase(1);
+	EXPECT_EQ(smallVector.getSize(), 3);
+	EXPECT_EQ(smallVector[0], 1);
+	EXPECT_EQ(smallVector[1], 3);
+	EXPECT_EQ(smallVector[2], 4);
+}
+
+TEST(SmallVector, clear0){
+	SmallVector<int, 4> smallVector({0, 1, 2, 3, 4});
+	unsigned int capacity = smallVector.getCapacity();
+	smallVector.clear();
+	EXPECT_EQ(smallVector.getSize(), 0);
+	EXPECT_EQ(smallVector.getCapacity(), capacity);
+}
+
+TEST(SmallVector, iterators0){
+	SmallVector<int, 4> smallVector({0, 1, 2, 3, 4});
+	int counter = 0;
+	for(int element : smallVector)
+		EXPECT_EQ(element, counter++);
+	EXPECT_EQ(counter, 5);
+	EXPECT_EQ(smallVector.end() - smallVector.begin(), 5);
+}
+
+TEST(SmallVector, getSizeInBytes0){
+	SmallVector<int, 4> smallVector0({0, 1, 2});
+	EXPECT_EQ(smallVector0.getSizeInBytes(), sizeof(smallVector0));
+
+	SmallVector<int, 4> smallVector1({0, 1, 2, 3, 4});
+	EXPECT_EQ(
+		smallVector1.getSizeInBytes(),
+		sizeof(smallVector1) + 5*sizeof(int)
+	);
+}
+
+};